@@ -0,0 +1,34 @@
+/// glare/core/hash.h
+/// 64-bit FNV-1a over bytes. Cheap and stable across runs and platforms, so
+/// the hashes can be stored in files; not meant to resist crafted input.
+
+#pragma once
+#include "glare/core/common.h"
+#include <cstddef>
+
+namespace glare
+{
+constexpr uint64 FNV1A_OFFSET = 0xcbf29ce484222325ull;
+constexpr uint64 FNV1A_PRIME = 0x100000001b3ull;
+
+// Pass the previous result as <hash> to continue over more bytes
+NODISCARD inline uint64 hash_fnv1a(const void* data, size_t size, uint64 hash = FNV1A_OFFSET)
+{
+	const uint8* bytes = static_cast<const uint8*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= FNV1A_PRIME;
+	}
+	return hash;
+}
+
+// Up to the terminating zero, which is left out
+NODISCARD inline uint64 hash_fnv1a(const char* cstr, uint64 hash = FNV1A_OFFSET)
+{
+	for (; *cstr != '\0'; ++cstr) {
+		hash ^= static_cast<uint8>(*cstr);
+		hash *= FNV1A_PRIME;
+	}
+	return hash;
+}
+}
@@ -0,0 +1,131 @@
+#include "glare/core/job.h"
+#include "glare/core/assert.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace glare
+{
+static std::vector<std::thread>	g_workers;
+static std::deque<job_func>		g_job_queue;
+static std::mutex				g_job_mutex;
+static std::condition_variable	g_job_signal;
+static bool						g_job_quit = false;
+
+static void _worker_main()
+{
+	for (;;) {
+		job_func job;
+		{
+			std::unique_lock<std::mutex> lock(g_job_mutex);
+			g_job_signal.wait(lock, [] { return g_job_quit || !g_job_queue.empty(); });
+			if (g_job_queue.empty()) {
+				return; // quit and drained
+			}
+			job = std::move(g_job_queue.front());
+			g_job_queue.pop_front();
+		}
+		job();
+	}
+}
+
+STATIC void job_system::start(uint32 num_workers)
+{
+	ASSERT(g_workers.empty(), "job_system already started");
+	if (num_workers == 0) {
+		const uint32 hardware = std::thread::hardware_concurrency();
+		num_workers = hardware > 1 ? hardware - 1 : 1;
+	}
+	g_job_quit = false;
+	for (uint32 i = 0; i < num_workers; ++i) {
+		g_workers.emplace_back(_worker_main);
+	}
+}
+
+STATIC void job_system::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(g_job_mutex);
+		g_job_quit = true;
+	}
+	g_job_signal.notify_all();
+	for (auto& each : g_workers) {
+		each.join();
+	}
+	g_workers.clear();
+}
+
+STATIC void job_system::submit(job_func job)
+{
+	if (g_workers.empty()) {
+		job();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(g_job_mutex);
+		g_job_queue.emplace_back(std::move(job));
+	}
+	g_job_signal.notify_one();
+}
+
+STATIC void job_system::parallel_for(size_t count, size_t grain, const job_range_func& func)
+{
+	if (count == 0) {
+		return;
+	}
+	grain = grain > 0 ? grain : 1;
+	const size_t num_chunks = (count + grain - 1) / grain;
+	if (g_workers.empty() || num_chunks == 1) {
+		func(0, count);
+		return;
+	}
+
+	// Shared with helper jobs, which may still be queued after the last chunk is taken
+	struct range_state
+	{
+		std::atomic<size_t> next_chunk {0};
+		std::atomic<size_t> done_chunks {0};
+		std::mutex			done_mutex;
+		std::condition_variable done_signal;
+	};
+	auto state = std::make_shared<range_state>();
+	const job_range_func* p_func = &func;
+	auto run_chunks = [state, p_func, count, grain, num_chunks]() {
+		for (;;) {
+			const size_t chunk = state->next_chunk.fetch_add(1);
+			if (chunk >= num_chunks) {
+				return;
+			}
+			const size_t begin = chunk * grain;
+			const size_t end = begin + grain < count ? begin + grain : count;
+			(*p_func)(begin, end);
+			if (state->done_chunks.fetch_add(1) + 1 == num_chunks) {
+				std::lock_guard<std::mutex> lock(state->done_mutex);
+				state->done_signal.notify_all();
+			}
+		}
+	};
+
+	const size_t num_helpers = num_chunks - 1 < g_workers.size() ? num_chunks - 1 : g_workers.size();
+	for (size_t i = 0; i < num_helpers; ++i) {
+		submit(run_chunks);
+	}
+	run_chunks();
+	std::unique_lock<std::mutex> lock(state->done_mutex);
+	state->done_signal.wait(lock, [&state, num_chunks] { return state->done_chunks.load() == num_chunks; });
+}
+
+STATIC uint32 job_system::get_worker_count()
+{
+	return static_cast<uint32>(g_workers.size());
+}
+
+STATIC bool job_system::is_running()
+{
+	return !g_workers.empty();
+}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "glare/core/common.h"
+#include <functional>
+
+namespace glare
+{
+using job_func = std::function<void()>;
+// Processes the element range [begin, end)
+using job_range_func = std::function<void(size_t begin, size_t end)>;
+
+// Fixed pool of worker threads with one shared FIFO queue.
+// Everything runs inline on the calling thread until start() is called.
+STATIC class job_system
+{
+public:
+	// num_workers == 0: one worker per hardware thread, minus the calling thread
+	static void start(uint32 num_workers = 0);
+	// Finishes the queued jobs, then joins all workers
+	static void stop();
+	static void submit(job_func job);
+	// Splits [0, count) into chunks of at least <grain> elements and blocks until all are done.
+	// The calling thread works on chunks as well, so nesting a parallel_for inside a job is safe.
+	static void parallel_for(size_t count, size_t grain, const job_range_func& func);
+	NODISCARD static uint32 get_worker_count();
+	NODISCARD static bool is_running();
+};
+}
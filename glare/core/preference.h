@@ -1,3 +1,5 @@
 #pragma once
 
 #define GLARE_USE_STD_STRING 1
+// 1: sin_deg/cos_deg/sincos default to the polynomial approximation (math/utilities.h)
+#define GLARE_FAST_TRIG 0
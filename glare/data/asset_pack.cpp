@@ -0,0 +1,269 @@
+#include "glare/data/asset_pack.h"
+#include "glare/core/assert.h"
+#include "glare/core/hash.h"
+#include "glare/core/string_utils.h"
+#include "glare/render/renderer.h"
+#include "glare/render/shader.h"
+#include "glare/render/sprite.h"
+#include "glare/render/texture.h"
+#include <algorithm>
+#include <vector>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace glare
+{
+static_assert(sizeof(asset_pack_header) % ASSET_PACK_ALIGNMENT == 0, "The entry table follows the header aligned");
+static_assert(sizeof(asset_pack_entry) == 32, "asset_pack_entry is part of the file format");
+static_assert(sizeof(asset_pack_sprite) == 16, "asset_pack_sprite is part of the file format");
+
+// Return: the view, nullptr when the file is missing or empty
+static const byte* _map_file(const char* path, size_t& out_size)
+{
+	out_size = 0;
+#if defined(_WIN32)
+	HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return nullptr;
+	}
+	LARGE_INTEGER file_size;
+	const void* view = nullptr;
+	if (::GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0) {
+		// the view keeps the mapping and the file open on its own
+		HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			::CloseHandle(mapping);
+		}
+		out_size = view ? static_cast<size_t>(file_size.QuadPart) : 0;
+	}
+	::CloseHandle(file);
+	return static_cast<const byte*>(view);
+#else
+	const int file = ::open(path, O_RDONLY);
+	if (file < 0) {
+		return nullptr;
+	}
+	struct stat file_stat;
+	void* view = MAP_FAILED;
+	if (::fstat(file, &file_stat) == 0 && file_stat.st_size > 0) {
+		view = ::mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		out_size = view != MAP_FAILED ? static_cast<size_t>(file_stat.st_size) : 0;
+	}
+	::close(file);
+	return view != MAP_FAILED ? static_cast<const byte*>(view) : nullptr;
+#endif
+}
+
+static void _unmap_file(const byte* view, size_t size)
+{
+#if defined(_WIN32)
+	UNUSED(size);
+	::UnmapViewOfFile(view);
+#else
+	::munmap(const_cast<byte*>(view), size);
+#endif
+}
+
+asset_pack::~asset_pack()
+{
+	close();
+}
+
+bool asset_pack::open(const char* path)
+{
+	close();
+	m_data = _map_file(path, m_size);
+	if (!m_data) {
+		return false;
+	}
+	m_header = reinterpret_cast<const asset_pack_header*>(m_data);
+	const bool header_ok = m_size >= sizeof(asset_pack_header)
+		&& m_header->magic == ASSET_PACK_MAGIC && m_header->version == ASSET_PACK_VERSION && m_header->file_size == m_size
+		&& m_header->entry_table_offset + static_cast<uint64>(m_header->entry_count) * sizeof(asset_pack_entry) <= m_size
+		&& m_header->string_table_offset + m_header->string_table_size <= m_size;
+	if (!header_ok) {
+		ALERT(format("%s is not an asset pack of version %u", path, ASSET_PACK_VERSION));
+		close();
+		return false;
+	}
+	m_entries = reinterpret_cast<const asset_pack_entry*>(m_data + m_header->entry_table_offset);
+	m_strings = reinterpret_cast<const char*>(m_data + m_header->string_table_offset);
+	for (uint32 i = 0; i < m_header->entry_count; ++i) {
+		const asset_pack_entry& entry = m_entries[i];
+		if (entry.offset % ASSET_PACK_ALIGNMENT != 0 || entry.offset + entry.size > m_size || entry.name >= m_header->string_table_size) {
+			ALERT(format("%s is truncated or corrupted", path));
+			close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void asset_pack::close()
+{
+	if (m_data) {
+		_unmap_file(m_data, m_size);
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_header = nullptr;
+	m_entries = nullptr;
+	m_strings = nullptr;
+}
+
+const asset_pack_entry* asset_pack::find(const string& name, e_asset_type type) const
+{
+	if (!m_data) {
+		return nullptr;
+	}
+	const uint64 name_hash = hash_fnv1a(name.c_str());
+	const asset_pack_entry* end = m_entries + m_header->entry_count;
+	const asset_pack_entry* found = std::lower_bound(m_entries, end, name_hash
+		, [](const asset_pack_entry& entry, uint64 hash) { return entry.name_hash < hash; });
+	for (; found != end && found->name_hash == name_hash; ++found) {
+		if (found->type == type && name == get_string(found->name)) {
+			return found;
+		}
+	}
+	return nullptr;
+}
+
+const asset_pack_entry& asset_pack::get_checked(const string& name, e_asset_type type) const
+{
+	const asset_pack_entry* found = find(name, type);
+	ASSERT(found, format("No asset [%s] of type %u in the pack", name.c_str(), type));
+	return *found;
+}
+
+texture2d* asset_pack::load_texture2d(renderer* r, const string& name) const
+{
+	const auto cached = renderer::s_cached_texture.find(name);
+	if (cached != std::end(renderer::s_cached_texture)) {
+		return cached->second;
+	}
+	const asset_pack_entry& entry = get_checked(name, ASSET_TEXTURE);
+	const asset_pack_texture* record = get_record<asset_pack_texture>(entry);
+	const asset_pack_level* levels = reinterpret_cast<const asset_pack_level*>(record + 1);
+	const byte* record_start = m_data + entry.offset;
+
+	// the device copies straight out of the mapping
+	std::vector<D3D11_SUBRESOURCE_DATA> data(record->level_count);
+	memset(data.data(), 0, data.size() * sizeof(D3D11_SUBRESOURCE_DATA));
+	for (uint32 level = 0; level < record->level_count; ++level) {
+		data[level].pSysMem		= record_start + levels[level].offset;
+		data[level].SysMemPitch	= levels[level].row_pitch;
+	}
+	texture2d* created = new texture2d(r);
+	created->create_from_memory(ivec2(record->width, record->height), static_cast<dx_format>(record->format), data.data(), record->level_count);
+	created->set_texture_name(name);
+	renderer::s_cached_texture[name] = created;
+	return created;
+}
+
+sprite_sheet* asset_pack::load_sprite_sheet(renderer* r, const string& name) const
+{
+	const asset_pack_entry& entry = get_checked(name, ASSET_SPRITE_SHEET);
+	const asset_pack_sprite_sheet* record = get_record<asset_pack_sprite_sheet>(entry);
+	const asset_pack_sprite* sprites = reinterpret_cast<const asset_pack_sprite*>(record + 1);
+
+	const auto found = sprite_sheet::s_sprite_sheet_cache.find(name);
+	if (found != std::end(sprite_sheet::s_sprite_sheet_cache)) {
+		delete found->second;
+	}
+	sprite_sheet* created = new sprite_sheet();
+	created->m_texture = load_texture2d(r, get_string(record->texture));
+	created->m_layout = ivec2(record->layout_x, record->layout_y);
+	created->m_sprites.reserve(record->sprite_count);
+	for (uint32 i = 0; i < record->sprite_count; ++i) {
+		created->m_sprites.emplace_back(created, sprites[i].bottom_left, sprites[i].top_right);
+	}
+	sprite_sheet::s_sprite_sheet_cache[name] = created;
+	return created;
+}
+
+sprite_anim* asset_pack::load_sprite_anim(const string& name) const
+{
+	const asset_pack_entry& entry = get_checked(name, ASSET_SPRITE_ANIM);
+	const asset_pack_sprite_anim* record = get_record<asset_pack_sprite_anim>(entry);
+	const asset_pack_clip* clips = reinterpret_cast<const asset_pack_clip*>(record + 1);
+	const asset_pack_frame* frames = reinterpret_cast<const asset_pack_frame*>(clips + record->clip_count);
+
+	sprite_anim* created = new sprite_anim();
+	created->m_sprite_sheet = sprite_sheet::get_sprite_sheet(get_string(record->sheet));
+	for (uint32 c = 0; c < record->clip_count; ++c) {
+		const asset_pack_clip& clip = clips[c];
+		std::vector<sprite_anim_clip::frame> clip_frames;
+		clip_frames.reserve(clip.frame_count);
+		for (uint32 f = clip.first_frame; f < clip.first_frame + clip.frame_count; ++f) {
+			clip_frames.emplace_back(created->m_sprite_sheet->get_sprite(frames[f].sprite_index), frames[f].time);
+		}
+		sprite_anim_clip new_clip(std::move(clip_frames), clip.start_paused != 0);
+		new_clip.m_playback_mode = static_cast<sprite_anim_clip::e_playback_mode>(clip.playback_mode);
+		if (c == 0) {
+			created->m_current_clip_id = get_string(clip.id);
+		}
+		created->m_clips.emplace(get_string(clip.id), std::move(new_clip));
+	}
+
+	const auto found = sprite_anim::s_sprite_anim_cache.find(name);
+	if (found != std::end(sprite_anim::s_sprite_anim_cache)) {
+		delete found->second;
+	}
+	sprite_anim::s_sprite_anim_cache[name] = created;
+	return created;
+}
+
+shader* asset_pack::create_shader(renderer* r, const string& name) const
+{
+	const asset_pack_shader* record = get_record<asset_pack_shader>(get_checked(name, ASSET_SHADER));
+	shader_pass_desc pass;
+	pass.src			= get_string(record->src);
+	pass.vs_entry		= get_string(record->vs_entry);
+	pass.ps_entry		= get_string(record->ps_entry);
+	pass.blend_mode		= static_cast<e_blend_mode>(record->blend_mode);
+	pass.depth_comp_op	= static_cast<e_compare_operator>(record->depth_comp_op);
+	pass.write_depth	= record->write_depth != 0;
+	pass.cull_mode		= static_cast<e_cull_mode>(record->cull_mode);
+	pass.fill_mode		= static_cast<e_fill_mode>(record->fill_mode);
+	pass.front_ccw		= record->front_ccw != 0;
+	return shader::create_from_pass(pass, r);
+}
+
+void asset_pack::load_all(renderer* r) const
+{
+	if (!m_data) {
+		return;
+	}
+	// sheets need their textures, animations their sheets
+	for (e_asset_type type : { ASSET_TEXTURE, ASSET_SPRITE_SHEET, ASSET_SPRITE_ANIM }) {
+		for (uint32 i = 0; i < m_header->entry_count; ++i) {
+			const asset_pack_entry& entry = m_entries[i];
+			if (entry.type != type) {
+				continue;
+			}
+			const string name = get_string(entry.name);
+			switch (type) {
+			case ASSET_TEXTURE:
+				load_texture2d(r, name);
+				break;
+			case ASSET_SPRITE_SHEET:
+				load_sprite_sheet(r, name);
+				break;
+			case ASSET_SPRITE_ANIM:
+				load_sprite_anim(name);
+				break;
+			default:
+				break;
+			}
+		}
+	}
+}
+}
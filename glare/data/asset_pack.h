@@ -0,0 +1,184 @@
+/// glare/data/asset_pack.h
+/// Binary pack of baked assets: textures with their mips (rgba8, float or BC
+/// blocks, uploaded as stored), sprite sheet uv tables, sprite animation clips
+/// and shader pass descriptions. asset_pack_writer bakes it offline from the
+/// png and xml files; at runtime the file is mapped into memory and the
+/// engine objects are built from the records in place, nothing is parsed.
+///
+/// Layout, little endian, every record aligned to ASSET_PACK_ALIGNMENT:
+///		asset_pack_header
+///		asset_pack_entry[entry_count], sorted by name hash then type
+///		string table, zero terminated names referenced by offset
+///		records, each a fixed struct followed by its arrays and texels
+/// Offsets in a record are from the start of that record. open() checks the
+/// header, the version and that every entry lies inside the file; the records
+/// themselves are trusted, a pack of the same version wrote them.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/vector.h"
+
+namespace glare
+{
+class renderer;
+class texture2d;
+class sprite_sheet;
+class sprite_anim;
+class shader;
+
+constexpr uint32 ASSET_PACK_MAGIC = 0x4b504c47;	// "GLPK"
+// Bump with every change of the structs below
+constexpr uint32 ASSET_PACK_VERSION = 1;
+constexpr uint32 ASSET_PACK_ALIGNMENT = 16;
+
+enum e_asset_type : uint32
+{
+	ASSET_TEXTURE,
+	ASSET_SPRITE_SHEET,
+	ASSET_SPRITE_ANIM,
+	ASSET_SHADER,
+};
+
+struct asset_pack_header
+{
+	uint32	magic;
+	uint32	version;
+	uint32	entry_count;
+	uint32	string_table_size;
+	uint64	entry_table_offset;
+	uint64	string_table_offset;
+	uint64	file_size;			// catches truncated files
+	uint64	reserved;
+};
+
+struct asset_pack_entry
+{
+	uint64	name_hash;			// hash_fnv1a() of the name
+	uint32	name;				// string table offset
+	uint32	type;				// e_asset_type
+	uint64	offset;				// of the record, from the start of the file
+	uint64	size;				// of the record with its arrays and texels
+};
+
+// Followed by <level_count> asset_pack_level, level 0 first
+struct asset_pack_texture
+{
+	uint32	format;				// dx_format of every level
+	uint32	level_count;
+	int32	width;
+	int32	height;
+};
+
+struct asset_pack_level
+{
+	uint64	offset;				// of the texels
+	uint32	size;				// in bytes
+	uint32	row_pitch;			// bytes per row of texels, or of blocks
+};
+
+// Followed by <sprite_count> asset_pack_sprite
+struct asset_pack_sprite_sheet
+{
+	uint32	texture;			// name of a texture, string table offset
+	uint32	sprite_count;
+	int32	layout_x;			// 0 for irregular sheets
+	int32	layout_y;
+};
+
+struct asset_pack_sprite
+{
+	vec2	bottom_left;		// uvs, normalized at bake time
+	vec2	top_right;
+};
+
+// Followed by <clip_count> asset_pack_clip, then the frames of every clip
+struct asset_pack_sprite_anim
+{
+	uint32	sheet;				// name of a sprite sheet, string table offset
+	uint32	clip_count;
+	uint32	frame_count;		// over all the clips
+	uint32	reserved;
+};
+
+struct asset_pack_clip
+{
+	uint32	id;					// string table offset
+	uint32	playback_mode;		// sprite_anim_clip::e_playback_mode
+	uint32	start_paused;
+	uint32	first_frame;		// into the frames of the animation
+	uint32	frame_count;
+	uint32	reserved;
+};
+
+struct asset_pack_frame
+{
+	int32	sprite_index;
+	float32	time;
+};
+
+// A shader_pass_desc, the hlsl itself is still compiled at load
+struct asset_pack_shader
+{
+	uint32	src;				// string table offsets
+	uint32	vs_entry;
+	uint32	ps_entry;
+	uint32	blend_mode;			// e_blend_mode
+	uint32	depth_comp_op;		// e_compare_operator
+	uint32	write_depth;
+	uint32	cull_mode;			// e_cull_mode
+	uint32	fill_mode;			// e_fill_mode
+	uint32	front_ccw;
+	uint32	reserved;
+};
+
+class asset_pack
+{
+public:
+	asset_pack() = default;
+	~asset_pack();
+	asset_pack(const asset_pack&) = delete;
+	asset_pack& operator=(const asset_pack&) = delete;
+
+	// Maps <path> read only.
+	// Return: false when the file is missing, not a pack or of another version
+	bool open(const char* path);
+	void close();
+	NODISCARD bool is_open() const { return m_data != nullptr; }
+	NODISCARD size_t get_size() const { return m_size; }
+
+	NODISCARD uint32 get_entry_count() const { return m_header->entry_count; }
+	NODISCARD const asset_pack_entry& get_entry(uint32 index) const { return m_entries[index]; }
+	NODISCARD const char* get_string(uint32 offset) const { return m_strings + offset; }
+	// Return: nullptr when the pack has no asset of <type> named <name>
+	NODISCARD const asset_pack_entry* find(const string& name, e_asset_type type) const;
+	template <typename T>
+	NODISCARD const T* get_record(const asset_pack_entry& entry) const
+	{
+		return reinterpret_cast<const T*>(m_data + entry.offset);
+	}
+
+	// Like renderer::load_texture2d_from_file(), cached in renderer::s_cached_texture
+	// under <name>; a texture cached under it before is returned instead
+	texture2d* load_texture2d(renderer* r, const string& name) const;
+	// Cached in sprite_sheet::s_sprite_sheet_cache, replacing a sheet of the
+	// same name. Its texture is loaded from the pack unless cached already
+	sprite_sheet* load_sprite_sheet(renderer* r, const string& name) const;
+	// Cached in sprite_anim::s_sprite_anim_cache, its sheet has to be cached
+	sprite_anim* load_sprite_anim(const string& name) const;
+	// Compiles the pass like shader::load_from_xml(), the caller owns it
+	shader* create_shader(renderer* r, const string& name) const;
+	// Every texture, then every sprite sheet and animation. Shaders are left
+	// to create_shader(), as nothing caches them
+	void load_all(renderer* r) const;
+
+private:
+	NODISCARD const asset_pack_entry& get_checked(const string& name, e_asset_type type) const;
+
+private:
+	const byte*					m_data = nullptr;
+	size_t						m_size = 0;
+	const asset_pack_header*	m_header = nullptr;
+	const asset_pack_entry*		m_entries = nullptr;
+	const char*					m_strings = nullptr;
+};
+}
@@ -0,0 +1,317 @@
+#include "glare/data/asset_pack_writer.h"
+#include "glare/core/assert.h"
+#include "glare/core/hash.h"
+#include "glare/core/string_utils.h"
+#include "glare/data/xml_utils.h"
+#include "glare/math/utilities.h"
+#include "glare/render/shader.h"
+#include "glare/render/sprite.h"
+#include "glare/render/surface.h"
+#include "glare/render/texture.h"
+#include "glare/render/vertex_format.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace glare
+{
+struct texture_level_source
+{
+	const void*	texels;
+	uint32		size;
+	uint32		row_pitch;
+};
+
+// Appends <size> zeroed bytes aligned to <alignment>.
+// Return: their offset in <record>
+static size_t _append(std::vector<byte>& record, size_t size, size_t alignment = 4)
+{
+	const size_t offset = (record.size() + alignment - 1) / alignment * alignment;
+	record.resize(offset + size, 0);
+	return offset;
+}
+
+static void _write_texture_record(std::vector<byte>& record, const ivec2& size, dx_format format, const std::vector<texture_level_source>& levels)
+{
+	const size_t levels_offset = _append(record, sizeof(asset_pack_texture) + levels.size() * sizeof(asset_pack_level));
+	std::vector<size_t> texel_offsets(levels.size());
+	for (size_t i = 0; i < levels.size(); ++i) {
+		texel_offsets[i] = _append(record, levels[i].size, ASSET_PACK_ALIGNMENT);
+	}
+	asset_pack_texture* texture = reinterpret_cast<asset_pack_texture*>(record.data() + levels_offset);
+	texture->format			= static_cast<uint32>(format);
+	texture->level_count	= static_cast<uint32>(levels.size());
+	texture->width			= size.x;
+	texture->height			= size.y;
+	asset_pack_level* level = reinterpret_cast<asset_pack_level*>(texture + 1);
+	for (size_t i = 0; i < levels.size(); ++i) {
+		level[i].offset		= texel_offsets[i];
+		level[i].size		= levels[i].size;
+		level[i].row_pitch	= levels[i].row_pitch;
+		memcpy(record.data() + texel_offsets[i], levels[i].texels, levels[i].size);
+	}
+}
+
+void asset_pack_writer::add_texture(const string& name, const surface* image, const asset_pack_texture_options& options)
+{
+	if (options.compress) {
+		compressed_image compressed;
+		compress_surface(image, options.blocks, compressed, options.mips);
+		add_texture(name, compressed);
+		return;
+	}
+
+	// the same levels as texture2d::create_from_surface() uploads
+	const bool use_rgba8 = image->get_storage() == SURFACE_STORAGE_RGBA8;
+	std::vector<mip_level> generated;
+	const std::vector<mip_level>* mips = &image->m_mips;
+	if (mips->empty() && options.mips) {
+		generate_mip_chain(image->get_surface_buffer(), image->m_size, mip_chain_options(), generated);
+		if (use_rgba8) {
+			image->release_cache();
+		}
+		mips = &generated;
+	}
+
+	const size_t texel_size = use_rgba8 ? sizeof(rgba8) : sizeof(rgba);
+	std::vector<texture_level_source> levels(mips->size() + 1);
+	levels[0].texels	= use_rgba8 ? static_cast<const void*>(image->get_rgba8_buffer()) : image->get_surface_buffer();
+	levels[0].size		= static_cast<uint32>(texel_size * image->get_texel_count());
+	levels[0].row_pitch	= static_cast<uint32>(texel_size * image->m_size.x);
+	std::vector<std::vector<rgba8>> packed(use_rgba8 ? mips->size() : 0);
+	for (size_t level = 1; level < levels.size(); ++level) {
+		const mip_level& mip = (*mips)[level - 1];
+		if (use_rgba8) {
+			std::vector<rgba8>& bytes = packed[level - 1];
+			bytes.resize(mip.texels.size());
+			vertex_packing::pack_unorm8x4(reinterpret_cast<byte*>(bytes.data()), sizeof(rgba8)
+				, reinterpret_cast<const byte*>(mip.texels.data()), sizeof(rgba), mip.texels.size());
+			levels[level].texels = bytes.data();
+		} else {
+			levels[level].texels = mip.texels.data();
+		}
+		levels[level].size		= static_cast<uint32>(texel_size * mip.texels.size());
+		levels[level].row_pitch	= static_cast<uint32>(texel_size * mip.size.x);
+	}
+	_write_texture_record(add_asset(name, ASSET_TEXTURE).record, image->m_size
+		, use_rgba8 ? DXGI_FORMAT_R8G8B8A8_UNORM : DXGI_FORMAT_R32G32B32A32_FLOAT, levels);
+	m_texture_sizes[name] = image->m_size;
+}
+
+void asset_pack_writer::add_texture(const string& name, const compressed_image& image)
+{
+	ASSERT(!image.levels.empty(), "Compressed image has no levels");
+	const ivec2& size = image.levels[0].size;
+	ASSERT(size.x % 4 == 0 && size.y % 4 == 0, "Block compressed textures need a size that is a multiple of 4");
+	std::vector<texture_level_source> levels(image.levels.size());
+	for (size_t level = 0; level < levels.size(); ++level) {
+		levels[level].texels	= image.levels[level].blocks.data();
+		levels[level].size		= static_cast<uint32>(image.levels[level].blocks.size());
+		levels[level].row_pitch	= get_block_row_pitch(image.format, image.levels[level].size.x);
+	}
+	_write_texture_record(add_asset(name, ASSET_TEXTURE).record, size, get_block_dx_format(image.format, image.srgb), levels);
+	m_texture_sizes[name] = size;
+}
+
+bool asset_pack_writer::add_texture_from_file(const string& name, const char* path, const asset_pack_texture_options& options, bool flip_v)
+{
+	const surface image(path, flip_v);
+	if (image.m_size.x == 0) {
+		return false;
+	}
+	add_texture(name, &image, options);
+	return true;
+}
+
+void asset_pack_writer::add_sprite_sheet(const string& name, const sprite_sheet* sheet, const string& texture)
+{
+	std::vector<byte>& record = add_asset(name, ASSET_SPRITE_SHEET).record;
+	const size_t sprite_count = sheet->get_num_sprites();
+	_append(record, sizeof(asset_pack_sprite_sheet) + sprite_count * sizeof(asset_pack_sprite));
+	asset_pack_sprite_sheet* header = reinterpret_cast<asset_pack_sprite_sheet*>(record.data());
+	header->texture			= add_string(texture);
+	header->sprite_count	= static_cast<uint32>(sprite_count);
+	header->layout_x		= sheet->m_layout.x;
+	header->layout_y		= sheet->m_layout.y;
+	asset_pack_sprite* sprites = reinterpret_cast<asset_pack_sprite*>(header + 1);
+	for (size_t i = 0; i < sprite_count; ++i) {
+		const sprite& each = sheet->get_sprite(i);
+		sprites[i].bottom_left = each.m_bottom_left;
+		sprites[i].top_right = each.m_top_right;
+	}
+}
+
+void asset_pack_writer::add_sprite_sheet_from_xml(const string& name, const char* path, const asset_pack_texture_options& options)
+{
+	xml::document* doc = xml::load_file(path);
+	const xml::node root_node = doc->root().child("sprites");
+	const string texture = root_node.attribute("texture").value();
+	if (get_texture_size(texture).x == 0) {
+		const xml::attribute src = root_node.attribute("src");
+		if (src.empty()) {
+			FATAL("No available texture nor image file when loading sprite sheet");
+		}
+		if (!add_texture_from_file(texture, src.value(), options)) {
+			FATAL(format("Decoding %s of sprite sheet %s failed", src.value(), path));
+		}
+	}
+	const vec2 texture_size(get_texture_size(texture));
+	sprite_sheet sheet;
+	sheet.read_sprites_from_xml(root_node, vec2(1.f / texture_size.u, 1.f / texture_size.v));
+	xml::unload_file(doc);
+	add_sprite_sheet(name, &sheet, texture);
+}
+
+void asset_pack_writer::add_sprite_anim_from_xml(const string& name, const char* path)
+{
+	xml::document* doc = xml::load_file(path);
+	const xml::node anim_node = doc->child("sprite_anim");
+	std::vector<asset_pack_clip> clips;
+	std::vector<asset_pack_frame> frames;
+	for (auto& each_clip : anim_node.children("clip")) {
+		asset_pack_clip& clip = clips.emplace_back();
+		memset(&clip, 0, sizeof(clip));
+		clip.id = add_string(xml::get_attr(each_clip, "id", "no-clip-id"));
+		const string mode = xml::get_attr(each_clip, "mode", "loop");
+		clip.playback_mode = static_cast<uint32>(
+			mode == "once" ? sprite_anim_clip::e_playback_mode::PLAYBACK_ONCE
+			: mode == "pingpong" ? sprite_anim_clip::e_playback_mode::PLAYBACK_PINGPONG
+			: sprite_anim_clip::e_playback_mode::PLAYBACK_LOOP);
+		clip.start_paused = xml::get_attr(each_clip, "start_paused", false) ? 1 : 0;
+		clip.first_frame = static_cast<uint32>(frames.size());
+		for (auto& each_frame : each_clip.children("frame")) {
+			asset_pack_frame& frame = frames.emplace_back();
+			frame.sprite_index = xml::get_attr(each_frame, "sprite_index", 0);
+			frame.time = xml::get_attr(each_frame, "time", 0.f);
+		}
+		clip.frame_count = static_cast<uint32>(frames.size()) - clip.first_frame;
+	}
+	const uint32 sheet = add_string(xml::get_attr(anim_node, "sheet", "default"));
+	xml::unload_file(doc);
+
+	std::vector<byte>& record = add_asset(name, ASSET_SPRITE_ANIM).record;
+	_append(record, sizeof(asset_pack_sprite_anim) + clips.size() * sizeof(asset_pack_clip) + frames.size() * sizeof(asset_pack_frame));
+	asset_pack_sprite_anim* header = reinterpret_cast<asset_pack_sprite_anim*>(record.data());
+	header->sheet		= sheet;
+	header->clip_count	= static_cast<uint32>(clips.size());
+	header->frame_count	= static_cast<uint32>(frames.size());
+	asset_pack_clip* clips_out = reinterpret_cast<asset_pack_clip*>(header + 1);
+	memcpy(clips_out, clips.data(), clips.size() * sizeof(asset_pack_clip));
+	memcpy(clips_out + clips.size(), frames.data(), frames.size() * sizeof(asset_pack_frame));
+}
+
+void asset_pack_writer::add_shader(const string& name, const shader_pass_desc& pass)
+{
+	asset_pack_shader record;
+	memset(&record, 0, sizeof(record));
+	record.src				= add_string(pass.src);
+	record.vs_entry			= add_string(pass.vs_entry);
+	record.ps_entry			= add_string(pass.ps_entry);
+	record.blend_mode		= static_cast<uint32>(pass.blend_mode);
+	record.depth_comp_op	= static_cast<uint32>(pass.depth_comp_op);
+	record.write_depth		= pass.write_depth ? 1 : 0;
+	record.cull_mode		= static_cast<uint32>(pass.cull_mode);
+	record.fill_mode		= static_cast<uint32>(pass.fill_mode);
+	record.front_ccw		= pass.front_ccw ? 1 : 0;
+	std::vector<byte>& bytes = add_asset(name, ASSET_SHADER).record;
+	_append(bytes, sizeof(record));
+	memcpy(bytes.data(), &record, sizeof(record));
+}
+
+void asset_pack_writer::add_shader_from_xml(const string& name, const char* path)
+{
+	shader_pass_desc pass;
+	shader::read_pass_from_xml(path, pass);
+	add_shader(name, pass);
+}
+
+bool asset_pack_writer::write(const char* path) const
+{
+	// sorted for the binary search of asset_pack::find()
+	std::vector<asset_pack_entry> entries(m_assets.size());
+	for (size_t i = 0; i < m_assets.size(); ++i) {
+		const asset& each = m_assets[i];
+		entries[i].name_hash	= hash_fnv1a(each.name.c_str());
+		entries[i].name			= m_string_offsets.at(each.name);
+		entries[i].type			= each.type;
+		entries[i].size			= each.record.size();
+	}
+	std::vector<uint32> order(m_assets.size());
+	for (uint32 i = 0; i < order.size(); ++i) {
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&entries](uint32 a, uint32 b) {
+		return entries[a].name_hash != entries[b].name_hash ? entries[a].name_hash < entries[b].name_hash : entries[a].type < entries[b].type;
+	});
+
+	const auto align = [](uint64 offset) { return (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT; };
+	asset_pack_header header;
+	memset(&header, 0, sizeof(header));
+	header.magic				= ASSET_PACK_MAGIC;
+	header.version				= ASSET_PACK_VERSION;
+	header.entry_count			= static_cast<uint32>(entries.size());
+	header.string_table_size	= static_cast<uint32>(m_strings.size());
+	header.entry_table_offset	= sizeof(asset_pack_header);
+	header.string_table_offset	= header.entry_table_offset + entries.size() * sizeof(asset_pack_entry);
+	uint64 offset = header.string_table_offset + m_strings.size();
+	std::vector<asset_pack_entry> sorted(entries.size());
+	for (size_t i = 0; i < order.size(); ++i) {
+		offset = align(offset);
+		entries[order[i]].offset = offset;
+		sorted[i] = entries[order[i]];
+		offset += entries[order[i]].size;
+	}
+	header.file_size = offset;
+
+	FILE* file = fopen(path, "wb");
+	if (!file) {
+		return false;
+	}
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(sorted.data(), sizeof(asset_pack_entry), sorted.size(), file) == sorted.size()
+		&& fwrite(m_strings.data(), 1, m_strings.size(), file) == m_strings.size();
+	const byte padding[ASSET_PACK_ALIGNMENT] = {};
+	uint64 position = header.string_table_offset + m_strings.size();
+	for (size_t i = 0; i < sorted.size() && written; ++i) {
+		const std::vector<byte>& record = m_assets[order[i]].record;
+		written = fwrite(padding, 1, sorted[i].offset - position, file) == sorted[i].offset - position
+			&& fwrite(record.data(), 1, record.size(), file) == record.size();
+		position = sorted[i].offset + record.size();
+	}
+	written = fclose(file) == 0 && written;
+	return written;
+}
+
+ivec2 asset_pack_writer::get_texture_size(const string& name) const
+{
+	const auto found = m_texture_sizes.find(name);
+	return found != std::end(m_texture_sizes) ? found->second : ivec2(0, 0);
+}
+
+asset_pack_writer::asset& asset_pack_writer::add_asset(const string& name, e_asset_type type)
+{
+	add_string(name);
+	for (asset& each : m_assets) {
+		if (each.type == type && each.name == name) {
+			each.record.clear();
+			return each;
+		}
+	}
+	asset& created = m_assets.emplace_back();
+	created.name = name;
+	created.type = type;
+	return created;
+}
+
+uint32 asset_pack_writer::add_string(const string& text)
+{
+	const auto found = m_string_offsets.find(text);
+	if (found != std::end(m_string_offsets)) {
+		return found->second;
+	}
+	const uint32 offset = static_cast<uint32>(m_strings.size());
+	m_strings.insert(m_strings.end(), text.c_str(), text.c_str() + text.size() + 1);
+	m_string_offsets.emplace(text, offset);
+	return offset;
+}
+}
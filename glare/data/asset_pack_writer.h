@@ -0,0 +1,69 @@
+/// glare/data/asset_pack_writer.h
+/// Offline baker of asset packs, see asset_pack.h for the layout.
+///
+/// Assets are kept in memory until write(). The png and xml files are read
+/// with the same code as the runtime loaders, so a pack builds the same
+/// objects as loading its sources: textures get the default mip chain of
+/// texture2d, sprite uvs are normalized by the size of the sheet texture.
+/// Adding a name twice for the same type replaces the first one.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/data/asset_pack.h"
+#include "glare/render/block_compression.h"
+#include <unordered_map>
+#include <vector>
+
+namespace glare
+{
+class surface;
+struct shader_pass_desc;
+
+struct asset_pack_texture_options
+{
+	bool	mips = true;		// the default chain of texture2d, built here
+	bool	compress = false;	// BC blocks with <blocks>, else the texels as the surface stores them
+	block_compression_options	blocks;
+};
+
+class asset_pack_writer
+{
+public:
+	void add_texture(const string& name, const surface* image, const asset_pack_texture_options& options = asset_pack_texture_options());
+	void add_texture(const string& name, const compressed_image& image);
+	// Return: false when the file does not decode
+	bool add_texture_from_file(const string& name, const char* path, const asset_pack_texture_options& options = asset_pack_texture_options(), bool flip_v=false);
+	// <sheet> uvs as they are, under the texture name <texture>
+	void add_sprite_sheet(const string& name, const sprite_sheet* sheet, const string& texture);
+	// The texture of the sheet is added from its src unless added before
+	void add_sprite_sheet_from_xml(const string& name, const char* path, const asset_pack_texture_options& options = asset_pack_texture_options());
+	void add_sprite_anim_from_xml(const string& name, const char* path);
+	void add_shader(const string& name, const shader_pass_desc& pass);
+	void add_shader_from_xml(const string& name, const char* path);
+
+	// Return: false when the file cannot be written
+	bool write(const char* path) const;
+
+	NODISCARD size_t get_asset_count() const { return m_assets.size(); }
+	// Return: the texture size, 0 when no texture <name> was added
+	NODISCARD ivec2 get_texture_size(const string& name) const;
+
+private:
+	struct asset
+	{
+		string				name;
+		e_asset_type		type = ASSET_TEXTURE;
+		std::vector<byte>	record;
+	};
+
+private:
+	asset& add_asset(const string& name, e_asset_type type);
+	uint32 add_string(const string& text);
+
+private:
+	std::vector<asset>						m_assets;
+	std::vector<char>						m_strings;
+	std::unordered_map<string, uint32>		m_string_offsets;
+	std::unordered_map<string, ivec2>		m_texture_sizes;
+};
+}
@@ -0,0 +1,236 @@
+#include "glare/dev/asset_pack_bench.h"
+#include "glare/core/clock.h"
+#include "glare/core/string_utils.h"
+#include "glare/data/asset_pack.h"
+#include "glare/data/asset_pack_writer.h"
+#include "glare/math/utilities.h"
+#include "glare/render/renderer.h"
+#include "glare/render/sprite.h"
+#include "glare/render/surface.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+constexpr int32 SHEET_LAYOUT = 4;	// sprites a row and a column
+constexpr int32 CLIP_FRAMES = 8;
+
+struct loaded_assets
+{
+	std::vector<texture2d*>		textures;
+	std::vector<sprite_sheet*>	sheets;
+	std::vector<sprite_anim*>	anims;
+
+	~loaded_assets()
+	{
+		for (sprite_anim* each : anims) {
+			delete each;
+		}
+		for (sprite_sheet* each : sheets) {
+			delete each;
+		}
+		for (texture2d* each : textures) {
+			delete each;
+		}
+	}
+};
+
+// Removes <id> from <cache>, so the next path loads it again.
+// Return: the cached object, nullptr when there was none
+template<typename T>
+static T* _take(std::unordered_map<string, T*>& cache, const string& id)
+{
+	const auto found = cache.find(id);
+	if (found == std::end(cache)) {
+		return nullptr;
+	}
+	T* taken = found->second;
+	cache.erase(found);
+	return taken;
+}
+
+static uint64 _get_file_size(const string& path)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file) {
+		return 0;
+	}
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fclose(file);
+	return size > 0 ? static_cast<uint64>(size) : 0;
+}
+
+static bool _is_same_sprite(const sprite& a, const sprite& b)
+{
+	return a.m_bottom_left.u == b.m_bottom_left.u && a.m_bottom_left.v == b.m_bottom_left.v
+		&& a.m_top_right.u == b.m_top_right.u && a.m_top_right.v == b.m_top_right.v;
+}
+
+static bool _is_same_sheet(const sprite_sheet* a, const sprite_sheet* b)
+{
+	if (!a || !b || a->m_texture->get_size() != b->m_texture->get_size() || a->get_num_sprites() != b->get_num_sprites()) {
+		return false;
+	}
+	for (size_t i = 0; i < a->get_num_sprites(); ++i) {
+		if (!_is_same_sprite(a->get_sprite(i), b->get_sprite(i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool _is_same_anim(const sprite_anim* a, const sprite_anim* b)
+{
+	if (!a || !b || a->m_current_clip_id != b->m_current_clip_id || a->m_clips.size() != b->m_clips.size()) {
+		return false;
+	}
+	for (const auto& each : a->m_clips) {
+		const auto found = b->m_clips.find(each.first);
+		if (found == std::end(b->m_clips)) {
+			return false;
+		}
+		const sprite_anim_clip& left = each.second;
+		const sprite_anim_clip& right = found->second;
+		if (left.m_playback_mode != right.m_playback_mode || left.m_paused != right.m_paused || left.m_frames.size() != right.m_frames.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < left.m_frames.size(); ++i) {
+			if (left.m_frames[i].m_frame_time != right.m_frames[i].m_frame_time
+				|| !_is_same_sprite(left.m_frames[i].m_sprite, right.m_frames[i].m_sprite)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+asset_pack_bench_result run_asset_pack_bench(renderer* r, const char* directory, uint32 num_sheets, uint32 image_size)
+{
+	asset_pack_bench_result result;
+	result.num_sheets = num_sheets;
+	result.image_size = image_size;
+
+	// noisy gradients, so the png files do not compress to nothing
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float32> noise(-0.1f, 0.1f);
+	std::vector<string> texture_ids;
+	std::vector<string> sheet_ids;
+	std::vector<string> anim_ids;
+	std::vector<string> paths;
+	const int32 cell = static_cast<int32>(image_size) / SHEET_LAYOUT;
+	for (uint32 i = 0; i < num_sheets; ++i) {
+		surface image(image_size, image_size);
+		rgba* texels = image.get_surface_buffer();
+		for (uint32 y = 0; y < image_size; ++y) {
+			for (uint32 x = 0; x < image_size; ++x) {
+				const float32 u = static_cast<float32>(x) / image_size;
+				const float32 v = static_cast<float32>(y) / image_size;
+				texels[static_cast<size_t>(y) * image_size + x] = rgba(clamp(u + noise(rng), 0.f, 1.f)
+					, clamp(v + noise(rng), 0.f, 1.f), static_cast<float32>(i) / num_sheets, ((x / 7 + y / 5) & 1) ? 1.f : 0.5f);
+			}
+		}
+		texture_ids.emplace_back(format("asset_pack_bench_texture_%u", i));
+		sheet_ids.emplace_back(format("asset_pack_bench_sheet_%u", i));
+		anim_ids.emplace_back(format("asset_pack_bench_anim_%u", i));
+		const string png_path = format("%s/asset_pack_bench_%u.png", directory, i);
+		const string sheet_path = format("%s/asset_pack_bench_sheet_%u.xml", directory, i);
+		const string anim_path = format("%s/asset_pack_bench_anim_%u.xml", directory, i);
+		image.write_png(png_path.c_str());
+
+		if (FILE* xml_file = fopen(sheet_path.c_str(), "w")) {
+			fprintf(xml_file, "<sprites texture=\"%s\" src=\"%s\">\n", texture_ids.back().c_str(), png_path.c_str());
+			for (int32 s = 0; s < SHEET_LAYOUT * SHEET_LAYOUT; ++s) {
+				const int32 left = (s % SHEET_LAYOUT) * cell;
+				const int32 top = (s / SHEET_LAYOUT) * cell;
+				fprintf(xml_file, "\t<sprite index=\"%d\" bl=\"%d,%d\" tr=\"%d,%d\"/>\n", s, left, top + cell, left + cell, top);
+			}
+			fprintf(xml_file, "</sprites>\n");
+			fclose(xml_file);
+		}
+		if (FILE* xml_file = fopen(anim_path.c_str(), "w")) {
+			fprintf(xml_file, "<sprite_anim sheet=\"%s\">\n", sheet_ids.back().c_str());
+			const char* modes[] = { "loop", "pingpong" };
+			for (int32 c = 0; c < 2; ++c) {
+				fprintf(xml_file, "\t<clip id=\"clip_%d\" mode=\"%s\">\n", c, modes[c]);
+				for (int32 f = 0; f < CLIP_FRAMES; ++f) {
+					fprintf(xml_file, "\t\t<frame sprite_index=\"%d\" time=\"%g\"/>\n", (c * CLIP_FRAMES + f) % (SHEET_LAYOUT * SHEET_LAYOUT), 0.05 + 0.01 * f);
+				}
+				fprintf(xml_file, "\t</clip>\n");
+			}
+			fprintf(xml_file, "</sprite_anim>\n");
+			fclose(xml_file);
+		}
+		paths.push_back(png_path);
+		paths.push_back(sheet_path);
+		paths.push_back(anim_path);
+	}
+	for (const string& each : paths) {
+		result.source_bytes += _get_file_size(each);
+	}
+
+	const auto take_all = [&](loaded_assets& out) {
+		for (uint32 i = 0; i < num_sheets; ++i) {
+			out.textures.push_back(_take(renderer::s_cached_texture, texture_ids[i]));
+			out.sheets.push_back(_take(sprite_sheet::s_sprite_sheet_cache, sheet_ids[i]));
+			out.anims.push_back(_take(sprite_anim::s_sprite_anim_cache, anim_ids[i]));
+		}
+	};
+
+	loaded_assets from_files;
+	const float64 xml_start = get_current_time_seconds();
+	for (uint32 i = 0; i < num_sheets; ++i) {
+		sprite_sheet::load_sprite_sheet_from_xml(sheet_ids[i], r, paths[i * 3 + 1].c_str());
+		sprite_anim::load_sprite_anim_from_xml(anim_ids[i], paths[i * 3 + 2].c_str());
+	}
+	result.xml_png_ms = (get_current_time_seconds() - xml_start) * 1000.0;
+	take_all(from_files);
+
+	const string pack_paths[2] = { format("%s/asset_pack_bench.pack", directory), format("%s/asset_pack_bench_bc.pack", directory) };
+	for (uint32 variant = 0; variant < 2; ++variant) {
+		asset_pack_texture_options options;
+		options.compress = variant == 1;
+		options.blocks.format = BLOCK_FORMAT_BC1;
+		options.blocks.quality = BLOCK_QUALITY_FAST;
+		options.blocks.alpha_threshold = 0;
+		const float64 bake_start = get_current_time_seconds();
+		{
+			asset_pack_writer writer;
+			for (uint32 i = 0; i < num_sheets; ++i) {
+				writer.add_sprite_sheet_from_xml(sheet_ids[i], paths[i * 3 + 1].c_str(), options);
+				writer.add_sprite_anim_from_xml(anim_ids[i], paths[i * 3 + 2].c_str());
+			}
+			writer.write(pack_paths[variant].c_str());
+		}
+		(variant == 0 ? result.bake_ms : result.bake_bc_ms) = (get_current_time_seconds() - bake_start) * 1000.0;
+		(variant == 0 ? result.pack_bytes : result.pack_bc_bytes) = _get_file_size(pack_paths[variant]);
+
+		loaded_assets from_pack;
+		const float64 load_start = get_current_time_seconds();
+		{
+			asset_pack pack;
+			if (pack.open(pack_paths[variant].c_str())) {
+				pack.load_all(r);
+			}
+		}
+		(variant == 0 ? result.pack_ms : result.pack_bc_ms) = (get_current_time_seconds() - load_start) * 1000.0;
+		take_all(from_pack);
+
+		if (variant == 0) {
+			for (uint32 i = 0; i < num_sheets; ++i) {
+				result.mismatches += _is_same_sheet(from_files.sheets[i], from_pack.sheets[i]) ? 0 : 1;
+				result.mismatches += _is_same_anim(from_files.anims[i], from_pack.anims[i]) ? 0 : 1;
+			}
+		}
+	}
+
+	for (const string& each : paths) {
+		std::remove(each.c_str());
+	}
+	for (const string& each : pack_paths) {
+		std::remove(each.c_str());
+	}
+	return result;
+}
+}
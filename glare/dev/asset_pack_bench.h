@@ -0,0 +1,34 @@
+/// glare/dev/asset_pack_bench.h
+/// Startup of a set of sprite sheets with animations, each a png with a sheet
+/// xml and an animation xml: loaded from the files the way the game does,
+/// then from asset packs baked from the same files, one keeping rgba8 texels
+/// and one with BC1 blocks. The objects of the two paths are compared.
+/// The files were just written, so both paths read from the OS file cache;
+/// a cold disk adds the read of the files (see the byte counts) to either.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+class renderer;
+
+struct asset_pack_bench_result
+{
+	uint32	num_sheets		= 0;
+	uint32	image_size		= 0;
+	uint64	source_bytes	= 0;	// png and xml files
+	uint64	pack_bytes		= 0;	// rgba8 texels with mips
+	uint64	pack_bc_bytes	= 0;	// BC1 blocks with mips
+	float64	xml_png_ms		= 0.0;	// png decode, mips and upload, sheet and animation xml
+	float64	bake_ms			= 0.0;	// asset_pack_writer, offline
+	float64	bake_bc_ms		= 0.0;
+	float64	pack_ms			= 0.0;	// asset_pack open() and load_all()
+	float64	pack_bc_ms		= 0.0;
+	uint32	mismatches		= 0;	// sheets and animations the rgba8 pack builds differently
+};
+
+// Writes into <directory>, which has to exist, and removes the files again.
+// Creates the textures on <r>
+asset_pack_bench_result run_asset_pack_bench(renderer* r, const char* directory, uint32 num_sheets = 32, uint32 image_size = 512);
+}
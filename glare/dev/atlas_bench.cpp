@@ -0,0 +1,64 @@
+#include "glare/dev/atlas_bench.h"
+#include "glare/render/texture_atlas.h"
+#include "glare/render/surface.h"
+#include "glare/render/sprite.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+static atlas_bench_entry _make_entry(const char* name, const texture_atlas& atlas)
+{
+	const texture_atlas_stats stats = atlas.get_stats();
+	atlas_bench_entry result;
+	result.name = name;
+	result.pages = static_cast<uint32>(atlas.get_page_count());
+	result.build_ms = stats.pack_ms;
+	result.page_fill = static_cast<float64>(stats.content_texels) / std::max<uint64>(stats.page_texels, 1);
+	result.occupied_fill = static_cast<float64>(stats.content_texels) / std::max<uint64>(stats.occupied_texels, 1);
+	return result;
+}
+
+atlas_bench_result run_atlas_bench(uint32 num_sprites)
+{
+	// sheets of 10x10 sprites, 8 to 64 texels a side
+	constexpr int32 SHEET_LAYOUT = 10;
+	constexpr uint32 SPRITES_PER_SHEET = SHEET_LAYOUT * SHEET_LAYOUT;
+	std::mt19937 rng(1234u);
+	std::uniform_int_distribution<int32> extent(8, 64);
+	const uint32 num_sheets = (num_sprites + SPRITES_PER_SHEET - 1) / SPRITES_PER_SHEET;
+
+	atlas_bench_result result;
+	result.num_sprites = num_sheets * SPRITES_PER_SHEET;
+	std::vector<std::unique_ptr<surface>> sheet_images;
+	std::vector<std::unique_ptr<sprite_sheet>> sheets;
+	for (uint32 i = 0; i < num_sheets; ++i) {
+		const ivec2 sprite_size(extent(rng), extent(rng));
+		sheet_images.emplace_back(new surface(sprite_size.x * SHEET_LAYOUT, sprite_size.y * SHEET_LAYOUT, rgba(0.5f, 0.25f, 1.f, 1.f)));
+		sheets.emplace_back(new sprite_sheet(nullptr, ivec2(SHEET_LAYOUT, SHEET_LAYOUT)));
+	}
+	{
+		texture_atlas atlas(nullptr);
+		for (uint32 i = 0; i < num_sheets; ++i) {
+			(void)atlas.add_sprite_sheet(sheets[i].get(), sheet_images[i].get());
+		}
+		result.modes[0] = _make_entry("sprite sheets", atlas);
+	}
+
+	std::vector<std::unique_ptr<surface>> images;
+	for (uint32 i = 0; i < result.num_sprites; ++i) {
+		images.emplace_back(new surface(extent(rng), extent(rng), rgba(1.f, 0.5f, 0.25f, 1.f)));
+	}
+	{
+		texture_atlas atlas(nullptr);
+		atlas_region region;
+		for (const auto& each : images) {
+			(void)atlas.add_surface(each.get(), region);
+		}
+		result.modes[1] = _make_entry("incremental surfaces", atlas);
+	}
+	return result;
+}
+}
@@ -0,0 +1,29 @@
+/// glare/dev/atlas_bench.h
+/// Packs many small sprites with texture_atlas, as whole sprite sheets and
+/// as one surface at a time, and reports the build time and how full the
+/// pages are. CPU only, no device is needed.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct atlas_bench_entry
+{
+	const char*	name			= nullptr;
+	uint32		pages			= 0;
+	float64		build_ms		= 0.0;	// packing and texel copies
+	float64		page_fill		= 0.0;	// sprite texels / page texels
+	float64		occupied_fill	= 0.0;	// sprite texels / texels down to the lowest sprite of each page
+};
+
+struct atlas_bench_result
+{
+	static constexpr size_t NUM_MODES = 2;
+
+	uint32				num_sprites = 0;
+	atlas_bench_entry	modes[NUM_MODES];	// sprite sheets, incremental surfaces
+};
+
+atlas_bench_result run_atlas_bench(uint32 num_sprites = 10000);
+}
@@ -0,0 +1,149 @@
+#include "glare/dev/block_compression_bench.h"
+#include "glare/core/clock.h"
+#include "glare/core/job.h"
+#include "glare/math/utilities.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace glare
+{
+// Smooth gradients with light noise and hard edged bands, a photo-like image
+static void _make_photo(uint32 size, std::vector<rgba8>& out_texels)
+{
+	std::mt19937 rng(1234u);
+	std::uniform_int_distribution<int32> noise(-2, 2);
+	out_texels.resize(static_cast<size_t>(size) * size);
+	for (uint32 y = 0; y < size; ++y) {
+		for (uint32 x = 0; x < size; ++x) {
+			const float32 u = static_cast<float32>(x) / size;
+			const float32 v = static_cast<float32>(y) / size;
+			const auto channel = [&noise, &rng](float32 value) {
+				return static_cast<byte>(clamp(static_cast<int32>(value * 255.f) + noise(rng), 0, 255));
+			};
+			const bool band = static_cast<uint32>((u + v * 0.3f) * 24.f) % 5 == 0;
+			out_texels[static_cast<size_t>(y) * size + x] = band
+				? rgba8(channel(0.9f - v * 0.5f), channel(0.2f), channel(0.1f + u * 0.3f), 255)
+				: rgba8(channel(u), channel(0.5f + 0.5f * std::sin(u * 9.f + v * 5.f)), channel(v * (1.f - u)), 255);
+		}
+	}
+}
+
+// Colored discs over transparency, with soft edges
+static void _make_alpha(uint32 size, std::vector<rgba8>& out_texels)
+{
+	std::mt19937 rng(99u);
+	std::uniform_real_distribution<float32> unit(0.f, 1.f);
+	out_texels.assign(static_cast<size_t>(size) * size, rgba8(0, 0, 0, 0));
+	for (uint32 disc = 0; disc < 64; ++disc) {
+		const float32 cx = unit(rng) * size;
+		const float32 cy = unit(rng) * size;
+		const float32 radius = (0.02f + unit(rng) * 0.08f) * size;
+		const rgba8 color(static_cast<byte>(unit(rng) * 255.f), static_cast<byte>(unit(rng) * 255.f), static_cast<byte>(unit(rng) * 255.f));
+		const int32 x0 = std::max(0, static_cast<int32>(cx - radius));
+		const int32 x1 = std::min(static_cast<int32>(size) - 1, static_cast<int32>(cx + radius));
+		const int32 y0 = std::max(0, static_cast<int32>(cy - radius));
+		const int32 y1 = std::min(static_cast<int32>(size) - 1, static_cast<int32>(cy + radius));
+		for (int32 y = y0; y <= y1; ++y) {
+			for (int32 x = x0; x <= x1; ++x) {
+				const float32 distance = std::sqrt((x - cx) * (x - cx) + (y - cy) * (y - cy)) / radius;
+				if (distance < 1.f) {
+					rgba8& texel = out_texels[static_cast<size_t>(y) * size + x];
+					texel = color;
+					texel.a = static_cast<byte>(clamp((1.f - distance) * 4.f, 0.f, 1.f) * 255.f);
+				}
+			}
+		}
+	}
+}
+
+// Tangent space normals of a wavy height field, xy in rg
+static void _make_normal(uint32 size, std::vector<rgba8>& out_texels)
+{
+	out_texels.resize(static_cast<size_t>(size) * size);
+	for (uint32 y = 0; y < size; ++y) {
+		for (uint32 x = 0; x < size; ++x) {
+			const float32 u = static_cast<float32>(x) / size * 160.f;
+			const float32 v = static_cast<float32>(y) / size * 100.f;
+			const float32 dx = 0.6f * std::cos(u) * std::cos(v * 0.3f);
+			const float32 dy = -0.6f * std::sin(v) * std::sin(u * 0.2f);
+			const float32 length = std::sqrt(dx * dx + dy * dy + 1.f);
+			out_texels[static_cast<size_t>(y) * size + x] = rgba8(static_cast<byte>((dx / length * 0.5f + 0.5f) * 255.f)
+				, static_cast<byte>((dy / length * 0.5f + 0.5f) * 255.f), static_cast<byte>((1.f / length * 0.5f + 0.5f) * 255.f));
+		}
+	}
+}
+
+static float64 _get_psnr(const std::vector<rgba8>& a, const std::vector<rgba8>& b, uint32 channels)
+{
+	float64 sum = 0.0;
+	for (size_t i = 0; i < a.size(); ++i) {
+		const byte* left = &a[i].r;
+		const byte* right = &b[i].r;
+		for (uint32 c = 0; c < channels; ++c) {
+			const float64 delta = static_cast<float64>(left[c]) - right[c];
+			sum += delta * delta;
+		}
+	}
+	const float64 mse = sum / (static_cast<float64>(a.size()) * channels);
+	return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+block_compression_bench_result run_block_compression_bench(uint32 size, uint32 num_runs)
+{
+	block_compression_bench_result result;
+	result.size = size;
+	result.num_workers = job_system::get_worker_count();
+	const ivec2 extent(static_cast<int32>(size), static_cast<int32>(size));
+
+	std::vector<rgba8> photo;
+	std::vector<rgba8> alpha;
+	std::vector<rgba8> normal;
+	_make_photo(size, photo);
+	_make_alpha(size, alpha);
+	_make_normal(size, normal);
+
+	struct bench_case
+	{
+		const char*			image;
+		const std::vector<rgba8>*	texels;
+		e_block_format		format;
+		uint32				channels;
+	};
+	const bench_case cases[] = {
+		{ "photo", &photo, BLOCK_FORMAT_BC1, 3 },
+		{ "photo", &photo, BLOCK_FORMAT_BC4, 1 },
+		{ "photo", &photo, BLOCK_FORMAT_BC7, 3 },
+		{ "alpha", &alpha, BLOCK_FORMAT_BC3, 4 },
+		{ "alpha", &alpha, BLOCK_FORMAT_BC7, 4 },
+		{ "normal", &normal, BLOCK_FORMAT_BC5, 2 },
+	};
+	const e_block_quality qualities[] = { BLOCK_QUALITY_FAST, BLOCK_QUALITY_NORMAL, BLOCK_QUALITY_HIGH };
+
+	std::vector<byte> blocks;
+	std::vector<rgba8> decoded(photo.size());
+	for (const bench_case& each : cases) {
+		for (e_block_quality quality : qualities) {
+			block_compression_options options;
+			options.format = each.format;
+			options.quality = quality;
+			block_compression_bench_entry entry;
+			entry.image = each.image;
+			entry.format = each.format;
+			entry.quality = quality;
+			entry.encode_ms = 1e9;
+			for (uint32 run = 0; run < num_runs; ++run) {
+				const float64 start = get_current_time_seconds();
+				compress_blocks(each.texels->data(), extent, options, blocks);
+				entry.encode_ms = std::min(entry.encode_ms, (get_current_time_seconds() - start) * 1000.0);
+			}
+			entry.mtexels_per_s = photo.size() / (entry.encode_ms * 1000.0);
+			entry.bits_per_texel = blocks.size() * 8.0 / photo.size();
+			decompress_blocks(blocks.data(), extent, each.format, decoded.data());
+			entry.psnr_db = _get_psnr(*each.texels, decoded, each.channels);
+			result.entries.push_back(entry);
+		}
+	}
+	return result;
+}
+}
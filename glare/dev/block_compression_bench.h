@@ -0,0 +1,33 @@
+/// glare/dev/block_compression_bench.h
+/// Encodes generated test images with every BC format and quality preset,
+/// timing the encoder and measuring the PSNR of the decoded blocks against
+/// the source over the channels the format keeps. CPU only; the encoder
+/// splits over job_system when it is running.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/block_compression.h"
+#include <vector>
+
+namespace glare
+{
+struct block_compression_bench_entry
+{
+	string			image;			// "photo", "alpha" or "normal"
+	e_block_format	format			= BLOCK_FORMAT_BC1;
+	e_block_quality	quality			= BLOCK_QUALITY_NORMAL;
+	float64			encode_ms		= 0.0;	// best of the runs, level 0 only
+	float64			mtexels_per_s	= 0.0;
+	float64			psnr_db			= 0.0;	// over the channels the format keeps
+	float64			bits_per_texel	= 0.0;
+};
+
+struct block_compression_bench_result
+{
+	uint32	size		= 0;
+	uint32	num_workers	= 0;
+	std::vector<block_compression_bench_entry>	entries;
+};
+
+block_compression_bench_result run_block_compression_bench(uint32 size = 1024, uint32 num_runs = 3);
+}
@@ -43,6 +43,7 @@ STATIC void dev_ui::render()
 	dx_rtv* rtv = rt->get_dx_handle();
 	m_renderer->get_dx_context()->OMSetRenderTargets(1, &rtv, nullptr);
 	ImGui_ImplDX11_RenderDrawData(draw_data);
+	m_renderer->get_state_cache()->invalidate();
 }
 
 STATIC void dev_ui::end_frame()
@@ -0,0 +1,62 @@
+#include "glare/dev/mip_chain_bench.h"
+#include "glare/core/clock.h"
+#include "glare/math/utilities.h"
+#include "glare/render/mip_chain.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+static mip_chain_bench_entry _measure_setup(const char* name, const std::vector<rgba>& image, const ivec2& size
+	, const mip_chain_options& options, uint32 num_runs)
+{
+	mip_chain_bench_entry result;
+	result.name = name;
+	result.generate_ms = 1e9;
+	std::vector<mip_level> levels;
+	for (uint32 run = 0; run < num_runs; ++run) {
+		levels.clear();
+		const float64 start = get_current_time_seconds();
+		generate_mip_chain(image.data(), size, options, levels);
+		const float64 end = get_current_time_seconds();
+		result.generate_ms = std::min(result.generate_ms, (end - start) * 1000.0);
+	}
+	result.mtexels_per_s = static_cast<float64>(image.size()) / std::max(result.generate_ms, 1e-6) / 1000.0;
+	return result;
+}
+
+mip_chain_bench_result run_mip_chain_bench(uint32 size, uint32 num_runs)
+{
+	// noise over smooth gradients, alpha tested cutouts
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float32> noise(-0.1f, 0.1f);
+	const ivec2 extent(static_cast<int32>(size), static_cast<int32>(size));
+	std::vector<rgba> image(static_cast<size_t>(size) * size);
+	for (uint32 y = 0; y < size; ++y) {
+		for (uint32 x = 0; x < size; ++x) {
+			const float32 u = static_cast<float32>(x) / size;
+			const float32 v = static_cast<float32>(y) / size;
+			image[static_cast<size_t>(y) * size + x] = rgba(clamp(u + noise(rng), 0.f, 1.f), clamp(v + noise(rng), 0.f, 1.f)
+				, 0.5f, ((x / 7 + y / 5) & 1) ? 1.f : 0.f);
+		}
+	}
+
+	mip_chain_options box_linear;
+	box_linear.srgb = false;
+	mip_chain_options box_srgb;
+	mip_chain_options kaiser_srgb;
+	kaiser_srgb.filter = MIP_FILTER_KAISER;
+	mip_chain_options box_coverage;
+	box_coverage.alpha_coverage_reference = 0.5f;
+
+	mip_chain_bench_result result;
+	result.size = size;
+	result.num_levels = get_mip_level_count(extent);
+	result.setups[0] = _measure_setup("box linear", image, extent, box_linear, num_runs);
+	result.setups[1] = _measure_setup("box sRGB", image, extent, box_srgb, num_runs);
+	result.setups[2] = _measure_setup("Kaiser sRGB", image, extent, kaiser_srgb, num_runs);
+	result.setups[3] = _measure_setup("box sRGB + alpha coverage", image, extent, box_coverage, num_runs);
+	return result;
+}
+}
@@ -0,0 +1,27 @@
+/// glare/dev/mip_chain_bench.h
+/// Times generate_mip_chain on a square image for each filter setup.
+/// CPU only, no device is needed.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct mip_chain_bench_entry
+{
+	const char*	name			= nullptr;
+	float64		generate_ms		= 0.0;	// best of the runs, whole chain
+	float64		mtexels_per_s	= 0.0;	// level 0 texels
+};
+
+struct mip_chain_bench_result
+{
+	static constexpr size_t NUM_SETUPS = 4;
+
+	uint32					size = 0;
+	uint32					num_levels = 0;
+	mip_chain_bench_entry	setups[NUM_SETUPS];	// box linear, box sRGB, Kaiser sRGB, box sRGB with alpha coverage
+};
+
+mip_chain_bench_result run_mip_chain_bench(uint32 size = 4096, uint32 num_runs = 3);
+}
@@ -0,0 +1,48 @@
+#include "glare/dev/physics_bench.h"
+#include "glare/physics/physics_world.h"
+#include <algorithm>
+
+namespace glare
+{
+physics_bench_result run_physics_bench(uint32 num_bodies, uint32 num_steps)
+{
+	constexpr uint32	COLUMNS = 200;
+	constexpr float32	BODY_SIZE = 0.8f;
+	constexpr float32	SPACING = 1.2f;
+
+	physics_world world(nullptr);
+	body_desc ground;
+	ground.type = BODY_STATIC;
+	ground.size = {COLUMNS * SPACING + 10.f, 1.f};
+	ground.position = {0.f, -0.5f};
+	world.create_body(ground);
+
+	for (uint32 i = 0; i < num_bodies; ++i) {
+		body_desc desc;
+		desc.shape = (i & 1u) ? SHAPE_DISK : SHAPE_BOX;
+		desc.size = {BODY_SIZE, BODY_SIZE};
+		desc.rotation_deg = static_cast<float32>(i % 7u) * 5.f;
+		desc.position = {
+			(static_cast<float32>(i % COLUMNS) - COLUMNS * 0.5f) * SPACING,
+			1.f + static_cast<float32>(i / COLUMNS) * SPACING};
+		world.create_body(desc);
+	}
+
+	physics_bench_result result;
+	result.num_bodies = num_bodies;
+	result.num_steps = num_steps;
+	for (uint32 step = 0; step < num_steps; ++step) {
+		world.step(physics_world::FIXED_STEP);
+		const float64 step_ms = world.get_stats().step_ms;
+		result.total_ms += step_ms;
+		result.max_step_ms = std::max(result.max_step_ms, step_ms);
+	}
+	const physics_stats& stats = world.get_stats();
+	result.avg_step_ms = num_steps > 0 ? result.total_ms / num_steps : 0.0;
+	result.bodies_per_ms = result.total_ms > 0.0 ? static_cast<float64>(num_bodies) * num_steps / result.total_ms : 0.0;
+	result.final_contacts = stats.contacts;
+	result.final_islands = stats.islands;
+	result.final_awake = stats.awake_bodies;
+	return result;
+}
+}
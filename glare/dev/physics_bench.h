@@ -0,0 +1,25 @@
+/// glare/dev/physics_bench.h
+/// Reference scene for measuring physics_world throughput:
+/// a ground box and a grid of alternating boxes and disks dropped on it.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct physics_bench_result
+{
+	uint32	num_bodies		= 0;
+	uint32	num_steps		= 0;
+	float64	total_ms		= 0.0;
+	float64	avg_step_ms		= 0.0;
+	float64	max_step_ms		= 0.0;
+	float64	bodies_per_ms	= 0.0;	// num_bodies * num_steps / total_ms
+	uint32	final_contacts	= 0;
+	uint32	final_islands	= 0;
+	uint32	final_awake		= 0;
+};
+
+// Steps the scene <num_steps> times at physics_world::FIXED_STEP, independent of any clock
+physics_bench_result run_physics_bench(uint32 num_bodies, uint32 num_steps);
+}
@@ -0,0 +1,72 @@
+#include "glare/dev/raycast_bench.h"
+#include "glare/core/clock.h"
+#include "glare/math/raycast2.h"
+#include <random>
+#include <vector>
+
+namespace glare
+{
+template<typename SOA>
+static float64 _time_rays(const std::vector<ray2>& rays, const SOA& primitives, uint32& hits)
+{
+	const float64 start = get_current_time_seconds();
+	for (const ray2& each : rays) {
+		float32 distance;
+		hits += raycast_closest(each, primitives, distance) != SIZE_MAX ? 1u : 0u;
+	}
+	const float64 seconds = get_current_time_seconds() - start;
+	return seconds > 0.0 ? static_cast<float64>(rays.size()) / seconds : 0.0;
+}
+
+raycast_bench_result run_raycast_bench(uint32 num_primitives, uint32 num_rays)
+{
+	constexpr float32 WORLD_SIZE = 1000.f;
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float32> position(-WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+	std::uniform_real_distribution<float32> size(0.5f, 4.f);
+	std::uniform_real_distribution<float32> angle(0.f, 360.f);
+
+	std::vector<float32> min_x(num_primitives), min_y(num_primitives), max_x(num_primitives), max_y(num_primitives);
+	std::vector<float32> radius(num_primitives);
+	std::vector<float32> center_x(num_primitives), center_y(num_primitives);
+	obb2_batch boxes(num_primitives);
+	for (uint32 i = 0; i < num_primitives; ++i) {
+		const vec2 center(position(rng), position(rng));
+		const vec2 extends(size(rng), size(rng));
+		min_x[i] = center.x - extends.x;
+		min_y[i] = center.y - extends.y;
+		max_x[i] = center.x + extends.x;
+		max_y[i] = center.y + extends.y;
+		center_x[i] = center.x;
+		center_y[i] = center.y;
+		radius[i] = extends.x;
+		boxes.add(obb2(center, extends * 2.f, angle(rng)));
+	}
+	std::vector<ray2> rays;
+	rays.reserve(num_rays);
+	for (uint32 i = 0; i < num_rays; ++i) {
+		const vec2 origin(position(rng), position(rng));
+		rays.emplace_back(origin, vec2(position(rng), position(rng)) - origin);
+	}
+
+	aabb2_soa aabbs;
+	aabbs.min_x = min_x.data();
+	aabbs.min_y = min_y.data();
+	aabbs.max_x = max_x.data();
+	aabbs.max_y = max_y.data();
+	aabbs.count = num_primitives;
+	disk_soa disks;
+	disks.center_x = center_x.data();
+	disks.center_y = center_y.data();
+	disks.radius = radius.data();
+	disks.count = num_primitives;
+
+	raycast_bench_result result;
+	result.num_primitives = num_primitives;
+	result.num_rays = num_rays;
+	result.aabb2_rays_per_second = _time_rays(rays, aabbs, result.num_hits);
+	result.obb2_rays_per_second = _time_rays(rays, boxes.get_soa(), result.num_hits);
+	result.disk_rays_per_second = _time_rays(rays, disks, result.num_hits);
+	return result;
+}
+}
@@ -0,0 +1,21 @@
+/// glare/dev/raycast_bench.h
+/// Measures ray throughput of the raycast2 batch kernels against random
+/// aabb2, obb2 and disk sets, one closest-hit query per ray.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct raycast_bench_result
+{
+	uint32	num_primitives		= 0;
+	uint32	num_rays			= 0;
+	float64	aabb2_rays_per_second	= 0.0;
+	float64	obb2_rays_per_second	= 0.0;
+	float64	disk_rays_per_second	= 0.0;
+	uint32	num_hits			= 0;	// over all 3 sets, keeps the queries from being optimized out
+};
+
+raycast_bench_result run_raycast_bench(uint32 num_primitives = 50000, uint32 num_rays = 1000);
+}
@@ -0,0 +1,77 @@
+#include "glare/dev/render_queue_bench.h"
+#include "glare/core/clock.h"
+#include "glare/render/render_queue.h"
+#include <algorithm>
+#include <random>
+
+namespace glare
+{
+class _counting_target final : public i_render_command_target
+{
+public:
+	void bind_shader(shader* s, e_blend_mode blend_mode) override	{ UNUSED(s); UNUSED(blend_mode); }
+	void bind_texture(const texture* tex) override					{ UNUSED(tex); }
+	void bind_vbo(vertex_buffer* vbo) override						{ UNUSED(vbo); }
+	void bind_ibo(index_buffer* ibo) override						{ UNUSED(ibo); }
+	void draw(const render_command& command) override				{ m_elements += command.m_element_count; }
+public:
+	uint64 m_elements = 0;
+};
+
+render_queue_bench_result run_render_queue_bench(uint32 num_commands, uint32 num_runs)
+{
+	constexpr uint32 NUM_SHADERS = 8;
+	constexpr uint32 NUM_TEXTURES = 64;
+	constexpr uint32 NUM_LAYERS = 4;
+	constexpr uint32 RUN_LENGTH = 16;	// sprites sharing a texture in submission order
+
+	// The queue never dereferences them, the addresses only serve as ids
+	static byte s_tokens[NUM_SHADERS + NUM_TEXTURES + 1];
+	shader* shaders[NUM_SHADERS];
+	const texture* textures[NUM_TEXTURES];
+	for (uint32 i = 0; i < NUM_SHADERS; ++i) {
+		shaders[i] = reinterpret_cast<shader*>(&s_tokens[i]);
+	}
+	for (uint32 i = 0; i < NUM_TEXTURES; ++i) {
+		textures[i] = reinterpret_cast<const texture*>(&s_tokens[NUM_SHADERS + i]);
+	}
+	vertex_buffer* vbo = reinterpret_cast<vertex_buffer*>(&s_tokens[NUM_SHADERS + NUM_TEXTURES]);
+
+	render_queue_bench_result result;
+	result.num_commands = num_commands;
+	result.sort_ms = 1e9;
+	result.replay_ms = 1e9;
+	std::mt19937 rng(1234u);
+	render_queue queue;
+	_counting_target target;
+	for (uint32 run = 0; run < num_runs; ++run) {
+		queue.clear();
+		render_command command;
+		command.m_vbo = vbo;
+		command.m_element_count = 6;
+		for (uint32 i = 0; i < num_commands; ++i) {
+			if (i % RUN_LENGTH == 0) {
+				command.m_shader = shaders[rng() % NUM_SHADERS];
+				command.m_texture = textures[rng() % NUM_TEXTURES];
+			}
+			command.m_element_offset = i * 6;
+			const e_blend_mode blend_mode = rng() % 4 == 0 ? BLEND_OPAQUE : BLEND_ALPHA;
+			queue.submit(command, static_cast<uint8>(rng() % NUM_LAYERS), blend_mode);
+		}
+
+		const float64 start = get_current_time_seconds();
+		queue.sort();
+		const float64 sorted = get_current_time_seconds();
+		queue.replay(target);
+		const float64 replayed = get_current_time_seconds();
+		result.sort_ms = std::min(result.sort_ms, (sorted - start) * 1000.0);
+		result.replay_ms = std::min(result.replay_ms, (replayed - sorted) * 1000.0);
+	}
+	const render_queue_stats& stats = queue.get_stats();
+	result.sort_bits = stats.sort_bits;
+	result.radix_passes = stats.radix_passes;
+	result.shader_binds = stats.shader_binds;
+	result.texture_binds = stats.texture_binds;
+	return result;
+}
+}
@@ -0,0 +1,23 @@
+/// glare/dev/render_queue_bench.h
+/// Measures render_queue sorting and replay on a 2D sprite-like workload:
+/// a few layers, mostly alpha blended, shaders and textures picked in runs.
+/// Replay goes into a target that only counts, so no device is needed.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct render_queue_bench_result
+{
+	uint32	num_commands	= 0;
+	float64	sort_ms			= 0.0;	// best of the runs
+	float64	replay_ms		= 0.0;	// best of the runs
+	uint32	sort_bits		= 0;
+	uint32	radix_passes	= 0;
+	uint32	shader_binds	= 0;
+	uint32	texture_binds	= 0;
+};
+
+render_queue_bench_result run_render_queue_bench(uint32 num_commands = 100000, uint32 num_runs = 10);
+}
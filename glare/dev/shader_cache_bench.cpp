@@ -0,0 +1,110 @@
+#include "glare/dev/shader_cache_bench.h"
+#include "glare/core/clock.h"
+#include "glare/core/string_utils.h"
+#include "glare/render/shader_cache.h"
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+
+namespace glare
+{
+static void _append_line(const string& path, const char* line)
+{
+	if (FILE* file = fopen(path.c_str(), "a")) {
+		fprintf(file, "%s\n", line);
+		fclose(file);
+	}
+}
+
+shader_cache_bench_result run_shader_cache_bench(const char* directory, const shader_compiler_factory& make_compiler, uint32 num_shaders)
+{
+	shader_cache_bench_result result;
+	result.num_shaders = num_shaders;
+	const string root = format("%s/shader_cache_bench", directory);
+	const string cache_directory = root + "/cache";
+	std::error_code error;
+	std::filesystem::remove_all(root, error);
+	std::filesystem::create_directories(root + "/inc", error);
+
+	// shader_<i>.hlsl includes common.hlsli and inc/part_<i>.hlsli, every part includes inc/detail.hlsli
+	const string common_path = root + "/common.hlsli";
+	const string detail_path = root + "/inc/detail.hlsli";
+	_append_line(common_path, "cbuffer frame : register(b0) { float4x4 projection; };");
+	_append_line(detail_path, "float4 tint(float4 color) { return color * float4(1.0, 0.9, 0.8, 1.0); }");
+	std::vector<string> paths;
+	for (uint32 i = 0; i < num_shaders; ++i) {
+		const string part_path = format("%s/inc/part_%u.hlsli", root.c_str(), i);
+		_append_line(part_path, "#include \"detail.hlsli\"");
+		_append_line(part_path, format("float4 shade_%u(float4 color) { return tint(color) * %u.0 / 64.0; }", i, i + 1).c_str());
+		paths.push_back(format("%s/shader_%u.hlsl", root.c_str(), i));
+		_append_line(paths.back(), "#include \"common.hlsli\"");
+		_append_line(paths.back(), format("  #  include \"inc/part_%u.hlsli\"", i).c_str());
+		_append_line(paths.back(), "float4 Vert(float4 position : POSITION) : SV_Position { return mul(position, projection); }");
+		_append_line(paths.back(), format("float4 Pixel(float4 color : COLOR) : SV_Target { return shade_%u(color); }", i).c_str());
+	}
+
+	// Every stage with a new cache, as a new run would. Return: the compiles
+	const auto compile_all = [&](uint32 flags, std::vector<std::vector<byte>>* out_bytecode, float64* out_ms) {
+		shader_cache cache(make_compiler ? make_compiler() : new stub_shader_compiler(), cache_directory);
+		std::vector<byte> bytecode;
+		const float64 start = get_current_time_seconds();
+		for (const string& path : paths) {
+			string source;
+			load_file_to_string(source, path.c_str());
+			for (uint32 stage = 0; stage < 2; ++stage) {
+				shader_compile_request request;
+				request.filename		= path.c_str();
+				request.source			= source.c_str();
+				request.source_size		= source.length();
+				request.entry_point		= stage == 0 ? "Vert" : "Pixel";
+				request.shader_model	= stage == 0 ? "vs_5_0" : "ps_5_0";
+				request.flags			= flags;
+				cache.get_bytecode(request, bytecode);
+				if (out_bytecode) {
+					out_bytecode->push_back(bytecode);
+				}
+			}
+		}
+		if (out_ms) {
+			*out_ms = (get_current_time_seconds() - start) * 1000.0;
+		}
+		return cache.get_stats().misses;
+	};
+
+	const uint32 flags = 1u << 15;	// D3DCOMPILE_OPTIMIZATION_LEVEL3
+	std::vector<std::vector<byte>> cold;
+	std::vector<std::vector<byte>> warm;
+	result.cold_compiles = compile_all(flags, &cold, &result.cold_ms);
+	result.warm_compiles = compile_all(flags, &warm, &result.warm_ms);
+	result.bytecode_matches = cold == warm;
+
+	_append_line(common_path, "// edited");
+	result.shared_include_compiles = compile_all(flags, nullptr, nullptr);
+	_append_line(format("%s/inc/part_0.hlsli", root.c_str()), "// edited");
+	result.own_include_compiles = compile_all(flags, nullptr, nullptr);
+	_append_line(detail_path, "// edited");
+	result.nested_include_compiles = compile_all(flags, nullptr, nullptr);
+	result.flag_compiles = compile_all(flags | 1u, nullptr, nullptr);
+
+	// cut the entry of the first vertex stage short
+	{
+		shader_cache cache(new stub_shader_compiler(), cache_directory);
+		string source;
+		load_file_to_string(source, paths[0].c_str());
+		shader_compile_request request;
+		request.filename		= paths[0].c_str();
+		request.source			= source.c_str();
+		request.source_size		= source.length();
+		request.entry_point		= "Vert";
+		request.shader_model	= "vs_5_0";
+		request.flags			= flags;
+		const string entry_path = cache.get_entry_path(cache.get_key(request));
+		std::filesystem::resize_file(entry_path, std::filesystem::file_size(entry_path, error) / 2, error);
+		const uint32 damaged = compile_all(flags, nullptr, nullptr);
+		result.damaged_entry_recompiled = damaged == 1 && compile_all(flags, nullptr, nullptr) == 0;
+	}
+
+	std::filesystem::remove_all(root, error);
+	return result;
+}
+}
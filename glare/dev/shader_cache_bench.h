@@ -0,0 +1,39 @@
+/// glare/dev/shader_cache_bench.h
+/// Drives shader_cache over generated hlsl files with nested #includes:
+/// a cold start that compiles every stage, a warm one that reads them back,
+/// then the misses after editing each kind of include, changing the flags
+/// and damaging an entry. Every pass uses a new cache object on the same
+/// directory, as a new run of the game would.
+/// Without a compiler factory the stages go through a stub that needs no D3D,
+/// so the counts can be checked anywhere; the times then only show the cost
+/// of the cache itself.
+
+#pragma once
+#include "glare/core/common.h"
+#include <functional>
+
+namespace glare
+{
+class i_shader_compiler;
+// Return: a new compiler, owned by the cache it is given to
+using shader_compiler_factory = std::function<i_shader_compiler*()>;
+
+struct shader_cache_bench_result
+{
+	uint32	num_shaders					= 0;		// each a vertex and a pixel stage
+	float64	cold_ms						= 0.0;		// empty cache, every stage compiled and stored
+	float64	warm_ms						= 0.0;		// every stage read back
+	uint32	cold_compiles				= 0;
+	uint32	warm_compiles				= 0;		// 0 expected
+	bool	bytecode_matches			= false;	// the warm bytecode is the cold one
+	uint32	shared_include_compiles		= 0;		// after editing the include of every shader, all stages expected
+	uint32	own_include_compiles		= 0;		// after editing the include of one shader, its 2 stages expected
+	uint32	nested_include_compiles		= 0;		// after editing an include of an include, all stages expected
+	uint32	flag_compiles				= 0;		// other compile flags, all stages expected
+	bool	damaged_entry_recompiled	= false;	// an entry cut short is a miss and is written again
+};
+
+// Writes into <directory>, which has to exist, and removes the files again.
+// <make_compiler>: nullptr for the stub
+shader_cache_bench_result run_shader_cache_bench(const char* directory, const shader_compiler_factory& make_compiler = nullptr, uint32 num_shaders = 32);
+}
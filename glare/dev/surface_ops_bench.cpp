@@ -0,0 +1,209 @@
+#include "glare/dev/surface_ops_bench.h"
+#include "glare/core/clock.h"
+#include "glare/core/job.h"
+#include "glare/render/surface.h"
+#include "glare/render/surface_ops.h"
+#include "glare/render/vertex_format.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <random>
+
+namespace glare
+{
+using bench_step = std::function<void()>;
+
+// Best of <num_runs>, <reset> runs untimed before each
+static float64 _best_ms(uint32 num_runs, const bench_step& reset, const bench_step& step)
+{
+	float64 best = 1e9;
+	for (uint32 run = 0; run < num_runs; ++run) {
+		reset();
+		const float64 start = get_current_time_seconds();
+		step();
+		best = std::min(best, (get_current_time_seconds() - start) * 1000.0);
+	}
+	return best;
+}
+
+static bool _is_same(const surface& a, const surface& b)
+{
+	if (a.get_storage() == SURFACE_STORAGE_RGBA8) {
+		return memcmp(a.get_rgba8_buffer(), b.get_rgba8_buffer(), a.get_texel_count() * sizeof(rgba8)) == 0;
+	}
+	const float32* left = &a.get_surface_buffer()->r;
+	const float32* right = &b.get_surface_buffer()->r;
+	for (size_t i = 0; i < a.get_texel_count() * 4; ++i) {
+		if (std::abs(left[i] - right[i]) > 1e-6f) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void _blend_alpha_scalar(rgba& under, const rgba& color)
+{
+	const float32 inv_alpha = 1.f - color.a;
+	under = rgba(color.r * color.a + under.r * inv_alpha, color.g * color.a + under.g * inv_alpha
+		, color.b * color.a + under.b * inv_alpha, color.a * color.a + under.a * inv_alpha);
+}
+
+surface_ops_bench_result run_surface_ops_bench(uint32 size, uint32 num_runs)
+{
+	surface_ops_bench_result result;
+	result.size = size;
+	result.num_workers = job_system::get_worker_count();
+	const size_t count = static_cast<size_t>(size) * size;
+
+	// noise in every channel, alpha included, so no kernel can take a shortcut
+	std::mt19937 rng(1234u);
+	std::uniform_int_distribution<int32> channel(0, 255);
+	std::vector<rgba8> noise(count);
+	std::vector<rgba8> overlay(count);
+	for (size_t i = 0; i < count; ++i) {
+		noise[i] = rgba8(channel(rng), channel(rng), channel(rng), channel(rng));
+		overlay[i] = rgba8(channel(rng), channel(rng), channel(rng), channel(rng));
+	}
+
+	surface image8(size, size, rgba8());
+	surface reference8(size, size, rgba8());
+	surface overlay8(size, size, rgba8());
+	surface image_float(size, size);
+	surface reference_float(size, size);
+	surface overlay_float(size, size);
+	memcpy(static_cast<void*>(overlay8.get_rgba8_buffer()), overlay.data(), count * sizeof(rgba8));
+	surface_ops::convert_rgba8_to_float(overlay_float.get_surface_buffer(), overlay.data(), count);
+	const auto reset8 = [&noise, count](surface& image) {
+		memcpy(static_cast<void*>(image.get_rgba8_buffer()), noise.data(), count * sizeof(rgba8));
+	};
+	const auto reset_float = [&noise, count](surface& image) {
+		surface_ops::convert_rgba8_to_float(image.get_surface_buffer(), noise.data(), count);
+	};
+
+	// <step> on image8 or image_float, <scalar> on the matching reference, both from the noise
+	const auto add = [&](const char* name, bool bytes, size_t texels, const bench_step& step, const bench_step& scalar) {
+		surface_ops_bench_entry entry;
+		entry.name = name;
+		surface& image = bytes ? image8 : image_float;
+		surface& reference = bytes ? reference8 : reference_float;
+		const bench_step reset = [&]() { bytes ? reset8(image) : reset_float(image); };
+		entry.ms = _best_ms(num_runs, reset, step);
+		entry.mtexels_per_s = texels / (entry.ms * 1000.0);
+		if (scalar) {
+			const bench_step reset_reference = [&]() { bytes ? reset8(reference) : reset_float(reference); };
+			entry.scalar_ms = _best_ms(num_runs, reset_reference, scalar);
+			entry.matches_scalar = _is_same(image, reference);
+		}
+		result.entries.push_back(entry);
+	};
+
+	std::vector<rgba> floats(count);
+	std::vector<rgba8> bytes(count);
+	add("rgba8 to float", true, count, [&]() {
+		surface_ops::convert_rgba8_to_float(floats.data(), image8.get_rgba8_buffer(), count);
+	}, nullptr);
+	add("float to rgba8", false, count, [&]() {
+		surface_ops::convert_float_to_rgba8(bytes.data(), image_float.get_surface_buffer(), count);
+	}, nullptr);
+
+	const ivec2 origin(0, 0);
+	const ivec2 extent(static_cast<int32>(size), static_cast<int32>(size));
+	add("blit copy rgba8", true, count, [&]() {
+		surface_ops::blit(&image8, origin, &overlay8, origin, extent);
+	}, nullptr);
+	add("blit copy float to rgba8", true, count, [&]() {
+		surface_ops::blit(&image8, origin, &overlay_float, origin, extent);
+	}, [&]() {
+		rgba8* texels = reference8.get_rgba8_buffer();
+		const rgba* from = overlay_float.get_surface_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			texels[i] = vertex_packing::pack_unorm8x4(from[i]);
+		}
+	});
+	add("blit alpha rgba8", true, count, [&]() {
+		surface_ops::blit(&image8, origin, &overlay8, origin, extent, surface_ops::BLIT_ALPHA);
+	}, [&]() {
+		rgba8* texels = reference8.get_rgba8_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			rgba under(texels[i]);
+			_blend_alpha_scalar(under, rgba(overlay[i]));
+			texels[i] = vertex_packing::pack_unorm8x4(under);
+		}
+	});
+	add("blit alpha float", false, count, [&]() {
+		surface_ops::blit(&image_float, origin, &overlay_float, origin, extent, surface_ops::BLIT_ALPHA);
+	}, [&]() {
+		rgba* texels = reference_float.get_surface_buffer();
+		const rgba* from = overlay_float.get_surface_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			_blend_alpha_scalar(texels[i], from[i]);
+		}
+	});
+
+	add("premultiply rgba8", true, count, [&]() {
+		surface_ops::premultiply_alpha(&image8);
+	}, [&]() {
+		rgba8* texels = reference8.get_rgba8_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			// through float, as the straightforward version would
+			rgba color(texels[i]);
+			texels[i] = vertex_packing::pack_unorm8x4(rgba(color.r * color.a, color.g * color.a, color.b * color.a, color.a));
+		}
+	});
+	add("premultiply float", false, count, [&]() {
+		surface_ops::premultiply_alpha(&image_float);
+	}, [&]() {
+		rgba* texels = reference_float.get_surface_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			texels[i] = rgba(texels[i].r * texels[i].a, texels[i].g * texels[i].a, texels[i].b * texels[i].a, texels[i].a);
+		}
+	});
+	add("unpremultiply rgba8", true, count, [&]() {
+		surface_ops::unpremultiply_alpha(&image8);
+	}, [&]() {
+		rgba8* texels = reference8.get_rgba8_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			const float32 scale = texels[i].a > 0 ? 255.f / texels[i].a : 0.f;
+			texels[i].r = static_cast<byte>(std::lrint(std::min(texels[i].r * scale, 255.f)));
+			texels[i].g = static_cast<byte>(std::lrint(std::min(texels[i].g * scale, 255.f)));
+			texels[i].b = static_cast<byte>(std::lrint(std::min(texels[i].b * scale, 255.f)));
+		}
+	});
+
+	const uint8 bgra[4] = { 2, 1, 0, 3 };
+	add("swizzle rgba8", true, count, [&]() {
+		surface_ops::swizzle(&image8, bgra);
+	}, [&]() {
+		rgba8* texels = reference8.get_rgba8_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			std::swap(texels[i].r, texels[i].b);
+		}
+	});
+	add("swizzle float", false, count, [&]() {
+		surface_ops::swizzle(&image_float, bgra);
+	}, [&]() {
+		rgba* texels = reference_float.get_surface_buffer();
+		for (size_t i = 0; i < count; ++i) {
+			std::swap(texels[i].r, texels[i].b);
+		}
+	});
+
+	// the resizes read the noise image and write a separate one
+	surface half8(size / 2, size / 2, rgba8());
+	surface larger8(size * 3 / 2, size * 3 / 2, rgba8());
+	add("resize bilinear 1/2 rgba8", true, half8.get_texel_count(), [&]() {
+		surface_ops::resize(&half8, &image8, surface_ops::RESIZE_FILTER_BILINEAR);
+	}, nullptr);
+	add("resize lanczos3 1/2 rgba8", true, half8.get_texel_count(), [&]() {
+		surface_ops::resize(&half8, &image8, surface_ops::RESIZE_FILTER_LANCZOS3);
+	}, nullptr);
+	add("resize bilinear 3/2 rgba8", true, larger8.get_texel_count(), [&]() {
+		surface_ops::resize(&larger8, &image8, surface_ops::RESIZE_FILTER_BILINEAR);
+	}, nullptr);
+	add("resize lanczos3 3/2 rgba8", true, larger8.get_texel_count(), [&]() {
+		surface_ops::resize(&larger8, &image8, surface_ops::RESIZE_FILTER_LANCZOS3);
+	}, nullptr);
+	return result;
+}
+}
@@ -0,0 +1,30 @@
+/// glare/dev/surface_ops_bench.h
+/// Throughput of the surface_ops kernels on a large noisy image, in both
+/// storages, against plain per-texel loops where there is one to compare
+/// with. Also checks that the kernels agree with those loops. CPU only; the
+/// kernels split over job_system when it is running.
+
+#pragma once
+#include "glare/core/common.h"
+#include <vector>
+
+namespace glare
+{
+struct surface_ops_bench_entry
+{
+	string	name;
+	float64	ms					= 0.0;	// best of the runs
+	float64	mtexels_per_s		= 0.0;	// destination texels
+	float64	scalar_ms			= 0.0;	// 0 without a scalar reference
+	bool	matches_scalar		= true;	// rgba8 exactly, float within 1e-6
+};
+
+struct surface_ops_bench_result
+{
+	uint32	size		= 0;
+	uint32	num_workers	= 0;
+	std::vector<surface_ops_bench_entry>	entries;
+};
+
+surface_ops_bench_result run_surface_ops_bench(uint32 size = 2048, uint32 num_runs = 3);
+}
@@ -0,0 +1,101 @@
+#include "glare/dev/surface_storage_bench.h"
+#include "glare/core/clock.h"
+#include "glare/core/string_utils.h"
+#include "glare/render/surface.h"
+#include "glare/render/surface_ops.h"
+#include "glare/render/vertex_format.h"
+#include "stb/stb_image.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+template<typename FUNC>
+static float64 _best_ms(uint32 num_runs, const FUNC& func)
+{
+	float64 best = 1e9;
+	for (uint32 run = 0; run < num_runs; ++run) {
+		const float64 start = get_current_time_seconds();
+		func();
+		best = std::min(best, (get_current_time_seconds() - start) * 1000.0);
+	}
+	return best;
+}
+
+surface_storage_bench_result run_surface_storage_bench(const char* directory, uint32 size, uint32 num_runs)
+{
+	surface_storage_bench_result result;
+	result.size = size;
+	const size_t num_texels = static_cast<size_t>(size) * size;
+	const string path = format("%s/surface_storage_bench.png", directory);
+	{
+		// smooth gradients with noise, a photo-like compression ratio
+		std::mt19937 rng(1234u);
+		std::uniform_int_distribution<int32> noise(-12, 12);
+		surface image(size, size, rgba8(0, 0, 0, 255));
+		rgba8* texels = image.get_rgba8_buffer();
+		for (uint32 y = 0; y < size; ++y) {
+			for (uint32 x = 0; x < size; ++x) {
+				const auto channel = [&noise, &rng](uint32 base) {
+					return static_cast<byte>(std::min(std::max(static_cast<int32>(base & 0xff) + noise(rng), 0), 255));
+				};
+				texels[static_cast<size_t>(y) * size + x] = rgba8(channel(x * 255 / size), channel(y * 255 / size), channel((x + y) / 8), 255);
+			}
+		}
+		image.write_png(path.c_str());
+	}
+
+	// the former surface(path): keep the stb buffer, add a float copy one texel at a time
+	result.legacy_load_ms = _best_ms(1, [&path, &result]() {
+		int width, height, num_channels;
+		byte* raw = stbi_load(path.c_str(), &width, &height, &num_channels, 0);
+		std::vector<rgba> texels;
+		const size_t count = static_cast<size_t>(width) * height;
+		texels.reserve(count);
+		for (size_t i = 0; i < count; ++i) {
+			const byte* raw_color = raw + i * num_channels;
+			rgba8 texel8(raw_color[0], raw_color[1], raw_color[2]);
+			if (num_channels == 4) {
+				texel8.a = raw_color[3];
+			}
+			texels.emplace_back(rgba(texel8));
+		}
+		result.legacy_bytes = count * num_channels + texels.capacity() * sizeof(rgba);
+		stbi_image_free(raw);
+	});
+	surface* loaded = nullptr;
+	result.load_ms = _best_ms(1, [&path, &loaded]() {
+		loaded = new surface(path.c_str());
+	});
+	result.bytes = loaded->get_memory_usage();
+
+	std::vector<rgba> floats(num_texels);
+	std::vector<rgba8> bytes(num_texels);
+	const rgba8* source = loaded->get_rgba8_buffer();
+	result.to_float_ms = _best_ms(num_runs, [&]() {
+		surface_ops::convert_rgba8_to_float(floats.data(), source, num_texels);
+	});
+	result.to_float_scalar_ms = _best_ms(num_runs, [&]() {
+		for (size_t i = 0; i < num_texels; ++i) {
+			floats[i] = rgba(source[i]);
+		}
+	});
+	result.to_rgba8_ms = _best_ms(num_runs, [&]() {
+		surface_ops::convert_float_to_rgba8(bytes.data(), floats.data(), num_texels);
+	});
+	result.to_rgba8_scalar_ms = _best_ms(num_runs, [&]() {
+		for (size_t i = 0; i < num_texels; ++i) {
+			bytes[i] = vertex_packing::pack_unorm8x4(floats[i]);
+		}
+	});
+	surface_ops::convert_float_to_rgba8(bytes.data(), floats.data(), num_texels);
+	result.round_trip_exact = memcmp(bytes.data(), source, num_texels * sizeof(rgba8)) == 0;
+
+	delete loaded;
+	std::remove(path.c_str());
+	return result;
+}
+}
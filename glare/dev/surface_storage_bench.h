@@ -0,0 +1,28 @@
+/// glare/dev/surface_storage_bench.h
+/// Loads a large png the way surface(path) used to (stb buffer plus a float
+/// copy built texel by texel) and into rgba8 storage, and times the lazy
+/// conversions between the storages against scalar loops. CPU only.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct surface_storage_bench_result
+{
+	uint32	size				= 0;
+	float64	legacy_load_ms		= 0.0;	// decode, then the float copy
+	float64	load_ms				= 0.0;	// decode into rgba8 storage
+	uint64	legacy_bytes		= 0;	// stb buffer and float copy
+	uint64	bytes				= 0;	// surface::get_memory_usage() after the load
+	// Whole image, best of the runs
+	float64	to_float_ms			= 0.0;
+	float64	to_float_scalar_ms	= 0.0;
+	float64	to_rgba8_ms			= 0.0;
+	float64	to_rgba8_scalar_ms	= 0.0;
+	bool	round_trip_exact	= false;	// rgba8 -> float -> rgba8 gives the same bytes
+};
+
+// Writes a <size> x <size> png into <directory>, which has to exist, and removes it again
+surface_storage_bench_result run_surface_storage_bench(const char* directory, uint32 size = 4096, uint32 num_runs = 3);
+}
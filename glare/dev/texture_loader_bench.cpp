@@ -0,0 +1,136 @@
+#include "glare/dev/texture_loader_bench.h"
+#include "glare/core/clock.h"
+#include "glare/core/job.h"
+#include "glare/core/string_utils.h"
+#include "glare/math/utilities.h"
+#include "glare/render/renderer.h"
+#include "glare/render/sprite.h"
+#include "glare/render/surface.h"
+#include "glare/render/texture_loader.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+static bool _is_same_image(const surface& a, const surface& b)
+{
+	if (a.m_size != b.m_size || a.m_mips.size() != b.m_mips.size()
+		|| memcmp(a.get_rgba8_buffer(), b.get_rgba8_buffer(), a.get_texel_count() * sizeof(rgba8)) != 0) {
+		return false;
+	}
+	for (size_t i = 0; i < a.m_mips.size(); ++i) {
+		const std::vector<rgba>& texels = a.m_mips[i].texels;
+		if (memcmp(texels.data(), b.m_mips[i].texels.data(), texels.size() * sizeof(rgba)) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+texture_loader_bench_result run_texture_loader_bench(const char* directory, uint32 num_images, uint32 image_size)
+{
+	texture_loader_bench_result result;
+	result.num_images = num_images;
+	result.image_size = image_size;
+	result.num_workers = job_system::get_worker_count();
+
+	// noisy gradients, so the png files do not compress to nothing
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float32> noise(-0.1f, 0.1f);
+	std::vector<string> ids;
+	std::vector<string> paths;
+	for (uint32 i = 0; i < num_images; ++i) {
+		surface image(image_size, image_size);
+		rgba* texels = image.get_surface_buffer();
+		for (uint32 y = 0; y < image_size; ++y) {
+			for (uint32 x = 0; x < image_size; ++x) {
+				const float32 u = static_cast<float32>(x) / image_size;
+				const float32 v = static_cast<float32>(y) / image_size;
+				texels[static_cast<size_t>(y) * image_size + x] = rgba(clamp(u + noise(rng), 0.f, 1.f)
+					, clamp(v + noise(rng), 0.f, 1.f), static_cast<float32>(i) / num_images, ((x / 7 + y / 5) & 1) ? 1.f : 0.5f);
+			}
+		}
+		ids.emplace_back(format("texture_loader_bench_%u", i));
+		paths.emplace_back(format("%s/texture_loader_bench_%u.png", directory, i));
+		image.write_png(paths.back().c_str());
+	}
+
+	// a 2x2 sheet over the first image, under its own texture id
+	const string sheet_id = "texture_loader_bench_sheet";
+	const string sheet_path = format("%s/texture_loader_bench_sheet.xml", directory);
+	const int32 half = static_cast<int32>(image_size / 2);
+	if (FILE* xml_file = fopen(sheet_path.c_str(), "w")) {
+		fprintf(xml_file, "<sprites texture=\"%s\" src=\"%s\">\n", sheet_id.c_str(), paths[0].c_str());
+		for (int32 i = 0; i < 4; ++i) {
+			const int32 left = (i % 2) * half;
+			const int32 top = (i / 2) * half;
+			fprintf(xml_file, "\t<sprite index=\"%d\" bl=\"%d,%d\" tr=\"%d,%d\"/>\n", i, left, top + half, left + half, top);
+		}
+		fprintf(xml_file, "</sprites>\n");
+		fclose(xml_file);
+	}
+
+	std::vector<std::unique_ptr<surface>> reference;
+	const float64 sync_start = get_current_time_seconds();
+	for (const string& each : paths) {
+		reference.emplace_back(new surface(each.c_str()));
+		reference.back()->generate_mips();
+	}
+	result.sync_ms = (get_current_time_seconds() - sync_start) * 1000.0;
+
+	{
+		texture_loader loader(nullptr);
+		const float64 start = get_current_time_seconds();
+		for (uint32 i = 0; i < num_images; ++i) {
+			const surface* expected = reference[i].get();
+			loader.load_texture2d(ids[i], paths[i].c_str(), false, [&result, expected](const texture_load_result& loaded) {
+				if (!loaded.succeeded) {
+					++result.failed;
+					return;
+				}
+				++result.loaded;
+				if (!_is_same_image(*loaded.image, *expected)) {
+					++result.mismatches;
+				}
+			});
+		}
+		const sprite_sheet* sheet = loader.load_sprite_sheet_from_xml(sheet_id, sheet_path.c_str());
+		result.request_ms = (get_current_time_seconds() - start) * 1000.0;
+		loader.flush();
+		result.async_ms = (get_current_time_seconds() - start) * 1000.0;
+		result.decode_ms = loader.get_stats().decode_ms;
+
+		result.sheet_sprites = static_cast<uint32>(sheet->get_num_sprites());
+		result.sheet_uvs_ok = result.sheet_sprites == 4;
+		for (size_t i = 0; i < sheet->get_num_sprites() && result.sheet_uvs_ok; ++i) {
+			const sprite& each = sheet->get_sprite(i);
+			const vec2 expected_bl(0.5f * (i % 2), 0.5f * (i / 2) + 0.5f);
+			result.sheet_uvs_ok = std::abs(each.m_bottom_left.u - expected_bl.u) < 1e-6f && std::abs(each.m_bottom_left.v - expected_bl.v) < 1e-6f
+				&& std::abs(each.m_top_right.u - expected_bl.u - 0.5f) < 1e-6f && std::abs(each.m_top_right.v - expected_bl.v + 0.5f) < 1e-6f;
+		}
+	}
+
+	ids.push_back(sheet_id);
+	for (const string& each : ids) {
+		const auto found = renderer::s_cached_texture.find(each);
+		if (found != std::end(renderer::s_cached_texture)) {
+			delete found->second;
+			renderer::s_cached_texture.erase(found);
+		}
+	}
+	const auto sheet_found = sprite_sheet::s_sprite_sheet_cache.find(sheet_id);
+	if (sheet_found != std::end(sprite_sheet::s_sprite_sheet_cache)) {
+		delete sheet_found->second;
+		sprite_sheet::s_sprite_sheet_cache.erase(sheet_found);
+	}
+	for (const string& each : paths) {
+		std::remove(each.c_str());
+	}
+	std::remove(sheet_path.c_str());
+	return result;
+}
+}
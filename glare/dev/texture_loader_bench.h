@@ -0,0 +1,31 @@
+/// glare/dev/texture_loader_bench.h
+/// Runs the texture_loader decode pipeline headless: writes png files to a
+/// directory, loads them through a texture_loader without a renderer and
+/// compares every surface handed to the callbacks with a synchronous decode.
+/// A sprite sheet xml goes through the same path.
+/// The workers are whatever job_system runs; stopped, everything is inline.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct texture_loader_bench_result
+{
+	uint32	num_images		= 0;
+	uint32	image_size		= 0;
+	uint32	num_workers		= 0;
+	float64	sync_ms			= 0.0;	// decode and mips on the calling thread, one image after the other
+	float64	request_ms		= 0.0;	// the load_texture2d() calls, what a level load blocks on
+	float64	async_ms		= 0.0;	// from the first request until flush() returns
+	float64	decode_ms		= 0.0;	// summed over the workers
+	uint32	loaded			= 0;	// callbacks with a surface
+	uint32	failed			= 0;	// callbacks of failed decodes
+	uint32	mismatches		= 0;	// images whose texels or mips differ from the synchronous decode
+	uint32	sheet_sprites	= 0;	// sprites of the sheet after its texture finished
+	bool	sheet_uvs_ok	= false;
+};
+
+// Writes into <directory>, which has to exist, and removes the files again
+texture_loader_bench_result run_texture_loader_bench(const char* directory, uint32 num_images = 32, uint32 image_size = 512);
+}
@@ -0,0 +1,64 @@
+#include "glare/dev/trig_bench.h"
+#include "glare/core/clock.h"
+#include "glare/math/utilities.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+static float64 _get_max_error(const std::vector<float32>& angles, const std::vector<float32>& sins, const std::vector<float32>& coss)
+{
+	float64 error = 0.0;
+	for (size_t i = 0; i < angles.size(); ++i) {
+		error = std::max(error, std::abs(sins[i] - std::sin(static_cast<float64>(angles[i]))));
+		error = std::max(error, std::abs(coss[i] - std::cos(static_cast<float64>(angles[i]))));
+	}
+	return error;
+}
+
+static trig_bench_entry _measure(const char* name, bool batch, e_trig_precision precision
+	, const std::vector<float32>& angles, uint32 num_runs, float32& checksum)
+{
+	trig_bench_entry result;
+	result.name = name;
+	std::vector<float32> sins(angles.size());
+	std::vector<float32> coss(angles.size());
+	float64 best_ms = 1e9;
+	for (uint32 run = 0; run < num_runs; ++run) {
+		const float64 start = get_current_time_seconds();
+		if (batch) {
+			sincos(angles.data(), sins.data(), coss.data(), angles.size(), precision);
+		} else {
+			for (size_t i = 0; i < angles.size(); ++i) {
+				sincos(angles[i], sins[i], coss[i], precision);
+			}
+		}
+		const float64 end = get_current_time_seconds();
+		best_ms = std::min(best_ms, (end - start) * 1000.0);
+		checksum += sins[run % sins.size()] + coss[run % coss.size()];
+	}
+	result.ns_per_call = best_ms * 1e6 / static_cast<float64>(std::max<size_t>(angles.size(), 1));
+	result.max_abs_error = _get_max_error(angles, sins, coss);
+	return result;
+}
+
+trig_bench_result run_trig_bench(uint32 num_angles, uint32 num_runs)
+{
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float32> angle(-4.f * PI, 4.f * PI);
+	std::vector<float32> angles(num_angles);
+	for (float32& each : angles) {
+		each = angle(rng);
+	}
+
+	trig_bench_result result;
+	result.num_angles = num_angles;
+	result.entries[0] = _measure("scalar exact", false, TRIG_EXACT, angles, num_runs, result.checksum);
+	result.entries[1] = _measure("scalar fast", false, TRIG_FAST, angles, num_runs, result.checksum);
+	result.entries[2] = _measure("batch exact", true, TRIG_EXACT, angles, num_runs, result.checksum);
+	result.entries[3] = _measure("batch fast", true, TRIG_FAST, angles, num_runs, result.checksum);
+	return result;
+}
+}
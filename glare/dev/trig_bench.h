@@ -0,0 +1,28 @@
+/// glare/dev/trig_bench.h
+/// Times sincos in each precision, one call at a time and in a batch, over
+/// angles spread on [-4pi, 4pi], and measures the error against double sin/cos.
+/// No device is needed.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct trig_bench_entry
+{
+	const char*	name			= nullptr;
+	float64		ns_per_call		= 0.0;	// one sin and cos pair, best of the runs
+	float64		max_abs_error	= 0.0;
+};
+
+struct trig_bench_result
+{
+	static constexpr size_t NUM_ENTRIES = 4;
+
+	uint32				num_angles = 0;
+	trig_bench_entry	entries[NUM_ENTRIES];	// scalar exact, scalar fast, batch exact, batch fast
+	float32				checksum = 0.f;			// keeps the calls from being optimized out
+};
+
+trig_bench_result run_trig_bench(uint32 num_angles = 1u << 16, uint32 num_runs = 20);
+}
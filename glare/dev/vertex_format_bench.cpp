@@ -0,0 +1,49 @@
+#include "glare/dev/vertex_format_bench.h"
+#include "glare/core/clock.h"
+#include "glare/render/vertex.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace glare
+{
+template<typename T>
+static vertex_format_bench_entry _measure_format(const char* name, const std::vector<super_vertex>& source, uint32 num_runs)
+{
+	vertex_format_bench_entry result;
+	result.name = name;
+	result.stride = static_cast<uint32>(sizeof(T));
+	result.upload_bytes = static_cast<uint64>(sizeof(T)) * source.size();
+	result.convert_ms = 1e9;
+	std::vector<T> converted(source.size());
+	for (uint32 run = 0; run < num_runs; ++run) {
+		const float64 start = get_current_time_seconds();
+		vertex_format<T>::copy_from_super_vertex(converted.data(), source.data(), source.size());
+		const float64 end = get_current_time_seconds();
+		result.convert_ms = std::min(result.convert_ms, (end - start) * 1000.0);
+	}
+	result.mvertices_per_s = static_cast<float64>(source.size()) / std::max(result.convert_ms, 1e-6) / 1000.0;
+	return result;
+}
+
+vertex_format_bench_result run_vertex_format_bench(uint32 num_vertices, uint32 num_runs)
+{
+	// quads scattered over a 1080p screen, atlas uvs and a few tints
+	std::mt19937 rng(1234u);
+	std::uniform_real_distribution<float32> screen(0.f, 1920.f);
+	std::uniform_real_distribution<float32> unit(0.f, 1.f);
+	std::vector<super_vertex> source(num_vertices);
+	for (super_vertex& each : source) {
+		each.position = vec3(screen(rng), screen(rng), 0.f);
+		each.color = rgba(unit(rng), unit(rng), unit(rng), unit(rng));
+		each.uv = vec2(unit(rng), unit(rng));
+	}
+
+	vertex_format_bench_result result;
+	result.num_vertices = num_vertices;
+	result.formats[0] = _measure_format<vertex_pcu>("vertex_pcu", source, num_runs);
+	result.formats[1] = _measure_format<vertex_pcu_compact>("vertex_pcu_compact", source, num_runs);
+	result.formats[2] = _measure_format<vertex_pcu_2d>("vertex_pcu_2d", source, num_runs);
+	return result;
+}
+}
@@ -0,0 +1,29 @@
+/// glare/dev/vertex_format_bench.h
+/// Compares the vertex formats on a sprite-like mesh: the bytes a frame
+/// uploads for it and how fast copy_from_super_vertex converts to each.
+/// Conversion only, no device is needed.
+
+#pragma once
+#include "glare/core/common.h"
+
+namespace glare
+{
+struct vertex_format_bench_entry
+{
+	const char*	name			= nullptr;
+	uint32		stride			= 0;	// bytes per vertex
+	uint64		upload_bytes	= 0;	// for the whole mesh
+	float64		convert_ms		= 0.0;	// best of the runs
+	float64		mvertices_per_s	= 0.0;
+};
+
+struct vertex_format_bench_result
+{
+	static constexpr size_t NUM_FORMATS = 3;
+
+	uint32						num_vertices = 0;
+	vertex_format_bench_entry	formats[NUM_FORMATS];	// vertex_pcu, vertex_pcu_compact, vertex_pcu_2d
+};
+
+vertex_format_bench_result run_vertex_format_bench(uint32 num_vertices = 400000, uint32 num_runs = 20);
+}
@@ -0,0 +1,95 @@
+/// glare/math/half.h
+/// IEEE 754 binary16 conversion, for packed vertex and texture data.
+///
+/// float_to_half() rounds to nearest even like the hardware does, overflows
+/// to infinity, keeps NaN quiet and produces subnormals. The SSE2 version
+/// converts 4 lanes without F16C and gives the same bits as the scalar one.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/simd.h"
+#include <cstring>
+
+namespace glare
+{
+using half = uint16;
+
+inline half float_to_half(float32 value)
+{
+	constexpr uint32 F32_INFINITY	= 255u << 23;
+	constexpr uint32 F16_MAX		= (127u + 16u) << 23;	// first float above the half range
+	constexpr uint32 F16_MIN_NORMAL	= 113u << 23;
+	constexpr uint32 DENORM_MAGIC	= ((127u - 15u) + (23u - 10u) + 1u) << 23;
+	uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	const uint32 sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint32 result;
+	if (bits >= F16_MAX) {
+		result = bits > F32_INFINITY ? 0x7e00u : 0x7c00u;
+	} else if (bits < F16_MIN_NORMAL) {
+		// the float add aligns the 10 mantissa bits at the bottom, rounding to nearest even
+		float32 magic, shifted;
+		memcpy(&magic, &DENORM_MAGIC, sizeof(magic));
+		memcpy(&shifted, &bits, sizeof(shifted));
+		shifted += magic;
+		memcpy(&result, &shifted, sizeof(result));
+		result -= DENORM_MAGIC;
+	} else {
+		const uint32 mantissa_odd = (bits >> 13) & 1u;
+		bits += ((15u - 127u) << 23) + 0xfffu + mantissa_odd;
+		result = bits >> 13;
+	}
+	return static_cast<half>(result | (sign >> 16));
+}
+
+inline float32 half_to_float(half value)
+{
+	constexpr uint32 SHIFTED_EXPONENT = 0x7c00u << 13;
+	uint32 bits = (value & 0x7fffu) << 13;
+	const uint32 exponent = bits & SHIFTED_EXPONENT;
+	bits += (127u - 15u) << 23;
+	float32 result;
+	if (exponent == SHIFTED_EXPONENT) {
+		bits += (128u - 16u) << 23;		// Inf/NaN
+		memcpy(&result, &bits, sizeof(result));
+	} else if (exponent == 0) {
+		bits += 1u << 23;				// zero/subnormal, renormalize
+		memcpy(&result, &bits, sizeof(result));
+		result -= 6.103515625e-05f;		// 2^-14
+	} else {
+		memcpy(&result, &bits, sizeof(result));
+	}
+	return (value & 0x8000u) ? -result : result;
+}
+
+#if defined(GLARE_SIMD_SSE2)
+namespace simd
+{
+// Return: 4 halves in the low 16 bits of each 32 bit lane
+inline __m128i float_to_half(const float4& value)
+{
+	const __m128i bits_signed	= _mm_castps_si128(value.v);
+	const __m128i sign			= _mm_and_si128(bits_signed, _mm_set1_epi32(static_cast<int32>(0x80000000u)));
+	const __m128i bits			= _mm_xor_si128(bits_signed, sign);
+
+	const __m128i is_inf_nan	= _mm_cmpgt_epi32(bits, _mm_set1_epi32(((127 + 16) << 23) - 1));
+	const __m128i is_nan		= _mm_cmpgt_epi32(bits, _mm_set1_epi32(255 << 23));
+	const __m128i is_denormal	= _mm_cmpgt_epi32(_mm_set1_epi32(113 << 23), bits);
+
+	const __m128i inf_nan = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(is_nan, _mm_set1_epi32(0x0200)));
+	const __m128i denorm_magic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i denormal = _mm_sub_epi32(
+		_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(denorm_magic))), denorm_magic);
+	const __m128i mantissa_odd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+	const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits
+		, _mm_set1_epi32(static_cast<int32>((15u - 127u) << 23) + 0xfff)), mantissa_odd), 13);
+
+	__m128i result = _mm_or_si128(_mm_and_si128(is_denormal, denormal), _mm_andnot_si128(is_denormal, normal));
+	result = _mm_or_si128(_mm_and_si128(is_inf_nan, inf_nan), _mm_andnot_si128(is_inf_nan, result));
+	return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+}
+}
+#endif
+}
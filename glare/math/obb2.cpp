@@ -0,0 +1,69 @@
+#include "glare/math/obb2.h"
+#include <cfloat>
+
+namespace glare
+{
+vec2 obb2::world_to_local(const vec2& world_pos) const
+{
+	const vec2 displacement = world_pos - center;
+	return {displacement.dot(right), displacement.dot(up())};
+}
+
+vec2 obb2::local_to_world(const vec2& local_pos) const
+{
+	return center + local_pos.x * right + local_pos.y * up();
+}
+
+vec2 obb2::get_nearest_point(const vec2& worldPoint) const
+{
+	vec2 local = world_to_local(worldPoint);
+	local.x = clamp(local.x, -extends.x, extends.x);
+	local.y = clamp(local.y, -extends.y, extends.y);
+	return local_to_world(local);
+}
+
+bool obb2::is_overlapping(const obb2& with) const
+{
+	float32 depth;
+	vec2 normal;
+	return is_overlapping(with, depth, normal);
+}
+
+bool obb2::is_overlapping(const obb2& with, float32& out_depth, vec2& out_normal) const
+{
+	// Separating axis test over the 2 local axes of each box
+	const vec2 axes[4] = { right, up(), with.right, with.up() };
+	const vec2 displacement = with.center - center;
+	out_depth = FLT_MAX;
+	out_normal = vec2::ZERO;
+	for (const vec2& axis : axes) {
+		const float32 distance = displacement.dot(axis);
+		const float32 radius_a =
+			extends.x * fabsf(right.dot(axis)) + extends.y * fabsf(up().dot(axis));
+		const float32 radius_b =
+			with.extends.x * fabsf(with.right.dot(axis)) + with.extends.y * fabsf(with.up().dot(axis));
+		const float32 overlap = radius_a + radius_b - fabsf(distance);
+		if (overlap < out_depth) {
+			out_depth = overlap;
+			out_normal = distance < 0.f ? axis * -1.f : axis;
+		}
+	}
+	return out_depth >= 0.f;
+}
+
+bool obb2::is_overlapping(const vec2& worldPosition) const
+{
+	const vec2 local = world_to_local(worldPosition);
+	return fabsf(local.x) <= extends.x && fabsf(local.y) <= extends.y;
+}
+
+aabb2 obb2::get_bounding() const
+{
+	const vec2 axis_up = up();
+	const vec2 half_size {
+		extends.x * fabsf(right.x) + extends.y * fabsf(axis_up.x),
+		extends.x * fabsf(right.y) + extends.y * fabsf(axis_up.y)
+	};
+	return {center - half_size, center + half_size};
+}
+}
@@ -18,7 +18,7 @@ public:
 		: center(center)
 		, extends (size * 0.5f)
 	{
-		right = {cos_deg(rot_deg), sin_deg(rot_deg)};
+		sincos_deg(rot_deg, right.y, right.x);
 	}
 	obb2(const obb2& copy)
 		: center(copy.center)
@@ -53,13 +53,15 @@ public:
 	}
 	void set_rotation(float rot_deg)
 	{
-		right = {cos_deg(rot_deg), sin_deg(rot_deg)};
+		sincos_deg(rot_deg, right.y, right.x);
 	}
 
-	NODISCARD vec2 topleft()	const	{ return center - extends.x * right + extends.y * right.ratated_90_deg(); }
-	NODISCARD vec2 topright()	const	{ return center + extends.x * right + extends.y * right.ratated_90_deg(); }
-	NODISCARD vec2 bottomleft()	const	{ return center - extends.x * right - extends.y * right.ratated_90_deg(); }
-	NODISCARD vec2 bottomright()const	{ return center + extends.x * right - extends.y * right.ratated_90_deg(); }
+	// Local y axis, i.e. right rotated by +90 degrees
+	NODISCARD vec2 up()			const	{ return {-right.y, right.x}; }
+	NODISCARD vec2 topleft()	const	{ return center - extends.x * right + extends.y * up(); }
+	NODISCARD vec2 topright()	const	{ return center + extends.x * right + extends.y * up(); }
+	NODISCARD vec2 bottomleft()	const	{ return center - extends.x * right - extends.y * up(); }
+	NODISCARD vec2 bottomright()const	{ return center + extends.x * right - extends.y * up(); }
 	NODISCARD vec2 size() const { return extends * 2.f; }
 
 
@@ -68,6 +70,9 @@ public:
 
 	vec2 get_nearest_point	(const vec2& worldPoint) const;
 	bool is_overlapping		(const obb2& with) const;
+	// Also outputs the minimum translation along the separating axes,
+	// out_normal points from this box to <with>.
+	bool is_overlapping		(const obb2& with, float32& out_depth, vec2& out_normal) const;
 	bool is_overlapping		(const vec2& worldPosition) const;
 
 	aabb2 get_bounding() const;
@@ -75,10 +80,12 @@ public:
 	// Output corners in order of [tl, tr, bl, br]
 	void get_corners(vec2* out) const
 	{
-		out[0] = topleft();
-		out[1] = topright();
-		out[2] = bottomleft();
-		out[3] = bottomright();
+		const vec2 half_right = extends.x * right;
+		const vec2 half_up = extends.y * up();
+		out[0] = center - half_right + half_up;
+		out[1] = center + half_right + half_up;
+		out[2] = center - half_right - half_up;
+		out[3] = center + half_right - half_up;
 	}
 };
 }
\ No newline at end of file
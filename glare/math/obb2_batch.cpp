@@ -0,0 +1,163 @@
+#include "glare/math/obb2_batch.h"
+#include "glare/math/simd.h"
+#include "glare/core/assert.h"
+
+namespace glare
+{
+obb2 obb2_soa::get(size_t index) const
+{
+	obb2 box;
+	box.center = {center_x[index], center_y[index]};
+	box.right = {right_x[index], right_y[index]};
+	box.extends = {extends_x[index], extends_y[index]};
+	return box;
+}
+
+void obb2_batch::reserve(size_t count)
+{
+	m_center_x.reserve(count);
+	m_center_y.reserve(count);
+	m_right_x.reserve(count);
+	m_right_y.reserve(count);
+	m_extends_x.reserve(count);
+	m_extends_y.reserve(count);
+}
+
+void obb2_batch::clear()
+{
+	m_center_x.clear();
+	m_center_y.clear();
+	m_right_x.clear();
+	m_right_y.clear();
+	m_extends_x.clear();
+	m_extends_y.clear();
+}
+
+size_t obb2_batch::add(const obb2& box)
+{
+	m_center_x.push_back(box.center.x);
+	m_center_y.push_back(box.center.y);
+	m_right_x.push_back(box.right.x);
+	m_right_y.push_back(box.right.y);
+	m_extends_x.push_back(box.extends.x);
+	m_extends_y.push_back(box.extends.y);
+	return size() - 1;
+}
+
+void obb2_batch::set(size_t index, const obb2& box)
+{
+	m_center_x[index] = box.center.x;
+	m_center_y[index] = box.center.y;
+	m_right_x[index] = box.right.x;
+	m_right_y[index] = box.right.y;
+	m_extends_x[index] = box.extends.x;
+	m_extends_y[index] = box.extends.y;
+}
+
+obb2_soa obb2_batch::get_soa() const
+{
+	obb2_soa view;
+	view.center_x = m_center_x.data();
+	view.center_y = m_center_y.data();
+	view.right_x = m_right_x.data();
+	view.right_y = m_right_y.data();
+	view.extends_x = m_extends_x.data();
+	view.extends_y = m_extends_y.data();
+	view.count = size();
+	return view;
+}
+
+////////////////////////////////
+// For orthonormal frames |dot(a.right, b.right)| == |dot(a.up, b.up)| and
+// |dot(a.right, b.up)| == |dot(a.up, b.right)|, so the projected radii of the
+// 4 candidate axes only need those 2 terms.
+template<typename V>
+static uint32 _overlap_obb2_lanes(const obb2_soa& a, const obb2_soa& b, size_t i
+	, float32* out_depth, vec2* out_normal)
+{
+	const V a_rx = V::load(a.right_x + i);
+	const V a_ry = V::load(a.right_y + i);
+	const V a_ex = V::load(a.extends_x + i);
+	const V a_ey = V::load(a.extends_y + i);
+	const V b_rx = V::load(b.right_x + i);
+	const V b_ry = V::load(b.right_y + i);
+	const V b_ex = V::load(b.extends_x + i);
+	const V b_ey = V::load(b.extends_y + i);
+	const V dx = V::load(b.center_x + i) - V::load(a.center_x + i);
+	const V dy = V::load(b.center_y + i) - V::load(a.center_y + i);
+
+	const V abs_cos = simd::abs(a_rx * b_rx + a_ry * b_ry);
+	const V abs_sin = simd::abs(a_ry * b_rx - a_rx * b_ry);
+
+	// axis a.right
+	V dist = dx * a_rx + dy * a_ry;
+	V best = a_ex + b_ex * abs_cos + b_ey * abs_sin - simd::abs(dist);
+	V normal_x = simd::mul_sign(a_rx, dist);
+	V normal_y = simd::mul_sign(a_ry, dist);
+	auto try_axis = [&](const V& axis_x, const V& axis_y, const V& radius_sum) {
+		const V d = dx * axis_x + dy * axis_y;
+		const V overlap = radius_sum - simd::abs(d);
+		const V is_less = overlap < best;
+		best = simd::select(is_less, overlap, best);
+		normal_x = simd::select(is_less, simd::mul_sign(axis_x, d), normal_x);
+		normal_y = simd::select(is_less, simd::mul_sign(axis_y, d), normal_y);
+	};
+	// axis a.up = (-a.right.y, a.right.x)
+	try_axis(-a_ry, a_rx, a_ey + b_ex * abs_sin + b_ey * abs_cos);
+	// axis b.right
+	try_axis(b_rx, b_ry, b_ex + a_ex * abs_cos + a_ey * abs_sin);
+	// axis b.up
+	try_axis(-b_ry, b_rx, b_ey + a_ex * abs_sin + a_ey * abs_cos);
+
+	if (out_depth) {
+		best.store(out_depth + i);
+	}
+	if (out_normal) {
+		float32 nx[V::WIDTH];
+		float32 ny[V::WIDTH];
+		normal_x.store(nx);
+		normal_y.store(ny);
+		for (size_t lane = 0; lane < V::WIDTH; ++lane) {
+			out_normal[i + lane] = {nx[lane], ny[lane]};
+		}
+	}
+	return simd::movemask(best >= V(0.f));
+}
+
+size_t overlap_obb2_batch(const obb2_soa& a, const obb2_soa& b, uint32* out_mask
+	, float32* out_depth, vec2* out_normal)
+{
+	ASSERT(out_mask, "Overlap mask output is required");
+	const size_t count = a.count < b.count ? a.count : b.count;
+	size_t num_overlapping = 0;
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	for (; i + simd::float8::WIDTH <= count; i += simd::float8::WIDTH) {
+		const uint32 bits = _overlap_obb2_lanes<simd::float8>(a, b, i, out_depth, out_normal);
+		simd::set_mask_bits(out_mask, i, bits, simd::float8::WIDTH);
+		num_overlapping += simd::count_bits(bits);
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	for (; i + simd::float4::WIDTH <= count; i += simd::float4::WIDTH) {
+		const uint32 bits = _overlap_obb2_lanes<simd::float4>(a, b, i, out_depth, out_normal);
+		simd::set_mask_bits(out_mask, i, bits, simd::float4::WIDTH);
+		num_overlapping += simd::count_bits(bits);
+	}
+#endif
+	for (; i < count; ++i) {
+		float32 depth;
+		vec2 normal;
+		const bool overlapping = a.get(i).is_overlapping(b.get(i), depth, normal);
+		simd::set_mask_bits(out_mask, i, overlapping ? 1u : 0u, 1u);
+		num_overlapping += overlapping ? 1u : 0u;
+		if (out_depth) {
+			out_depth[i] = depth;
+		}
+		if (out_normal) {
+			out_normal[i] = normal;
+		}
+	}
+	return num_overlapping;
+}
+}
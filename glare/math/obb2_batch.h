@@ -0,0 +1,58 @@
+/// glare/math/obb2_batch.h
+/// Structure-of-arrays storage of obb2 and batched narrow-phase tests.
+///
+/// Boxes are assumed to have a unit-length obb2::right, as every obb2
+/// constructor and obb2::rotate produce.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/obb2.h"
+#include <vector>
+
+namespace glare
+{
+// Non-owning view of obb2 components, one array per component
+struct obb2_soa
+{
+	const float32* center_x = nullptr;
+	const float32* center_y = nullptr;
+	const float32* right_x = nullptr;
+	const float32* right_y = nullptr;
+	const float32* extends_x = nullptr;
+	const float32* extends_y = nullptr;
+	size_t count = 0;
+
+	NODISCARD obb2 get(size_t index) const;
+};
+
+class obb2_batch
+{
+public:
+	obb2_batch() = default;
+	explicit obb2_batch(size_t reserve_count) { reserve(reserve_count); }
+
+	void reserve(size_t count);
+	void clear();
+	// Return: the index of added box
+	size_t add(const obb2& box);
+	void set(size_t index, const obb2& box);
+	NODISCARD obb2 get(size_t index) const { return get_soa().get(index); }
+	NODISCARD size_t size() const { return m_center_x.size(); }
+	NODISCARD obb2_soa get_soa() const;
+public:
+	std::vector<float32> m_center_x;
+	std::vector<float32> m_center_y;
+	std::vector<float32> m_right_x;
+	std::vector<float32> m_right_y;
+	std::vector<float32> m_extends_x;
+	std::vector<float32> m_extends_y;
+};
+
+// Separating axis test of a[i] against b[i] for every i < min(a.count, b.count).
+// out_mask:	simd::get_mask_word_count(count) words, bit i is set when pair i overlaps.
+// out_depth:	optional, per pair penetration depth (negative when separated).
+// out_normal:	optional, per pair axis of minimum penetration, pointing from a[i] to b[i].
+// Return: the number of overlapping pairs
+size_t overlap_obb2_batch(const obb2_soa& a, const obb2_soa& b, uint32* out_mask
+	, float32* out_depth=nullptr, vec2* out_normal=nullptr);
+}
@@ -0,0 +1,380 @@
+#include "glare/math/raycast2.h"
+#include "glare/math/simd.h"
+#include <cmath>
+
+namespace glare
+{
+// Keeps 1 / direction finite for axis-aligned rays in the batch kernels
+static constexpr float32 MIN_DIRECTION = 1e-20f;
+static constexpr size_t CLOSEST_CHUNK = 256;
+
+// Slab test of a ray, given in the box frame, against [lo, hi]
+static bool _raycast_slabs(const vec2& origin, const vec2& direction, const vec2& lo, const vec2& hi
+	, float32 max_distance, float32& out_distance, vec2& out_normal)
+{
+	float32 enter = -FLT_MAX;
+	float32 exit = max_distance;
+	vec2 normal = direction * -1.f;
+	for (int32 axis = 0; axis < 2; ++axis) {
+		const float32 o = axis ? origin.y : origin.x;
+		const float32 d = axis ? direction.y : direction.x;
+		const float32 slab_lo = axis ? lo.y : lo.x;
+		const float32 slab_hi = axis ? hi.y : hi.x;
+		if (fabsf(d) < MIN_DIRECTION) {
+			if (o < slab_lo || o > slab_hi) {
+				return false;
+			}
+			continue;
+		}
+		const float32 inv_d = 1.f / d;
+		float32 t_lo = (slab_lo - o) * inv_d;
+		float32 t_hi = (slab_hi - o) * inv_d;
+		float32 side = -1.f;
+		if (t_lo > t_hi) {
+			const float32 swap = t_lo;
+			t_lo = t_hi;
+			t_hi = swap;
+			side = 1.f;
+		}
+		if (t_lo > enter) {
+			enter = t_lo;
+			normal = axis ? vec2(0.f, side) : vec2(side, 0.f);
+		}
+		exit = t_hi < exit ? t_hi : exit;
+		if (enter > exit) {
+			return false;
+		}
+	}
+	if (exit < 0.f) {
+		return false;
+	}
+	if (enter < 0.f) {
+		out_distance = 0.f;
+		out_normal = direction * -1.f;
+	} else {
+		out_distance = enter;
+		out_normal = normal;
+	}
+	return true;
+}
+
+bool raycast(const ray2& ray, const aabb2& box, raycast_hit& out_hit)
+{
+	float32 distance;
+	vec2 normal;
+	if (!_raycast_slabs(ray.origin, ray.direction, box.min, box.max, ray.max_distance, distance, normal)) {
+		return false;
+	}
+	out_hit.distance = distance;
+	out_hit.position = ray.get_point(distance);
+	out_hit.normal = normal;
+	return true;
+}
+
+bool raycast(const ray2& ray, const obb2& box, raycast_hit& out_hit)
+{
+	const vec2 up = box.up();
+	const vec2 offset = ray.origin - box.center;
+	const vec2 local_origin(offset.dot(box.right), offset.dot(up));
+	const vec2 local_direction(ray.direction.dot(box.right), ray.direction.dot(up));
+	float32 distance;
+	vec2 normal;
+	if (!_raycast_slabs(local_origin, local_direction, box.extends * -1.f, box.extends, ray.max_distance, distance, normal)) {
+		return false;
+	}
+	out_hit.distance = distance;
+	out_hit.position = ray.get_point(distance);
+	out_hit.normal = box.right * normal.x + up * normal.y;
+	return true;
+}
+
+bool raycast_disk(const ray2& ray, const vec2& center, float32 radius, raycast_hit& out_hit)
+{
+	const vec2 offset = ray.origin - center;
+	const float32 b = offset.dot(ray.direction);
+	const float32 c = offset.length_square() - radius * radius;
+	const float32 discriminant = b * b - c;
+	if (discriminant < 0.f) {
+		return false;
+	}
+	const float32 root = sqrtf(discriminant);
+	if (-b + root < 0.f) {
+		return false; // behind the origin
+	}
+	const float32 distance = -b - root > 0.f ? -b - root : 0.f;
+	if (distance > ray.max_distance) {
+		return false;
+	}
+	out_hit.distance = distance;
+	out_hit.position = ray.get_point(distance);
+	out_hit.normal = distance > 0.f ? (out_hit.position - center) / radius : ray.direction * -1.f;
+	return true;
+}
+
+bool cast_aabb2(const aabb2& moving, const ray2& motion, const aabb2& target, raycast_hit& out_hit)
+{
+	// Sweeping a box against a box is a ray against the target grown by the moving box
+	const vec2 extends = moving.get_extends();
+	const aabb2 grown(target.min - extends, target.max + extends);
+	return raycast(ray2(moving.get_center(), motion.direction, motion.max_distance), grown, out_hit);
+}
+
+bool cast_obb2(const obb2& moving, const ray2& motion, const obb2& target, raycast_hit& out_hit)
+{
+	// Separating axes over time: on every axis the projections overlap during
+	// [enter, exit], and the boxes touch while all those intervals overlap.
+	const vec2 axes[4] = {moving.right, moving.up(), target.right, target.up()};
+	const vec2 moving_up = moving.up();
+	const vec2 target_up = target.up();
+	const vec2 gap = target.center - moving.center;
+	float32 enter = -FLT_MAX;
+	float32 exit = motion.max_distance;
+	vec2 normal = motion.direction * -1.f;
+	for (const vec2& axis : axes) {
+		const float32 radius =
+			moving.extends.x * fabsf(moving.right.dot(axis)) + moving.extends.y * fabsf(moving_up.dot(axis)) +
+			target.extends.x * fabsf(target.right.dot(axis)) + target.extends.y * fabsf(target_up.dot(axis));
+		const float32 distance = gap.dot(axis);
+		const float32 speed = motion.direction.dot(axis);
+		if (fabsf(speed) < MIN_DIRECTION) {
+			if (fabsf(distance) > radius) {
+				return false;
+			}
+			continue;
+		}
+		float32 t_lo = (distance - radius) / speed;
+		float32 t_hi = (distance + radius) / speed;
+		if (t_lo > t_hi) {
+			const float32 swap = t_lo;
+			t_lo = t_hi;
+			t_hi = swap;
+		}
+		if (t_lo > enter) {
+			enter = t_lo;
+			normal = speed > 0.f ? axis * -1.f : axis;
+		}
+		exit = t_hi < exit ? t_hi : exit;
+		if (enter > exit) {
+			return false;
+		}
+	}
+	if (exit < 0.f) {
+		return false;
+	}
+	const bool started_inside = enter < 0.f;
+	out_hit.distance = started_inside ? 0.f : enter;
+	out_hit.position = moving.center + motion.direction * out_hit.distance;
+	out_hit.normal = started_inside ? motion.direction * -1.f : normal;
+	return true;
+}
+
+////////////////////////////////
+// Batch kernels, one ray against V::WIDTH primitives starting at i
+
+static vec2 _safe_direction(const vec2& direction)
+{
+	const auto safe = [](float32 d) { return fabsf(d) < MIN_DIRECTION ? MIN_DIRECTION : d; };
+	return {safe(direction.x), safe(direction.y)};
+}
+
+template<typename V>
+static V _slab_distance(const V& origin_x, const V& origin_y, const V& inv_dx, const V& inv_dy
+	, const V& lo_x, const V& lo_y, const V& hi_x, const V& hi_y, const V& max_distance)
+{
+	const V tx0 = (lo_x - origin_x) * inv_dx;
+	const V tx1 = (hi_x - origin_x) * inv_dx;
+	const V ty0 = (lo_y - origin_y) * inv_dy;
+	const V ty1 = (hi_y - origin_y) * inv_dy;
+	const V enter = simd::max(simd::min(tx0, tx1), simd::min(ty0, ty1));
+	const V exit = simd::min(simd::max(tx0, tx1), simd::max(ty0, ty1));
+	const V distance = simd::max(enter, V(0.f));
+	const V hit = (exit >= distance) & (distance <= max_distance);
+	return simd::select(hit, distance, V(FLT_MAX));
+}
+
+template<typename V>
+static void _raycast_aabb2_lanes(const ray2& ray, const vec2& inv_direction, const aabb2_soa& boxes, size_t i, float32* out_distance)
+{
+	_slab_distance<V>(ray.origin.x, ray.origin.y, inv_direction.x, inv_direction.y
+		, V::load(boxes.min_x + i), V::load(boxes.min_y + i), V::load(boxes.max_x + i), V::load(boxes.max_y + i)
+		, ray.max_distance).store(out_distance + i);
+}
+
+template<typename V>
+static void _raycast_obb2_lanes(const ray2& ray, const obb2_soa& boxes, size_t i, float32* out_distance)
+{
+	const V rx = V::load(boxes.right_x + i);
+	const V ry = V::load(boxes.right_y + i);
+	const V ex = V::load(boxes.extends_x + i);
+	const V ey = V::load(boxes.extends_y + i);
+	const V ox = V(ray.origin.x) - V::load(boxes.center_x + i);
+	const V oy = V(ray.origin.y) - V::load(boxes.center_y + i);
+	const V dx(ray.direction.x);
+	const V dy(ray.direction.y);
+	// Ray in the box frame, right = (rx, ry), up = (-ry, rx)
+	const V local_ox = ox * rx + oy * ry;
+	const V local_oy = oy * rx - ox * ry;
+	const V local_dx = dx * rx + dy * ry;
+	const V local_dy = dy * rx - dx * ry;
+	const V tiny(MIN_DIRECTION);
+	const V inv_dx = V(1.f) / simd::select(simd::abs(local_dx) < tiny, tiny, local_dx);
+	const V inv_dy = V(1.f) / simd::select(simd::abs(local_dy) < tiny, tiny, local_dy);
+	_slab_distance<V>(local_ox, local_oy, inv_dx, inv_dy, -ex, -ey, ex, ey, ray.max_distance).store(out_distance + i);
+}
+
+template<typename V>
+static void _raycast_disk_lanes(const ray2& ray, const disk_soa& disks, size_t i, float32* out_distance)
+{
+	const V ox = V(ray.origin.x) - V::load(disks.center_x + i);
+	const V oy = V(ray.origin.y) - V::load(disks.center_y + i);
+	const V radius = V::load(disks.radius + i);
+	const V b = ox * V(ray.direction.x) + oy * V(ray.direction.y);
+	const V c = ox * ox + oy * oy - radius * radius;
+	const V discriminant = b * b - c;
+	const V root = simd::sqrt(simd::max(discriminant, V(0.f)));
+	const V distance = simd::max(V(0.f) - b - root, V(0.f));
+	const V hit = (discriminant >= V(0.f)) & (root - b >= V(0.f)) & (distance <= V(ray.max_distance));
+	simd::select(hit, distance, V(FLT_MAX)).store(out_distance + i);
+}
+
+void raycast_batch(const ray2& ray, const aabb2_soa& boxes, float32* out_distance)
+{
+	const vec2 direction = _safe_direction(ray.direction);
+	const vec2 inv_direction(1.f / direction.x, 1.f / direction.y);
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	for (; i + simd::float8::WIDTH <= boxes.count; i += simd::float8::WIDTH) {
+		_raycast_aabb2_lanes<simd::float8>(ray, inv_direction, boxes, i, out_distance);
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	for (; i + simd::float4::WIDTH <= boxes.count; i += simd::float4::WIDTH) {
+		_raycast_aabb2_lanes<simd::float4>(ray, inv_direction, boxes, i, out_distance);
+	}
+#endif
+	for (; i < boxes.count; ++i) {
+		raycast_hit hit;
+		const aabb2 box(boxes.min_x[i], boxes.min_y[i], boxes.max_x[i], boxes.max_y[i]);
+		out_distance[i] = raycast(ray, box, hit) ? hit.distance : FLT_MAX;
+	}
+}
+
+void raycast_batch(const ray2& ray, const obb2_soa& boxes, float32* out_distance)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	for (; i + simd::float8::WIDTH <= boxes.count; i += simd::float8::WIDTH) {
+		_raycast_obb2_lanes<simd::float8>(ray, boxes, i, out_distance);
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	for (; i + simd::float4::WIDTH <= boxes.count; i += simd::float4::WIDTH) {
+		_raycast_obb2_lanes<simd::float4>(ray, boxes, i, out_distance);
+	}
+#endif
+	for (; i < boxes.count; ++i) {
+		raycast_hit hit;
+		out_distance[i] = raycast(ray, boxes.get(i), hit) ? hit.distance : FLT_MAX;
+	}
+}
+
+void raycast_batch(const ray2& ray, const disk_soa& disks, float32* out_distance)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	for (; i + simd::float8::WIDTH <= disks.count; i += simd::float8::WIDTH) {
+		_raycast_disk_lanes<simd::float8>(ray, disks, i, out_distance);
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	for (; i + simd::float4::WIDTH <= disks.count; i += simd::float4::WIDTH) {
+		_raycast_disk_lanes<simd::float4>(ray, disks, i, out_distance);
+	}
+#endif
+	for (; i < disks.count; ++i) {
+		raycast_hit hit;
+		const vec2 center(disks.center_x[i], disks.center_y[i]);
+		out_distance[i] = raycast_disk(ray, center, disks.radius[i], hit) ? hit.distance : FLT_MAX;
+	}
+}
+
+static float32 _min_of(const float32* values, size_t count)
+{
+	float32 result = FLT_MAX;
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	simd::float4 lanes(FLT_MAX);
+	for (; i + simd::float4::WIDTH <= count; i += simd::float4::WIDTH) {
+		lanes = simd::min(lanes, simd::float4::load(values + i));
+	}
+	float32 stored[simd::float4::WIDTH];
+	lanes.store(stored);
+	for (const float32 each : stored) {
+		result = each < result ? each : result;
+	}
+#endif
+	for (; i < count; ++i) {
+		result = values[i] < result ? values[i] : result;
+	}
+	return result;
+}
+
+// Runs the batch over fixed size chunks, so the distances stay in cache
+template<typename SOA, typename ADVANCE>
+static size_t _raycast_closest(const ray2& ray, const SOA& primitives, float32& out_distance, ADVANCE advance)
+{
+	float32 distances[CLOSEST_CHUNK];
+	size_t closest = SIZE_MAX;
+	out_distance = FLT_MAX;
+	for (size_t begin = 0; begin < primitives.count; begin += CLOSEST_CHUNK) {
+		SOA chunk = advance(primitives, begin);
+		chunk.count = primitives.count - begin < CLOSEST_CHUNK ? primitives.count - begin : CLOSEST_CHUNK;
+		raycast_batch(ray, chunk, distances);
+		// Most chunks are all misses, only look for the index when the minimum improves
+		if (_min_of(distances, chunk.count) >= out_distance) {
+			continue;
+		}
+		for (size_t i = 0; i < chunk.count; ++i) {
+			if (distances[i] < out_distance) {
+				out_distance = distances[i];
+				closest = begin + i;
+			}
+		}
+	}
+	return closest;
+}
+
+size_t raycast_closest(const ray2& ray, const aabb2_soa& boxes, float32& out_distance)
+{
+	return _raycast_closest(ray, boxes, out_distance, [](aabb2_soa view, size_t offset) {
+		view.min_x += offset;
+		view.min_y += offset;
+		view.max_x += offset;
+		view.max_y += offset;
+		return view;
+	});
+}
+
+size_t raycast_closest(const ray2& ray, const obb2_soa& boxes, float32& out_distance)
+{
+	return _raycast_closest(ray, boxes, out_distance, [](obb2_soa view, size_t offset) {
+		view.center_x += offset;
+		view.center_y += offset;
+		view.right_x += offset;
+		view.right_y += offset;
+		view.extends_x += offset;
+		view.extends_y += offset;
+		return view;
+	});
+}
+
+size_t raycast_closest(const ray2& ray, const disk_soa& disks, float32& out_distance)
+{
+	return _raycast_closest(ray, disks, out_distance, [](disk_soa view, size_t offset) {
+		view.center_x += offset;
+		view.center_y += offset;
+		view.radius += offset;
+		return view;
+	});
+}
+}
@@ -0,0 +1,100 @@
+/// glare/math/raycast2.h
+/// Ray and swept-shape queries against aabb2, obb2 and disks.
+///
+/// Rays have a unit direction, so hit distances are in world units and the
+/// ones from different primitive types can be compared directly.
+/// Rays starting inside a primitive hit it at distance 0 with a normal
+/// opposite to the ray direction.
+///
+/// The batch functions test one ray against many primitives stored as
+/// structure-of-arrays, and fill FLT_MAX for the misses.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/aabb2.h"
+#include "glare/math/obb2.h"
+#include "glare/math/obb2_batch.h"
+#include <cfloat>
+
+namespace glare
+{
+struct ray2
+{
+	vec2	origin = vec2::ZERO;
+	vec2	direction = {1.f, 0.f};	// unit length
+	float32	max_distance = FLT_MAX;
+
+	ray2() = default;
+	// <direction> gets normalized
+	ray2(const vec2& origin, const vec2& direction, float32 max_distance = FLT_MAX)
+		: origin(origin)
+		, direction(direction.normalized())
+		, max_distance(max_distance)
+	{}
+	NODISCARD static ray2 from_segment(const vec2& start, const vec2& end)
+	{
+		return ray2(start, end - start, (end - start).length());
+	}
+
+	NODISCARD vec2 get_point(float32 distance) const { return origin + direction * distance; }
+};
+
+struct raycast_hit
+{
+	float32	distance = FLT_MAX;
+	vec2	position;	// hit point, or the center of the moving shape for casts
+	vec2	normal;		// surface normal of the hit primitive, facing the ray
+	uint32	id = UINT32_MAX;	// filled by queries over several primitives
+
+	NODISCARD bool is_hit() const { return distance != FLT_MAX; }
+};
+
+bool raycast(const ray2& ray, const aabb2& box, raycast_hit& out_hit);
+bool raycast(const ray2& ray, const obb2& box, raycast_hit& out_hit);
+bool raycast_disk(const ray2& ray, const vec2& center, float32 radius, raycast_hit& out_hit);
+
+// Moves <moving> along <motion> up to motion.max_distance, without rotating,
+// and reports where it first touches <target>
+bool cast_aabb2(const aabb2& moving, const ray2& motion, const aabb2& target, raycast_hit& out_hit);
+bool cast_obb2(const obb2& moving, const ray2& motion, const obb2& target, raycast_hit& out_hit);
+
+// Non-owning views, one array per component
+struct aabb2_soa
+{
+	const float32* min_x = nullptr;
+	const float32* min_y = nullptr;
+	const float32* max_x = nullptr;
+	const float32* max_y = nullptr;
+	size_t count = 0;
+};
+
+struct disk_soa
+{
+	const float32* center_x = nullptr;
+	const float32* center_y = nullptr;
+	const float32* radius = nullptr;
+	size_t count = 0;
+};
+
+// out_distance[i]: distance to primitive i, FLT_MAX when missed or beyond ray.max_distance
+void raycast_batch(const ray2& ray, const aabb2_soa& boxes, float32* out_distance);
+void raycast_batch(const ray2& ray, const obb2_soa& boxes, float32* out_distance);
+void raycast_batch(const ray2& ray, const disk_soa& disks, float32* out_distance);
+
+// Return: the index of the nearest primitive hit, or SIZE_MAX
+size_t raycast_closest(const ray2& ray, const aabb2_soa& boxes, float32& out_distance);
+size_t raycast_closest(const ray2& ray, const obb2_soa& boxes, float32& out_distance);
+size_t raycast_closest(const ray2& ray, const disk_soa& disks, float32& out_distance);
+
+// Lets a spatial structure run ray queries without knowing what is stored in it.
+// The structure walks the candidates whose bounds the ray crosses, nearest
+// first when it can, and hands each one to visit().
+class ray_query_visitor
+{
+public:
+	virtual ~ray_query_visitor() = default;
+	// Return: the distance to clip the ray to. The hit distance keeps only closer
+	// candidates, ray.max_distance keeps every candidate, 0 ends the query.
+	virtual float32 visit(uint32 id, const ray2& ray) = 0;
+};
+}
@@ -0,0 +1,176 @@
+/// glare/math/simd.h
+/// Thin wrappers over SSE/AVX intrinsics shared by the batch kernels.
+///
+/// GLARE_SIMD_SSE2 is on for every x64 (and /arch:SSE2 x86) build.
+/// GLARE_SIMD_AVX2 is on when compiled with /arch:AVX2.
+/// float4/float8 expose the same interface, so a kernel written as a template
+/// over the lane type compiles for both widths. Kernels still need a scalar
+/// path for the tail and for targets without SSE2.
+
+#pragma once
+#include "glare/core/common.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define GLARE_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define GLARE_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace glare
+{
+namespace simd
+{
+// Bit mask helpers, one bit per element packed into uint32 words
+constexpr size_t get_mask_word_count(size_t count) { return (count + 31u) / 32u; }
+inline bool is_mask_set(const uint32* mask, size_t index)
+{
+	return (mask[index >> 5u] >> (index & 31u)) & 1u;
+}
+inline uint32 count_bits(uint32 bits)
+{
+	bits = bits - ((bits >> 1u) & 0x55555555u);
+	bits = (bits & 0x33333333u) + ((bits >> 2u) & 0x33333333u);
+	return (((bits + (bits >> 4u)) & 0x0f0f0f0fu) * 0x01010101u) >> 24u;
+}
+// <num_bits> must not cross a word boundary, i.e. first_index is aligned to the lane width
+inline void set_mask_bits(uint32* mask, size_t first_index, uint32 bits, size_t num_bits)
+{
+	const uint32 shift = static_cast<uint32>(first_index & 31u);
+	const uint32 word_mask = static_cast<uint32>(((1ull << num_bits) - 1ull) << shift);
+	uint32& word = mask[first_index >> 5u];
+	word = (word & ~word_mask) | ((bits << shift) & word_mask);
+}
+
+#if defined(GLARE_SIMD_SSE2)
+struct float4
+{
+	static constexpr size_t WIDTH = 4;
+	__m128 v;
+
+	float4() = default;
+	float4(__m128 v) : v(v) {}
+	float4(float32 broadcast) : v(_mm_set1_ps(broadcast)) {}
+
+	static float4 load(const float32* src)	{ return _mm_loadu_ps(src); }
+	void store(float32* dst) const			{ _mm_storeu_ps(dst, v); }
+
+	float4 operator + (const float4& rhs) const { return _mm_add_ps(v, rhs.v); }
+	float4 operator - (const float4& rhs) const { return _mm_sub_ps(v, rhs.v); }
+	float4 operator * (const float4& rhs) const { return _mm_mul_ps(v, rhs.v); }
+	float4 operator / (const float4& rhs) const { return _mm_div_ps(v, rhs.v); }
+	float4 operator - () const { return _mm_xor_ps(v, _mm_set1_ps(-0.f)); }
+	// Comparisons return lane masks (all-ones / all-zeros)
+	float4 operator < (const float4& rhs) const { return _mm_cmplt_ps(v, rhs.v); }
+	float4 operator <= (const float4& rhs) const { return _mm_cmple_ps(v, rhs.v); }
+	float4 operator > (const float4& rhs) const { return _mm_cmpgt_ps(v, rhs.v); }
+	float4 operator >= (const float4& rhs) const { return _mm_cmpge_ps(v, rhs.v); }
+	float4 operator & (const float4& rhs) const { return _mm_and_ps(v, rhs.v); }
+	float4 operator | (const float4& rhs) const { return _mm_or_ps(v, rhs.v); }
+	float4 operator ^ (const float4& rhs) const { return _mm_xor_ps(v, rhs.v); }
+};
+
+inline float4 min(const float4& a, const float4& b)	{ return _mm_min_ps(a.v, b.v); }
+inline float4 max(const float4& a, const float4& b)	{ return _mm_max_ps(a.v, b.v); }
+inline float4 sqrt(const float4& a)						{ return _mm_sqrt_ps(a.v); }
+inline float4 abs(const float4& a)						{ return _mm_andnot_ps(_mm_set1_ps(-0.f), a.v); }
+// mask ? a : b
+inline float4 select(const float4& mask, const float4& a, const float4& b)
+{
+	return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+}
+// Negate lanes of <a> where <sign> is negative
+inline float4 mul_sign(const float4& a, const float4& sign)
+{
+	return _mm_xor_ps(a.v, _mm_and_ps(sign.v, _mm_set1_ps(-0.f)));
+}
+// Round to nearest integer (current MXCSR mode, round-half-even by default)
+inline float4 round(const float4& a)					{ return _mm_cvtepi32_ps(_mm_cvtps_epi32(a.v)); }
+inline uint32 movemask(const float4& mask)				{ return static_cast<uint32>(_mm_movemask_ps(mask.v)); }
+
+// Degree 5 polynomials, about 1e-5 relative error: enough for color transfer
+// functions, not a replacement for std::log2/exp2.
+// <a> must be positive and normal
+inline float4 log2(const float4& a)
+{
+	const __m128i bits = _mm_castps_si128(a.v);
+	const float4 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+	// mantissa in [1, 2)
+	const float4 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+	float4 p = float4(-3.4436006e-2f);
+	p = p * m + float4(3.1821337e-1f);
+	p = p * m + float4(-1.2315303f);
+	p = p * m + float4(2.5988452f);
+	p = p * m + float4(-3.3241990f);
+	p = p * m + float4(3.1157899f);
+	return p * (m - float4(1.f)) + exponent;
+}
+// Clamped to [-126, 128)
+inline float4 exp2(const float4& a)
+{
+	const float4 x = min(max(a, float4(-126.f)), float4(127.99999f));
+	__m128i whole = _mm_cvttps_epi32(x.v);
+	// truncation rounds negative values up, floor them
+	const float4 truncated = _mm_cvtepi32_ps(whole);
+	whole = _mm_add_epi32(whole, _mm_castps_si128((truncated > x).v));
+	const float4 f = x - float4(_mm_cvtepi32_ps(whole));
+	float4 p = float4(1.8775767e-3f);
+	p = p * f + float4(8.9893397e-3f);
+	p = p * f + float4(5.5826318e-2f);
+	p = p * f + float4(2.4015361e-1f);
+	p = p * f + float4(6.9315308e-1f);
+	p = p * f + float4(9.9999994e-1f);
+	const float4 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(whole, _mm_set1_epi32(127)), 23));
+	return p * scale;
+}
+// <a> must be positive and normal
+inline float4 pow(const float4& a, const float4& b)		{ return exp2(b * log2(a)); }
+#endif
+
+#if defined(GLARE_SIMD_AVX2)
+struct float8
+{
+	static constexpr size_t WIDTH = 8;
+	__m256 v;
+
+	float8() = default;
+	float8(__m256 v) : v(v) {}
+	float8(float32 broadcast) : v(_mm256_set1_ps(broadcast)) {}
+
+	static float8 load(const float32* src)	{ return _mm256_loadu_ps(src); }
+	void store(float32* dst) const			{ _mm256_storeu_ps(dst, v); }
+
+	float8 operator + (const float8& rhs) const { return _mm256_add_ps(v, rhs.v); }
+	float8 operator - (const float8& rhs) const { return _mm256_sub_ps(v, rhs.v); }
+	float8 operator * (const float8& rhs) const { return _mm256_mul_ps(v, rhs.v); }
+	float8 operator / (const float8& rhs) const { return _mm256_div_ps(v, rhs.v); }
+	float8 operator - () const { return _mm256_xor_ps(v, _mm256_set1_ps(-0.f)); }
+	float8 operator < (const float8& rhs) const { return _mm256_cmp_ps(v, rhs.v, _CMP_LT_OQ); }
+	float8 operator <= (const float8& rhs) const { return _mm256_cmp_ps(v, rhs.v, _CMP_LE_OQ); }
+	float8 operator > (const float8& rhs) const { return _mm256_cmp_ps(v, rhs.v, _CMP_GT_OQ); }
+	float8 operator >= (const float8& rhs) const { return _mm256_cmp_ps(v, rhs.v, _CMP_GE_OQ); }
+	float8 operator & (const float8& rhs) const { return _mm256_and_ps(v, rhs.v); }
+	float8 operator | (const float8& rhs) const { return _mm256_or_ps(v, rhs.v); }
+	float8 operator ^ (const float8& rhs) const { return _mm256_xor_ps(v, rhs.v); }
+};
+
+inline float8 min(const float8& a, const float8& b)	{ return _mm256_min_ps(a.v, b.v); }
+inline float8 max(const float8& a, const float8& b)	{ return _mm256_max_ps(a.v, b.v); }
+inline float8 sqrt(const float8& a)						{ return _mm256_sqrt_ps(a.v); }
+inline float8 abs(const float8& a)						{ return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.v); }
+inline float8 select(const float8& mask, const float8& a, const float8& b)
+{
+	return _mm256_blendv_ps(b.v, a.v, mask.v);
+}
+inline float8 mul_sign(const float8& a, const float8& sign)
+{
+	return _mm256_xor_ps(a.v, _mm256_and_ps(sign.v, _mm256_set1_ps(-0.f)));
+}
+inline float8 round(const float8& a)					{ return _mm256_round_ps(a.v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+inline uint32 movemask(const float8& mask)				{ return static_cast<uint32>(_mm256_movemask_ps(mask.v)); }
+#endif
+}
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/vector.h"
+#include "glare/math/matrix.h"
+#include "glare/math/utilities.h"
+
+namespace glare
+{
+// 2D affine transform, p' = i * p.x + j * p.y + t
+struct affine2
+{
+	vec2 i = {1.f, 0.f};
+	vec2 j = {0.f, 1.f};
+	vec2 t = vec2::ZERO;
+
+	affine2() = default;
+	affine2(const vec2& i, const vec2& j, const vec2& t)
+		: i(i), j(j), t(t)
+	{}
+
+	NODISCARD vec2 transform_vector(const vec2& v) const	{ return i * v.x + j * v.y; }
+	NODISCARD vec2 transform_point(const vec2& p) const	{ return i * p.x + j * p.y + t; }
+	// (*this * rhs).transform_point(p) == transform_point(rhs.transform_point(p))
+	affine2 operator * (const affine2& rhs) const
+	{
+		return {transform_vector(rhs.i), transform_vector(rhs.j), transform_point(rhs.t)};
+	}
+	NODISCARD mat4 to_mat4() const { return mat4(i, j, t); }
+};
+
+// Translation, rotation and scale, applied as scale -> rotate -> translate
+struct transform2
+{
+	vec2	position = vec2::ZERO;
+	float32	rotation_deg = 0.f;
+	vec2	scale = vec2::ONE;
+
+	transform2() = default;
+	transform2(const vec2& position, float32 rotation_deg = 0.f, const vec2& scale = vec2::ONE)
+		: position(position), rotation_deg(rotation_deg), scale(scale)
+	{}
+
+	NODISCARD affine2 to_affine2() const
+	{
+		float32 s, c;
+		sincos_deg(rotation_deg, s, c);
+		return {vec2(c, s) * scale.x, vec2(-s, c) * scale.y, position};
+	}
+};
+}
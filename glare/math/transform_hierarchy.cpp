@@ -0,0 +1,241 @@
+#include "glare/math/transform_hierarchy.h"
+#include "glare/core/assert.h"
+#include "glare/core/job.h"
+#include <algorithm>
+
+namespace glare
+{
+transform_handle transform_hierarchy::create(const transform2& local, transform_handle parent)
+{
+	transform_handle created;
+	if (m_free_handles.empty()) {
+		created.index = static_cast<uint32>(m_slot_of_handle.size());
+		m_slot_of_handle.push_back(UINT32_MAX);
+		m_generation.push_back(0);
+	} else {
+		created.index = m_free_handles.back();
+		m_free_handles.pop_back();
+	}
+	created.generation = m_generation[created.index];
+
+	const uint32 slot = static_cast<uint32>(m_local.size());
+	m_slot_of_handle[created.index] = slot;
+	m_handle_of_slot.push_back(created.index);
+	m_parent.push_back(parent.is_null() ? NO_PARENT : get_slot(parent));
+	m_local.push_back(local);
+	m_world.emplace_back();
+	m_dirty.push_back(1);
+	m_alive.push_back(1);
+	m_any_dirty = true;
+	m_order_dirty = true;
+	return created;
+}
+
+void transform_hierarchy::destroy(transform_handle node)
+{
+	if (!is_valid(node)) {
+		ALERT("Destroying an invalid transform handle");
+		return;
+	}
+	// Slot and handle index are recycled by rebuild_order()
+	m_alive[get_slot(node)] = 0;
+	++m_generation[node.index];
+	m_order_dirty = true;
+}
+
+bool transform_hierarchy::set_parent(transform_handle node, transform_handle parent)
+{
+	const uint32 slot = get_slot(node);
+	uint32 parent_slot = NO_PARENT;
+	if (!parent.is_null()) {
+		parent_slot = get_slot(parent);
+		for (uint32 ancestor = parent_slot; ancestor != NO_PARENT; ancestor = m_parent[ancestor]) {
+			if (ancestor == slot) {
+				return false;
+			}
+		}
+	}
+	m_parent[slot] = parent_slot;
+	mark_dirty(slot);
+	m_order_dirty = true;
+	return true;
+}
+
+bool transform_hierarchy::is_valid(transform_handle node) const
+{
+	if (node.index >= m_slot_of_handle.size() || m_generation[node.index] != node.generation) {
+		return false;
+	}
+	const uint32 slot = m_slot_of_handle[node.index];
+	return slot != UINT32_MAX && m_alive[slot];
+}
+
+void transform_hierarchy::set_local(transform_handle node, const transform2& local)
+{
+	const uint32 slot = get_slot(node);
+	m_local[slot] = local;
+	mark_dirty(slot);
+}
+
+void transform_hierarchy::set_position(transform_handle node, const vec2& position)
+{
+	const uint32 slot = get_slot(node);
+	m_local[slot].position = position;
+	mark_dirty(slot);
+}
+
+void transform_hierarchy::set_rotation(transform_handle node, float32 rotation_deg)
+{
+	const uint32 slot = get_slot(node);
+	m_local[slot].rotation_deg = rotation_deg;
+	mark_dirty(slot);
+}
+
+void transform_hierarchy::set_scale(transform_handle node, const vec2& scale)
+{
+	const uint32 slot = get_slot(node);
+	m_local[slot].scale = scale;
+	mark_dirty(slot);
+}
+
+void transform_hierarchy::update()
+{
+	if (m_order_dirty) {
+		rebuild_order();
+	}
+	if (!m_any_dirty) {
+		return;
+	}
+	// Parents live in lower levels, so a level only reads finished results
+	const size_t num_levels = m_level_begin.empty() ? 0 : m_level_begin.size() - 1;
+	for (size_t level = 0; level < num_levels; ++level) {
+		const size_t begin = m_level_begin[level];
+		const size_t end = m_level_begin[level + 1];
+		if (end - begin >= PARALLEL_LEVEL_SIZE && job_system::is_running()) {
+			job_system::parallel_for(end - begin, PARALLEL_GRAIN, [this, begin](size_t first, size_t last) {
+				update_range(begin + first, begin + last);
+			});
+		} else {
+			update_range(begin, end);
+		}
+	}
+	std::fill(std::begin(m_dirty), std::end(m_dirty), static_cast<uint8>(0));
+	m_any_dirty = false;
+}
+
+uint32 transform_hierarchy::get_slot(transform_handle node) const
+{
+#if defined(GLARE_DEBUG)
+	ASSERT(is_valid(node), "Invalid transform handle");
+#endif
+	return m_slot_of_handle[node.index];
+}
+
+void transform_hierarchy::mark_dirty(uint32 slot)
+{
+	m_dirty[slot] = 1;
+	m_any_dirty = true;
+}
+
+void transform_hierarchy::update_range(size_t begin, size_t end)
+{
+	for (size_t slot = begin; slot < end; ++slot) {
+		const uint32 parent = m_parent[slot];
+		const bool parent_dirty = parent != NO_PARENT && m_dirty[parent];
+		if (!m_dirty[slot] && !parent_dirty) {
+			continue;
+		}
+		m_dirty[slot] = 1; // propagate to children in the next level
+		const affine2 local = m_local[slot].to_affine2();
+		m_world[slot] = parent == NO_PARENT ? local : m_world[parent] * local;
+	}
+}
+
+void transform_hierarchy::rebuild_order()
+{
+	const uint32 count = static_cast<uint32>(m_local.size());
+
+	// Children of each slot, compressed into one array
+	std::vector<uint32> child_begin(static_cast<size_t>(count) + 1u, 0u);
+	for (uint32 slot = 0; slot < count; ++slot) {
+		if (m_alive[slot] && m_parent[slot] != NO_PARENT) {
+			++child_begin[m_parent[slot] + 1u];
+		}
+	}
+	for (uint32 slot = 0; slot < count; ++slot) {
+		child_begin[slot + 1u] += child_begin[slot];
+	}
+	std::vector<uint32> children(child_begin[count]);
+	{
+		std::vector<uint32> cursor(child_begin.begin(), child_begin.end() - 1);
+		for (uint32 slot = 0; slot < count; ++slot) {
+			if (m_alive[slot] && m_parent[slot] != NO_PARENT) {
+				children[cursor[m_parent[slot]]++] = slot;
+			}
+		}
+	}
+
+	// Breadth first from the roots gives the depth order.
+	// Nodes under a destroyed parent are never reached and die with it.
+	std::vector<uint32> order;
+	order.reserve(count);
+	m_level_begin.clear();
+	m_level_begin.push_back(0);
+	for (uint32 slot = 0; slot < count; ++slot) {
+		if (m_alive[slot] && m_parent[slot] == NO_PARENT) {
+			order.push_back(slot);
+		}
+	}
+	m_level_begin.push_back(static_cast<uint32>(order.size()));
+	while (m_level_begin[m_level_begin.size() - 2] < m_level_begin.back()) {
+		const uint32 begin = m_level_begin[m_level_begin.size() - 2];
+		const uint32 end = m_level_begin.back();
+		for (uint32 i = begin; i < end; ++i) {
+			const uint32 slot = order[i];
+			for (uint32 c = child_begin[slot]; c < child_begin[slot + 1u]; ++c) {
+				order.push_back(children[c]);
+			}
+		}
+		m_level_begin.push_back(static_cast<uint32>(order.size()));
+	}
+	m_level_begin.pop_back();
+
+	std::vector<uint32> new_slot(count, UINT32_MAX);
+	for (uint32 i = 0; i < static_cast<uint32>(order.size()); ++i) {
+		new_slot[order[i]] = i;
+	}
+	for (uint32 slot = 0; slot < count; ++slot) {
+		if (new_slot[slot] == UINT32_MAX) {
+			const uint32 handle_index = m_handle_of_slot[slot];
+			if (m_alive[slot]) {
+				++m_generation[handle_index]; // died with an ancestor
+			}
+			m_slot_of_handle[handle_index] = UINT32_MAX;
+			m_free_handles.push_back(handle_index);
+		}
+	}
+
+	const size_t new_count = order.size();
+	std::vector<uint32>		handle_of_slot(new_count);
+	std::vector<uint32>		parent(new_count);
+	std::vector<transform2>	local(new_count);
+	std::vector<affine2>	world(new_count);
+	std::vector<uint8>		dirty(new_count);
+	for (size_t i = 0; i < new_count; ++i) {
+		const uint32 old = order[i];
+		handle_of_slot[i] = m_handle_of_slot[old];
+		parent[i] = m_parent[old] == NO_PARENT ? NO_PARENT : new_slot[m_parent[old]];
+		local[i] = m_local[old];
+		world[i] = m_world[old];
+		dirty[i] = m_dirty[old];
+		m_slot_of_handle[handle_of_slot[i]] = static_cast<uint32>(i);
+	}
+	m_handle_of_slot.swap(handle_of_slot);
+	m_parent.swap(parent);
+	m_local.swap(local);
+	m_world.swap(world);
+	m_dirty.swap(dirty);
+	m_alive.assign(new_count, 1);
+	m_order_dirty = false;
+}
+}
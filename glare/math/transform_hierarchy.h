@@ -0,0 +1,88 @@
+/// glare/math/transform_hierarchy.h
+///
+/// Parent/child 2D transforms stored as parallel arrays sorted by depth, so
+/// every parent sits before its children and update() is one forward sweep
+/// per depth level. Nodes are addressed through transform_handle, which
+/// stays valid while the arrays get re-sorted.
+///
+/// World transforms are cached, and only nodes whose local transform changed
+/// (and their descendants) are recomputed on update(). Levels wider than
+/// PARALLEL_LEVEL_SIZE are split over job_system.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/transform2.h"
+#include <vector>
+
+namespace glare
+{
+struct transform_handle
+{
+	uint32 index = UINT32_MAX;
+	uint32 generation = 0;
+
+	NODISCARD bool is_null() const { return index == UINT32_MAX; }
+	bool operator == (const transform_handle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+	bool operator != (const transform_handle& rhs) const { return !(*this == rhs); }
+};
+
+class transform_hierarchy
+{
+public:
+	static constexpr uint32 NO_PARENT = UINT32_MAX;
+	static constexpr size_t PARALLEL_LEVEL_SIZE = 4096;
+	static constexpr size_t PARALLEL_GRAIN = 1024;
+public:
+	transform_hierarchy() = default;
+
+	transform_handle create(const transform2& local = transform2(), transform_handle parent = transform_handle());
+	// Destroys the node, its descendants go away on the next update()
+	void destroy(transform_handle node);
+	// A null parent makes the node a root. Re-parenting under a descendant is refused.
+	bool set_parent(transform_handle node, transform_handle parent);
+	NODISCARD bool is_valid(transform_handle node) const;
+	NODISCARD size_t size() const { return m_local.size(); }
+
+	// Local
+	NODISCARD const transform2& get_local(transform_handle node) const { return m_local[get_slot(node)]; }
+	void set_local(transform_handle node, const transform2& local);
+	void set_position(transform_handle node, const vec2& position);
+	void set_rotation(transform_handle node, float32 rotation_deg);
+	void set_scale(transform_handle node, const vec2& scale);
+
+	// World, valid as of the last update()
+	NODISCARD const affine2& get_world(transform_handle node) const { return m_world[get_slot(node)]; }
+	NODISCARD mat4 get_world_mat4(transform_handle node) const { return get_world(node).to_mat4(); }
+
+	void update();
+
+	// Dense access for systems walking every node, e.g. rendering.
+	// Slots change when update() re-sorts after create/destroy/set_parent.
+	NODISCARD uint32 get_slot(transform_handle node) const;
+	NODISCARD const affine2* get_world_array() const { return m_world.data(); }
+
+private:
+	void mark_dirty(uint32 slot);
+	void rebuild_order();
+	void update_range(size_t begin, size_t end);
+
+public:
+	// Sparse, indexed by transform_handle::index
+	std::vector<uint32>	m_slot_of_handle;
+	std::vector<uint32>	m_generation;
+	std::vector<uint32>	m_free_handles;
+
+	// Dense, indexed by slot, sorted by depth after update()
+	std::vector<uint32>		m_handle_of_slot;
+	std::vector<uint32>		m_parent;		// parent slot or NO_PARENT
+	std::vector<transform2>	m_local;
+	std::vector<affine2>	m_world;
+	std::vector<uint8>		m_dirty;		// uint8 rather than vector<bool>, written from several threads
+	std::vector<uint8>		m_alive;
+
+	// Level d owns slots [m_level_begin[d], m_level_begin[d + 1])
+	std::vector<uint32>	m_level_begin;
+	bool	m_order_dirty = false;
+	bool	m_any_dirty = false;
+};
+}
@@ -0,0 +1,79 @@
+#include "glare/math/utilities.h"
+#include "glare/math/simd.h"
+
+namespace glare
+{
+#if defined(GLARE_SIMD_SSE2)
+static simd::float4 _test_bit(const simd::float4& integral, int32 bit)
+{
+	const __m128i bit_mask = _mm_set1_epi32(1 << bit);
+	const __m128i masked = _mm_and_si128(_mm_cvtps_epi32(integral.v), bit_mask);
+	return _mm_castsi128_ps(_mm_cmpeq_epi32(masked, bit_mask));
+}
+#endif
+
+#if defined(GLARE_SIMD_AVX2)
+static simd::float8 _test_bit(const simd::float8& integral, int32 bit)
+{
+	const __m256i bit_mask = _mm256_set1_epi32(1 << bit);
+	const __m256i masked = _mm256_and_si256(_mm256_cvtps_epi32(integral.v), bit_mask);
+	return _mm256_castsi256_ps(_mm256_cmpeq_epi32(masked, bit_mask));
+}
+#endif
+
+// Lane-wise twin of sincos(TRIG_FAST), see math/utilities.h.
+// Return: false, with nothing written, when a lane is past TRIG_FAST_MAX_RADIAN
+template<typename V>
+static bool _sincos_fast_lanes(const float32* radians, float32* out_sin, float32* out_cos)
+{
+	const V x = V::load(radians);
+	if (simd::movemask(simd::abs(x) > V(TRIG_FAST_MAX_RADIAN))) {
+		return false;
+	}
+	const V k = simd::round(x * V(2.f / PI));
+	const V r = ((x - k * V(1.5703125f)) - k * V(4.837512969970703125e-4f)) - k * V(7.549789948768648e-8f);
+	const V z = r * r;
+	const V s = r + r * z * (V(-1.6666654611e-1f) + z * (V(8.3321608736e-3f) + z * V(-1.9515295891e-4f)));
+	const V c = V(1.f) - V(0.5f) * z
+		+ z * z * (V(4.166664568298827e-2f) + z * (V(-1.388731625493765e-3f) + z * V(2.443315711809948e-5f)));
+	const V swap = _test_bit(k, 0);
+	const V sin_negative = _test_bit(k, 1);
+	const V cos_negative = _test_bit(k + V(1.f), 1);
+	const V sign_bit(-0.f);
+	(simd::select(swap, c, s) ^ (sin_negative & sign_bit)).store(out_sin);
+	(simd::select(swap, s, c) ^ (cos_negative & sign_bit)).store(out_cos);
+	return true;
+}
+
+static void _sincos_each(const float32* radians, float32* out_sin, float32* out_cos, size_t begin, size_t end, e_trig_precision precision)
+{
+	for (size_t i = begin; i < end; ++i) {
+		float32 s, c;
+		sincos(radians[i], s, c, precision);
+		out_sin[i] = s;
+		out_cos[i] = c;
+	}
+}
+
+void sincos(const float32* radians, float32* out_sin, float32* out_cos, size_t count, e_trig_precision precision)
+{
+	size_t i = 0;
+	if (precision == TRIG_FAST) {
+#if defined(GLARE_SIMD_AVX2)
+		for (; i + simd::float8::WIDTH <= count; i += simd::float8::WIDTH) {
+			if (!_sincos_fast_lanes<simd::float8>(radians + i, out_sin + i, out_cos + i)) {
+				_sincos_each(radians, out_sin, out_cos, i, i + simd::float8::WIDTH, precision);
+			}
+		}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+		for (; i + simd::float4::WIDTH <= count; i += simd::float4::WIDTH) {
+			if (!_sincos_fast_lanes<simd::float4>(radians + i, out_sin + i, out_cos + i)) {
+				_sincos_each(radians, out_sin, out_cos, i, i + simd::float4::WIDTH, precision);
+			}
+		}
+#endif
+	}
+	_sincos_each(radians, out_sin, out_cos, i, count, precision);
+}
+}
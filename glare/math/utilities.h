@@ -1,5 +1,6 @@
 #pragma once
 #include "glare/core/common.h"
+#include <cmath>
 
 namespace glare
 {
@@ -35,7 +36,88 @@ constexpr decltype(auto) lerp(const T& a, const T& b, const P alpha)
 inline float32 rtd(float32 rad) { return rad / PI * 180.f; }
 inline float32 dtr(float32 deg) { return deg / 180.f * PI; }
 
-inline float32 cos_deg(float32 deg) { return cosf(dtr(deg)); }
-inline float32 sin_deg(float32 deg) { return sinf(dtr(deg)); }
+//////////////////////////////////////////////////////////////////////////
+// sin/cos
+//
+// TRIG_EXACT goes to the CRT sinf/cosf.
+// TRIG_FAST reduces the angle to [-pi/4, pi/4] around the nearest multiple of
+// pi/2 and evaluates minimax polynomials (cephes sinf/cosf coefficients).
+// Max absolute error is 1.2e-7 for |radian| <= TRIG_FAST_MAX_RADIAN; past
+// that the float reduction would lose bits (and the quadrant overflow int32),
+// so larger and non finite angles go to the CRT as well. The degree versions
+// reduce in degrees first, so multiples of 90 give exact 0/1/-1.
+enum e_trig_precision
+{
+	TRIG_EXACT,
+	TRIG_FAST
+};
+
+constexpr e_trig_precision TRIG_DEFAULT_PRECISION = GLARE_FAST_TRIG ? TRIG_FAST : TRIG_EXACT;
+constexpr float32 TRIG_FAST_MAX_RADIAN = 8192.f;
+
+// Minimax polynomials on [-pi/4, pi/4], then quadrant fix-up.
+inline void _sincos_reduced(float32 r, int32 quadrant, float32& out_sin, float32& out_cos)
+{
+	const float32 z = r * r;
+	const float32 s = r + r * z * (-1.6666654611e-1f + z * (8.3321608736e-3f + z * -1.9515295891e-4f));
+	const float32 c = 1.f - 0.5f * z + z * z * (4.166664568298827e-2f + z * (-1.388731625493765e-3f + z * 2.443315711809948e-5f));
+	// branchless, the quadrant of arbitrary angles is not predictable;
+	// one of each pair of products is exactly 0, so the select is exact
+	const float32 swap = static_cast<float32>(quadrant & 1);
+	const float32 keep = 1.f - swap;
+	const float32 sin_sign = 1.f - static_cast<float32>(quadrant & 2);
+	const float32 cos_sign = 1.f - static_cast<float32>((quadrant + 1) & 2);
+	out_sin = (keep * s + swap * c) * sin_sign;
+	out_cos = (keep * c + swap * s) * cos_sign;
+}
+
+inline void sincos(float32 radian, float32& out_sin, float32& out_cos, e_trig_precision precision=TRIG_DEFAULT_PRECISION)
+{
+	if (precision == TRIG_EXACT || !(fabsf(radian) <= TRIG_FAST_MAX_RADIAN)) {
+		out_sin = sinf(radian);
+		out_cos = cosf(radian);
+		return;
+	}
+	const float32 k = nearbyintf(radian * (2.f / PI));
+	// Cody-Waite: pi/2 split in 3 parts so k * part is exact
+	const float32 r = ((radian - k * 1.5703125f) - k * 4.837512969970703125e-4f) - k * 7.549789948768648e-8f;
+	_sincos_reduced(r, static_cast<int32>(k), out_sin, out_cos);
+}
+
+inline void sincos_deg(float32 degree, float32& out_sin, float32& out_cos, e_trig_precision precision=TRIG_DEFAULT_PRECISION)
+{
+	if (precision == TRIG_EXACT) {
+		sincos(dtr(degree), out_sin, out_cos, TRIG_EXACT);
+		return;
+	}
+	const float32 k = nearbyintf(degree * (1.f / 90.f));
+	const float32 r = dtr(degree - k * 90.f);
+	_sincos_reduced(r, static_cast<int32>(fmodf(k, 4.f)), out_sin, out_cos);
+}
+
+inline float32 cos_deg(float32 deg)
+{
+	if (TRIG_DEFAULT_PRECISION == TRIG_EXACT) {
+		return cosf(dtr(deg));
+	}
+	float32 s, c;
+	sincos_deg(deg, s, c, TRIG_FAST);
+	return c;
+}
+
+inline float32 sin_deg(float32 deg)
+{
+	if (TRIG_DEFAULT_PRECISION == TRIG_EXACT) {
+		return sinf(dtr(deg));
+	}
+	float32 s, c;
+	sincos_deg(deg, s, c, TRIG_FAST);
+	return s;
+}
+
+// Batch version, 8/4 lanes at a time when AVX2/SSE2 is available.
+// <out_sin> and <out_cos> hold <count> elements and may alias <radians>.
+// TRIG_EXACT runs the CRT one element at a time.
+void sincos(const float32* radians, float32* out_sin, float32* out_cos, size_t count, e_trig_precision precision=TRIG_DEFAULT_PRECISION);
 
 };
\ No newline at end of file
@@ -58,8 +58,8 @@ void vec2::rotate_90_deg(int32 positive/*=1*/)
 
 void vec2::rotate(float32 radian)
 {
-	const float cc = cos(radian);
-	const float ss = sin(radian);
+	float cc, ss;
+	sincos(radian, ss, cc);
 	const float new_x = cc * x - ss * y;
 	const float new_y = ss * x + cc * y;
 	x = new_x;
@@ -0,0 +1,200 @@
+#include "glare/physics/contact.h"
+#include <cfloat>
+#include <cmath>
+
+namespace glare
+{
+// Face k of a box: 0: +right, 1: +up, 2: -right, 3: -up
+static vec2 _face_normal(const obb2& box, int32 face)
+{
+	const vec2 axis = (face & 1) ? box.up() : box.right;
+	return face >= 2 ? axis * -1.f : axis;
+}
+
+static float32 _face_extent(const obb2& box, int32 face)
+{
+	return (face & 1) ? box.extends.y : box.extends.x;
+}
+
+static float32 _side_extent(const obb2& box, int32 face)
+{
+	return (face & 1) ? box.extends.x : box.extends.y;
+}
+
+// Max separation of <other> from the faces of <box>, outputs the face index
+static float32 _max_face_separation(const obb2& box, const obb2& other, int32& out_face)
+{
+	const vec2 displacement = other.center - box.center;
+	const vec2 other_up = other.up();
+	float32 best = -FLT_MAX;
+	for (int32 k = 0; k < 2; ++k) {
+		const vec2 axis = k ? box.up() : box.right;
+		const float32 distance = displacement.dot(axis);
+		const float32 other_radius =
+			other.extends.x * fabsf(other.right.dot(axis)) + other.extends.y * fabsf(other_up.dot(axis));
+		const float32 separation = fabsf(distance) - _face_extent(box, k) - other_radius;
+		if (separation > best) {
+			best = separation;
+			out_face = distance >= 0.f ? k : k + 2;
+		}
+	}
+	return best;
+}
+
+struct _clip_vertex
+{
+	vec2 position;
+	uint32 id = 0;
+};
+
+// Keeps the part of segment v[0]-v[1] with dot(normal, v) <= offset
+static int32 _clip_segment(const _clip_vertex in[2], _clip_vertex out[2], const vec2& normal, float32 offset, uint32 clip_id)
+{
+	int32 count = 0;
+	const float32 distance0 = normal.dot(in[0].position) - offset;
+	const float32 distance1 = normal.dot(in[1].position) - offset;
+	if (distance0 <= 0.f) {
+		out[count++] = in[0];
+	}
+	if (distance1 <= 0.f) {
+		out[count++] = in[1];
+	}
+	if (distance0 * distance1 < 0.f) {
+		const float32 t = distance0 / (distance0 - distance1);
+		out[count].position = in[0].position + (in[1].position - in[0].position) * t;
+		out[count].id = clip_id;
+		++count;
+	}
+	return count;
+}
+
+bool contact::collide_disks(const vec2& center_a, float32 radius_a, const vec2& center_b, float32 radius_b, contact_manifold& out)
+{
+	const vec2 displacement = center_b - center_a;
+	const float32 radius_sum = radius_a + radius_b;
+	const float32 reach = radius_sum + SPECULATIVE_DISTANCE;
+	const float32 distance_square = displacement.length_square();
+	if (distance_square > reach * reach) {
+		return false;
+	}
+	const float32 distance = sqrtf(distance_square);
+	out.normal = distance > 1e-6f ? displacement / distance : vec2(0.f, 1.f);
+	const vec2 surface_a = center_a + out.normal * radius_a;
+	const vec2 surface_b = center_b - out.normal * radius_b;
+	out.point_count = 1;
+	out.points[0].position = (surface_a + surface_b) * 0.5f;
+	out.points[0].separation = distance - radius_sum;
+	out.points[0].feature_id = 0;
+	return true;
+}
+
+bool contact::collide_box_disk(const obb2& box_a, const vec2& center_b, float32 radius_b, contact_manifold& out)
+{
+	const vec2 local = box_a.world_to_local(center_b);
+	vec2 clamped(clamp(local.x, -box_a.extends.x, box_a.extends.x), clamp(local.y, -box_a.extends.y, box_a.extends.y));
+	vec2 local_normal;
+	float32 separation;
+	if (clamped == local) {
+		// Center inside the box, push out through the nearest face
+		const float32 gap_x = box_a.extends.x - fabsf(local.x);
+		const float32 gap_y = box_a.extends.y - fabsf(local.y);
+		if (gap_x < gap_y) {
+			local_normal = {local.x >= 0.f ? 1.f : -1.f, 0.f};
+			clamped.x = local_normal.x * box_a.extends.x;
+			separation = -gap_x - radius_b;
+		} else {
+			local_normal = {0.f, local.y >= 0.f ? 1.f : -1.f};
+			clamped.y = local_normal.y * box_a.extends.y;
+			separation = -gap_y - radius_b;
+		}
+	} else {
+		const vec2 difference = local - clamped;
+		const float32 distance = difference.length();
+		if (distance > radius_b + SPECULATIVE_DISTANCE) {
+			return false;
+		}
+		local_normal = difference / distance;
+		separation = distance - radius_b;
+	}
+	out.normal = box_a.right * local_normal.x + box_a.up() * local_normal.y;
+	const vec2 surface_a = box_a.local_to_world(clamped);
+	const vec2 surface_b = center_b - out.normal * radius_b;
+	out.point_count = 1;
+	out.points[0].position = (surface_a + surface_b) * 0.5f;
+	out.points[0].separation = separation;
+	out.points[0].feature_id = 0;
+	return true;
+}
+
+bool contact::collide_boxes(const obb2& box_a, const obb2& box_b, contact_manifold& out)
+{
+	int32 face_a = 0;
+	int32 face_b = 0;
+	const float32 separation_a = _max_face_separation(box_a, box_b, face_a);
+	if (separation_a > SPECULATIVE_DISTANCE) {
+		return false;
+	}
+	const float32 separation_b = _max_face_separation(box_b, box_a, face_b);
+	if (separation_b > SPECULATIVE_DISTANCE) {
+		return false;
+	}
+
+	// Prefer faces of a, so the reference face does not flip between steps
+	const bool flip = separation_b > 0.95f * separation_a + 0.005f;
+	const obb2& reference = flip ? box_b : box_a;
+	const obb2& incident = flip ? box_a : box_b;
+	const int32 reference_face = flip ? face_b : face_a;
+	const vec2 normal = _face_normal(reference, reference_face);
+
+	// Incident face is the one most anti-parallel to the reference normal
+	int32 incident_face = 0;
+	float32 min_dot = FLT_MAX;
+	for (int32 k = 0; k < 4; ++k) {
+		const float32 d = _face_normal(incident, k).dot(normal);
+		if (d < min_dot) {
+			min_dot = d;
+			incident_face = k;
+		}
+	}
+	const vec2 incident_normal = _face_normal(incident, incident_face);
+	const vec2 incident_tangent = incident_normal.ratated_90_deg();
+	const vec2 incident_center = incident.center + incident_normal * _face_extent(incident, incident_face);
+	const float32 incident_side = _side_extent(incident, incident_face);
+	_clip_vertex incident_edge[2];
+	incident_edge[0].position = incident_center + incident_tangent * incident_side;
+	incident_edge[0].id = 0;
+	incident_edge[1].position = incident_center - incident_tangent * incident_side;
+	incident_edge[1].id = 1;
+
+	// Clip against the 2 side planes of the reference face
+	const vec2 tangent = normal.ratated_90_deg();
+	const float32 center_on_tangent = tangent.dot(reference.center);
+	const float32 side = _side_extent(reference, reference_face);
+	_clip_vertex clipped1[2];
+	_clip_vertex clipped2[2];
+	if (_clip_segment(incident_edge, clipped1, tangent, center_on_tangent + side, 2) < 2) {
+		return false;
+	}
+	if (_clip_segment(clipped1, clipped2, tangent * -1.f, side - center_on_tangent, 3) < 2) {
+		return false;
+	}
+
+	const float32 face_offset = normal.dot(reference.center) + _face_extent(reference, reference_face);
+	const uint32 feature_base =
+		(flip ? 1u << 12u : 0u) | (static_cast<uint32>(reference_face) << 8u) | (static_cast<uint32>(incident_face) << 4u);
+	out.normal = flip ? normal * -1.f : normal;
+	out.point_count = 0;
+	for (const _clip_vertex& each : clipped2) {
+		const float32 separation = normal.dot(each.position) - face_offset;
+		if (separation <= SPECULATIVE_DISTANCE) {
+			contact_point& point = out.points[out.point_count++];
+			point.position = each.position - normal * (separation * 0.5f);
+			point.separation = separation;
+			point.feature_id = feature_base | each.id;
+			point.normal_impulse = 0.f;
+			point.tangent_impulse = 0.f;
+		}
+	}
+	return out.point_count > 0;
+}
+}
@@ -0,0 +1,43 @@
+/// glare/physics/contact.h
+/// Narrow phase between the physics shapes.
+///
+/// Every function outputs a manifold whose normal points from shape a to
+/// shape b, with up to 2 points. Separation is negative when penetrating.
+/// feature_id identifies the pair of features (faces/vertices) that produced
+/// a point, so contacts can be matched between steps for warm starting.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/obb2.h"
+
+namespace glare
+{
+struct contact_point
+{
+	vec2	position;
+	float32	separation = 0.f;
+	uint32	feature_id = 0;
+	// accumulated impulses, kept across steps for warm starting
+	float32	normal_impulse = 0.f;
+	float32	tangent_impulse = 0.f;
+};
+
+struct contact_manifold
+{
+	uint32	body_a = 0;
+	uint32	body_b = 0;
+	vec2	normal;
+	int32	point_count = 0;
+	contact_point points[2];
+};
+
+namespace contact
+{
+	// Points closer than this are still reported, which keeps resting contacts stable
+	constexpr float32 SPECULATIVE_DISTANCE = 0.02f;
+
+	bool collide_disks(const vec2& center_a, float32 radius_a, const vec2& center_b, float32 radius_b, contact_manifold& out);
+	bool collide_box_disk(const obb2& box_a, const vec2& center_b, float32 radius_b, contact_manifold& out);
+	bool collide_boxes(const obb2& box_a, const obb2& box_b, contact_manifold& out);
+}
+}
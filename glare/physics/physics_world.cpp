@@ -0,0 +1,724 @@
+#include "glare/physics/physics_world.h"
+#include "glare/core/assert.h"
+#include "glare/core/clock.h"
+#include "glare/core/job.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace glare
+{
+static constexpr float32 BAUMGARTE				= 0.2f;
+static constexpr float32 LINEAR_SLOP			= 0.005f;
+static constexpr float32 RESTITUTION_THRESHOLD	= 1.f;	// slower impacts don't bounce
+static constexpr size_t	 COLLIDE_GRAIN			= 256;
+
+static uint64 _pair_key(uint32 a, uint32 b)
+{
+	return (static_cast<uint64>(a) << 32u) | static_cast<uint64>(b);
+}
+
+// Velocity of <r> rotating at <w> radian per second, i.e. w x r
+static vec2 _cross(float32 w, const vec2& r)
+{
+	return {-w * r.y, w * r.x};
+}
+
+physics_world::physics_world(clock* parent)
+	: m_clock(new clock(parent))
+{
+}
+
+physics_world::~physics_world()
+{
+	// The parent clock deletes its garbage children on its next step
+	if (m_clock->m_parent) {
+		m_clock->m_garbage = true;
+	} else {
+		delete m_clock;
+	}
+}
+
+body_handle physics_world::create_body(const body_desc& desc)
+{
+	body_handle created;
+	if (m_free_bodies.empty()) {
+		created.index = static_cast<uint32>(m_position.size());
+		const size_t count = m_position.size() + 1u;
+		m_position.resize(count);
+		m_prev_position.resize(count);
+		m_angle.resize(count);
+		m_prev_angle.resize(count);
+		m_sin.resize(count);
+		m_cos.resize(count);
+		m_velocity.resize(count);
+		m_angular_velocity.resize(count);
+		m_inv_mass.resize(count);
+		m_inv_inertia.resize(count);
+		m_friction.resize(count);
+		m_restitution.resize(count);
+		m_extends.resize(count);
+		m_bounds.resize(count);
+		m_sleep_time.resize(count);
+		m_shape.resize(count);
+		m_type.resize(count);
+		m_awake.resize(count);
+		m_alive.resize(count);
+		m_generation.push_back(0);
+		m_sweep_order.push_back(created.index);
+	} else {
+		created.index = m_free_bodies.back();
+		m_free_bodies.pop_back();
+	}
+	created.generation = m_generation[created.index];
+
+	const uint32 i = created.index;
+	const float32 angle = dtr(desc.rotation_deg);
+	m_position[i] = desc.position;
+	m_prev_position[i] = desc.position;
+	m_angle[i] = angle;
+	m_prev_angle[i] = angle;
+	sincos(angle, m_sin[i], m_cos[i]);
+	m_velocity[i] = desc.velocity;
+	m_angular_velocity[i] = dtr(desc.angular_velocity_deg);
+	m_friction[i] = desc.friction;
+	m_restitution[i] = desc.restitution;
+	m_shape[i] = desc.shape;
+	m_type[i] = desc.type;
+	m_sleep_time[i] = 0.f;
+	m_alive[i] = 1;
+	m_awake[i] = desc.type == BODY_DYNAMIC ? 1 : 0;
+
+	float32 mass;
+	float32 inertia;
+	if (desc.shape == SHAPE_DISK) {
+		const float32 radius = desc.size.x * 0.5f;
+		m_extends[i] = {radius, radius};
+		mass = desc.density * PI * radius * radius;
+		inertia = 0.5f * mass * radius * radius;
+	} else {
+		m_extends[i] = desc.size * 0.5f;
+		mass = desc.density * desc.size.x * desc.size.y;
+		inertia = mass * desc.size.length_square() / 12.f;
+	}
+	const bool is_dynamic = desc.type == BODY_DYNAMIC && mass > 0.f;
+	m_inv_mass[i] = is_dynamic ? 1.f / mass : 0.f;
+	m_inv_inertia[i] = is_dynamic && inertia > 0.f ? 1.f / inertia : 0.f;
+	if (!is_dynamic) {
+		m_velocity[i] = vec2::ZERO;
+		m_angular_velocity[i] = 0.f;
+	}
+	// Queries see the body before the next step
+	update_bounds(i);
+	return created;
+}
+
+void physics_world::destroy_body(body_handle body)
+{
+	if (!is_valid(body)) {
+		ALERT("Destroying an invalid body handle");
+		return;
+	}
+	const uint32 index = body.index;
+	// Whatever rested on the body has to fall now. Its pairs go too, a body
+	// created into the same index must not warm start from its impulses
+	for (contact_manifold& each : m_prev_manifolds) {
+		if (each.body_a == index || each.body_b == index) {
+			const uint32 other = each.body_a == index ? each.body_b : each.body_a;
+			if (m_type[other] == BODY_DYNAMIC) {
+				m_awake[other] = 1;
+				m_sleep_time[other] = 0.f;
+			}
+			m_prev_manifold_of_pair.erase(_pair_key(each.body_a, each.body_b));
+			each.point_count = 0;
+		}
+	}
+	m_alive[index] = 0;
+	m_awake[index] = 0;
+	m_inv_mass[index] = 0.f;
+	m_inv_inertia[index] = 0.f;
+	++m_generation[index];
+	m_free_bodies.push_back(index);
+}
+
+bool physics_world::is_valid(body_handle body) const
+{
+	return body.index < m_alive.size() && m_alive[body.index] && m_generation[body.index] == body.generation;
+}
+
+obb2 physics_world::get_obb(body_handle body) const
+{
+	return get_obb_at(get_index(body));
+}
+
+vec2 physics_world::get_interpolated_position(body_handle body) const
+{
+	const uint32 i = get_index(body);
+	return m_prev_position[i] + (m_position[i] - m_prev_position[i]) * get_alpha();
+}
+
+float32 physics_world::get_interpolated_rotation_deg(body_handle body) const
+{
+	const uint32 i = get_index(body);
+	return rtd(m_prev_angle[i] + (m_angle[i] - m_prev_angle[i]) * get_alpha());
+}
+
+void physics_world::set_transform(body_handle body, const vec2& position, float32 rotation_deg)
+{
+	const uint32 i = get_index(body);
+	m_position[i] = position;
+	m_prev_position[i] = position;
+	m_angle[i] = dtr(rotation_deg);
+	m_prev_angle[i] = m_angle[i];
+	sincos(m_angle[i], m_sin[i], m_cos[i]);
+	update_bounds(i);
+	wake_up(body);
+}
+
+void physics_world::set_velocity(body_handle body, const vec2& velocity)
+{
+	const uint32 i = get_index(body);
+	if (m_type[i] == BODY_DYNAMIC) {
+		m_velocity[i] = velocity;
+		wake_up(body);
+	}
+}
+
+void physics_world::apply_impulse(body_handle body, const vec2& impulse, const vec2& world_point)
+{
+	const uint32 i = get_index(body);
+	if (m_type[i] == BODY_DYNAMIC) {
+		m_velocity[i] += impulse * m_inv_mass[i];
+		m_angular_velocity[i] += m_inv_inertia[i] * (world_point - m_position[i]).cross2(impulse);
+		wake_up(body);
+	}
+}
+
+void physics_world::wake_up(body_handle body)
+{
+	const uint32 i = get_index(body);
+	if (m_type[i] == BODY_DYNAMIC) {
+		m_awake[i] = 1;
+		m_sleep_time[i] = 0.f;
+	}
+}
+
+void physics_world::raycast(const ray2& ray, ray_query_visitor& visitor) const
+{
+	ray2 clipped = ray;
+	const size_t count = m_position.size();
+	for (size_t i = 0; i < count && clipped.max_distance > 0.f; ++i) {
+		raycast_hit hit;
+		if (m_alive[i] && glare::raycast(clipped, m_bounds[i], hit)) {
+			clipped.max_distance = visitor.visit(static_cast<uint32>(i), clipped);
+		}
+	}
+}
+
+body_handle physics_world::raycast_closest(const ray2& ray, raycast_hit& out_hit) const
+{
+	class closest_visitor : public ray_query_visitor
+	{
+	public:
+		explicit closest_visitor(const physics_world& world) : m_world(world) {}
+		float32 visit(uint32 id, const ray2& ray) override
+		{
+			raycast_hit hit;
+			const bool is_hit = m_world.m_shape[id] == SHAPE_DISK
+				? raycast_disk(ray, m_world.m_position[id], m_world.m_extends[id].x, hit)
+				: glare::raycast(ray, m_world.get_obb_at(id), hit);
+			if (!is_hit || hit.distance >= m_hit.distance) {
+				return ray.max_distance;
+			}
+			m_hit = hit;
+			m_hit.id = id;
+			return hit.distance;
+		}
+	public:
+		const physics_world& m_world;
+		raycast_hit m_hit;
+	};
+
+	closest_visitor visitor(*this);
+	raycast(ray, visitor);
+	out_hit = visitor.m_hit;
+	return out_hit.is_hit() ? get_body(out_hit.id) : body_handle();
+}
+
+void physics_world::update()
+{
+	m_accumulator += m_clock->get_frame_time();
+	m_stats.steps = 0;
+	while (m_accumulator >= FIXED_STEP && m_stats.steps < MAX_STEPS_PER_UPDATE) {
+		step(FIXED_STEP);
+		m_accumulator -= FIXED_STEP;
+		++m_stats.steps;
+	}
+	// Too slow to catch up, drop the time rather than spiral
+	if (m_accumulator >= FIXED_STEP) {
+		m_accumulator = fmodf(m_accumulator, FIXED_STEP);
+	}
+}
+
+void physics_world::step(float32 dt)
+{
+	const float64 start = get_current_time_seconds();
+	std::copy(std::begin(m_position), std::end(m_position), std::begin(m_prev_position));
+	std::copy(std::begin(m_angle), std::end(m_angle), std::begin(m_prev_angle));
+
+	integrate_velocities(dt);
+	refresh_bounds();
+	find_pairs();
+	collide();
+	build_islands();
+
+	const size_t num_islands = m_island_constraint_begin.empty() ? 0 : m_island_constraint_begin.size() - 1;
+	job_system::parallel_for(num_islands, PARALLEL_ISLAND_GRAIN, [this, dt](size_t begin, size_t end) {
+		for (size_t island = begin; island < end; ++island) {
+			solve_island(static_cast<uint32>(island), dt);
+		}
+	});
+
+	integrate_positions(dt);
+	refresh_rotations();
+	update_sleep(dt);
+
+	// Keep this step's manifolds for warm starting the next one
+	m_prev_manifold_of_pair.clear();
+	uint32 num_contacts = 0;
+	for (uint32 i = 0; i < static_cast<uint32>(m_manifolds.size()); ++i) {
+		m_prev_manifold_of_pair[_pair_key(m_manifolds[i].body_a, m_manifolds[i].body_b)] = i;
+		num_contacts += static_cast<uint32>(m_manifolds[i].point_count);
+	}
+	m_prev_manifolds.swap(m_manifolds);
+
+	uint32 awake = 0;
+	for (const uint8 each : m_awake) {
+		awake += each;
+	}
+	m_stats.step_ms = (get_current_time_seconds() - start) * 1000.0;
+	m_stats.bodies = static_cast<uint32>(size());
+	m_stats.awake_bodies = awake;
+	m_stats.bodies_per_ms = m_stats.step_ms > 0.0 ? awake / m_stats.step_ms : 0.0;
+	m_stats.pairs = static_cast<uint32>(m_pairs.size());
+	m_stats.contacts = num_contacts;
+	m_stats.islands = static_cast<uint32>(num_islands);
+}
+
+uint32 physics_world::get_index(body_handle body) const
+{
+#if defined(GLARE_DEBUG)
+	ASSERT(is_valid(body), "Invalid body handle");
+#endif
+	return body.index;
+}
+
+void physics_world::refresh_rotations()
+{
+	sincos(m_angle.data(), m_sin.data(), m_cos.data(), m_angle.size());
+}
+
+void physics_world::refresh_bounds()
+{
+	const uint32 count = static_cast<uint32>(m_position.size());
+	for (uint32 i = 0; i < count; ++i) {
+		update_bounds(i);
+	}
+}
+
+void physics_world::update_bounds(uint32 index)
+{
+	const vec2& extends = m_extends[index];
+	vec2 reach = extends;
+	if (m_shape[index] == SHAPE_BOX) {
+		const float32 c = fabsf(m_cos[index]);
+		const float32 s = fabsf(m_sin[index]);
+		reach = {c * extends.x + s * extends.y, s * extends.x + c * extends.y};
+	}
+	reach += vec2(contact::SPECULATIVE_DISTANCE, contact::SPECULATIVE_DISTANCE);
+	m_bounds[index] = {m_position[index] - reach, m_position[index] + reach};
+}
+
+void physics_world::integrate_velocities(float32 dt)
+{
+	const vec2 gravity_step = m_gravity * dt;
+	const size_t count = m_velocity.size();
+	for (size_t i = 0; i < count; ++i) {
+		if (m_awake[i]) {
+			m_velocity[i] += gravity_step;
+		}
+	}
+}
+
+void physics_world::find_pairs()
+{
+	// Bodies move little between steps, so insertion sort is close to linear
+	const size_t count = m_sweep_order.size();
+	for (size_t i = 1; i < count; ++i) {
+		const uint32 moving = m_sweep_order[i];
+		const float32 key = m_bounds[moving].min.x;
+		size_t j = i;
+		while (j > 0 && m_bounds[m_sweep_order[j - 1]].min.x > key) {
+			m_sweep_order[j] = m_sweep_order[j - 1];
+			--j;
+		}
+		m_sweep_order[j] = moving;
+	}
+
+	m_pairs.clear();
+	for (size_t i = 0; i < count; ++i) {
+		const uint32 a = m_sweep_order[i];
+		if (!m_alive[a]) {
+			continue;
+		}
+		const aabb2& bounds_a = m_bounds[a];
+		for (size_t j = i + 1; j < count; ++j) {
+			const uint32 b = m_sweep_order[j];
+			const aabb2& bounds_b = m_bounds[b];
+			if (bounds_b.min.x > bounds_a.max.x) {
+				break;
+			}
+			if (!m_alive[b] || (m_type[a] == BODY_STATIC && m_type[b] == BODY_STATIC)) {
+				continue;
+			}
+			if (bounds_b.min.y > bounds_a.max.y || bounds_a.min.y > bounds_b.max.y) {
+				continue;
+			}
+			m_pairs.push_back(a < b ? _pair_key(a, b) : _pair_key(b, a));
+		}
+	}
+}
+
+void physics_world::collide()
+{
+	m_manifolds.resize(m_pairs.size());
+	job_system::parallel_for(m_pairs.size(), COLLIDE_GRAIN, [this](size_t begin, size_t end) {
+		for (size_t p = begin; p < end; ++p) {
+			const uint64 key = m_pairs[p];
+			const uint32 a = static_cast<uint32>(key >> 32u);
+			const uint32 b = static_cast<uint32>(key);
+			contact_manifold& manifold = m_manifolds[p];
+			manifold.body_a = a;
+			manifold.body_b = b;
+			manifold.point_count = 0;
+
+			const auto found = m_prev_manifold_of_pair.find(key);
+			const contact_manifold* prev = found == m_prev_manifold_of_pair.end() ? nullptr : &m_prev_manifolds[found->second];
+			if (!m_awake[a] && !m_awake[b]) {
+				// Both asleep or static, keep the contact as it was
+				if (prev) {
+					manifold = *prev;
+				}
+				continue;
+			}
+
+			bool touching;
+			if (m_shape[a] == SHAPE_DISK && m_shape[b] == SHAPE_DISK) {
+				touching = contact::collide_disks(m_position[a], m_extends[a].x, m_position[b], m_extends[b].x, manifold);
+			} else if (m_shape[b] == SHAPE_DISK) {
+				touching = contact::collide_box_disk(get_obb_at(a), m_position[b], m_extends[b].x, manifold);
+			} else if (m_shape[a] == SHAPE_DISK) {
+				touching = contact::collide_box_disk(get_obb_at(b), m_position[a], m_extends[a].x, manifold);
+				manifold.normal = manifold.normal * -1.f;
+			} else {
+				touching = contact::collide_boxes(get_obb_at(a), get_obb_at(b), manifold);
+			}
+			if (!touching) {
+				manifold.point_count = 0;
+				continue;
+			}
+
+			for (int32 i = 0; i < manifold.point_count; ++i) {
+				contact_point& point = manifold.points[i];
+				point.normal_impulse = 0.f;
+				point.tangent_impulse = 0.f;
+				if (!prev) {
+					continue;
+				}
+				for (int32 k = 0; k < prev->point_count; ++k) {
+					if (prev->points[k].feature_id == point.feature_id) {
+						point.normal_impulse = prev->points[k].normal_impulse;
+						point.tangent_impulse = prev->points[k].tangent_impulse;
+						break;
+					}
+				}
+			}
+		}
+	});
+	m_manifolds.erase(
+		std::remove_if(std::begin(m_manifolds), std::end(m_manifolds), [](const contact_manifold& each) { return each.point_count == 0; }),
+		std::end(m_manifolds));
+}
+
+uint32 physics_world::find_root(uint32 index)
+{
+	while (m_island_parent[index] != index) {
+		m_island_parent[index] = m_island_parent[m_island_parent[index]];
+		index = m_island_parent[index];
+	}
+	return index;
+}
+
+void physics_world::build_islands()
+{
+	const uint32 count = static_cast<uint32>(m_position.size());
+	m_island_parent.resize(count);
+	for (uint32 i = 0; i < count; ++i) {
+		m_island_parent[i] = i;
+	}
+	// Static bodies never join, they would merge every island resting on the ground
+	for (const contact_manifold& each : m_manifolds) {
+		if (m_type[each.body_a] == BODY_DYNAMIC && m_type[each.body_b] == BODY_DYNAMIC) {
+			const uint32 root_a = find_root(each.body_a);
+			const uint32 root_b = find_root(each.body_b);
+			if (root_a != root_b) {
+				m_island_parent[root_a] = root_b;
+			}
+		}
+	}
+
+	// An island is awake if any of its bodies is, touching a sleeping island wakes it
+	m_island_of_root.assign(count, UINT32_MAX);
+	for (uint32 i = 0; i < count; ++i) {
+		if (m_alive[i] && m_awake[i]) {
+			m_island_of_root[find_root(i)] = 0;
+		}
+	}
+	uint32 num_islands = 0;
+	for (uint32 i = 0; i < count; ++i) {
+		if (m_island_of_root[i] == 0 && m_island_parent[i] == i) {
+			m_island_of_root[i] = num_islands++;
+		}
+	}
+	m_island_body_begin.assign(static_cast<size_t>(num_islands) + 1u, 0u);
+	for (uint32 i = 0; i < count; ++i) {
+		if (m_alive[i] && m_type[i] == BODY_DYNAMIC) {
+			const uint32 island = m_island_of_root[find_root(i)];
+			if (island != UINT32_MAX) {
+				m_awake[i] = 1;
+				++m_island_body_begin[island + 1u];
+			}
+		}
+	}
+	for (uint32 island = 0; island < num_islands; ++island) {
+		m_island_body_begin[island + 1u] += m_island_body_begin[island];
+	}
+	m_island_bodies.resize(m_island_body_begin[num_islands]);
+	{
+		std::vector<uint32> cursor(m_island_body_begin.begin(), m_island_body_begin.end() - 1);
+		for (uint32 i = 0; i < count; ++i) {
+			if (m_awake[i]) {
+				m_island_bodies[cursor[m_island_of_root[find_root(i)]]++] = i;
+			}
+		}
+	}
+
+	// Constraints sorted by island, a manifold belongs to the island of its dynamic body
+	const uint32 num_manifolds = static_cast<uint32>(m_manifolds.size());
+	std::vector<uint32> island_of_manifold(num_manifolds);
+	m_island_constraint_begin.assign(static_cast<size_t>(num_islands) + 1u, 0u);
+	for (uint32 m = 0; m < num_manifolds; ++m) {
+		const contact_manifold& each = m_manifolds[m];
+		const uint32 dynamic_body = m_type[each.body_a] == BODY_DYNAMIC ? each.body_a : each.body_b;
+		const uint32 island = m_island_of_root[find_root(dynamic_body)];
+		island_of_manifold[m] = island;
+		if (island != UINT32_MAX) {
+			++m_island_constraint_begin[island + 1u];
+		}
+	}
+	for (uint32 island = 0; island < num_islands; ++island) {
+		m_island_constraint_begin[island + 1u] += m_island_constraint_begin[island];
+	}
+	const size_t num_constraints = m_island_constraint_begin[num_islands];
+	m_constraint_body_a.resize(num_constraints);
+	m_constraint_body_b.resize(num_constraints);
+	m_constraint_manifold.resize(num_constraints);
+	m_constraint_normal.resize(num_constraints);
+	m_constraint_friction.resize(num_constraints);
+	m_constraint_restitution.resize(num_constraints);
+	m_constraint_point_count.resize(num_constraints);
+	m_point_r_a.resize(num_constraints * 2u);
+	m_point_r_b.resize(num_constraints * 2u);
+	m_point_normal_mass.resize(num_constraints * 2u);
+	m_point_tangent_mass.resize(num_constraints * 2u);
+	m_point_target_speed.resize(num_constraints * 2u);
+	m_point_normal_impulse.resize(num_constraints * 2u);
+	m_point_tangent_impulse.resize(num_constraints * 2u);
+	std::vector<uint32> cursor(m_island_constraint_begin.begin(), m_island_constraint_begin.end() - 1);
+	for (uint32 m = 0; m < num_manifolds; ++m) {
+		if (island_of_manifold[m] == UINT32_MAX) {
+			continue;
+		}
+		const contact_manifold& each = m_manifolds[m];
+		const uint32 c = cursor[island_of_manifold[m]]++;
+		m_constraint_body_a[c] = each.body_a;
+		m_constraint_body_b[c] = each.body_b;
+		m_constraint_manifold[c] = m;
+		m_constraint_normal[c] = each.normal;
+		m_constraint_friction[c] = sqrtf(m_friction[each.body_a] * m_friction[each.body_b]);
+		m_constraint_restitution[c] = std::max(m_restitution[each.body_a], m_restitution[each.body_b]);
+		m_constraint_point_count[c] = each.point_count;
+	}
+}
+
+void physics_world::solve_island(uint32 island, float32 dt)
+{
+	const float32 inv_dt = 1.f / dt;
+	const uint32 begin = m_island_constraint_begin[island];
+	const uint32 end = m_island_constraint_begin[island + 1u];
+
+	// Static bodies are shared between islands, so they are never written to
+	const auto apply = [this](uint32 a, uint32 b, const vec2& impulse, const vec2& r_a, const vec2& r_b) {
+		if (m_inv_mass[a] > 0.f) {
+			m_velocity[a] -= impulse * m_inv_mass[a];
+			m_angular_velocity[a] -= m_inv_inertia[a] * r_a.cross2(impulse);
+		}
+		if (m_inv_mass[b] > 0.f) {
+			m_velocity[b] += impulse * m_inv_mass[b];
+			m_angular_velocity[b] += m_inv_inertia[b] * r_b.cross2(impulse);
+		}
+	};
+	const auto relative_velocity = [this](uint32 a, uint32 b, const vec2& r_a, const vec2& r_b) {
+		return m_velocity[b] + _cross(m_angular_velocity[b], r_b) - m_velocity[a] - _cross(m_angular_velocity[a], r_a);
+	};
+
+	// Prepare, then warm start with the impulses of the last step
+	for (uint32 c = begin; c < end; ++c) {
+		const contact_manifold& manifold = m_manifolds[m_constraint_manifold[c]];
+		const uint32 a = m_constraint_body_a[c];
+		const uint32 b = m_constraint_body_b[c];
+		const vec2 normal = m_constraint_normal[c];
+		const vec2 tangent = normal.ratated_90_deg(-1);
+		const float32 restitution = m_constraint_restitution[c];
+		for (int32 p = 0; p < m_constraint_point_count[c]; ++p) {
+			const contact_point& point = manifold.points[p];
+			const size_t k = c * 2u + static_cast<size_t>(p);
+			const vec2 r_a = point.position - m_position[a];
+			const vec2 r_b = point.position - m_position[b];
+			m_point_r_a[k] = r_a;
+			m_point_r_b[k] = r_b;
+
+			const float32 rn_a = r_a.cross2(normal);
+			const float32 rn_b = r_b.cross2(normal);
+			const float32 k_normal = m_inv_mass[a] + m_inv_mass[b] + m_inv_inertia[a] * rn_a * rn_a + m_inv_inertia[b] * rn_b * rn_b;
+			m_point_normal_mass[k] = k_normal > 0.f ? 1.f / k_normal : 0.f;
+
+			const float32 rt_a = r_a.cross2(tangent);
+			const float32 rt_b = r_b.cross2(tangent);
+			const float32 k_tangent = m_inv_mass[a] + m_inv_mass[b] + m_inv_inertia[a] * rt_a * rt_a + m_inv_inertia[b] * rt_b * rt_b;
+			m_point_tangent_mass[k] = k_tangent > 0.f ? 1.f / k_tangent : 0.f;
+
+			// Separated points may approach until they touch, penetrating ones are pushed apart
+			float32 target_speed;
+			if (point.separation > 0.f) {
+				target_speed = -point.separation * inv_dt;
+			} else {
+				target_speed = -BAUMGARTE * inv_dt * std::min(0.f, point.separation + LINEAR_SLOP);
+			}
+			const float32 normal_speed = relative_velocity(a, b, r_a, r_b).dot(normal);
+			if (normal_speed < -RESTITUTION_THRESHOLD) {
+				target_speed = std::max(target_speed, -restitution * normal_speed);
+			}
+			m_point_target_speed[k] = target_speed;
+			m_point_normal_impulse[k] = point.normal_impulse;
+			m_point_tangent_impulse[k] = point.tangent_impulse;
+
+			apply(a, b, normal * point.normal_impulse + tangent * point.tangent_impulse, r_a, r_b);
+		}
+	}
+
+	for (int32 iteration = 0; iteration < VELOCITY_ITERATIONS; ++iteration) {
+		for (uint32 c = begin; c < end; ++c) {
+			const uint32 a = m_constraint_body_a[c];
+			const uint32 b = m_constraint_body_b[c];
+			const vec2 normal = m_constraint_normal[c];
+			const vec2 tangent = normal.ratated_90_deg(-1);
+			const float32 friction = m_constraint_friction[c];
+			for (int32 p = 0; p < m_constraint_point_count[c]; ++p) {
+				const size_t k = c * 2u + static_cast<size_t>(p);
+				const vec2 r_a = m_point_r_a[k];
+				const vec2 r_b = m_point_r_b[k];
+
+				// Normal, accumulated impulse stays positive
+				const float32 normal_speed = relative_velocity(a, b, r_a, r_b).dot(normal);
+				const float32 normal_impulse = std::max(m_point_normal_impulse[k] + m_point_normal_mass[k] * (m_point_target_speed[k] - normal_speed), 0.f);
+				const float32 normal_delta = normal_impulse - m_point_normal_impulse[k];
+				m_point_normal_impulse[k] = normal_impulse;
+				apply(a, b, normal * normal_delta, r_a, r_b);
+
+				// Friction, bounded by the normal impulse
+				const float32 tangent_speed = relative_velocity(a, b, r_a, r_b).dot(tangent);
+				const float32 friction_bound = friction * normal_impulse;
+				const float32 tangent_impulse = clamp(m_point_tangent_impulse[k] - m_point_tangent_mass[k] * tangent_speed, -friction_bound, friction_bound);
+				const float32 tangent_delta = tangent_impulse - m_point_tangent_impulse[k];
+				m_point_tangent_impulse[k] = tangent_impulse;
+				apply(a, b, tangent * tangent_delta, r_a, r_b);
+			}
+		}
+	}
+
+	// Back to the manifolds, the next step warm starts from them
+	for (uint32 c = begin; c < end; ++c) {
+		contact_manifold& manifold = m_manifolds[m_constraint_manifold[c]];
+		for (int32 p = 0; p < m_constraint_point_count[c]; ++p) {
+			const size_t k = c * 2u + static_cast<size_t>(p);
+			manifold.points[p].normal_impulse = m_point_normal_impulse[k];
+			manifold.points[p].tangent_impulse = m_point_tangent_impulse[k];
+		}
+	}
+}
+
+void physics_world::integrate_positions(float32 dt)
+{
+	const size_t count = m_position.size();
+	for (size_t i = 0; i < count; ++i) {
+		if (!m_awake[i]) {
+			continue;
+		}
+		m_position[i] += m_velocity[i] * dt;
+		m_angle[i] += m_angular_velocity[i] * dt;
+		// Stay in the accurate range of the fast sincos, interpolation is unaffected
+		if (fabsf(m_angle[i]) > 2.f * PI) {
+			const float32 wrap = m_angle[i] > 0.f ? 2.f * PI : -2.f * PI;
+			m_angle[i] -= wrap;
+			m_prev_angle[i] -= wrap;
+		}
+	}
+}
+
+void physics_world::update_sleep(float32 dt)
+{
+	const float32 linear_square = SLEEP_LINEAR_SPEED * SLEEP_LINEAR_SPEED;
+	const size_t num_islands = m_island_body_begin.empty() ? 0 : m_island_body_begin.size() - 1;
+	for (size_t island = 0; island < num_islands; ++island) {
+		float32 min_sleep_time = FLT_MAX;
+		for (uint32 k = m_island_body_begin[island]; k < m_island_body_begin[island + 1u]; ++k) {
+			const uint32 i = m_island_bodies[k];
+			if (m_velocity[i].length_square() > linear_square || fabsf(m_angular_velocity[i]) > SLEEP_ANGULAR_SPEED) {
+				m_sleep_time[i] = 0.f;
+			} else {
+				m_sleep_time[i] += dt;
+			}
+			min_sleep_time = std::min(min_sleep_time, m_sleep_time[i]);
+		}
+		if (min_sleep_time < SLEEP_TIME) {
+			continue;
+		}
+		for (uint32 k = m_island_body_begin[island]; k < m_island_body_begin[island + 1u]; ++k) {
+			const uint32 i = m_island_bodies[k];
+			m_awake[i] = 0;
+			m_velocity[i] = vec2::ZERO;
+			m_angular_velocity[i] = 0.f;
+		}
+	}
+}
+
+obb2 physics_world::get_obb_at(uint32 index) const
+{
+	obb2 box;
+	box.center = m_position[index];
+	box.right = {m_cos[index], m_sin[index]};
+	box.extends = m_extends[index];
+	return box;
+}
+}
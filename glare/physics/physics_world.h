@@ -0,0 +1,206 @@
+/// glare/physics/physics_world.h
+///
+/// 2D rigid bodies (boxes and disks) stepped at a fixed rate.
+///
+/// Bodies are stored as parallel arrays indexed by a stable body_handle.
+/// A step runs: integrate velocities -> sort-and-sweep broadphase -> narrow
+/// phase with warm-started manifolds -> islands -> sequential impulses per
+/// island -> integrate positions -> sleeping.
+/// Islands share no dynamic body, so they are solved in parallel over
+/// job_system. Islands at rest for SLEEP_TIME are put to sleep and skipped
+/// until something touches them.
+///
+/// update() consumes the frame time of the world's own clock, so pausing or
+/// scaling the parent clock pauses or scales the simulation.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/obb2.h"
+#include "glare/math/raycast2.h"
+#include "glare/physics/contact.h"
+#include <unordered_map>
+#include <vector>
+
+namespace glare
+{
+class clock;
+extern clock* g_master_clock;
+
+enum e_body_shape : uint8
+{
+	SHAPE_BOX,
+	SHAPE_DISK,
+};
+
+enum e_body_type : uint8
+{
+	BODY_STATIC,
+	BODY_DYNAMIC,
+};
+
+struct body_desc
+{
+	e_body_type		type				= BODY_DYNAMIC;
+	e_body_shape	shape				= SHAPE_BOX;
+	vec2			position			= vec2::ZERO;
+	float32			rotation_deg		= 0.f;
+	vec2			size				= vec2::ONE;	// box size, disk diameter is size.x
+	vec2			velocity			= vec2::ZERO;
+	float32			angular_velocity_deg = 0.f;
+	float32			density				= 1.f;
+	float32			friction			= 0.4f;
+	float32			restitution			= 0.f;
+};
+
+struct body_handle
+{
+	uint32 index = UINT32_MAX;
+	uint32 generation = 0;
+
+	NODISCARD bool is_null() const { return index == UINT32_MAX; }
+	bool operator == (const body_handle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+	bool operator != (const body_handle& rhs) const { return !(*this == rhs); }
+};
+
+struct physics_stats
+{
+	float64	step_ms			= 0.0;	// last fixed step
+	float64	bodies_per_ms	= 0.0;	// awake bodies / step_ms
+	uint32	steps			= 0;	// fixed steps run by the last update()
+	uint32	bodies			= 0;
+	uint32	awake_bodies	= 0;
+	uint32	pairs			= 0;	// broadphase pairs
+	uint32	contacts		= 0;	// contact points
+	uint32	islands			= 0;	// awake islands
+};
+
+class physics_world
+{
+public:
+	static constexpr float32	FIXED_STEP			= 1.f / 60.f;
+	static constexpr int32		MAX_STEPS_PER_UPDATE = 4;
+	static constexpr int32		VELOCITY_ITERATIONS	= 8;
+	static constexpr float32	SLEEP_TIME			= 0.5f;
+	static constexpr float32	SLEEP_LINEAR_SPEED	= 0.05f;
+	static constexpr float32	SLEEP_ANGULAR_SPEED	= 2.f * PI / 180.f;
+	static constexpr size_t		PARALLEL_ISLAND_GRAIN = 4;
+public:
+	explicit physics_world(clock* parent = g_master_clock);
+	~physics_world();
+	physics_world(const physics_world&) = delete;
+	physics_world& operator=(const physics_world&) = delete;
+
+	body_handle create_body(const body_desc& desc);
+	void destroy_body(body_handle body);
+	NODISCARD bool is_valid(body_handle body) const;
+
+	NODISCARD vec2		get_position(body_handle body) const		{ return m_position[get_index(body)]; }
+	NODISCARD float32	get_rotation_deg(body_handle body) const	{ return rtd(m_angle[get_index(body)]); }
+	NODISCARD vec2		get_velocity(body_handle body) const		{ return m_velocity[get_index(body)]; }
+	NODISCARD bool		is_awake(body_handle body) const			{ return m_awake[get_index(body)] != 0; }
+	NODISCARD obb2		get_obb(body_handle body) const;
+	// Position blended between the last 2 steps by get_alpha(), for rendering
+	NODISCARD vec2		get_interpolated_position(body_handle body) const;
+	NODISCARD float32	get_interpolated_rotation_deg(body_handle body) const;
+
+	void set_transform(body_handle body, const vec2& position, float32 rotation_deg);
+	void set_velocity(body_handle body, const vec2& velocity);
+	void apply_impulse(body_handle body, const vec2& impulse, const vec2& world_point);
+	void wake_up(body_handle body);
+
+	// Hands every body whose bounds the ray crosses to <visitor>, ids are body indices
+	void raycast(const ray2& ray, ray_query_visitor& visitor) const;
+	// Return: the nearest body hit, or a null handle
+	body_handle raycast_closest(const ray2& ray, raycast_hit& out_hit) const;
+	NODISCARD body_handle get_body(uint32 index) const { return {index, m_generation[index]}; }
+
+	// Runs as many fixed steps as the clock accumulated, up to MAX_STEPS_PER_UPDATE
+	void update();
+	// One step of <dt> seconds, regardless of the clock
+	void step(float32 dt);
+
+	NODISCARD float32				get_alpha() const	{ return m_accumulator / FIXED_STEP; }
+	NODISCARD const physics_stats&	get_stats() const	{ return m_stats; }
+	NODISCARD size_t				size() const		{ return m_position.size() - m_free_bodies.size(); }
+
+public:
+	vec2	m_gravity = {0.f, -9.8f};
+
+private:
+	NODISCARD uint32 get_index(body_handle body) const;
+	void refresh_rotations();
+	void refresh_bounds();
+	void update_bounds(uint32 index);
+	void integrate_velocities(float32 dt);
+	void find_pairs();
+	void collide();
+	void build_islands();
+	void solve_island(uint32 island, float32 dt);
+	void integrate_positions(float32 dt);
+	void update_sleep(float32 dt);
+	NODISCARD obb2 get_obb_at(uint32 index) const;
+	NODISCARD uint32 find_root(uint32 index);
+
+private:
+	clock*		m_clock = nullptr;
+	float32		m_accumulator = 0.f;
+
+	// Bodies, indexed by body_handle::index, dead slots have m_alive == 0
+	std::vector<vec2>		m_position;
+	std::vector<vec2>		m_prev_position;
+	std::vector<float32>	m_angle;			// radian
+	std::vector<float32>	m_prev_angle;
+	std::vector<float32>	m_sin;				// sin/cos of m_angle, refreshed in batch
+	std::vector<float32>	m_cos;
+	std::vector<vec2>		m_velocity;
+	std::vector<float32>	m_angular_velocity;	// radian per second
+	std::vector<float32>	m_inv_mass;			// 0 for static bodies
+	std::vector<float32>	m_inv_inertia;
+	std::vector<float32>	m_friction;
+	std::vector<float32>	m_restitution;
+	std::vector<vec2>		m_extends;			// box half size, disk radius in x
+	std::vector<aabb2>		m_bounds;
+	std::vector<float32>	m_sleep_time;
+	std::vector<e_body_shape>	m_shape;
+	std::vector<e_body_type>	m_type;
+	std::vector<uint8>		m_awake;
+	std::vector<uint8>		m_alive;
+	std::vector<uint32>		m_generation;
+	std::vector<uint32>		m_free_bodies;
+
+	// Broadphase, body indices kept sorted by m_bounds[].min.x between steps
+	std::vector<uint32>		m_sweep_order;
+	std::vector<uint64>		m_pairs;			// (a << 32) | b with a < b
+
+	// Manifolds of this step and the previous one, looked up by pair key for warm starting
+	std::vector<contact_manifold>		m_manifolds;
+	std::vector<contact_manifold>		m_prev_manifolds;
+	std::unordered_map<uint64, uint32>	m_prev_manifold_of_pair;
+
+	// Islands, union-find over dynamic bodies
+	std::vector<uint32>		m_island_parent;
+	std::vector<uint32>		m_island_of_root;
+	std::vector<uint32>		m_island_constraint_begin;	// island i owns [begin[i], begin[i + 1])
+	std::vector<uint32>		m_island_body_begin;
+	std::vector<uint32>		m_island_bodies;
+
+	// Constraints, one per manifold grouped by island, as parallel arrays like
+	// the bodies. The point columns hold 2 slots per constraint, [c * 2 + p].
+	std::vector<uint32>		m_constraint_body_a;
+	std::vector<uint32>		m_constraint_body_b;
+	std::vector<uint32>		m_constraint_manifold;
+	std::vector<vec2>		m_constraint_normal;
+	std::vector<float32>	m_constraint_friction;
+	std::vector<float32>	m_constraint_restitution;
+	std::vector<int32>		m_constraint_point_count;
+	std::vector<vec2>		m_point_r_a;
+	std::vector<vec2>		m_point_r_b;
+	std::vector<float32>	m_point_normal_mass;
+	std::vector<float32>	m_point_tangent_mass;
+	std::vector<float32>	m_point_target_speed;	// minimum normal relative speed, from separation and restitution
+	std::vector<float32>	m_point_normal_impulse;	// accumulated, stored back to the manifold after solving
+	std::vector<float32>	m_point_tangent_impulse;
+
+	physics_stats	m_stats;
+};
+}
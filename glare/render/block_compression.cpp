@@ -0,0 +1,965 @@
+#include "glare/render/block_compression.h"
+#include "glare/render/surface.h"
+#include "glare/render/surface_ops.h"
+#include "glare/core/assert.h"
+#include "glare/core/job.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace glare
+{
+// blocks per job, a block takes a few microseconds
+static constexpr size_t PARALLEL_BLOCKS = 256;
+static constexpr uint32 POWER_ITERATIONS = 8;
+static constexpr uint32 BC7_MODE5 = 5;
+static constexpr uint32 BC7_MODE6 = 6;
+static constexpr uint32 BC7_WEIGHTS2[4] = { 0, 21, 43, 64 };
+static constexpr uint32 BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+static constexpr float32 BC1_FOUR_WEIGHTS[4] = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+static constexpr float32 BC1_THREE_WEIGHTS[4] = { 0.f, 1.f, 0.5f, 0.f };
+static constexpr uint32 ALL_TEXELS = 0xFFFF;
+
+// 16 texels of a block, rows of 4
+struct texel_block
+{
+	byte	texels[16][4];
+};
+
+// Little endian bit stream over a zeroed block
+struct block_bits
+{
+	byte*	data = nullptr;
+	uint32	position = 0;
+
+	void write(uint32 value, uint32 count)
+	{
+		for (uint32 i = 0; i < count; ++i, ++position) {
+			data[position >> 3] |= static_cast<byte>(((value >> i) & 1) << (position & 7));
+		}
+	}
+};
+
+static uint32 _read_bits(const byte* data, uint32& position, uint32 count)
+{
+	uint32 value = 0;
+	for (uint32 i = 0; i < count; ++i, ++position) {
+		value |= ((data[position >> 3] >> (position & 7)) & 1u) << i;
+	}
+	return value;
+}
+
+static uint32 _get_quality_refinements(e_block_quality quality)
+{
+	switch (quality) {
+	case BLOCK_QUALITY_FAST:	return 0;
+	case BLOCK_QUALITY_NORMAL:	return 1;
+	default:					return 4;
+	}
+}
+
+static void _load_block(const rgba8* texels, const ivec2& size, int32 block_x, int32 block_y, texel_block& out_block)
+{
+	for (int32 y = 0; y < 4; ++y) {
+		const size_t row = static_cast<size_t>(std::min(block_y * 4 + y, size.y - 1)) * size.x;
+		for (int32 x = 0; x < 4; ++x) {
+			const int32 column = std::min(block_x * 4 + x, size.x - 1);
+			memcpy(out_block.texels[y * 4 + x], &texels[row + column], 4);
+		}
+	}
+}
+
+// Ends of the segment fitted through the <mask> texels over the first <channels> channels
+static void _fit_endpoints(const texel_block& block, uint32 channels, uint32 mask, bool principal_axis, float32 low[4], float32 high[4])
+{
+	float32 mean[4] = {};
+	float32 minimum[4] = { 255.f, 255.f, 255.f, 255.f };
+	float32 maximum[4] = {};
+	uint32 count = 0;
+	for (uint32 i = 0; i < 16; ++i) {
+		if (mask & (1u << i)) {
+			for (uint32 c = 0; c < channels; ++c) {
+				const float32 value = block.texels[i][c];
+				mean[c] += value;
+				minimum[c] = std::min(minimum[c], value);
+				maximum[c] = std::max(maximum[c], value);
+			}
+			++count;
+		}
+	}
+	if (count == 0) {
+		std::fill(low, low + 4, 0.f);
+		std::fill(high, high + 4, 0.f);
+		return;
+	}
+	for (uint32 c = 0; c < channels; ++c) {
+		mean[c] /= count;
+	}
+
+	float32 covariance[4][4] = {};
+	for (uint32 i = 0; i < 16; ++i) {
+		if (mask & (1u << i)) {
+			for (uint32 a = 0; a < channels; ++a) {
+				for (uint32 b = a; b < channels; ++b) {
+					covariance[a][b] += (block.texels[i][a] - mean[a]) * (block.texels[i][b] - mean[b]);
+				}
+			}
+		}
+	}
+	for (uint32 a = 0; a < channels; ++a) {
+		for (uint32 b = 0; b < a; ++b) {
+			covariance[a][b] = covariance[b][a];
+		}
+	}
+
+	if (!principal_axis) {
+		// the box diagonal that follows the widest channel, inset by 1/16 of the range
+		uint32 widest = 0;
+		for (uint32 c = 1; c < channels; ++c) {
+			if (maximum[c] - minimum[c] > maximum[widest] - minimum[widest]) {
+				widest = c;
+			}
+		}
+		for (uint32 c = 0; c < channels; ++c) {
+			const float32 inset = (maximum[c] - minimum[c]) / 16.f;
+			const bool flipped = covariance[widest][c] < 0.f;
+			low[c] = (flipped ? maximum[c] - inset : minimum[c] + inset);
+			high[c] = (flipped ? minimum[c] + inset : maximum[c] - inset);
+		}
+		return;
+	}
+
+	float32 axis[4] = {};
+	for (uint32 c = 0; c < channels; ++c) {
+		axis[c] = maximum[c] - minimum[c];
+	}
+	for (uint32 iteration = 0; iteration < POWER_ITERATIONS; ++iteration) {
+		float32 next[4] = {};
+		float32 length = 0.f;
+		for (uint32 a = 0; a < channels; ++a) {
+			for (uint32 b = 0; b < channels; ++b) {
+				next[a] += covariance[a][b] * axis[b];
+			}
+			length = std::max(length, std::abs(next[a]));
+		}
+		if (length <= 0.f) {
+			break;
+		}
+		for (uint32 c = 0; c < channels; ++c) {
+			axis[c] = next[c] / length;
+		}
+	}
+	float32 length = 0.f;
+	for (uint32 c = 0; c < channels; ++c) {
+		length += axis[c] * axis[c];
+	}
+	if (length <= 0.f) {
+		// a flat block
+		for (uint32 c = 0; c < channels; ++c) {
+			low[c] = high[c] = mean[c];
+		}
+		return;
+	}
+	length = std::sqrt(length);
+	for (uint32 c = 0; c < channels; ++c) {
+		axis[c] /= length;
+	}
+
+	float32 t_min = 0.f;
+	float32 t_max = 0.f;
+	for (uint32 i = 0; i < 16; ++i) {
+		if (mask & (1u << i)) {
+			float32 t = 0.f;
+			for (uint32 c = 0; c < channels; ++c) {
+				t += (block.texels[i][c] - mean[c]) * axis[c];
+			}
+			t_min = std::min(t_min, t);
+			t_max = std::max(t_max, t);
+		}
+	}
+	for (uint32 c = 0; c < channels; ++c) {
+		low[c] = std::min(std::max(mean[c] + t_min * axis[c], 0.f), 255.f);
+		high[c] = std::min(std::max(mean[c] + t_max * axis[c], 0.f), 255.f);
+	}
+}
+
+// Least squares endpoints over channels [first, end) for fixed interpolation <weights>, 0 at <low> and 1 at <high>;
+// false when the weights cannot tell the endpoints apart
+static bool _solve_endpoints(const texel_block& block, uint32 first, uint32 end, uint32 mask, const float32 weights[16], float32 low[4], float32 high[4])
+{
+	float32 aa = 0.f;
+	float32 ab = 0.f;
+	float32 bb = 0.f;
+	float32 ax[4] = {};
+	float32 bx[4] = {};
+	for (uint32 i = 0; i < 16; ++i) {
+		if (mask & (1u << i)) {
+			const float32 b = weights[i];
+			const float32 a = 1.f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			for (uint32 c = first; c < end; ++c) {
+				ax[c] += a * block.texels[i][c];
+				bx[c] += b * block.texels[i][c];
+			}
+		}
+	}
+	const float32 determinant = aa * bb - ab * ab;
+	if (std::abs(determinant) < 1e-6f) {
+		return false;
+	}
+	for (uint32 c = first; c < end; ++c) {
+		low[c] = std::min(std::max((bb * ax[c] - ab * bx[c]) / determinant, 0.f), 255.f);
+		high[c] = std::min(std::max((aa * bx[c] - ab * ax[c]) / determinant, 0.f), 255.f);
+	}
+	return true;
+}
+
+static uint16 _pack_565(const float32 color[4])
+{
+	const uint32 r = static_cast<uint32>(std::lrint(color[0] * (31.f / 255.f)));
+	const uint32 g = static_cast<uint32>(std::lrint(color[1] * (63.f / 255.f)));
+	const uint32 b = static_cast<uint32>(std::lrint(color[2] * (31.f / 255.f)));
+	return static_cast<uint16>((r << 11) | (g << 5) | b);
+}
+
+static void _unpack_565(uint16 color, byte out[4])
+{
+	const uint32 r = (color >> 11) & 31;
+	const uint32 g = (color >> 5) & 63;
+	const uint32 b = color & 31;
+	out[0] = static_cast<byte>((r << 3) | (r >> 2));
+	out[1] = static_cast<byte>((g << 2) | (g >> 4));
+	out[2] = static_cast<byte>((b << 3) | (b >> 2));
+	out[3] = 255;
+}
+
+// BC3 color blocks always take four colors, BC1 only when c0 > c1
+static bool _is_four_color(uint16 c0, uint16 c1, bool force_four)
+{
+	return force_four || c0 > c1;
+}
+
+static void _bc1_palette(uint16 c0, uint16 c1, bool force_four, byte palette[4][4])
+{
+	_unpack_565(c0, palette[0]);
+	_unpack_565(c1, palette[1]);
+	const bool four = _is_four_color(c0, c1, force_four);
+	for (uint32 c = 0; c < 3; ++c) {
+		const uint32 a = palette[0][c];
+		const uint32 b = palette[1][c];
+		if (four) {
+			palette[2][c] = static_cast<byte>((2 * a + b + 1) / 3);
+			palette[3][c] = static_cast<byte>((a + 2 * b + 1) / 3);
+		} else {
+			palette[2][c] = static_cast<byte>((a + b + 1) / 2);
+			palette[3][c] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = four ? 255 : 0;
+}
+
+// Writes the color block for <a> and <b>, returns the squared rgb error. <transparent> texels take index 3 of
+// the three color mode, which <three_color> selects by ordering c0 <= c1
+static uint32 _encode_bc1_endpoints(const texel_block& block, const float32 a[4], const float32 b[4], bool three_color, bool force_four
+	, uint32 transparent, byte out[8])
+{
+	uint16 c0 = _pack_565(a);
+	uint16 c1 = _pack_565(b);
+	if (three_color ? c0 > c1 : c0 < c1) {
+		std::swap(c0, c1);
+	}
+	byte palette[4][4];
+	_bc1_palette(c0, c1, force_four, palette);
+	// index 3 of the three color mode is transparent, opaque texels cannot take it
+	const uint32 num_colors = _is_four_color(c0, c1, force_four) ? 4 : 3;
+
+	uint32 indices = 0;
+	uint32 error = 0;
+	for (uint32 i = 0; i < 16; ++i) {
+		if (transparent & (1u << i)) {
+			indices |= 3u << (i * 2);
+			continue;
+		}
+		uint32 best = 0;
+		uint32 best_error = UINT32_MAX;
+		for (uint32 k = 0; k < num_colors; ++k) {
+			uint32 distance = 0;
+			for (uint32 c = 0; c < 3; ++c) {
+				const int32 delta = static_cast<int32>(block.texels[i][c]) - palette[k][c];
+				distance += static_cast<uint32>(delta * delta);
+			}
+			if (distance < best_error) {
+				best_error = distance;
+				best = k;
+			}
+		}
+		indices |= best << (i * 2);
+		error += best_error;
+	}
+	out[0] = static_cast<byte>(c0);
+	out[1] = static_cast<byte>(c0 >> 8);
+	out[2] = static_cast<byte>(c1);
+	out[3] = static_cast<byte>(c1 >> 8);
+	memcpy(out + 4, &indices, 4);
+	return error;
+}
+
+// Fits, encodes and refines one BC1 color block in the mode <three_color> asks for
+static uint32 _encode_bc1_mode(const texel_block& block, e_block_quality quality, bool three_color, bool force_four, uint32 transparent, byte out[8])
+{
+	const uint32 opaque = ALL_TEXELS & ~transparent;
+	float32 low[4];
+	float32 high[4];
+	_fit_endpoints(block, 3, opaque, quality != BLOCK_QUALITY_FAST, low, high);
+	uint32 best_error = _encode_bc1_endpoints(block, low, high, three_color, force_four, transparent, out);
+
+	const uint32 refinements = _get_quality_refinements(quality);
+	for (uint32 iteration = 0; iteration < refinements && best_error > 0; ++iteration) {
+		uint16 c0;
+		uint16 c1;
+		uint32 indices;
+		memcpy(&c0, out, 2);
+		memcpy(&c1, out + 2, 2);
+		memcpy(&indices, out + 4, 4);
+		const float32* index_weights = _is_four_color(c0, c1, force_four) ? BC1_FOUR_WEIGHTS : BC1_THREE_WEIGHTS;
+		float32 weights[16];
+		for (uint32 i = 0; i < 16; ++i) {
+			weights[i] = index_weights[(indices >> (i * 2)) & 3];
+		}
+		if (!_solve_endpoints(block, 0, 3, opaque, weights, low, high)) {
+			break;
+		}
+		byte candidate[8];
+		const uint32 error = _encode_bc1_endpoints(block, low, high, three_color, force_four, transparent, candidate);
+		if (error >= best_error) {
+			break;
+		}
+		best_error = error;
+		memcpy(out, candidate, 8);
+	}
+	return best_error;
+}
+
+static void _encode_bc1(const texel_block& block, e_block_quality quality, bool force_four, byte alpha_threshold, byte out[8])
+{
+	uint32 transparent = 0;
+	if (!force_four) {
+		for (uint32 i = 0; i < 16; ++i) {
+			if (block.texels[i][3] < alpha_threshold) {
+				transparent |= 1u << i;
+			}
+		}
+	}
+	if (transparent) {
+		_encode_bc1_mode(block, quality, true, false, transparent, out);
+		return;
+	}
+	const uint32 error = _encode_bc1_mode(block, quality, false, force_four, 0, out);
+	if (quality == BLOCK_QUALITY_HIGH && !force_four && error > 0) {
+		// the three color mode has a midpoint the four color one lacks
+		byte candidate[8];
+		if (_encode_bc1_mode(block, quality, true, false, 0, candidate) < error) {
+			memcpy(out, candidate, 8);
+		}
+	}
+}
+
+static void _bc4_palette(uint32 r0, uint32 r1, byte palette[8])
+{
+	palette[0] = static_cast<byte>(r0);
+	palette[1] = static_cast<byte>(r1);
+	if (r0 > r1) {
+		for (uint32 i = 1; i < 7; ++i) {
+			palette[i + 1] = static_cast<byte>(((7 - i) * r0 + i * r1 + 3) / 7);
+		}
+	} else {
+		for (uint32 i = 1; i < 5; ++i) {
+			palette[i + 1] = static_cast<byte>(((5 - i) * r0 + i * r1 + 2) / 5);
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+// r0 > r1 selects eight interpolated values, r0 <= r1 six plus 0 and 255
+static uint32 _encode_bc4_endpoints(const byte values[16], uint32 r0, uint32 r1, byte out[8])
+{
+	byte palette[8];
+	_bc4_palette(r0, r1, palette);
+	uint64 indices = 0;
+	uint32 error = 0;
+	for (uint32 i = 0; i < 16; ++i) {
+		uint32 best = 0;
+		uint32 best_error = UINT32_MAX;
+		for (uint32 k = 0; k < 8; ++k) {
+			const int32 delta = static_cast<int32>(values[i]) - palette[k];
+			const uint32 distance = static_cast<uint32>(delta * delta);
+			if (distance < best_error) {
+				best_error = distance;
+				best = k;
+			}
+		}
+		indices |= static_cast<uint64>(best) << (i * 3);
+		error += best_error;
+	}
+	out[0] = static_cast<byte>(r0);
+	out[1] = static_cast<byte>(r1);
+	for (uint32 k = 0; k < 6; ++k) {
+		out[2 + k] = static_cast<byte>(indices >> (k * 8));
+	}
+	return error;
+}
+
+static void _encode_bc4(const byte values[16], e_block_quality quality, byte out[8])
+{
+	uint32 minimum = 255;
+	uint32 maximum = 0;
+	for (uint32 i = 0; i < 16; ++i) {
+		minimum = std::min<uint32>(minimum, values[i]);
+		maximum = std::max<uint32>(maximum, values[i]);
+	}
+	if (minimum == maximum) {
+		_encode_bc4_endpoints(values, maximum, minimum, out);
+		return;
+	}
+	uint32 best_error = _encode_bc4_endpoints(values, maximum, minimum, out);
+
+	const uint32 refinements = _get_quality_refinements(quality);
+	for (uint32 iteration = 0; iteration < refinements && best_error > 0; ++iteration) {
+		// index 0 is r0, 1 is r1, 2 to 7 step from r0 to r1 in sevenths
+		float32 aa = 0.f;
+		float32 ab = 0.f;
+		float32 bb = 0.f;
+		float32 ax = 0.f;
+		float32 bx = 0.f;
+		const uint64 indices = static_cast<uint64>(out[2]) | static_cast<uint64>(out[3]) << 8 | static_cast<uint64>(out[4]) << 16
+			| static_cast<uint64>(out[5]) << 24 | static_cast<uint64>(out[6]) << 32 | static_cast<uint64>(out[7]) << 40;
+		for (uint32 i = 0; i < 16; ++i) {
+			const uint32 index = (indices >> (i * 3)) & 7;
+			const float32 b = index == 0 ? 0.f : index == 1 ? 1.f : (index - 1) / 7.f;
+			const float32 a = 1.f - b;
+			aa += a * a;
+			ab += a * b;
+			bb += b * b;
+			ax += a * values[i];
+			bx += b * values[i];
+		}
+		const float32 determinant = aa * bb - ab * ab;
+		if (std::abs(determinant) < 1e-6f) {
+			break;
+		}
+		const int32 r0 = static_cast<int32>(std::lrint(std::min(std::max((bb * ax - ab * bx) / determinant, 0.f), 255.f)));
+		const int32 r1 = static_cast<int32>(std::lrint(std::min(std::max((aa * bx - ab * ax) / determinant, 0.f), 255.f)));
+		if (r0 <= r1) {
+			break;
+		}
+		byte candidate[8];
+		const uint32 error = _encode_bc4_endpoints(values, r0, r1, candidate);
+		if (error >= best_error) {
+			break;
+		}
+		best_error = error;
+		memcpy(out, candidate, 8);
+	}
+
+	if (quality == BLOCK_QUALITY_HIGH && best_error > 0) {
+		// six values between the inner extremes, with 0 and 255 exact
+		uint32 inner_min = 255;
+		uint32 inner_max = 0;
+		for (uint32 i = 0; i < 16; ++i) {
+			if (values[i] != 0 && values[i] != 255) {
+				inner_min = std::min<uint32>(inner_min, values[i]);
+				inner_max = std::max<uint32>(inner_max, values[i]);
+			}
+		}
+		if (inner_min <= inner_max) {
+			byte candidate[8];
+			if (_encode_bc4_endpoints(values, inner_min, inner_max, candidate) < best_error) {
+				memcpy(out, candidate, 8);
+			}
+		}
+	}
+}
+
+static void _encode_bc4_channel(const texel_block& block, uint32 channel, e_block_quality quality, byte out[8])
+{
+	byte values[16];
+	for (uint32 i = 0; i < 16; ++i) {
+		values[i] = block.texels[i][channel];
+	}
+	_encode_bc4(values, quality, out);
+}
+
+static byte _bc7_interpolate(uint32 e0, uint32 e1, uint32 weight)
+{
+	return static_cast<byte>(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+}
+
+// Nearest of the <count> steps from <e0> to <e1> over channels [first, end) for every texel, returns the squared error
+static uint32 _pick_bc7_indices(const texel_block& block, uint32 first, uint32 end, const byte e0[4], const byte e1[4]
+	, const uint32* weights, uint32 count, byte indices[16])
+{
+	byte palette[16][4];
+	for (uint32 k = 0; k < count; ++k) {
+		for (uint32 c = first; c < end; ++c) {
+			palette[k][c] = _bc7_interpolate(e0[c], e1[c], weights[k]);
+		}
+	}
+	uint32 error = 0;
+	for (uint32 i = 0; i < 16; ++i) {
+		uint32 best = 0;
+		uint32 best_error = UINT32_MAX;
+		for (uint32 k = 0; k < count; ++k) {
+			uint32 distance = 0;
+			for (uint32 c = first; c < end; ++c) {
+				const int32 delta = static_cast<int32>(block.texels[i][c]) - palette[k][c];
+				distance += static_cast<uint32>(delta * delta);
+			}
+			if (distance < best_error) {
+				best_error = distance;
+				best = k;
+			}
+		}
+		indices[i] = static_cast<byte>(best);
+		error += best_error;
+	}
+	return error;
+}
+
+// The anchor index has no top bit, swapping the endpoints of channels [first, end) mirrors the indices
+static bool _fix_bc7_anchor(byte indices[16], uint32 count, byte q0[4], byte q1[4], uint32 first, uint32 end)
+{
+	if (indices[0] < count / 2) {
+		return false;
+	}
+	for (uint32 c = first; c < end; ++c) {
+		std::swap(q0[c], q1[c]);
+	}
+	for (uint32 i = 0; i < 16; ++i) {
+		indices[i] = static_cast<byte>(count - 1 - indices[i]);
+	}
+	return true;
+}
+
+// 7 bit endpoint channels for the p-bit <p>, the decoded value is (q << 1) | p
+static void _quantize_bc7(const float32 value[4], uint32 p, byte out[4])
+{
+	for (uint32 c = 0; c < 4; ++c) {
+		out[c] = static_cast<byte>(std::min(std::max(std::lrint((value[c] - p) * 0.5f), 0l), 127l));
+	}
+}
+
+static float32 _get_bc7_endpoint_error(const float32 value[4], uint32 p)
+{
+	byte quantized[4];
+	_quantize_bc7(value, p, quantized);
+	float32 error = 0.f;
+	for (uint32 c = 0; c < 4; ++c) {
+		const float32 delta = value[c] - ((quantized[c] << 1) | p);
+		error += delta * delta;
+	}
+	return error;
+}
+
+// Mode 6: 7 mode bits, 7.7.7.7 for each endpoint, two p-bits, then 4 bit indices with 3 bits for the anchor
+static uint32 _encode_bc7_mode6(const texel_block& block, const float32 low[4], uint32 p0, const float32 high[4], uint32 p1, byte out[16])
+{
+	byte q[2][4];
+	byte e[2][4];
+	uint32 p[2] = { p0, p1 };
+	_quantize_bc7(low, p0, q[0]);
+	_quantize_bc7(high, p1, q[1]);
+	for (uint32 c = 0; c < 4; ++c) {
+		e[0][c] = static_cast<byte>((q[0][c] << 1) | p0);
+		e[1][c] = static_cast<byte>((q[1][c] << 1) | p1);
+	}
+	byte indices[16];
+	const uint32 error = _pick_bc7_indices(block, 0, 4, e[0], e[1], BC7_WEIGHTS4, 16, indices);
+	if (_fix_bc7_anchor(indices, 16, q[0], q[1], 0, 4)) {
+		std::swap(p[0], p[1]);
+	}
+
+	memset(out, 0, 16);
+	block_bits bits;
+	bits.data = out;
+	bits.write(1u << BC7_MODE6, BC7_MODE6 + 1);
+	for (uint32 c = 0; c < 4; ++c) {
+		bits.write(q[0][c], 7);
+		bits.write(q[1][c], 7);
+	}
+	bits.write(p[0], 1);
+	bits.write(p[1], 1);
+	bits.write(indices[0], 3);
+	for (uint32 i = 1; i < 16; ++i) {
+		bits.write(indices[i], 4);
+	}
+	return error;
+}
+
+// Best p-bits for <low> and <high>: by endpoint rounding, or by the block error when <search>. Opaque blocks
+// keep both p-bits set, the only way alpha decodes to exactly 255
+static uint32 _encode_bc7_mode6_pbits(const texel_block& block, const float32 low[4], const float32 high[4], bool opaque, bool search, byte out[16])
+{
+	if (opaque) {
+		return _encode_bc7_mode6(block, low, 1, high, 1, out);
+	}
+	if (!search) {
+		const uint32 p0 = _get_bc7_endpoint_error(low, 1) < _get_bc7_endpoint_error(low, 0) ? 1 : 0;
+		const uint32 p1 = _get_bc7_endpoint_error(high, 1) < _get_bc7_endpoint_error(high, 0) ? 1 : 0;
+		return _encode_bc7_mode6(block, low, p0, high, p1, out);
+	}
+	uint32 best_error = UINT32_MAX;
+	for (uint32 pbits = 0; pbits < 4; ++pbits) {
+		byte candidate[16];
+		const uint32 error = _encode_bc7_mode6(block, low, pbits & 1, high, pbits >> 1, candidate);
+		if (error < best_error) {
+			best_error = error;
+			memcpy(out, candidate, 16);
+		}
+	}
+	return best_error;
+}
+
+static uint32 _encode_bc7_mode6_refined(const texel_block& block, e_block_quality quality, bool opaque, byte out[16])
+{
+	float32 low[4];
+	float32 high[4];
+	_fit_endpoints(block, 4, ALL_TEXELS, quality != BLOCK_QUALITY_FAST, low, high);
+	const bool search = quality == BLOCK_QUALITY_HIGH;
+	uint32 best_error = _encode_bc7_mode6_pbits(block, low, high, opaque, search, out);
+
+	const uint32 refinements = _get_quality_refinements(quality);
+	for (uint32 iteration = 0; iteration < refinements && best_error > 0; ++iteration) {
+		// the indices as written, after a possible swap: weights run from the stored first endpoint
+		uint32 position = 65;
+		float32 weights[16];
+		for (uint32 i = 0; i < 16; ++i) {
+			weights[i] = BC7_WEIGHTS4[_read_bits(out, position, i == 0 ? 3 : 4)] / 64.f;
+		}
+		if (!_solve_endpoints(block, 0, 4, ALL_TEXELS, weights, low, high)) {
+			break;
+		}
+		byte candidate[16];
+		const uint32 error = _encode_bc7_mode6_pbits(block, low, high, opaque, search, candidate);
+		if (error >= best_error) {
+			break;
+		}
+		best_error = error;
+		memcpy(out, candidate, 16);
+	}
+	return best_error;
+}
+
+// Mode 5: 6 mode bits, 2 rotation bits left at 0, 7.7.7 color and 8 bit alpha endpoints, then 2 bit color
+// and 2 bit alpha indices, each with 1 bit for the anchor
+static uint32 _encode_bc7_mode5(const texel_block& block, const float32 low[4], const float32 high[4], byte out[16])
+{
+	byte q[2][4];
+	byte e[2][4];
+	for (uint32 c = 0; c < 3; ++c) {
+		q[0][c] = static_cast<byte>(std::min(std::max(std::lrint(low[c] * (127.f / 255.f)), 0l), 127l));
+		q[1][c] = static_cast<byte>(std::min(std::max(std::lrint(high[c] * (127.f / 255.f)), 0l), 127l));
+		e[0][c] = static_cast<byte>((q[0][c] << 1) | (q[0][c] >> 6));
+		e[1][c] = static_cast<byte>((q[1][c] << 1) | (q[1][c] >> 6));
+	}
+	q[0][3] = e[0][3] = static_cast<byte>(std::lrint(low[3]));
+	q[1][3] = e[1][3] = static_cast<byte>(std::lrint(high[3]));
+	byte color_indices[16];
+	byte alpha_indices[16];
+	const uint32 error = _pick_bc7_indices(block, 0, 3, e[0], e[1], BC7_WEIGHTS2, 4, color_indices)
+		+ _pick_bc7_indices(block, 3, 4, e[0], e[1], BC7_WEIGHTS2, 4, alpha_indices);
+	_fix_bc7_anchor(color_indices, 4, q[0], q[1], 0, 3);
+	_fix_bc7_anchor(alpha_indices, 4, q[0], q[1], 3, 4);
+
+	memset(out, 0, 16);
+	block_bits bits;
+	bits.data = out;
+	bits.write(1u << BC7_MODE5, BC7_MODE5 + 1);
+	bits.write(0, 2);
+	for (uint32 c = 0; c < 3; ++c) {
+		bits.write(q[0][c], 7);
+		bits.write(q[1][c], 7);
+	}
+	bits.write(q[0][3], 8);
+	bits.write(q[1][3], 8);
+	for (const byte* indices : { color_indices, alpha_indices }) {
+		bits.write(indices[0], 1);
+		for (uint32 i = 1; i < 16; ++i) {
+			bits.write(indices[i], 2);
+		}
+	}
+	return error;
+}
+
+static uint32 _encode_bc7_mode5_refined(const texel_block& block, e_block_quality quality, byte out[16])
+{
+	float32 low[4];
+	float32 high[4];
+	_fit_endpoints(block, 3, ALL_TEXELS, quality != BLOCK_QUALITY_FAST, low, high);
+	low[3] = 255.f;
+	high[3] = 0.f;
+	for (uint32 i = 0; i < 16; ++i) {
+		low[3] = std::min(low[3], static_cast<float32>(block.texels[i][3]));
+		high[3] = std::max(high[3], static_cast<float32>(block.texels[i][3]));
+	}
+	uint32 best_error = _encode_bc7_mode5(block, low, high, out);
+
+	const uint32 refinements = _get_quality_refinements(quality);
+	for (uint32 iteration = 0; iteration < refinements && best_error > 0; ++iteration) {
+		uint32 position = 66;
+		float32 color_weights[16];
+		float32 alpha_weights[16];
+		for (float32* weights : { color_weights, alpha_weights }) {
+			for (uint32 i = 0; i < 16; ++i) {
+				weights[i] = BC7_WEIGHTS2[_read_bits(out, position, i == 0 ? 1 : 2)] / 64.f;
+			}
+		}
+		const bool solved_color = _solve_endpoints(block, 0, 3, ALL_TEXELS, color_weights, low, high);
+		const bool solved_alpha = _solve_endpoints(block, 3, 4, ALL_TEXELS, alpha_weights, low, high);
+		if (!solved_color && !solved_alpha) {
+			break;
+		}
+		byte candidate[16];
+		const uint32 error = _encode_bc7_mode5(block, low, high, candidate);
+		if (error >= best_error) {
+			break;
+		}
+		best_error = error;
+		memcpy(out, candidate, 16);
+	}
+	return best_error;
+}
+
+static void _encode_bc7(const texel_block& block, e_block_quality quality, byte out[16])
+{
+	bool opaque = true;
+	for (uint32 i = 0; i < 16; ++i) {
+		opaque = opaque && block.texels[i][3] == 255;
+	}
+	const uint32 error = _encode_bc7_mode6_refined(block, quality, opaque, out);
+	if (!opaque && error > 0) {
+		// alpha that does not follow the color, such as soft edges over transparent black
+		byte candidate[16];
+		if (_encode_bc7_mode5_refined(block, quality, candidate) < error) {
+			memcpy(out, candidate, 16);
+		}
+	}
+}
+
+static void _encode_block(const texel_block& block, const block_compression_options& options, byte* out)
+{
+	switch (options.format) {
+	case BLOCK_FORMAT_BC1:
+		_encode_bc1(block, options.quality, false, options.alpha_threshold, out);
+		break;
+	case BLOCK_FORMAT_BC3:
+		_encode_bc4_channel(block, 3, options.quality, out);
+		_encode_bc1(block, options.quality, true, 0, out + 8);
+		break;
+	case BLOCK_FORMAT_BC4:
+		_encode_bc4_channel(block, 0, options.quality, out);
+		break;
+	case BLOCK_FORMAT_BC5:
+		_encode_bc4_channel(block, 0, options.quality, out);
+		_encode_bc4_channel(block, 1, options.quality, out + 8);
+		break;
+	case BLOCK_FORMAT_BC7:
+		_encode_bc7(block, options.quality, out);
+		break;
+	}
+}
+
+static void _decode_bc1(const byte* in, bool force_four, byte out[16][4])
+{
+	uint16 c0;
+	uint16 c1;
+	uint32 indices;
+	memcpy(&c0, in, 2);
+	memcpy(&c1, in + 2, 2);
+	memcpy(&indices, in + 4, 4);
+	byte palette[4][4];
+	_bc1_palette(c0, c1, force_four, palette);
+	for (uint32 i = 0; i < 16; ++i) {
+		memcpy(out[i], palette[(indices >> (i * 2)) & 3], 4);
+	}
+}
+
+static void _decode_bc4(const byte* in, uint32 channel, byte out[16][4])
+{
+	byte palette[8];
+	_bc4_palette(in[0], in[1], palette);
+	uint32 position = 16;
+	for (uint32 i = 0; i < 16; ++i) {
+		out[i][channel] = palette[_read_bits(in, position, 3)];
+	}
+}
+
+static void _decode_bc7(const byte* in, byte out[16][4])
+{
+	uint32 position = 0;
+	byte e[2][4];
+	if ((in[0] & 0x7F) == (1u << BC7_MODE6)) {
+		position = BC7_MODE6 + 1;
+		for (uint32 c = 0; c < 4; ++c) {
+			e[0][c] = static_cast<byte>(_read_bits(in, position, 7) << 1);
+			e[1][c] = static_cast<byte>(_read_bits(in, position, 7) << 1);
+		}
+		const uint32 p0 = _read_bits(in, position, 1);
+		const uint32 p1 = _read_bits(in, position, 1);
+		for (uint32 c = 0; c < 4; ++c) {
+			e[0][c] |= p0;
+			e[1][c] |= p1;
+		}
+		for (uint32 i = 0; i < 16; ++i) {
+			const uint32 weight = BC7_WEIGHTS4[_read_bits(in, position, i == 0 ? 3 : 4)];
+			for (uint32 c = 0; c < 4; ++c) {
+				out[i][c] = _bc7_interpolate(e[0][c], e[1][c], weight);
+			}
+		}
+		return;
+	}
+	if ((in[0] & 0x3F) == (1u << BC7_MODE5) && (in[0] >> 6) == 0) {
+		position = BC7_MODE5 + 1 + 2;
+		for (uint32 c = 0; c < 3; ++c) {
+			for (uint32 k = 0; k < 2; ++k) {
+				const uint32 value = _read_bits(in, position, 7);
+				e[k][c] = static_cast<byte>((value << 1) | (value >> 6));
+			}
+		}
+		e[0][3] = static_cast<byte>(_read_bits(in, position, 8));
+		e[1][3] = static_cast<byte>(_read_bits(in, position, 8));
+		for (uint32 i = 0; i < 16; ++i) {
+			const uint32 weight = BC7_WEIGHTS2[_read_bits(in, position, i == 0 ? 1 : 2)];
+			for (uint32 c = 0; c < 3; ++c) {
+				out[i][c] = _bc7_interpolate(e[0][c], e[1][c], weight);
+			}
+		}
+		for (uint32 i = 0; i < 16; ++i) {
+			out[i][3] = _bc7_interpolate(e[0][3], e[1][3], BC7_WEIGHTS2[_read_bits(in, position, i == 0 ? 1 : 2)]);
+		}
+		return;
+	}
+	// not written by the encoder
+	for (uint32 i = 0; i < 16; ++i) {
+		out[i][0] = 255;
+		out[i][1] = 0;
+		out[i][2] = 255;
+		out[i][3] = 255;
+	}
+}
+
+uint32 get_block_size(e_block_format format)
+{
+	return format == BLOCK_FORMAT_BC1 || format == BLOCK_FORMAT_BC4 ? 8 : 16;
+}
+
+uint32 get_block_row_pitch(e_block_format format, int32 width)
+{
+	return static_cast<uint32>((width + 3) / 4) * get_block_size(format);
+}
+
+void compress_blocks(const rgba8* texels, const ivec2& size, const block_compression_options& options, std::vector<byte>& out_blocks)
+{
+	const size_t blocks_x = static_cast<size_t>((size.x + 3) / 4);
+	const size_t blocks_y = static_cast<size_t>((size.y + 3) / 4);
+	const size_t block_size = get_block_size(options.format);
+	out_blocks.assign(blocks_x * blocks_y * block_size, 0);
+	if (out_blocks.empty()) {
+		return;
+	}
+	byte* blocks = out_blocks.data();
+	job_system::parallel_for(blocks_y, std::max<size_t>(1, PARALLEL_BLOCKS / blocks_x), [&](size_t begin, size_t end) {
+		texel_block block;
+		for (size_t y = begin; y < end; ++y) {
+			for (size_t x = 0; x < blocks_x; ++x) {
+				_load_block(texels, size, static_cast<int32>(x), static_cast<int32>(y), block);
+				_encode_block(block, options, blocks + (y * blocks_x + x) * block_size);
+			}
+		}
+	});
+}
+
+void compress_surface(const surface* from_surface, const block_compression_options& options, compressed_image& out_image, bool with_mips)
+{
+	out_image.format = options.format;
+	out_image.srgb = options.srgb;
+	out_image.levels.clear();
+	const bool use_rgba8 = from_surface->get_storage() == SURFACE_STORAGE_RGBA8;
+
+	std::vector<mip_level> generated;
+	const std::vector<mip_level>* mips = &from_surface->m_mips;
+	if (mips->empty() && with_mips) {
+		mip_chain_options mip_options;
+		mip_options.srgb = options.srgb;
+		generate_mip_chain(from_surface->get_surface_buffer(), from_surface->m_size, mip_options, generated);
+		if (use_rgba8) {
+			// the float copy was made for the filter only
+			from_surface->release_cache();
+		}
+		mips = &generated;
+	}
+
+	out_image.levels.resize(mips->size() + 1);
+	out_image.levels[0].size = from_surface->m_size;
+	compress_blocks(from_surface->get_rgba8_buffer(), from_surface->m_size, options, out_image.levels[0].blocks);
+	if (!use_rgba8) {
+		from_surface->release_cache();
+	}
+
+	std::vector<rgba8> bytes;
+	for (size_t level = 1; level < out_image.levels.size(); ++level) {
+		const mip_level& mip = (*mips)[level - 1];
+		bytes.resize(mip.texels.size());
+		surface_ops::convert_float_to_rgba8(bytes.data(), mip.texels.data(), mip.texels.size());
+		out_image.levels[level].size = mip.size;
+		compress_blocks(bytes.data(), mip.size, options, out_image.levels[level].blocks);
+	}
+}
+
+void decompress_blocks(const byte* blocks, const ivec2& size, e_block_format format, rgba8* out_texels)
+{
+	const int32 blocks_x = (size.x + 3) / 4;
+	const int32 blocks_y = (size.y + 3) / 4;
+	const size_t block_size = get_block_size(format);
+	for (int32 by = 0; by < blocks_y; ++by) {
+		for (int32 bx = 0; bx < blocks_x; ++bx) {
+			const byte* in = blocks + (static_cast<size_t>(by) * blocks_x + bx) * block_size;
+			byte decoded[16][4];
+			memset(decoded, 0, sizeof(decoded));
+			switch (format) {
+			case BLOCK_FORMAT_BC1:
+				_decode_bc1(in, false, decoded);
+				break;
+			case BLOCK_FORMAT_BC3:
+				_decode_bc1(in + 8, true, decoded);
+				_decode_bc4(in, 3, decoded);
+				break;
+			case BLOCK_FORMAT_BC4:
+				_decode_bc4(in, 0, decoded);
+				break;
+			case BLOCK_FORMAT_BC5:
+				_decode_bc4(in, 0, decoded);
+				_decode_bc4(in + 8, 1, decoded);
+				break;
+			case BLOCK_FORMAT_BC7:
+				_decode_bc7(in, decoded);
+				break;
+			}
+			if (format == BLOCK_FORMAT_BC4 || format == BLOCK_FORMAT_BC5) {
+				// missing channels read as 0, alpha as 1, like the sampler
+				for (auto& texel : decoded) {
+					texel[3] = 255;
+				}
+			}
+			for (int32 y = 0; y < 4 && by * 4 + y < size.y; ++y) {
+				for (int32 x = 0; x < 4 && bx * 4 + x < size.x; ++x) {
+					memcpy(static_cast<void*>(&out_texels[static_cast<size_t>(by * 4 + y) * size.x + bx * 4 + x]), decoded[y * 4 + x], 4);
+				}
+			}
+		}
+	}
+}
+}
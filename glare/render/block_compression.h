@@ -0,0 +1,77 @@
+/// glare/render/block_compression.h
+/// CPU encoder for the BC texture formats, for baking textures offline or at
+/// load time.
+///
+/// Every 4x4 block is fitted on its own: endpoints along the principal axis
+/// of the block colors (a bounding box in the fast preset), refined by least
+/// squares on the chosen indices, and kept when they lower the squared error
+/// against the decoded palette. BC7 uses the two single subset modes only,
+/// without the partition search of a full encoder: mode 6 (7.7.7.7 endpoints
+/// with a p-bit, 16 steps) for every block, and mode 5 (color and alpha
+/// fitted apart, 4 steps each) where it does better on translucent blocks.
+/// Partial blocks at the right and bottom edges repeat the edge texels.
+/// Block rows are split over job_system. The decoder reads what the encoder
+/// writes, for quality checks; nothing here needs a device.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include "glare/math/vector.h"
+#include <vector>
+
+namespace glare
+{
+class surface;
+
+enum e_block_format : uint8
+{
+	BLOCK_FORMAT_BC1,	// rgb, 1 bit alpha, 8 bytes a block
+	BLOCK_FORMAT_BC3,	// rgb as BC1 plus interpolated alpha, 16 bytes
+	BLOCK_FORMAT_BC4,	// red only, 8 bytes
+	BLOCK_FORMAT_BC5,	// red and green, 16 bytes, for normal maps
+	BLOCK_FORMAT_BC7,	// rgba, modes 5 and 6, 16 bytes
+};
+
+enum e_block_quality : uint8
+{
+	BLOCK_QUALITY_FAST,		// bounding box endpoints, no refinement
+	BLOCK_QUALITY_NORMAL,	// principal axis, one refinement
+	BLOCK_QUALITY_HIGH,		// more refinements, every BC1/BC4 mode and BC7 p-bit choice
+};
+
+struct block_compression_options
+{
+	e_block_format	format = BLOCK_FORMAT_BC1;
+	e_block_quality	quality = BLOCK_QUALITY_NORMAL;
+	// BC1, BC3 and BC7 upload as *_UNORM_SRGB; the encoder works on the stored values either way
+	bool			srgb = false;
+	// BC1 texels with alpha below this become transparent black, 0 keeps BC1 opaque
+	byte			alpha_threshold = 128;
+};
+
+struct compressed_level
+{
+	ivec2				size;	// in texels
+	std::vector<byte>	blocks;	// rows of blocks, top to bottom
+};
+
+struct compressed_image
+{
+	e_block_format					format = BLOCK_FORMAT_BC1;
+	bool							srgb = false;
+	std::vector<compressed_level>	levels;	// level 0 first
+};
+
+// Bytes per 4x4 block
+NODISCARD uint32 get_block_size(e_block_format format);
+// Bytes per row of blocks of a level <width> texels wide
+NODISCARD uint32 get_block_row_pitch(e_block_format format, int32 width);
+
+// Encodes one level, <out_blocks> is resized to fit
+void compress_blocks(const rgba8* texels, const ivec2& size, const block_compression_options& options, std::vector<byte>& out_blocks);
+// Level 0 and from_surface->m_mips, or a chain built here when the surface
+// has none and <with_mips> is set, filtered in sRGB when <options> is sRGB
+void compress_surface(const surface* from_surface, const block_compression_options& options, compressed_image& out_image, bool with_mips = true);
+// Decodes blocks written by compress_blocks()
+void decompress_blocks(const byte* blocks, const ivec2& size, e_block_format format, rgba8* out_texels);
+}
@@ -15,10 +15,11 @@ const buffer_layout* buffer_layout::acquire_layout(
 }
 
 buffer_layout::buffer_layout(const buffer_layout::attribute attr[])
+	: m_attributes(attr)
 {
 	m_stride = 0;
 	for (auto p = attr; !(p->is_null());++p) {
-		m_attributes.push_back(*p);
+		++m_attributes_count;
 		m_stride += get_size_of_hlsl_type(p->type);
 	}
 }
@@ -37,7 +38,8 @@ bool render_buffer::create(
 	const void* data, size_t buffer_size, size_t element_size, e_render_buffer_usage buffer_usage
 	, e_gpu_memory_usage memory_usage)
 {
-	if (buffer_size == 0 || !data) {
+	// only immutable buffers need initial data
+	if (buffer_size == 0 || (!data && memory_usage == GPU_MEMORY_IMMUTABLE)) {
 		return false;
 	}
 	DX_RELEASE(m_handle);
@@ -61,7 +63,7 @@ bool render_buffer::create(
 	memset(&data_desc, 0, sizeof(data_desc));
 	data_desc.pSysMem = data;
 	dx_device* device = m_renderer->get_dx_device();
-	HRESULT hr = device->CreateBuffer(&desc, &data_desc, &m_handle);
+	HRESULT hr = device->CreateBuffer(&desc, data ? &data_desc : nullptr, &m_handle);
 	if (SUCCEEDED(hr)) {
 		m_buffer_usage = buffer_usage;
 		m_memory_usage = memory_usage;
@@ -92,6 +94,37 @@ bool render_buffer::buffer(const void* data, size_t size)
 	return false;
 }
 
+void* render_buffer::map_discard()
+{
+	ASSERT(is_dynamic(), "Only dynamic buffers can be mapped.");
+	D3D11_MAPPED_SUBRESOURCE map;
+	HRESULT hr = m_renderer->get_dx_context()->Map(m_handle, 0, D3D11_MAP_WRITE_DISCARD, 0, &map);
+	if (FAILED(hr)) {
+		ALERT("Mapping gpu resource failed.");
+		return nullptr;
+	}
+	return map.pData;
+}
+
+void render_buffer::unmap()
+{
+	m_renderer->get_dx_context()->Unmap(m_handle, 0);
+}
+
+void render_buffer::update_range(const void* data, size_t offset, size_t size)
+{
+	ASSERT(m_memory_usage == GPU_MEMORY_GPU, "Only gpu buffers can be updated by range.");
+	ASSERT(offset + size <= m_buffer_size, "Updating out of the gpu buffer.");
+	D3D11_BOX box;
+	box.left	= static_cast<UINT>(offset);
+	box.right	= static_cast<UINT>(offset + size);
+	box.top		= 0;
+	box.bottom	= 1;
+	box.front	= 0;
+	box.back	= 1;
+	m_renderer->get_dx_context()->UpdateSubresource(m_handle, 0, &box, data, 0, 0);
+}
+
 constant_buffer::constant_buffer(renderer* r)
 	:render_buffer(r)
 {
@@ -149,10 +182,11 @@ index_buffer::index_buffer(renderer* r)
 
 bool index_buffer::buffer(const void* data, size_t count)
 {
-	const size_t size = count * sizeof(index_t);
+	const size_t index_size = get_size_of_index_type(m_index_type);
+	const size_t size = count * index_size;
 	bool result;
 	if (size > m_buffer_size || is_immutable()) {
-		result = create(data, size, sizeof(index_t), RENDER_BUFFER_INDEX, GPU_MEMORY_DYNAMIC);
+		result = create(data, size, index_size, RENDER_BUFFER_INDEX, GPU_MEMORY_DYNAMIC);
 	} else {
 		result = render_buffer::buffer(data, size);
 	}
@@ -162,11 +196,13 @@ bool index_buffer::buffer(const void* data, size_t count)
 	return result;
 }
 
-bool index_buffer::create_immutable_buffer(const index_t* data, size_t count)
+bool index_buffer::create_immutable_buffer(const void* data, size_t count, e_index_type type)
 {
-	const bool result = create(data, count * sizeof(index_t), sizeof(index_t), RENDER_BUFFER_INDEX, GPU_MEMORY_IMMUTABLE);
+	const size_t index_size = get_size_of_index_type(type);
+	const bool result = create(data, count * index_size, index_size, RENDER_BUFFER_INDEX, GPU_MEMORY_IMMUTABLE);
 	if (result) {
 		m_count = count;
+		m_index_type = type;
 	}
 	return result;
 }
@@ -178,5 +214,4 @@ STATIC buffer_layout::attribute buffer_layout::attribute::END()
 	static attribute _END;
 	return _END;
 }
-STATIC std::unordered_map<std::type_index, const buffer_layout*> buffer_layout::s_cached_layout;
 };
@@ -1,78 +1,124 @@
 #pragma once
 #include "glare/core/common.h"
 #include "glare/render/common.h"
-#include <unordered_map>
-#include <typeindex>
 
 namespace glare
 {
 struct super_vertex;
 class renderer;
+// The low byte is the size in bytes, the packed types tell themselves apart above it
 enum e_hlsl_type : uint32
 {
 	HLSL_NULL = 0,
 	HLSL_FLOAT = sizeof(float32),
 	HLSL_FLOAT2 = 2 * sizeof(float32),
 	HLSL_FLOAT3 = 3 * sizeof(float32),
-	HLSL_FLOAT4 = 4 * sizeof(float32)
+	HLSL_FLOAT4 = 4 * sizeof(float32),
+	HLSL_UNORM8X4 = 0x100 | (4 * sizeof(uint8)),	// read as float4 in [0, 1]
+	HLSL_HALF2 = 0x200 | (2 * sizeof(uint16)),		// read as float2
+	HLSL_UNORM16X2 = 0x300 | (2 * sizeof(uint16)),	// read as float2 in [0, 1]
+	HLSL_SIZE_MASK = 0xff
 };
 using super_vertex_copier = void(*) (void* dst, const super_vertex* src, size_t count);
 
-inline size_t get_size_of_hlsl_type(e_hlsl_type t)
+constexpr size_t get_size_of_hlsl_type(e_hlsl_type t)
+{
+	return static_cast<size_t>(t & HLSL_SIZE_MASK);
+}
+
+constexpr size_t get_component_count_of_hlsl_type(e_hlsl_type t)
+{
+	return t == HLSL_UNORM8X4 ? 4u : (t == HLSL_HALF2 || t == HLSL_UNORM16X2) ? 2u : get_size_of_hlsl_type(t) / sizeof(float32);
+}
+
+enum e_input_rate : uint8
+{
+	INPUT_PER_VERTEX	= D3D11_INPUT_PER_VERTEX_DATA,
+	INPUT_PER_INSTANCE	= D3D11_INPUT_PER_INSTANCE_DATA,	// advances once per instance
+};
+
+// The value is the size in bytes
+enum e_index_type : uint8
+{
+	INDEX_UINT16 = sizeof(uint16),
+	INDEX_UINT32 = sizeof(uint32),
+};
+
+constexpr size_t get_size_of_index_type(e_index_type t)
 {
 	return static_cast<size_t>(t);
 }
 
+constexpr dx_format get_dx_format_of_index_type(e_index_type t)
+{
+	return t == INDEX_UINT16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+}
+
+// The narrowest type addressing <vertex_count> vertices
+constexpr e_index_type get_index_type_for_vertex_count(size_t vertex_count)
+{
+	return vertex_count <= 0x10000u ? INDEX_UINT16 : INDEX_UINT32;
+}
+
+// Compile time description of a vertex type, see render/vertex_format.h
+template<typename V>
+struct vertex_format;
+
+// The attribute table is not copied, it must outlive the layout (static tables do)
 class buffer_layout
 {
 public:
 	struct attribute
 	{
 	public:
-		string name;
+		const char* name = nullptr;	// HLSL semantic
 		e_hlsl_type type = HLSL_NULL;
 		size_t offset = 0;
+		uint32 semantic_index = 0;	// the N of a SEMANTIC<N> shader input
 		
-		attribute() = default;
-		attribute(string name, e_hlsl_type type, size_t offset)
-			: name(std::move(name)), type(type), offset(offset)
+		constexpr attribute() = default;
+		constexpr attribute(const char* name, e_hlsl_type type, size_t offset, uint32 semantic_index = 0)
+			: name(name), type(type), offset(offset), semantic_index(semantic_index)
 		{}
 
-		NODISCARD bool is_null() const { return type == HLSL_NULL; }
+		NODISCARD constexpr bool is_null() const { return type == HLSL_NULL; }
 
 		static attribute END();
 	};
 public:
-	static std::unordered_map<std::type_index, const buffer_layout*> s_cached_layout;
+	// Runtime layouts, for attributes only known at runtime. Never freed
 	static const buffer_layout* acquire_layout(const attribute attr[], size_t stride, super_vertex_copier copy_func);
 
+	// The layout of a type with a vertex_format, built at compile time
 	template<typename T>
-	static const buffer_layout* acquire_layout_of()
+	static constexpr const buffer_layout* acquire_layout_of()
 	{
-		std::type_index key(typeid(T));
-		const auto found = s_cached_layout.find(key);
-		if (found == std::cend(s_cached_layout)) {
-			const buffer_layout* created = acquire_layout(T::_s_attr, sizeof(T), T::_copy_from_super_vertex);
-			s_cached_layout.emplace(std::make_pair(key, created));
-			return created;
-		}
-		return found->second;
+		return &vertex_format<T>::LAYOUT;
 	}
 
 public:
-	buffer_layout() = default;
+	constexpr buffer_layout() = default;
+	// <attr> ends with attribute::END(), the stride is the sum of the attribute sizes
 	buffer_layout(const attribute attr[]);
+	// <copy_func> may be nullptr for data not built from super_vertex, such as instances
+	constexpr buffer_layout(const attribute attr[], size_t count, size_t stride, super_vertex_copier copy_func
+		, e_input_rate input_rate = INPUT_PER_VERTEX)
+		: m_attributes(attr), m_attributes_count(count), m_stride(stride), m_copy_func(copy_func), m_input_rate(input_rate)
+	{}
 	const attribute& operator[] (size_t index) const { return m_attributes[index]; }
-	NODISCARD size_t get_attributes_count() const { return m_attributes.size(); }
+	NODISCARD size_t get_attributes_count() const { return m_attributes_count; }
 	NODISCARD size_t get_stride() const { return m_stride; }
+	NODISCARD e_input_rate get_input_rate() const { return m_input_rate; }
 	void copy_from_super_vertex(void* dst, const super_vertex* src, size_t count) const
 	{
 		m_copy_func(dst, src, count);
 	}
 public:
-	std::vector<attribute> m_attributes;
-	size_t m_stride;
+	const attribute* m_attributes = nullptr;
+	size_t m_attributes_count = 0;
+	size_t m_stride = 0;
 	super_vertex_copier m_copy_func = nullptr;
+	e_input_rate m_input_rate = INPUT_PER_VERTEX;
 };
 
 class render_buffer
@@ -88,6 +134,12 @@ public:
 
 	bool create(const void* data, size_t buffer_size, size_t element_size, e_render_buffer_usage buffer_usage, e_gpu_memory_usage memory_usage);
 	virtual bool buffer(const void* data, size_t size);
+	// Dynamic buffers: maps the whole buffer for writing, the previous content is lost
+	// Return: nullptr on failure, otherwise call unmap() once written
+	NODISCARD void* map_discard();
+	void unmap();
+	// GPU buffers: copies <size> bytes of <data> at byte <offset>
+	void update_range(const void* data, size_t offset, size_t size);
 
 	renderer*				m_renderer		= nullptr;
 	e_render_buffer_usage	m_buffer_usage	= RENDER_BUFFER_CONSTANT;
@@ -125,26 +177,24 @@ public:
 
 class index_buffer : public render_buffer
 {
-public:
-#if defined(GLARE_INDEX_T_UINT32)
-	using index_t = uint32;
-	static inline constexpr dx_format format = DXGI_FORMAT_R32_UINT;
-#endif
-#if defined(GLARE_INDEX_T_UINT16)
-	using index_t = uint16;
-	static inline constexpr dx_format format = DXGI_FORMAT_R16_UINT;
-#endif
 public:
 	index_buffer(renderer* r);
 
 	virtual ~index_buffer() override = default;
+	// <count> indices of get_index_type()
 	virtual bool buffer(const void* data, size_t count) override;
 
-	bool create_immutable_buffer(const index_t* data, size_t count);
+	bool create_immutable_buffer(const void* data, size_t count, e_index_type type);
+	// The type of the next buffer() or create(), bind_ibo() reads it
+	void set_index_type(e_index_type type) { m_index_type = type; }
+
 	NODISCARD size_t get_count() const { return m_count; }
+	NODISCARD e_index_type get_index_type() const { return m_index_type; }
+	NODISCARD dx_format get_format() const { return get_dx_format_of_index_type(m_index_type); }
 
 public:
 	size_t m_count = 0;
+	e_index_type m_index_type = INDEX_UINT32;
 };
 
 };
\ No newline at end of file
@@ -9,8 +9,6 @@
 
 namespace glare {
 
-//#define GLARE_INDEX_T_UINT16
-#define GLARE_INDEX_T_UINT32
 #define GLARE_RENDERER_DEBUG_LEAK	1
 #define GLARE_RENDERER_DEBUG_SHADER 10
 
@@ -79,6 +77,13 @@ enum e_texture_slot : uint32
 	TEXTURE_SLOT_METALLIC = 5
 };
 
+enum e_vertex_stream : uint32
+{
+	VERTEX_STREAM_GEOMETRY	= 0,	// per vertex data
+	VERTEX_STREAM_INSTANCE	= 1,	// per instance data, for the instanced draws
+	NUM_VERTEX_STREAMS
+};
+
 enum e_constant_buffer_id : uint32
 {
 	CONSTANT_FRAME_BUFFER	= 1,
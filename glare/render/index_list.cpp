@@ -0,0 +1,87 @@
+#include "glare/render/index_list.h"
+#include "glare/core/assert.h"
+
+namespace glare
+{
+void index_list::push_back(uint32 index)
+{
+	if (m_type == INDEX_UINT16) {
+		if (index <= 0xffffu) {
+			m_indices16.push_back(static_cast<uint16>(index));
+			return;
+		}
+		set_index_type(INDEX_UINT32);
+	}
+	m_indices32.push_back(index);
+}
+
+void index_list::set(size_t i, uint32 index)
+{
+	if (m_type == INDEX_UINT16) {
+		if (index <= 0xffffu) {
+			m_indices16[i] = static_cast<uint16>(index);
+			return;
+		}
+		set_index_type(INDEX_UINT32);
+	}
+	m_indices32[i] = index;
+}
+
+void index_list::resize(size_t count)
+{
+	if (m_type == INDEX_UINT16) {
+		m_indices16.resize(count);
+	} else {
+		m_indices32.resize(count);
+	}
+}
+
+void index_list::reserve(size_t count)
+{
+	if (m_type == INDEX_UINT16) {
+		m_indices16.reserve(count);
+	} else {
+		m_indices32.reserve(count);
+	}
+}
+
+void index_list::clear()
+{
+	m_indices16.clear();
+	m_indices32.clear();
+	m_type = INDEX_UINT16;
+}
+
+void index_list::set_index_type(e_index_type type)
+{
+	if (type == m_type) {
+		return;
+	}
+	if (type == INDEX_UINT32) {
+		m_indices32.assign(m_indices16.begin(), m_indices16.end());
+		m_indices16.clear();
+		m_indices16.shrink_to_fit();
+	} else {
+		m_indices16.resize(m_indices32.size());
+		for (size_t i = 0; i < m_indices32.size(); ++i) {
+			ASSERT(m_indices32[i] <= 0xffffu, "Narrowing an index list that holds 32 bit indices");
+			m_indices16[i] = static_cast<uint16>(m_indices32[i]);
+		}
+		m_indices32.clear();
+		m_indices32.shrink_to_fit();
+	}
+	m_type = type;
+}
+
+uint16* index_list::get_data16()
+{
+	ASSERT(m_type == INDEX_UINT16, "16 bit access to a 32 bit index list");
+	return m_indices16.data();
+}
+
+uint32* index_list::get_data32()
+{
+	ASSERT(m_type == INDEX_UINT32, "32 bit access to a 16 bit index list");
+	return m_indices32.data();
+}
+}
@@ -0,0 +1,51 @@
+/// glare/render/index_list.h
+/// CPU side indices stored at the narrowest width that holds them.
+///
+/// The list starts 16 bit and widens to 32 bit the first time an index
+/// above 0xffff is written, it only narrows again on clear(). data() is
+/// laid out for get_index_type(), so it uploads as is and bind_ibo() picks
+/// the DXGI format from the index_buffer that received it. Values are read
+/// and written as uint32 whatever the width.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/buffer.h"
+#include <vector>
+
+namespace glare
+{
+class index_list
+{
+public:
+	index_list() = default;
+
+	void push_back(uint32 index);
+	void set(size_t i, uint32 index);
+	NODISCARD uint32 operator[] (size_t i) const
+	{
+		return m_type == INDEX_UINT16 ? m_indices16[i] : m_indices32[i];
+	}
+
+	// New indices are 0
+	void resize(size_t count);
+	void reserve(size_t count);
+	// Back to empty and 16 bit
+	void clear();
+	// Converts the content, narrowing requires every index to fit
+	void set_index_type(e_index_type type);
+
+	NODISCARD size_t size() const				{ return m_type == INDEX_UINT16 ? m_indices16.size() : m_indices32.size(); }
+	NODISCARD bool empty() const				{ return size() == 0; }
+	NODISCARD e_index_type get_index_type() const { return m_type; }
+	NODISCARD size_t get_size_in_bytes() const	{ return size() * get_size_of_index_type(m_type); }
+	NODISCARD const void* data() const			{ return m_type == INDEX_UINT16 ? static_cast<const void*>(m_indices16.data()) : m_indices32.data(); }
+	// Typed access for bulk writes, the type must match
+	NODISCARD uint16* get_data16();
+	NODISCARD uint32* get_data32();
+
+private:
+	e_index_type		m_type = INDEX_UINT16;
+	std::vector<uint16>	m_indices16;
+	std::vector<uint32>	m_indices32;
+};
+}
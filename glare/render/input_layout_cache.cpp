@@ -0,0 +1,118 @@
+#include "glare/render/input_layout_cache.h"
+#include "glare/render/buffer.h"
+#include "glare/core/assert.h"
+#include "glare/core/hash.h"
+
+namespace glare
+{
+static DXGI_FORMAT _get_dxgi_format(e_hlsl_type type)
+{
+	switch(type) {
+	case HLSL_NULL:
+		return DXGI_FORMAT_UNKNOWN;
+	case HLSL_FLOAT:
+		return DXGI_FORMAT_R32_FLOAT;
+	case HLSL_FLOAT2:
+		return DXGI_FORMAT_R32G32_FLOAT;
+	case HLSL_FLOAT3:
+		return DXGI_FORMAT_R32G32B32_FLOAT;
+	case HLSL_FLOAT4:
+		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case HLSL_UNORM8X4:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case HLSL_HALF2:
+		return DXGI_FORMAT_R16G16_FLOAT;
+	case HLSL_UNORM16X2:
+		return DXGI_FORMAT_R16G16_UNORM;
+	default:
+		break;
+	}
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+dx_input_layout_device::dx_input_layout_device(dx_device* device)
+	: m_device(device)
+{
+}
+
+dx_layout* dx_input_layout_device::create_input_layout(const D3D11_INPUT_ELEMENT_DESC* elements, uint32 element_count
+	, const void* vs_bytecode, size_t vs_bytecode_size)
+{
+	dx_layout* created = nullptr;
+	HRESULT hr = m_device->CreateInputLayout(elements, element_count, vs_bytecode, vs_bytecode_size, &created);
+	if (FAILED(hr)) {
+		FATAL("Creating vbo input layout failed");
+	}
+	return created;
+}
+
+void dx_input_layout_device::release_input_layout(dx_layout* layout)
+{
+	DX_RELEASE(layout);
+}
+
+size_t input_layout_cache::key_hasher::operator()(const key& k) const
+{
+	const uint64 layouts = reinterpret_cast<uintptr_t>(k.layout) * 0x9e3779b97f4a7c15ull
+		^ reinterpret_cast<uintptr_t>(k.instance_layout) * 0xc2b2ae3d27d4eb4full;
+	return static_cast<size_t>(k.vs_hash ^ layouts);
+}
+
+input_layout_cache::input_layout_cache(i_input_layout_device* device)
+	: m_device(device)
+{
+	ASSERT(m_device, "input_layout_cache needs a device");
+}
+
+input_layout_cache::~input_layout_cache()
+{
+	for (auto& each : m_layouts) {
+		m_device->release_input_layout(each.second);
+	}
+	delete m_device;
+}
+
+dx_layout* input_layout_cache::acquire(const void* vs_bytecode, size_t vs_bytecode_size, uint64 vs_hash
+	, const buffer_layout* layout, const buffer_layout* instance_layout)
+{
+	ASSERT(layout, "Invalid buffer layout object");
+	const key lookup = {vs_hash, layout, instance_layout};
+	const auto found = m_layouts.find(lookup);
+	if (found != m_layouts.end()) {
+		++m_stats.reused;
+		return found->second;
+	}
+
+	m_elements.clear();
+	add_elements(layout, VERTEX_STREAM_GEOMETRY);
+	if (instance_layout) {
+		add_elements(instance_layout, VERTEX_STREAM_INSTANCE);
+	}
+	dx_layout* created = m_device->create_input_layout(m_elements.data(), static_cast<uint32>(m_elements.size()), vs_bytecode, vs_bytecode_size);
+	m_layouts.emplace(lookup, created);
+	++m_stats.created;
+	return created;
+}
+
+void input_layout_cache::add_elements(const buffer_layout* layout, e_vertex_stream stream)
+{
+	const bool per_instance = layout->get_input_rate() == INPUT_PER_INSTANCE;
+	const size_t attr_count = layout->get_attributes_count();
+	for (size_t i = 0; i < attr_count; ++i) {
+		auto& item = (*layout)[i];
+		D3D11_INPUT_ELEMENT_DESC& desc = m_elements.emplace_back();
+		desc.SemanticName = item.name;
+		desc.SemanticIndex = item.semantic_index;
+		desc.Format = _get_dxgi_format(item.type);
+		desc.InputSlot = stream;
+		desc.AlignedByteOffset = static_cast<UINT>(item.offset);
+		desc.InputSlotClass = static_cast<D3D11_INPUT_CLASSIFICATION>(layout->get_input_rate());
+		desc.InstanceDataStepRate = per_instance ? 1 : 0;
+	}
+}
+
+STATIC uint64 input_layout_cache::hash_bytecode(const void* bytecode, size_t size)
+{
+	return hash_fnv1a(bytecode, size);
+}
+}
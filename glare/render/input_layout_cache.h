@@ -0,0 +1,97 @@
+/// glare/render/input_layout_cache.h
+/// Input layouts shared by every shader, by (vertex shader bytecode, buffer_layouts).
+///
+/// A shader switching between meshes of different layouts finds its input
+/// layouts here instead of re-creating one on each switch, and shaders
+/// compiled to identical vertex shader bytecode share them. The cache owns
+/// the layouts: acquire() returns a borrowed pointer, valid until the cache
+/// is destroyed. vertex_format layouts are static and acquire_layout() never
+/// frees its layouts, so the buffer_layout address is a stable key.
+///
+/// An instanced draw adds the instance stream layout to the key: its
+/// attributes go to input slot VERTEX_STREAM_INSTANCE.
+///
+/// Layouts are created through an i_input_layout_device, so the cache can be
+/// driven by a stub without D3D.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/common.h"
+#include <unordered_map>
+#include <vector>
+
+namespace glare
+{
+class buffer_layout;
+
+class i_input_layout_device
+{
+public:
+	virtual ~i_input_layout_device() = default;
+	NODISCARD virtual dx_layout* create_input_layout(const D3D11_INPUT_ELEMENT_DESC* elements, uint32 element_count
+		, const void* vs_bytecode, size_t vs_bytecode_size) = 0;
+	virtual void release_input_layout(dx_layout* layout) = 0;
+};
+
+class dx_input_layout_device final : public i_input_layout_device
+{
+public:
+	explicit dx_input_layout_device(dx_device* device);
+	NODISCARD dx_layout* create_input_layout(const D3D11_INPUT_ELEMENT_DESC* elements, uint32 element_count
+		, const void* vs_bytecode, size_t vs_bytecode_size) override;
+	void release_input_layout(dx_layout* layout) override;
+private:
+	dx_device* m_device = nullptr;
+};
+
+struct input_layout_cache_stats
+{
+	uint32 created	= 0;
+	uint32 reused	= 0;
+};
+
+class input_layout_cache
+{
+public:
+	// Takes ownership of <device>
+	explicit input_layout_cache(i_input_layout_device* device);
+	~input_layout_cache();
+	input_layout_cache(const input_layout_cache&) = delete;
+	input_layout_cache& operator=(const input_layout_cache&) = delete;
+
+	// <vs_hash> from hash_bytecode() of <vs_bytecode>
+	// <instance_layout>: nullptr when not drawing instanced
+	NODISCARD dx_layout* acquire(const void* vs_bytecode, size_t vs_bytecode_size, uint64 vs_hash
+		, const buffer_layout* layout, const buffer_layout* instance_layout = nullptr);
+
+	// FNV-1a over the bytecode
+	NODISCARD static uint64 hash_bytecode(const void* bytecode, size_t size);
+
+	NODISCARD size_t get_layout_count() const { return m_layouts.size(); }
+	NODISCARD const input_layout_cache_stats& get_stats() const { return m_stats; }
+
+private:
+	struct key
+	{
+		uint64					vs_hash;
+		const buffer_layout*	layout;
+		const buffer_layout*	instance_layout;
+		bool operator==(const key& other) const
+		{
+			return vs_hash == other.vs_hash && layout == other.layout && instance_layout == other.instance_layout;
+		}
+	};
+	struct key_hasher
+	{
+		size_t operator()(const key& k) const;
+	};
+
+private:
+	i_input_layout_device*	m_device = nullptr;
+	std::unordered_map<key, dx_layout*, key_hasher> m_layouts;
+	std::vector<D3D11_INPUT_ELEMENT_DESC> m_elements; // reused between creations
+	input_layout_cache_stats m_stats;
+private:
+	void add_elements(const buffer_layout* layout, e_vertex_stream stream);
+};
+}
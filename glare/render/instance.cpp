@@ -0,0 +1,68 @@
+#include "glare/render/instance.h"
+#include "glare/math/obb2.h"
+#include "glare/math/obb2_batch.h"
+#include "glare/math/simd.h"
+
+namespace glare
+{
+instance_2d make_instance_2d(const obb2& box, const rgba& tint)
+{
+	instance_2d result;
+	result.position = box.center;
+	result.axis_x = box.right * box.extends.x;
+	result.axis_y = box.up() * box.extends.y;
+	result.tint = vertex_packing::pack_unorm8x4(tint);
+	return result;
+}
+
+void pack_instances_2d(const obb2_soa& boxes, const rgba* tints, instance_2d* out)
+{
+	const size_t count = boxes.count;
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 sign = _mm_set1_ps(-0.f);
+	for (; i + 4 <= count; i += 4) {
+		const __m128 right_x = _mm_loadu_ps(boxes.right_x + i);
+		const __m128 right_y = _mm_loadu_ps(boxes.right_y + i);
+		const __m128 extends_x = _mm_loadu_ps(boxes.extends_x + i);
+		const __m128 extends_y = _mm_loadu_ps(boxes.extends_y + i);
+		// rows become position.xy, axis_x.xy of one instance
+		__m128 row0 = _mm_loadu_ps(boxes.center_x + i);
+		__m128 row1 = _mm_loadu_ps(boxes.center_y + i);
+		__m128 row2 = _mm_mul_ps(right_x, extends_x);
+		__m128 row3 = _mm_mul_ps(right_y, extends_x);
+		_MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+		// up() is right rotated by +90 degrees
+		const __m128 axis_y_x = _mm_mul_ps(_mm_xor_ps(right_y, sign), extends_y);
+		const __m128 axis_y_y = _mm_mul_ps(right_x, extends_y);
+		const __m128 axis_y_01 = _mm_unpacklo_ps(axis_y_x, axis_y_y);
+		const __m128 axis_y_23 = _mm_unpackhi_ps(axis_y_x, axis_y_y);
+
+		instance_2d* to = out + i;
+		_mm_storeu_ps(&to[0].position.x, row0);
+		_mm_storeu_ps(&to[1].position.x, row1);
+		_mm_storeu_ps(&to[2].position.x, row2);
+		_mm_storeu_ps(&to[3].position.x, row3);
+		_mm_storel_pi(reinterpret_cast<__m64*>(&to[0].axis_y), axis_y_01);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(&to[1].axis_y), axis_y_01);
+		_mm_storel_pi(reinterpret_cast<__m64*>(&to[2].axis_y), axis_y_23);
+		_mm_storeh_pi(reinterpret_cast<__m64*>(&to[3].axis_y), axis_y_23);
+	}
+#endif
+	for (; i < count; ++i) {
+		const obb2 box = boxes.get(i);
+		out[i].position = box.center;
+		out[i].axis_x = box.right * box.extends.x;
+		out[i].axis_y = box.up() * box.extends.y;
+	}
+
+	if (tints) {
+		vertex_packing::pack_unorm8x4(reinterpret_cast<byte*>(out) + offsetof(instance_2d, tint), sizeof(instance_2d)
+			, reinterpret_cast<const byte*>(tints), sizeof(rgba), count);
+	} else {
+		for (size_t k = 0; k < count; ++k) {
+			out[k].tint = rgba8();
+		}
+	}
+}
+}
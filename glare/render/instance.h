@@ -0,0 +1,53 @@
+/// glare/render/instance.h
+/// Per instance data for the hardware instancing path.
+///
+/// An instance buffer is a vertex_buffer whose layout is INPUT_PER_INSTANCE,
+/// bound to VERTEX_STREAM_INSTANCE next to the shared mesh:
+///
+///	instances.set_buffer_layout(buffer_layout::acquire_layout_of<instance_2d>());
+///	instances.buffer(packed.data(), packed.size());
+///	r->draw_mesh_instanced(quad, &instances, packed.size());
+///
+/// Packing runs on the CPU only, so it can be checked without a device.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include "glare/math/vector.h"
+#include "glare/render/buffer.h"
+#include "glare/render/vertex_format.h"
+
+namespace glare
+{
+struct obb2;
+struct obb2_soa;
+
+// A 2D affine transform and a tint, 28 bytes. The vertex shader places a mesh
+// spanning [-1, 1] as position + x * axis_x + y * axis_y.
+struct instance_2d
+{
+	vec2 position;
+	vec2 axis_x;
+	vec2 axis_y;
+	rgba8 tint;
+};
+
+template<> struct vertex_format<instance_2d>
+{
+	static constexpr size_t STRIDE = sizeof(instance_2d);
+	static constexpr size_t ATTRIBUTES_COUNT = 4;
+	static constexpr buffer_layout::attribute ATTRIBUTES_TABLE[] = {
+		buffer_layout::attribute("INSTANCE_POSITION",	HLSL_FLOAT2,	offsetof(instance_2d, position)),
+		buffer_layout::attribute("INSTANCE_AXIS",		HLSL_FLOAT2,	offsetof(instance_2d, axis_x), 0),
+		buffer_layout::attribute("INSTANCE_AXIS",		HLSL_FLOAT2,	offsetof(instance_2d, axis_y), 1),
+		buffer_layout::attribute("INSTANCE_COLOR",		HLSL_UNORM8X4,	offsetof(instance_2d, tint)),
+		buffer_layout::attribute(),
+	};
+	static constexpr buffer_layout LAYOUT = buffer_layout(ATTRIBUTES_TABLE, ATTRIBUTES_COUNT, STRIDE, nullptr, INPUT_PER_INSTANCE);
+};
+
+NODISCARD instance_2d make_instance_2d(const obb2& box, const rgba& tint);
+// Packs boxes.count instances into <out>, 4 at a time with SSE2.
+// tints: boxes.count colors, or nullptr for white.
+void pack_instances_2d(const obb2_soa& boxes, const rgba* tints, instance_2d* out);
+}
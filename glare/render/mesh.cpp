@@ -12,22 +12,115 @@ void mesh::clear()
 
 void mesh::update_gpu_mesh(renderer* r)
 {
-	if (m_vertex_dirty) {
-		ASSERT(m_layout, "Buffer layout must be assigned.");
+	ASSERT(m_layout, "Buffer layout must be assigned.");
+	if (m_usage == MESH_STATIC) {
+		upload_static(r);
+	} else {
+		upload_vertices(r);
+		upload_indices(r);
+	}
+	m_vertex_dirty = false;
+	m_indices_dirty = false;
+	m_vertex_dirty_range.clear();
+	m_index_dirty_range.clear();
+}
+
+void mesh::upload_static(renderer* r)
+{
+	if (m_vertex_dirty || !m_vertex_dirty_range.is_empty()) {
 		delete m_gpu_vbo;
 		m_gpu_vbo = new vertex_buffer(r);
 		const size_t vertex_count = get_vertex_count();
-		const size_t vbo_size = m_layout->get_stride() * vertex_count;
-		byte* buffer = new byte[vbo_size];
-		m_layout->copy_from_super_vertex(buffer, m_verts.data(), vertex_count);
-		m_gpu_vbo->create_immutable_buffer(buffer, vertex_count, m_layout);
-		delete[] buffer;
-		m_vertex_dirty = false;
-	}
-	if (m_using_ibo && m_indices_dirty) {
+		std::vector<byte> buffer(m_layout->get_stride() * vertex_count);
+		m_layout->copy_from_super_vertex(buffer.data(), m_verts.data(), vertex_count);
+		m_gpu_vbo->create_immutable_buffer(buffer.data(), vertex_count, m_layout);
+	}
+	if (m_using_ibo && (m_indices_dirty || !m_index_dirty_range.is_empty())) {
 		delete m_gpu_ibo;
 		m_gpu_ibo = new index_buffer(r);
-		m_gpu_ibo->create_immutable_buffer(m_indices.data(), m_indices.size());
+		m_gpu_ibo->create_immutable_buffer(m_indices.data(), m_indices.size(), m_indices.get_index_type());
 	}
 }
+
+void mesh::upload_vertices(renderer* r)
+{
+	const size_t vertex_count = get_vertex_count();
+	if ((!m_vertex_dirty && m_vertex_dirty_range.is_empty()) || vertex_count == 0) {
+		return;
+	}
+	const size_t stride = m_layout->get_stride();
+	const size_t size = stride * vertex_count;
+	bool whole = m_vertex_dirty || m_usage == MESH_DYNAMIC;
+	if (!m_gpu_vbo || m_gpu_vbo->get_buffer_size() < size) {
+		if (!m_gpu_vbo) {
+			m_gpu_vbo = new vertex_buffer(r);
+		}
+		// room to grow, appending is frequent with mesh_builder
+		const size_t capacity = std::max(size, m_gpu_vbo->get_buffer_size() * 2);
+		m_gpu_vbo->create(nullptr, capacity, stride, RENDER_BUFFER_VERTEX
+			, m_usage == MESH_DYNAMIC ? GPU_MEMORY_DYNAMIC : GPU_MEMORY_GPU);
+		m_gpu_vbo->set_buffer_layout(m_layout);
+		whole = true;
+	}
+	m_gpu_vbo->m_count = vertex_count;
+
+	if (m_usage == MESH_DYNAMIC) {
+		void* mapped = m_gpu_vbo->map_discard();
+		if (mapped) {
+			m_layout->copy_from_super_vertex(mapped, m_verts.data(), vertex_count);
+			m_gpu_vbo->unmap();
+		}
+		return;
+	}
+	const size_t first = whole ? 0 : m_vertex_dirty_range.m_begin;
+	const size_t last = whole ? vertex_count : std::min(m_vertex_dirty_range.m_end, vertex_count);
+	if (first < last) {
+		m_upload_scratch.resize((last - first) * stride);
+		m_layout->copy_from_super_vertex(m_upload_scratch.data(), m_verts.data() + first, last - first);
+		m_gpu_vbo->update_range(m_upload_scratch.data(), first * stride, m_upload_scratch.size());
+	}
+}
+
+void mesh::upload_indices(renderer* r)
+{
+	const size_t index_count = get_indices_count();
+	if (!m_using_ibo || (!m_indices_dirty && m_index_dirty_range.is_empty()) || index_count == 0) {
+		return;
+	}
+	const e_index_type index_type = m_indices.get_index_type();
+	const size_t index_size = get_size_of_index_type(index_type);
+	const size_t size = m_indices.get_size_in_bytes();
+	bool whole = m_indices_dirty || m_usage == MESH_DYNAMIC;
+	if (!m_gpu_ibo || m_gpu_ibo->get_buffer_size() < size) {
+		if (!m_gpu_ibo) {
+			m_gpu_ibo = new index_buffer(r);
+		}
+		const size_t capacity = std::max(size, m_gpu_ibo->get_buffer_size() * 2);
+		m_gpu_ibo->create(nullptr, capacity, index_size, RENDER_BUFFER_INDEX
+			, m_usage == MESH_DYNAMIC ? GPU_MEMORY_DYNAMIC : GPU_MEMORY_GPU);
+		whole = true;
+	}
+	if (m_gpu_ibo->get_index_type() != index_type) {
+		// the list widened, every index moved
+		m_gpu_ibo->set_index_type(index_type);
+		whole = true;
+	}
+	m_gpu_ibo->m_count = index_count;
+
+	if (m_usage == MESH_DYNAMIC) {
+		void* mapped = m_gpu_ibo->map_discard();
+		if (mapped) {
+			memcpy(mapped, m_indices.data(), size);
+			m_gpu_ibo->unmap();
+		}
+		return;
+	}
+	// indices need no conversion, they go straight from the mesh
+	const size_t first = whole ? 0 : m_index_dirty_range.m_begin;
+	const size_t last = whole ? index_count : std::min(m_index_dirty_range.m_end, index_count);
+	if (first < last) {
+		const byte* indices = static_cast<const byte*>(m_indices.data());
+		m_gpu_ibo->update_range(indices + first * index_size, first * index_size, (last - first) * index_size);
+	}
 }
+}
\ No newline at end of file
@@ -3,19 +3,40 @@
 #include "glare/render/common.h"
 #include "glare/render/buffer.h"
 #include "glare/render/vertex.h"
+#include "glare/render/index_list.h"
+#include <algorithm>
 namespace glare
 {
+enum e_mesh_usage : uint8
+{
+	MESH_STATIC,	// immutable buffers, rebuilt when anything changed
+	MESH_DYNAMIC,	// rewritten as a whole each update, converted straight into mapped memory
+	MESH_SPARSE,	// few elements change per update, only the dirty ranges are uploaded
+};
+
 class mesh
 {
 public:
-	using index_t = index_buffer::index_t;
+	using index_t = uint32;	// index values, m_indices stores them 16 bit while they fit
+
+	// Elements [m_begin, m_end) changed since the last upload
+	struct dirty_range
+	{
+		size_t m_begin	= SIZE_MAX;
+		size_t m_end	= 0;
+
+		void add(size_t first, size_t count)	{ m_begin = std::min(m_begin, first); m_end = std::max(m_end, first + count); }
+		void clear()							{ m_begin = SIZE_MAX; m_end = 0; }
+		NODISCARD bool is_empty() const			{ return m_begin >= m_end; }
+	};
 public:
-	mesh(const buffer_layout* layout) : m_layout(layout) {}
+	mesh(const buffer_layout* layout, e_mesh_usage usage = MESH_STATIC) : m_layout(layout), m_usage(usage) {}
 	mesh(const mesh& copy_from)
 		: m_verts(copy_from.m_verts)
 		, m_indices(copy_from.m_indices)
 		, m_builder_brush(copy_from.m_builder_brush)
 		, m_layout(copy_from.m_layout)
+		, m_usage(copy_from.m_usage)
 		, m_using_ibo(copy_from.m_using_ibo)
 	{
 	}
@@ -30,20 +51,33 @@ public:
 	NODISCARD bool	 is_indexed()		 const { return m_using_ibo; }
 	NODISCARD size_t get_element_count() const { return is_indexed() ? get_indices_count() : get_vertex_count(); }
 
+	// Elements changed in place or appended, see e_mesh_usage
+	void mark_vertices_dirty(size_t first, size_t count = 1)	{ m_vertex_dirty_range.add(first, count); }
+	void mark_indices_dirty(size_t first, size_t count = 1)		{ m_index_dirty_range.add(first, count); }
 	void update_gpu_mesh(renderer* r);
+
+private:
+	void upload_static(renderer* r);
+	void upload_vertices(renderer* r);
+	void upload_indices(renderer* r);
 public:
 	// CPU
 	std::vector<super_vertex>	m_verts;
-	std::vector<index_t>		m_indices;
+	index_list					m_indices;
 	// used by mesh builder
 	super_vertex				m_builder_brush;
 	// GPU
 	const buffer_layout*	m_layout = nullptr;
+	e_mesh_usage	m_usage = MESH_STATIC;
 	vertex_buffer*	m_gpu_vbo = nullptr;
 	index_buffer*	m_gpu_ibo = nullptr;
 	bool			m_using_ibo = true;
+	// everything changed
 	bool			m_vertex_dirty = true;
 	bool			m_indices_dirty = true;
+	dirty_range		m_vertex_dirty_range;
+	dirty_range		m_index_dirty_range;
+	std::vector<byte>	m_upload_scratch;	// MESH_SPARSE converted vertices
 };
 
 
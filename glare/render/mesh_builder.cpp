@@ -2,8 +2,12 @@
 #include "glare/core/assert.h"
 #include "glare/math/aabb2.h"
 #include "glare/math/obb2.h"
+#include "glare/math/utilities.h"
+#include <algorithm>
 namespace glare
 {
+constexpr size_t DISK_TRIG_BATCH = 64;
+
 static vec2 g_default_box_uv[] = {
 	{0, 0}, {1, 0},
 	{0, 1}, {1, 1}
@@ -77,20 +81,30 @@ void mesh_builder::add_disk(mesh& obj, const vec2& center, float radius, uint32
 	brush.uv = uv_box.get_center();
 	brush.position = center;
 	indices[0] = add_vertex(obj, brush);
-	for(size_t i = 1; i <= slice; ++i) {
-		const float32 theta = static_cast<float32>(i - 1) / static_cast<float32>(slice) * PI * 2.f;
-		vec2 uv {cosf(theta), sinf(theta)};
-		//uv.y = 1.f - uv.y;
-		uv *= 0.5f;
-		uv += {0.5f, 0.5f};
-		uv *= size;
-		uv += uv_box.min;
-		brush.uv = uv;
-		vec2 position {cosf(theta), sinf(theta)};
-		position *= radius;
-		position += center;
-		brush.position = position;
-		indices[i] = add_vertex(obj, brush);
+	// evaluated in batches of DISK_TRIG_BATCH slices, no allocation
+	float32 thetas[DISK_TRIG_BATCH];
+	float32 sins[DISK_TRIG_BATCH];
+	float32 coss[DISK_TRIG_BATCH];
+	for (size_t first = 0; first < slice; first += DISK_TRIG_BATCH) {
+		const size_t count = std::min<size_t>(DISK_TRIG_BATCH, slice - first);
+		for (size_t i = 0; i < count; ++i) {
+			thetas[i] = static_cast<float32>(first + i) / static_cast<float32>(slice) * PI * 2.f;
+		}
+		sincos(thetas, sins, coss, count);
+		for (size_t i = 0; i < count; ++i) {
+			vec2 uv {coss[i], sins[i]};
+			//uv.y = 1.f - uv.y;
+			uv *= 0.5f;
+			uv += {0.5f, 0.5f};
+			uv *= size;
+			uv += uv_box.min;
+			brush.uv = uv;
+			vec2 position {coss[i], sins[i]};
+			position *= radius;
+			position += center;
+			brush.position = position;
+			indices[first + i + 1] = add_vertex(obj, brush);
+		}
 	}
 	indices[slice + 1] = indices[1];
 	for (size_t i = 1; i <= slice; ++i) {
@@ -113,7 +127,7 @@ mesh_builder::index_t mesh_builder::add_vertex(mesh& obj, const super_vertex& ve
 {
 	auto& verts = obj.m_verts;
 	verts.emplace_back(vertex);
-	obj.m_vertex_dirty = true;
+	obj.mark_vertices_dirty(verts.size() - 1);
 	return static_cast<index_t>(verts.size() - 1);
 }
 
@@ -126,9 +140,9 @@ void mesh_builder::add_triangle_indices(mesh& obj, index_t i0, index_t i1, index
 		ALERT("Index out of bound while building meshes.");
 	}
 #endif
-	indices.emplace_back(i0);
-	indices.emplace_back(i1);
-	indices.emplace_back(i2);
-	obj.m_indices_dirty = true;
+	indices.push_back(i0);
+	indices.push_back(i1);
+	indices.push_back(i2);
+	obj.mark_indices_dirty(indices.size() - 3, 3);
 }
 }
@@ -22,7 +22,7 @@ struct obb2;
 
 namespace mesh_builder
 {
-	using index_t = index_buffer::index_t;
+	using index_t = mesh::index_t;
 	// Check "Boxes auto build" for more info
 	void add_obb2(mesh& obj, const obb2& box, const vec2* uvs=nullptr);
 	// Only for aabb2 in right-hand world Cartesian space: x grows up, y grows right
@@ -0,0 +1,417 @@
+#include "glare/render/mip_chain.h"
+#include "glare/math/simd.h"
+#include "glare/math/utilities.h"
+#include "glare/core/assert.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+namespace glare
+{
+static constexpr float64 KAISER_RADIUS = 3.0;
+static constexpr float64 KAISER_ALPHA = 4.0;
+static constexpr uint32 ALPHA_COVERAGE_STEPS = 16;
+
+// Source texels of every destination texel along one axis, padded with zero weights
+struct filter_taps
+{
+	size_t					taps_per_texel = 0;
+	std::vector<uint32>		indices;
+	std::vector<float32>	weights;
+};
+
+static float64 _bessel_i0(float64 x)
+{
+	float64 sum = 1.0;
+	float64 term = 1.0;
+	const float64 half_x = x * 0.5;
+	for (int k = 1; k < 64 && term > sum * 1e-12; ++k) {
+		term *= (half_x / k) * (half_x / k);
+		sum += term;
+	}
+	return sum;
+}
+
+// <x> in destination texels
+static float64 _kaiser(float64 x)
+{
+	if (std::abs(x) >= KAISER_RADIUS) {
+		return 0.0;
+	}
+	const float64 t = x / KAISER_RADIUS;
+	const float64 window = _bessel_i0(KAISER_ALPHA * std::sqrt(1.0 - t * t)) / _bessel_i0(KAISER_ALPHA);
+	const float64 pi_x = 3.14159265358979323846 * x;
+	const float64 sinc = x == 0.0 ? 1.0 : std::sin(pi_x) / pi_x;
+	return sinc * window;
+}
+
+static filter_taps _build_taps(e_mip_filter filter, int32 src_size, int32 dst_size, bool wrap)
+{
+	const float64 scale = static_cast<float64>(src_size) / dst_size;
+	std::vector<int32> first(dst_size);
+	std::vector<int32> last(dst_size);
+	size_t max_taps = 0;
+	for (int32 i = 0; i < dst_size; ++i) {
+		const float64 center = (i + 0.5) * scale;
+		if (filter == MIP_FILTER_BOX) {
+			first[i] = static_cast<int32>(std::floor(center - scale * 0.5));
+			last[i] = static_cast<int32>(std::ceil(center + scale * 0.5)) - 1;
+		} else {
+			first[i] = static_cast<int32>(std::ceil(center - KAISER_RADIUS * scale - 0.5));
+			last[i] = static_cast<int32>(std::floor(center + KAISER_RADIUS * scale - 0.5));
+		}
+		max_taps = std::max(max_taps, static_cast<size_t>(last[i] - first[i] + 1));
+	}
+
+	filter_taps taps;
+	taps.taps_per_texel = max_taps;
+	taps.indices.assign(max_taps * dst_size, 0);
+	taps.weights.assign(max_taps * dst_size, 0.f);
+	std::vector<float64> weights(max_taps);
+	for (int32 i = 0; i < dst_size; ++i) {
+		const float64 center = (i + 0.5) * scale;
+		float64 sum = 0.0;
+		for (int32 j = first[i]; j <= last[i]; ++j) {
+			float64 weight;
+			if (filter == MIP_FILTER_BOX) {
+				weight = std::max(0.0, std::min(j + 1.0, center + scale * 0.5) - std::max(static_cast<float64>(j), center - scale * 0.5));
+			} else {
+				weight = _kaiser((j + 0.5 - center) / scale);
+			}
+			weights[j - first[i]] = weight;
+			sum += weight;
+		}
+		for (int32 j = first[i]; j <= last[i]; ++j) {
+			const size_t tap = i * max_taps + (j - first[i]);
+			const int32 source = wrap ? ((j % src_size) + src_size) % src_size : clamp(j, 0, src_size - 1);
+			taps.indices[tap] = static_cast<uint32>(source);
+			taps.weights[tap] = static_cast<float32>(weights[j - first[i]] / sum);
+		}
+		// padding taps keep a valid index and a zero weight
+		for (size_t k = static_cast<size_t>(last[i] - first[i] + 1); k < max_taps; ++k) {
+			taps.indices[i * max_taps + k] = taps.indices[i * max_taps];
+		}
+	}
+	return taps;
+}
+
+// <dst> rows are <taps>.size wide, <src> rows <src_width>
+static void _filter_rows(rgba* dst, const rgba* src, int32 src_width, int32 rows, const filter_taps& taps)
+{
+	const size_t dst_width = taps.indices.size() / taps.taps_per_texel;
+	for (int32 y = 0; y < rows; ++y) {
+		const rgba* row = src + static_cast<size_t>(y) * src_width;
+		rgba* out = dst + static_cast<size_t>(y) * dst_width;
+		for (size_t x = 0; x < dst_width; ++x) {
+			const uint32* indices = &taps.indices[x * taps.taps_per_texel];
+			const float32* weights = &taps.weights[x * taps.taps_per_texel];
+#if defined(GLARE_SIMD_SSE2)
+			simd::float4 sum(0.f);
+			for (size_t k = 0; k < taps.taps_per_texel; ++k) {
+				sum = sum + simd::float4::load(&row[indices[k]].r) * simd::float4(weights[k]);
+			}
+			sum.store(&out[x].r);
+#else
+			rgba sum(0.f, 0.f, 0.f, 0.f);
+			for (size_t k = 0; k < taps.taps_per_texel; ++k) {
+				const rgba& texel = row[indices[k]];
+				sum.r += texel.r * weights[k];
+				sum.g += texel.g * weights[k];
+				sum.b += texel.b * weights[k];
+				sum.a += texel.a * weights[k];
+			}
+			out[x] = sum;
+#endif
+		}
+	}
+}
+
+// dst[i] += src[i] * weight
+static void _add_scaled(float32* dst, const float32* src, float32 weight, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	const simd::float8 weight8(weight);
+	for (; i + 8 <= count; i += 8) {
+		(simd::float8::load(dst + i) + simd::float8::load(src + i) * weight8).store(dst + i);
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const simd::float4 weight4(weight);
+	for (; i + 4 <= count; i += 4) {
+		(simd::float4::load(dst + i) + simd::float4::load(src + i) * weight4).store(dst + i);
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] += src[i] * weight;
+	}
+}
+
+// <dst> has taps.size rows of <width> texels
+static void _filter_columns(rgba* dst, const rgba* src, int32 width, const filter_taps& taps)
+{
+	const size_t dst_height = taps.indices.size() / taps.taps_per_texel;
+	const size_t row_floats = static_cast<size_t>(width) * 4;
+	for (size_t y = 0; y < dst_height; ++y) {
+		float32* out = &dst[y * width].r;
+		memset(out, 0, row_floats * sizeof(float32));
+		for (size_t k = 0; k < taps.taps_per_texel; ++k) {
+			const float32 weight = taps.weights[y * taps.taps_per_texel + k];
+			if (weight != 0.f) {
+				const rgba* row = src + static_cast<size_t>(taps.indices[y * taps.taps_per_texel + k]) * width;
+				_add_scaled(out, &row->r, weight, row_floats);
+			}
+		}
+	}
+}
+
+static float32 _srgb_to_linear(float32 value)
+{
+	return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+static float32 _linear_to_srgb(float32 value)
+{
+	return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.f / 2.4f) - 0.055f;
+}
+
+// Converts r, g and b, keeps alpha
+template<bool TO_LINEAR>
+static rgba _convert_srgb(const rgba& texel)
+{
+	if constexpr (TO_LINEAR) {
+		return rgba(_srgb_to_linear(texel.r), _srgb_to_linear(texel.g), _srgb_to_linear(texel.b), texel.a);
+	} else {
+		return rgba(_linear_to_srgb(texel.r), _linear_to_srgb(texel.g), _linear_to_srgb(texel.b), texel.a);
+	}
+}
+
+#if defined(GLARE_SIMD_SSE2)
+template<bool TO_LINEAR>
+static simd::float4 _convert_srgb(const simd::float4& texel)
+{
+	const simd::float4 alpha_lane = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+	const simd::float4 tiny(1e-30f);
+	simd::float4 converted;
+	if constexpr (TO_LINEAR) {
+		const simd::float4 curve = simd::pow(simd::max((texel + simd::float4(0.055f)) * simd::float4(1.f / 1.055f), tiny), simd::float4(2.4f));
+		converted = simd::select(texel <= simd::float4(0.04045f), texel * simd::float4(1.f / 12.92f), curve);
+	} else {
+		const simd::float4 curve = simd::float4(1.055f) * simd::pow(simd::max(texel, tiny), simd::float4(1.f / 2.4f)) - simd::float4(0.055f);
+		converted = simd::select(texel <= simd::float4(0.0031308f), texel * simd::float4(12.92f), curve);
+	}
+	return simd::select(alpha_lane, texel, converted);
+}
+#endif
+
+// <dst> may be <src>
+template<bool TO_LINEAR>
+static void _convert_srgb(rgba* dst, const rgba* src, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	for (; i < count; ++i) {
+		_convert_srgb<TO_LINEAR>(simd::float4::load(&src[i].r)).store(&dst[i].r);
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = _convert_srgb<TO_LINEAR>(src[i]);
+	}
+}
+
+// Box filter of exactly half the size on both axes, without the row pass.
+// DECODE_SRGB linearizes the sources on the fly, sparing a decoded copy of level 0.
+template<bool DECODE_SRGB>
+static void _average_2x2(rgba* dst, const rgba* src, const ivec2& dst_size)
+{
+	const size_t src_width = static_cast<size_t>(dst_size.x) * 2;
+	for (int32 y = 0; y < dst_size.y; ++y) {
+		const rgba* top = src + static_cast<size_t>(y) * 2 * src_width;
+		const rgba* bottom = top + src_width;
+		rgba* out = dst + static_cast<size_t>(y) * dst_size.x;
+		for (int32 x = 0; x < dst_size.x; ++x) {
+#if defined(GLARE_SIMD_SSE2)
+			simd::float4 texels[4] = {simd::float4::load(&top[2 * x].r), simd::float4::load(&top[2 * x + 1].r)
+				, simd::float4::load(&bottom[2 * x].r), simd::float4::load(&bottom[2 * x + 1].r)};
+			if constexpr (DECODE_SRGB) {
+				for (simd::float4& each : texels) {
+					each = _convert_srgb<true>(each);
+				}
+			}
+			((texels[0] + texels[1] + texels[2] + texels[3]) * simd::float4(0.25f)).store(&out[x].r);
+#else
+			rgba texels[4] = {top[2 * x], top[2 * x + 1], bottom[2 * x], bottom[2 * x + 1]};
+			if constexpr (DECODE_SRGB) {
+				for (rgba& each : texels) {
+					each = _convert_srgb<true>(each);
+				}
+			}
+			out[x] = rgba((texels[0].r + texels[1].r + texels[2].r + texels[3].r) * 0.25f
+				, (texels[0].g + texels[1].g + texels[2].g + texels[3].g) * 0.25f
+				, (texels[0].b + texels[1].b + texels[2].b + texels[3].b) * 0.25f
+				, (texels[0].a + texels[1].a + texels[2].a + texels[3].a) * 0.25f);
+#endif
+		}
+	}
+}
+
+// The Kaiser lobes overshoot: no negative color, alpha in [0, 1]
+static void _clamp_texels(rgba* texels, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	const simd::float4 upper(_mm_set_ps(1.f, FLT_MAX, FLT_MAX, FLT_MAX));
+	for (; i < count; ++i) {
+		float32* texel = &texels[i].r;
+		simd::min(simd::max(simd::float4::load(texel), simd::float4(0.f)), upper).store(texel);
+	}
+#endif
+	for (; i < count; ++i) {
+		rgba& texel = texels[i];
+		texel.r = std::max(texel.r, 0.f);
+		texel.g = std::max(texel.g, 0.f);
+		texel.b = std::max(texel.b, 0.f);
+		texel.a = clamp(texel.a, 0.f, 1.f);
+	}
+}
+
+// Finds the reference the level passes at <coverage>, then scales alpha so
+// that <alpha_reference> passes there instead
+static void _keep_alpha_coverage(rgba* texels, size_t count, float32 alpha_reference, float32 coverage)
+{
+	float32 low = 0.f;
+	float32 high = 1.f;
+	float32 reference = alpha_reference;
+	for (uint32 step = 0; step < ALPHA_COVERAGE_STEPS; ++step) {
+		const float32 current = get_alpha_coverage(texels, count, reference);
+		if (current > coverage) {
+			low = reference;
+		} else if (current < coverage) {
+			high = reference;
+		} else {
+			break;
+		}
+		reference = (low + high) * 0.5f;
+	}
+	if (reference <= 0.f) {
+		return;
+	}
+	const float32 scale = alpha_reference / reference;
+	for (size_t i = 0; i < count; ++i) {
+		texels[i].a = std::min(texels[i].a * scale, 1.f);
+	}
+}
+
+uint32 get_mip_level_count(const ivec2& size)
+{
+	uint32 count = 1;
+	for (int32 extent = std::max(size.x, size.y); extent > 1; extent >>= 1) {
+		++count;
+	}
+	return count;
+}
+
+float32 get_alpha_coverage(const rgba* texels, size_t count, float32 alpha_reference, float32 alpha_scale)
+{
+	if (count == 0) {
+		return 0.f;
+	}
+	size_t covered = 0;
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	const simd::float4 reference(alpha_reference);
+	const simd::float4 scale(alpha_scale);
+	for (; i + 4 <= count; i += 4) {
+		const __m128 ba_01 = _mm_unpackhi_ps(_mm_loadu_ps(&texels[i].r), _mm_loadu_ps(&texels[i + 1].r));
+		const __m128 ba_23 = _mm_unpackhi_ps(_mm_loadu_ps(&texels[i + 2].r), _mm_loadu_ps(&texels[i + 3].r));
+		const simd::float4 alpha = _mm_movehl_ps(ba_23, ba_01);
+		covered += simd::count_bits(simd::movemask(alpha * scale > reference));
+	}
+#endif
+	for (; i < count; ++i) {
+		covered += texels[i].a * alpha_scale > alpha_reference ? 1u : 0u;
+	}
+	return static_cast<float32>(covered) / static_cast<float32>(count);
+}
+
+void generate_mip_chain(const rgba* texels, const ivec2& size, const mip_chain_options& options, std::vector<mip_level>& out_levels)
+{
+	ASSERT(size.x > 0 && size.y > 0, "Invalid mip chain size");
+	const uint32 full_count = get_mip_level_count(size);
+	const uint32 level_count = options.max_levels ? std::min(options.max_levels, full_count) : full_count;
+	if (level_count <= 1) {
+		return;
+	}
+	const size_t texel_count = static_cast<size_t>(size.x) * size.y;
+	const bool keep_coverage = options.alpha_coverage_reference > 0.f;
+	const float32 coverage = keep_coverage ? get_alpha_coverage(texels, texel_count, options.alpha_coverage_reference) : 0.f;
+	// The chain is filtered from linear, unscaled levels. Without sRGB or
+	// coverage the outputs are those levels, otherwise they are a converted copy.
+	const bool separate_chain = options.srgb || keep_coverage;
+
+	std::vector<rgba> linear;
+	std::vector<rgba> next;
+	std::vector<rgba> filtered_rows;
+	const bool exact_box = options.filter == MIP_FILTER_BOX;
+	// the 2x2 box decodes level 0 as it reads it, the other filters read it decoded
+	const bool decode_on_read = options.srgb && exact_box && size.x % 2 == 0 && size.y % 2 == 0;
+	const rgba* current = texels;
+	if (options.srgb && !decode_on_read) {
+		linear.resize(texel_count);
+		_convert_srgb<true>(linear.data(), texels, texel_count);
+		current = linear.data();
+	}
+	ivec2 current_size = size;
+	out_levels.reserve(out_levels.size() + level_count - 1);
+	for (uint32 level = 1; level < level_count; ++level) {
+		const ivec2 next_size(std::max(current_size.x / 2, 1), std::max(current_size.y / 2, 1));
+		mip_level& output = out_levels.emplace_back();
+		output.size = next_size;
+		output.texels.resize(static_cast<size_t>(next_size.x) * next_size.y);
+		std::vector<rgba>& target = separate_chain ? next : output.texels;
+		target.resize(output.texels.size());
+
+		if (exact_box && current_size.x == next_size.x * 2 && current_size.y == next_size.y * 2) {
+			if (decode_on_read && level == 1) {
+				_average_2x2<true>(target.data(), current, next_size);
+			} else {
+				_average_2x2<false>(target.data(), current, next_size);
+			}
+		} else {
+			const rgba* rows = current;
+			if (next_size.x != current_size.x) {
+				filtered_rows.resize(static_cast<size_t>(next_size.x) * current_size.y);
+				_filter_rows(filtered_rows.data(), current, current_size.x, current_size.y
+					, _build_taps(options.filter, current_size.x, next_size.x, options.wrap));
+				rows = filtered_rows.data();
+			}
+			if (next_size.y != current_size.y) {
+				_filter_columns(target.data(), rows, next_size.x, _build_taps(options.filter, current_size.y, next_size.y, options.wrap));
+			} else {
+				memcpy(static_cast<void*>(target.data()), rows, target.size() * sizeof(rgba));
+			}
+			if (!exact_box) {
+				_clamp_texels(target.data(), target.size());
+			}
+		}
+
+		if (separate_chain) {
+			if (options.srgb) {
+				_convert_srgb<false>(output.texels.data(), next.data(), next.size());
+			} else {
+				memcpy(static_cast<void*>(output.texels.data()), next.data(), next.size() * sizeof(rgba));
+			}
+			if (keep_coverage) {
+				_keep_alpha_coverage(output.texels.data(), output.texels.size(), options.alpha_coverage_reference, coverage);
+			}
+			// the level just filtered is the next source
+			linear.swap(next);
+			current = linear.data();
+		} else {
+			current = output.texels.data();
+		}
+		current_size = next_size;
+	}
+}
+}
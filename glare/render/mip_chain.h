@@ -0,0 +1,49 @@
+/// glare/render/mip_chain.h
+/// CPU mip chain generation for surfaces and texture2d uploads.
+///
+/// Each level is filtered from the previous one with a separable filter:
+/// the exact area average (MIP_FILTER_BOX, a 2x2 average for even sizes) or
+/// a Kaiser windowed sinc that stays sharper when minified. sRGB encoded
+/// colors are averaged in linear space, and alpha tested textures can keep
+/// the coverage of level 0 so foliage and fences do not fade out with distance.
+/// The passes run over float4 texels with SSE2 (AVX2 for the vertical one);
+/// nothing here needs a device.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include "glare/math/vector.h"
+#include <vector>
+
+namespace glare
+{
+enum e_mip_filter : uint8
+{
+	MIP_FILTER_BOX,		// area average
+	MIP_FILTER_KAISER,	// windowed sinc, radius of 3 destination texels
+};
+
+struct mip_chain_options
+{
+	e_mip_filter	filter = MIP_FILTER_BOX;
+	bool			srgb = true;	// rgb is sRGB encoded, alpha is always linear
+	bool			wrap = false;	// tiling textures sample across the opposite edge instead of clamping
+	// > 0: every level keeps the share of texels whose alpha passes this reference
+	float32			alpha_coverage_reference = 0.f;
+	// Levels including level 0, 0 for the full chain down to 1x1
+	uint32			max_levels = 0;
+};
+
+struct mip_level
+{
+	ivec2				size;
+	std::vector<rgba>	texels;
+};
+
+// Levels of the full chain of a <size> image, level 0 included
+NODISCARD uint32 get_mip_level_count(const ivec2& size);
+// Appends level 1 and below of the <size> image at <texels> to <out_levels>
+void generate_mip_chain(const rgba* texels, const ivec2& size, const mip_chain_options& options, std::vector<mip_level>& out_levels);
+// Share of the texels with alpha * alpha_scale > alpha_reference
+NODISCARD float32 get_alpha_coverage(const rgba* texels, size_t count, float32 alpha_reference, float32 alpha_scale=1.f);
+}
@@ -0,0 +1,329 @@
+#include "glare/render/render_queue.h"
+#include "glare/render/renderer.h"
+#include "glare/render/shader.h"
+#include "glare/render/texture.h"
+#include "glare/core/assert.h"
+#include "glare/math/utilities.h"
+
+namespace glare
+{
+constexpr uint32 LAYER_SHIFT		= 56;
+constexpr uint32 TRANSLUCENT_SHIFT	= 55;
+constexpr uint64 SHADER_MASK		= (1ull << render_queue::SHADER_ID_BITS) - 1;
+constexpr uint64 TEXTURE_MASK		= (1ull << render_queue::TEXTURE_ID_BITS) - 1;
+constexpr uint64 DEPTH_MASK			= (1ull << render_queue::DEPTH_BITS) - 1;
+constexpr uint64 FAR_DEPTH_MASK		= (1ull << render_queue::FAR_DEPTH_BITS) - 1;
+constexpr uint32 FAR_DEPTH_SHIFT	= TRANSLUCENT_SHIFT - render_queue::FAR_DEPTH_BITS;
+constexpr uint32 SHADER_SHIFT		= FAR_DEPTH_SHIFT - render_queue::SHADER_ID_BITS;
+constexpr uint32 TEXTURE_SHIFT		= SHADER_SHIFT - render_queue::TEXTURE_ID_BITS;
+constexpr uint32 DEPTH_SHIFT		= TEXTURE_SHIFT - render_queue::DEPTH_BITS;
+static_assert(DEPTH_SHIFT < 64, "render key fields must fit in 64 bits");
+
+static uint32 _get_id(std::unordered_map<const void*, uint32>& ids, const void* object)
+{
+	if (!object) {
+		return 0;
+	}
+	const auto found = ids.find(object);
+	if (found != ids.end()) {
+		return found->second;
+	}
+	const uint32 id = static_cast<uint32>(ids.size()) + 1;
+	ids.emplace(object, id);
+	return id;
+}
+
+// Forwards the replay into a renderer
+class _renderer_command_target final : public i_render_command_target
+{
+public:
+	explicit _renderer_command_target(renderer* r)
+		: m_renderer(r)
+	{}
+	~_renderer_command_target()
+	{
+		restore_blend_mode();
+	}
+	void bind_shader(shader* s, e_blend_mode blend_mode) override
+	{
+		if (s != m_renderer->m_current_shader) {
+			m_renderer->bind_shader(s);
+		}
+		// the commands borrow the shaders, each gets its own blend mode back
+		if (s != m_shader) {
+			restore_blend_mode();
+			m_shader = s;
+			m_shader_blend_mode = s->m_blend_mode;
+		}
+		s->set_blend_mode(blend_mode);
+	}
+	void bind_texture(const texture* tex) override
+	{
+		m_renderer->bind_texture(tex);
+	}
+	void bind_vbo(vertex_buffer* vbo) override
+	{
+		m_renderer->bind_vbo(vbo);
+	}
+	void bind_ibo(index_buffer* ibo) override
+	{
+		m_renderer->bind_ibo(ibo);
+	}
+	void draw(const render_command& command) override
+	{
+		m_renderer->m_current_shader->create_dx_vbo_layout(command.m_vbo->get_buffer_layout());
+		if (command.m_ibo) {
+			m_renderer->draw_indexed(command.m_element_count, command.m_element_offset);
+		} else {
+			m_renderer->draw(command.m_element_count, command.m_element_offset);
+		}
+	}
+private:
+	void restore_blend_mode()
+	{
+		if (m_shader) {
+			m_shader->set_blend_mode(m_shader_blend_mode);
+		}
+	}
+private:
+	renderer*		m_renderer;
+	shader*			m_shader = nullptr;
+	e_blend_mode	m_shader_blend_mode = BLEND_ALPHA;
+};
+
+void render_queue::submit(const render_command& command, uint8 layer, e_blend_mode blend_mode, float32 depth)
+{
+	ASSERT(command.m_shader && command.m_vbo, "render_command needs a shader and a vertex buffer");
+	const uint64 key = make_key(layer, blend_mode, command.m_shader, command.m_texture, depth);
+	m_varying_bits |= m_keys.empty() ? 0 : key ^ m_keys.front();
+	m_keys.push_back(key);
+	m_blend_modes.push_back(static_cast<uint8>(blend_mode));
+	m_commands.push_back(command);
+	m_order.clear();
+}
+
+uint64 render_queue::make_key(uint8 layer, e_blend_mode blend_mode, const shader* s, const texture* tex, float32 depth)
+{
+	depth = clamp(depth, 0.f, 1.f);
+	uint64 key = static_cast<uint64>(layer) << LAYER_SHIFT;
+	if (blend_mode == BLEND_OPAQUE) {
+		key |= FAR_DEPTH_MASK << FAR_DEPTH_SHIFT;
+		key |= (_get_id(m_shader_ids, s) & SHADER_MASK) << SHADER_SHIFT;
+		key |= (_get_id(m_texture_ids, tex) & TEXTURE_MASK) << TEXTURE_SHIFT;
+		key |= static_cast<uint64>(depth * static_cast<float32>(DEPTH_MASK)) << DEPTH_SHIFT;
+	} else {
+		key |= 1ull << TRANSLUCENT_SHIFT;
+		key |= (FAR_DEPTH_MASK - static_cast<uint64>(depth * static_cast<float32>(FAR_DEPTH_MASK))) << FAR_DEPTH_SHIFT;
+	}
+	return key;
+}
+
+constexpr uint32 RADIX = 1u << render_queue::RADIX_BITS;
+constexpr uint32 MAX_DIGITS = 64 / render_queue::RADIX_BITS;
+
+// Stable LSD radix sort of <values> by <digit_count> digits of get_key(value) from <first_bit>.
+// <histogram>[digit] holds the digit counts of every value on entry.
+// Return: the number of passes run, the result is in <values>
+template<typename T, typename KEY_FN>
+static uint32 _radix_sort(std::vector<T>& values, std::vector<T>& scratch
+	, uint32 histogram[MAX_DIGITS][RADIX], uint32 digit_count, uint32 first_bit, KEY_FN get_key)
+{
+	const size_t count = values.size();
+	scratch.resize(count);
+	uint32 passes = 0;
+	T* src = values.data();
+	T* dst = scratch.data();
+	for (uint32 digit = 0; digit < digit_count; ++digit) {
+		const uint32 shift = first_bit + digit * render_queue::RADIX_BITS;
+		uint32* offsets = histogram[digit];
+		// Every key has the same digit, the pass would not move anything
+		if (offsets[(get_key(src[0]) >> shift) & (RADIX - 1)] == count) {
+			continue;
+		}
+		uint32 offset = 0;
+		for (uint32 bucket = 0; bucket < RADIX; ++bucket) {
+			const uint32 bucket_count = offsets[bucket];
+			offsets[bucket] = offset;
+			offset += bucket_count;
+		}
+		for (size_t i = 0; i < count; ++i) {
+			const T value = src[i];
+			dst[offsets[(get_key(value) >> shift) & (RADIX - 1)]++] = value;
+		}
+		std::swap(src, dst);
+		++passes;
+	}
+	if (src != values.data()) {
+		values.swap(scratch);
+	}
+	return passes;
+}
+
+// Runs of key bits that vary between commands, least significant first
+struct _key_runs
+{
+	uint32	shift[64];
+	uint32	width[64];
+	uint64	mask[64];
+	uint32	count = 0;
+	uint32	bits = 0;	// sum of the widths
+};
+
+// Packs the varying bits of every key, then <index_bits> wide the command index, in a <T>.
+// Run by run over all keys rather than key by key, which the compiler vectorizes.
+// Return: the number of passes run, the order is in <out_order>
+template<typename T>
+static uint32 _sort_packed(const std::vector<uint64>& keys, const _key_runs& runs, std::vector<T>& packed, std::vector<T>& scratch
+	, std::vector<uint32>& out_order, uint32 index_bits)
+{
+	const size_t count = keys.size();
+	packed.resize(count);
+	T* const values = packed.data();
+	const uint64* const key_data = keys.data();
+	for (size_t i = 0; i < count; ++i) {
+		values[i] = static_cast<T>(i);
+	}
+	uint32 at = index_bits;
+	for (uint32 run = 0; run < runs.count; ++run) {
+		const uint32 shift = runs.shift[run];
+		const uint64 mask = runs.mask[run];
+		for (size_t i = 0; i < count; ++i) {
+			values[i] |= static_cast<T>(((key_data[i] >> shift) & mask) << at);
+		}
+		at += runs.width[run];
+	}
+
+	const uint32 digit_count = (runs.bits + render_queue::RADIX_BITS - 1) / render_queue::RADIX_BITS;
+	uint32 histogram[MAX_DIGITS][RADIX] = {};
+	for (size_t i = 0; i < count; ++i) {
+		T compact = values[i] >> index_bits;
+		for (uint32 digit = 0; digit < digit_count; ++digit) {
+			++histogram[digit][compact & (RADIX - 1)];
+			compact >>= render_queue::RADIX_BITS;
+		}
+	}
+	const uint32 passes = _radix_sort(packed, scratch, histogram, digit_count, index_bits, [](T value) { return value; });
+	const T index_mask = static_cast<T>((static_cast<uint64>(1) << index_bits) - 1);
+	for (size_t i = 0; i < count; ++i) {
+		out_order[i] = static_cast<uint32>(packed[i] & index_mask);
+	}
+	return passes;
+}
+
+void render_queue::sort()
+{
+	const size_t count = m_keys.size();
+	if (m_order.size() == count) {
+		return;
+	}
+
+	_key_runs runs;
+	for (uint32 bit = 0; bit < 64;) {
+		if (!((m_varying_bits >> bit) & 1u)) {
+			++bit;
+			continue;
+		}
+		const uint32 begin = bit;
+		while (bit < 64 && ((m_varying_bits >> bit) & 1u)) {
+			++bit;
+		}
+		runs.shift[runs.count] = begin;
+		runs.width[runs.count] = bit - begin;
+		runs.mask[runs.count] = bit - begin < 64 ? (1ull << (bit - begin)) - 1 : UINT64_MAX;
+		++runs.count;
+		runs.bits += bit - begin;
+	}
+	m_stats.sort_bits = runs.bits;
+
+	uint32 index_bits = 0;
+	while (index_bits < 32 && (static_cast<size_t>(1) << index_bits) < count) {
+		++index_bits;
+	}
+	m_order.resize(count);
+	if (runs.bits + index_bits <= 32) {
+		// The usual case, 4 bytes a command halve the memory each pass moves again
+		m_stats.radix_passes = _sort_packed(m_keys, runs, m_packed32, m_packed32_scratch, m_order, index_bits);
+	} else if (runs.bits <= 32) {
+		m_stats.radix_passes = _sort_packed(m_keys, runs, m_packed, m_packed_scratch, m_order, 32);
+	} else {
+		const uint32 digit_count = (runs.bits + RADIX_BITS - 1) / RADIX_BITS;
+		uint32 histogram[MAX_DIGITS][RADIX] = {};
+		m_items.resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			const uint64 key = m_keys[i];
+			uint64 compact = 0;
+			uint32 at = 0;
+			for (uint32 run = 0; run < runs.count; ++run) {
+				compact |= ((key >> runs.shift[run]) & runs.mask[run]) << at;
+				at += runs.width[run];
+			}
+			m_items[i] = {compact, static_cast<uint32>(i)};
+			for (uint32 digit = 0; digit < digit_count; ++digit) {
+				++histogram[digit][compact & (RADIX - 1)];
+				compact >>= RADIX_BITS;
+			}
+		}
+		m_stats.radix_passes = _radix_sort(m_items, m_items_scratch, histogram, digit_count, 0, [](const sort_item& item) { return item.key; });
+		for (size_t i = 0; i < count; ++i) {
+			m_order[i] = m_items[i].command;
+		}
+	}
+}
+
+void render_queue::replay(i_render_command_target& target)
+{
+	sort();
+	m_stats.commands = static_cast<uint32>(m_order.size());
+	m_stats.shader_binds = 0;
+	m_stats.texture_binds = 0;
+	m_stats.buffer_binds = 0;
+
+	shader* bound_shader = nullptr;
+	uint32 bound_blend = UINT32_MAX;
+	const texture* bound_texture = nullptr;
+	vertex_buffer* bound_vbo = nullptr;
+	index_buffer* bound_ibo = nullptr;
+	for (const uint32 index : m_order) {
+		const render_command& command = m_commands[index];
+		const uint8 blend = m_blend_modes[index];
+		if (command.m_shader != bound_shader || blend != bound_blend) {
+			target.bind_shader(command.m_shader, static_cast<e_blend_mode>(blend));
+			bound_shader = command.m_shader;
+			bound_blend = blend;
+			++m_stats.shader_binds;
+		}
+		if (command.m_texture && command.m_texture != bound_texture) {
+			target.bind_texture(command.m_texture);
+			bound_texture = command.m_texture;
+			++m_stats.texture_binds;
+		}
+		if (command.m_vbo != bound_vbo) {
+			target.bind_vbo(command.m_vbo);
+			bound_vbo = command.m_vbo;
+			++m_stats.buffer_binds;
+		}
+		if (command.m_ibo && command.m_ibo != bound_ibo) {
+			target.bind_ibo(command.m_ibo);
+			bound_ibo = command.m_ibo;
+			++m_stats.buffer_binds;
+		}
+		target.draw(command);
+	}
+}
+
+void render_queue::execute(renderer* r)
+{
+	_renderer_command_target target(r);
+	replay(target);
+}
+
+void render_queue::clear()
+{
+	m_commands.clear();
+	m_keys.clear();
+	m_blend_modes.clear();
+	m_varying_bits = 0;
+	m_order.clear();
+}
+
+}
@@ -0,0 +1,118 @@
+/// glare/render/render_queue.h
+/// Deferred draws, sorted by a 64-bit key before they reach the renderer.
+///
+/// Key layout, most significant bit first:
+///		layer:8 | translucent:1 | far depth:16 | shader:12 | texture:14 | depth:12 (near first) | 0:1
+/// Opaque commands come first in a layer. They fill shader, texture and depth,
+/// so they are grouped by state, and leave far depth at its value for depth 0.
+/// Translucent commands, alpha and additive alike, only fill far depth (far
+/// first) and leave the rest 0, so they are composited back to front whatever
+/// their blend mode or state: the sort is a stable LSD radix sort, and
+/// translucent commands of one layer at the same depth are drawn in
+/// submission order. The blend mode itself is kept beside the key.
+///
+/// sort() only looks at the key bits that differ between commands, packed
+/// together, so unused id and depth bits cost no pass. When they fit in 32
+/// bits with the command index, the usual case since ids are small and 2D
+/// scenes use few depths, each command sorts as 4 bytes; up to 32 bits of key
+/// it sorts as 8 bytes.
+///
+/// Shaders and textures get small ids on first submission. Ids past the
+/// key width wrap around, which only costs some batching.
+///
+/// replay() walks the sorted commands and only forwards state that changed
+/// to an i_render_command_target, execute() does it into a renderer.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/common.h"
+#include <unordered_map>
+#include <vector>
+
+namespace glare
+{
+class renderer;
+class shader;
+class texture;
+class vertex_buffer;
+class index_buffer;
+
+struct render_command
+{
+	shader*			m_shader = nullptr;
+	const texture*	m_texture = nullptr;	// diffuse slot, nullptr keeps the bound one
+	vertex_buffer*	m_vbo = nullptr;
+	index_buffer*	m_ibo = nullptr;		// nullptr: not indexed
+	uint32			m_element_count = 0;	// indices, or vertices when not indexed
+	uint32			m_element_offset = 0;
+};
+
+class i_render_command_target
+{
+public:
+	virtual ~i_render_command_target() = default;
+	virtual void bind_shader(shader* s, e_blend_mode blend_mode) = 0;
+	virtual void bind_texture(const texture* tex) = 0;
+	virtual void bind_vbo(vertex_buffer* vbo) = 0;
+	virtual void bind_ibo(index_buffer* ibo) = 0;
+	virtual void draw(const render_command& command) = 0;
+};
+
+struct render_queue_stats
+{
+	uint32	commands		= 0;
+	uint32	shader_binds	= 0;	// shader or blend mode changes
+	uint32	texture_binds	= 0;
+	uint32	buffer_binds	= 0;
+	uint32	sort_bits		= 0;	// key bits that differ between commands
+	uint32	radix_passes	= 0;
+};
+
+class render_queue
+{
+public:
+	static constexpr uint32 SHADER_ID_BITS	= 12;
+	static constexpr uint32 TEXTURE_ID_BITS	= 14;
+	static constexpr uint32 DEPTH_BITS		= 12;
+	static constexpr uint32 FAR_DEPTH_BITS	= 16;
+
+	struct sort_item
+	{
+		uint64 key;	// compacted
+		uint32 command;
+	};
+	static constexpr uint32 RADIX_BITS = 8;
+public:
+	// <depth> in [0, 1], 0 is nearest
+	void submit(const render_command& command, uint8 layer, e_blend_mode blend_mode, float32 depth = 0.f);
+	void sort();
+	// Sorts when needed, then replays into <target>
+	void replay(i_render_command_target& target);
+	void execute(renderer* r);
+	// Drops the commands, keeps shader and texture ids
+	void clear();
+
+	NODISCARD uint64 make_key(uint8 layer, e_blend_mode blend_mode, const shader* s, const texture* tex, float32 depth);
+	NODISCARD const std::vector<render_command>&	get_commands() const	{ return m_commands; }
+	// Valid after sort(), indices in get_commands()
+	NODISCARD const std::vector<uint32>&			get_order() const		{ return m_order; }
+	NODISCARD uint64								get_key(uint32 command) const { return m_keys[command]; }
+	NODISCARD const render_queue_stats&				get_stats() const		{ return m_stats; }
+
+private:
+	std::vector<render_command>	m_commands;
+	std::vector<uint64>			m_keys;		// by command
+	std::vector<uint8>			m_blend_modes;	// by command, e_blend_mode
+	uint64						m_varying_bits = 0;	// bits where some key differs from the first one
+	std::vector<uint32>			m_order;
+	std::vector<sort_item>		m_items;	// when the keys do not pack
+	std::vector<sort_item>		m_items_scratch;
+	std::vector<uint32>			m_packed32;	// compact key << index bits | command
+	std::vector<uint32>			m_packed32_scratch;
+	std::vector<uint64>			m_packed;	// compact key << 32 | command
+	std::vector<uint64>			m_packed_scratch;
+	std::unordered_map<const void*, uint32> m_shader_ids;
+	std::unordered_map<const void*, uint32> m_texture_ids;
+	render_queue_stats			m_stats;
+};
+}
@@ -0,0 +1,212 @@
+#include "glare/render/render_state.h"
+#include "glare/core/assert.h"
+
+namespace glare
+{
+dx_render_state_device::dx_render_state_device(dx_context* context)
+	: m_context(context)
+{
+}
+
+void dx_render_state_device::set_blend_state(dx_state_blend* state)
+{
+	static float black[] = { 0.f,0.f,0.f,1.f };
+	m_context->OMSetBlendState(state, black, 0xffffffff);
+}
+
+void dx_render_state_device::set_depth_stencil_state(dx_state_depth_stencil* state)
+{
+	m_context->OMSetDepthStencilState(state, 0);
+}
+
+void dx_render_state_device::set_rasterizer_state(dx_state_rasterizer* state)
+{
+	m_context->RSSetState(state);
+}
+
+void dx_render_state_device::set_topology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	m_context->IASetPrimitiveTopology(topology);
+}
+
+void dx_render_state_device::set_input_layout(dx_layout* layout)
+{
+	m_context->IASetInputLayout(layout);
+}
+
+void dx_render_state_device::set_vertex_shader(dx_vs* vs)
+{
+	m_context->VSSetShader(vs, nullptr, 0);
+}
+
+void dx_render_state_device::set_pixel_shader(dx_ps* ps)
+{
+	m_context->PSSetShader(ps, nullptr, 0);
+}
+
+void dx_render_state_device::set_vertex_buffer(uint32 stream, dx_buffer* buffer, uint32 stride)
+{
+	unsigned offset = 0;
+	m_context->IASetVertexBuffers(stream, 1, &buffer, &stride, &offset);
+}
+
+void dx_render_state_device::set_index_buffer(dx_buffer* buffer, dx_format format)
+{
+	m_context->IASetIndexBuffer(buffer, format, 0);
+}
+
+void dx_render_state_device::set_shader_resource(uint32 slot, dx_srv* srv)
+{
+	m_context->PSSetShaderResources(slot, 1, &srv);
+}
+
+void dx_render_state_device::set_sampler(uint32 slot, dx_sampler* sampler)
+{
+	m_context->PSSetSamplers(slot, 1, &sampler);
+}
+
+uint32 render_state_stats::get_issued_count() const
+{
+	uint32 total = 0;
+	for (const uint32 count : issued) {
+		total += count;
+	}
+	return total;
+}
+
+uint32 render_state_stats::get_skipped_count() const
+{
+	uint32 total = 0;
+	for (const uint32 count : skipped) {
+		total += count;
+	}
+	return total;
+}
+
+render_state_cache::render_state_cache(i_render_state_device* device)
+	: m_device(device)
+{
+	ASSERT(m_device, "render_state_cache needs a device");
+}
+
+render_state_cache::~render_state_cache()
+{
+	delete m_device;
+}
+
+template<typename T>
+bool render_state_cache::filter(T& bound, const T& value, uint32 valid_bit, uint32& valid_mask, e_render_state_call call)
+{
+	if ((valid_mask & valid_bit) && bound == value) {
+		++m_frame_stats.skipped[call];
+		return false;
+	}
+	bound = value;
+	valid_mask |= valid_bit;
+	++m_frame_stats.issued[call];
+	return true;
+}
+
+void render_state_cache::set_blend_state(dx_state_blend* state)
+{
+	if (filter(m_blend, state, 1u << STATE_CALL_BLEND, m_valid_calls, STATE_CALL_BLEND)) {
+		m_device->set_blend_state(state);
+	}
+}
+
+void render_state_cache::set_depth_stencil_state(dx_state_depth_stencil* state)
+{
+	if (filter(m_depth_stencil, state, 1u << STATE_CALL_DEPTH_STENCIL, m_valid_calls, STATE_CALL_DEPTH_STENCIL)) {
+		m_device->set_depth_stencil_state(state);
+	}
+}
+
+void render_state_cache::set_rasterizer_state(dx_state_rasterizer* state)
+{
+	if (filter(m_rasterizer, state, 1u << STATE_CALL_RASTERIZER, m_valid_calls, STATE_CALL_RASTERIZER)) {
+		m_device->set_rasterizer_state(state);
+	}
+}
+
+void render_state_cache::set_topology(D3D11_PRIMITIVE_TOPOLOGY topology)
+{
+	if (filter(m_topology, topology, 1u << STATE_CALL_TOPOLOGY, m_valid_calls, STATE_CALL_TOPOLOGY)) {
+		m_device->set_topology(topology);
+	}
+}
+
+void render_state_cache::set_input_layout(dx_layout* layout)
+{
+	if (filter(m_input_layout, layout, 1u << STATE_CALL_INPUT_LAYOUT, m_valid_calls, STATE_CALL_INPUT_LAYOUT)) {
+		m_device->set_input_layout(layout);
+	}
+}
+
+void render_state_cache::set_vertex_shader(dx_vs* vs)
+{
+	if (filter(m_vs, vs, 1u << STATE_CALL_VERTEX_SHADER, m_valid_calls, STATE_CALL_VERTEX_SHADER)) {
+		m_device->set_vertex_shader(vs);
+	}
+}
+
+void render_state_cache::set_pixel_shader(dx_ps* ps)
+{
+	if (filter(m_ps, ps, 1u << STATE_CALL_PIXEL_SHADER, m_valid_calls, STATE_CALL_PIXEL_SHADER)) {
+		m_device->set_pixel_shader(ps);
+	}
+}
+
+void render_state_cache::set_vertex_buffer(uint32 stream, dx_buffer* buffer, uint32 stride)
+{
+	ASSERT(stream < NUM_VERTEX_STREAMS, "Vertex stream out of range");
+	// A new stride alone has to be forwarded too
+	if (stride != m_vertex_strides[stream]) {
+		m_valid_vertex_buffers &= ~(1u << stream);
+		m_vertex_strides[stream] = stride;
+	}
+	if (filter(m_vertex_buffers[stream], buffer, 1u << stream, m_valid_vertex_buffers, STATE_CALL_VERTEX_BUFFER)) {
+		m_device->set_vertex_buffer(stream, buffer, stride);
+	}
+}
+
+void render_state_cache::set_index_buffer(dx_buffer* buffer, dx_format format)
+{
+	if (format != m_index_format) {
+		m_valid_calls &= ~(1u << STATE_CALL_INDEX_BUFFER);
+		m_index_format = format;
+	}
+	if (filter(m_index_buffer, buffer, 1u << STATE_CALL_INDEX_BUFFER, m_valid_calls, STATE_CALL_INDEX_BUFFER)) {
+		m_device->set_index_buffer(buffer, format);
+	}
+}
+
+void render_state_cache::set_shader_resource(uint32 slot, dx_srv* srv)
+{
+	ASSERT(slot < MAX_TEXTURE_SLOTS, "Texture slot out of range");
+	if (filter(m_srvs[slot], srv, 1u << slot, m_valid_srvs, STATE_CALL_SHADER_RESOURCE)) {
+		m_device->set_shader_resource(slot, srv);
+	}
+}
+
+void render_state_cache::set_sampler(uint32 slot, dx_sampler* sampler)
+{
+	ASSERT(slot < MAX_TEXTURE_SLOTS, "Sampler slot out of range");
+	if (filter(m_samplers[slot], sampler, 1u << slot, m_valid_samplers, STATE_CALL_SAMPLER)) {
+		m_device->set_sampler(slot, sampler);
+	}
+}
+
+void render_state_cache::invalidate()
+{
+	m_valid_calls = 0;
+	m_valid_vertex_buffers = 0;
+	m_valid_srvs = 0;
+	m_valid_samplers = 0;
+}
+
+void render_state_cache::begin_frame()
+{
+	m_last_frame_stats = m_frame_stats;
+	m_frame_stats = render_state_stats();
+}
+}
@@ -0,0 +1,146 @@
+/// glare/render/render_state.h
+/// Shadow of the pipeline state bound on the device context.
+///
+/// renderer sets state through a render_state_cache, which compares each
+/// call with the value it last forwarded and drops the repeats. The calls
+/// that get through reach an i_render_state_device: the D3D context in the
+/// renderer, or any recording implementation when checked without a device.
+///
+/// Comparing handles is safe: the context holds a reference on every bound
+/// object, so the address of a bound object can not be reused by a new one.
+/// Code setting state on the context directly must call invalidate().
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/common.h"
+
+namespace glare
+{
+enum e_render_state_call : uint8
+{
+	STATE_CALL_BLEND = 0,
+	STATE_CALL_DEPTH_STENCIL,
+	STATE_CALL_RASTERIZER,
+	STATE_CALL_TOPOLOGY,
+	STATE_CALL_INPUT_LAYOUT,
+	STATE_CALL_VERTEX_SHADER,
+	STATE_CALL_PIXEL_SHADER,
+	STATE_CALL_VERTEX_BUFFER,
+	STATE_CALL_INDEX_BUFFER,
+	STATE_CALL_SHADER_RESOURCE,
+	STATE_CALL_SAMPLER,
+
+	NUM_STATE_CALLS
+};
+
+class i_render_state_device
+{
+public:
+	virtual ~i_render_state_device() = default;
+	virtual void set_blend_state(dx_state_blend* state) = 0;
+	virtual void set_depth_stencil_state(dx_state_depth_stencil* state) = 0;
+	virtual void set_rasterizer_state(dx_state_rasterizer* state) = 0;
+	virtual void set_topology(D3D11_PRIMITIVE_TOPOLOGY topology) = 0;
+	virtual void set_input_layout(dx_layout* layout) = 0;
+	virtual void set_vertex_shader(dx_vs* vs) = 0;
+	virtual void set_pixel_shader(dx_ps* ps) = 0;
+	// Input slot <stream>, offset 0
+	virtual void set_vertex_buffer(uint32 stream, dx_buffer* buffer, uint32 stride) = 0;
+	virtual void set_index_buffer(dx_buffer* buffer, dx_format format) = 0;
+	// Pixel shader slots
+	virtual void set_shader_resource(uint32 slot, dx_srv* srv) = 0;
+	virtual void set_sampler(uint32 slot, dx_sampler* sampler) = 0;
+};
+
+class dx_render_state_device final : public i_render_state_device
+{
+public:
+	explicit dx_render_state_device(dx_context* context);
+	void set_blend_state(dx_state_blend* state) override;
+	void set_depth_stencil_state(dx_state_depth_stencil* state) override;
+	void set_rasterizer_state(dx_state_rasterizer* state) override;
+	void set_topology(D3D11_PRIMITIVE_TOPOLOGY topology) override;
+	void set_input_layout(dx_layout* layout) override;
+	void set_vertex_shader(dx_vs* vs) override;
+	void set_pixel_shader(dx_ps* ps) override;
+	void set_vertex_buffer(uint32 stream, dx_buffer* buffer, uint32 stride) override;
+	void set_index_buffer(dx_buffer* buffer, dx_format format) override;
+	void set_shader_resource(uint32 slot, dx_srv* srv) override;
+	void set_sampler(uint32 slot, dx_sampler* sampler) override;
+private:
+	dx_context* m_context = nullptr;
+};
+
+struct render_state_stats
+{
+	uint32 issued[NUM_STATE_CALLS] = {};	// forwarded to the device
+	uint32 skipped[NUM_STATE_CALLS] = {};	// already bound
+
+	NODISCARD uint32 get_issued_count() const;
+	NODISCARD uint32 get_skipped_count() const;
+};
+
+class render_state_cache
+{
+public:
+	static constexpr uint32 MAX_TEXTURE_SLOTS = 16;
+public:
+	// Takes ownership of <device>
+	explicit render_state_cache(i_render_state_device* device);
+	~render_state_cache();
+	render_state_cache(const render_state_cache&) = delete;
+	render_state_cache& operator=(const render_state_cache&) = delete;
+
+	void set_blend_state(dx_state_blend* state);
+	void set_depth_stencil_state(dx_state_depth_stencil* state);
+	void set_rasterizer_state(dx_state_rasterizer* state);
+	void set_topology(D3D11_PRIMITIVE_TOPOLOGY topology);
+	void set_input_layout(dx_layout* layout);
+	void set_vertex_shader(dx_vs* vs);
+	void set_pixel_shader(dx_ps* ps);
+	void set_vertex_buffer(uint32 stream, dx_buffer* buffer, uint32 stride);
+	void set_index_buffer(dx_buffer* buffer, dx_format format);
+	void set_shader_resource(uint32 slot, dx_srv* srv);
+	void set_sampler(uint32 slot, dx_sampler* sampler);
+
+	// Forgets the bound state, the next call of each kind is forwarded
+	void invalidate();
+	// Keeps the counters of the ending frame and starts new ones
+	void begin_frame();
+
+	NODISCARD const render_state_stats& get_frame_stats() const		{ return m_frame_stats; }
+	NODISCARD const render_state_stats& get_last_frame_stats() const	{ return m_last_frame_stats; }
+	NODISCARD i_render_state_device* get_device() const				{ return m_device; }
+
+private:
+	// Return: true when <value> has to be forwarded, <bound> is updated
+	template<typename T>
+	bool filter(T& bound, const T& value, uint32 valid_bit, uint32& valid_mask, e_render_state_call call);
+
+private:
+	i_render_state_device*	m_device = nullptr;
+
+	dx_state_blend*			m_blend = nullptr;
+	dx_state_depth_stencil*	m_depth_stencil = nullptr;
+	dx_state_rasterizer*	m_rasterizer = nullptr;
+	D3D11_PRIMITIVE_TOPOLOGY m_topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	dx_layout*				m_input_layout = nullptr;
+	dx_vs*					m_vs = nullptr;
+	dx_ps*					m_ps = nullptr;
+	dx_buffer*				m_vertex_buffers[NUM_VERTEX_STREAMS] = {};
+	uint32					m_vertex_strides[NUM_VERTEX_STREAMS] = {};
+	dx_buffer*				m_index_buffer = nullptr;
+	dx_format				m_index_format = DXGI_FORMAT_UNKNOWN;
+	dx_srv*					m_srvs[MAX_TEXTURE_SLOTS] = {};
+	dx_sampler*				m_samplers[MAX_TEXTURE_SLOTS] = {};
+
+	// A cleared bit forwards the next call whatever the shadow holds
+	uint32					m_valid_calls = 0;		// by e_render_state_call
+	uint32					m_valid_vertex_buffers = 0;	// by stream
+	uint32					m_valid_srvs = 0;		// by slot
+	uint32					m_valid_samplers = 0;	// by slot
+
+	render_state_stats		m_frame_stats;
+	render_state_stats		m_last_frame_stats;
+};
+}
@@ -0,0 +1,88 @@
+#include "glare/render/render_target_pool.h"
+#include "glare/render/renderer.h"
+#include "glare/render/texture.h"
+#include "glare/render/render_target.h"
+#include "glare/core/assert.h"
+
+namespace glare
+{
+render_target_pool::render_target_pool(renderer* r)
+	: m_renderer(r)
+{
+}
+
+render_target_pool::~render_target_pool()
+{
+	clear();
+}
+
+render_target_pool::entry render_target_pool::acquire(const ivec2& size, dx_format format)
+{
+	for (entry& each : m_entries) {
+		if (!each.m_in_use && each.m_size == size && each.m_format == format) {
+			each.m_in_use = true;
+			return each;
+		}
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	memset(&desc, 0, sizeof(desc));
+	desc.Width		= size.x;
+	desc.Height		= size.y;
+	desc.MipLevels	= 1;
+	desc.ArraySize	= 1;
+	desc.Format		= format;
+	desc.Usage		= static_cast<D3D11_USAGE>(GPU_MEMORY_GPU);
+	desc.BindFlags	= TEXTURE_SHADER_RESOURCE | TEXTURE_RENDER_TARGET;
+	desc.SampleDesc.Count	= 1;
+	desc.SampleDesc.Quality	= 0;
+	dx_texture2d* created = nullptr;
+	HRESULT hr = m_renderer->get_dx_device()->CreateTexture2D(&desc, nullptr, &created);
+	if (FAILED(hr)) {
+		FATAL("Creating pooled render target texture failed");
+	}
+
+	entry& added = m_entries.emplace_back();
+	added.m_texture = new texture2d(m_renderer);
+	added.m_texture->wrap_dx_texture(created);
+	DX_RELEASE(created);
+	added.m_target = new render_target();
+	added.m_target->make_from_dx_texture(m_renderer->get_dx_device(), added.m_texture->get_texture_handle());
+	added.m_size = size;
+	added.m_format = format;
+	added.m_in_use = true;
+	++m_stats.textures_created;
+	++m_stats.views_created;
+	++m_stats.total_textures_created;
+	++m_stats.total_views_created;
+	return added;
+}
+
+void render_target_pool::release(const texture2d* texture)
+{
+	for (entry& each : m_entries) {
+		if (each.m_texture == texture) {
+			ASSERT(each.m_in_use, "Releasing a pooled render target twice");
+			each.m_in_use = false;
+			return;
+		}
+	}
+	ALERT("Releasing a render target the pool does not own");
+}
+
+void render_target_pool::clear()
+{
+	for (entry& each : m_entries) {
+		ASSERT(!each.m_in_use, "Clearing a render target pool with targets in use");
+		delete each.m_target;
+		delete each.m_texture;
+	}
+	m_entries.clear();
+}
+
+void render_target_pool::begin_frame()
+{
+	m_stats.textures_created = 0;
+	m_stats.views_created = 0;
+}
+}
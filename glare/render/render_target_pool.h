@@ -0,0 +1,63 @@
+/// glare/render/render_target_pool.h
+/// Render target textures kept alive across frames, by size and format.
+///
+/// acquire() hands out a free entry of the requested size and format, and
+/// only creates the texture and its view when no such entry is free.
+/// release() returns it to the pool, it is not destroyed. The renderer takes
+/// its frame target from here every frame, so a frame costs no allocation
+/// once the first one ran. clear() drops every entry, for a resize.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/common.h"
+#include "glare/math/vector.h"
+#include <vector>
+
+namespace glare
+{
+class renderer;
+class texture2d;
+class render_target;
+
+struct render_target_pool_stats
+{
+	uint32 textures_created	= 0;	// this frame
+	uint32 views_created	= 0;	// this frame, render target views
+	uint32 total_textures_created = 0;
+	uint32 total_views_created = 0;
+};
+
+class render_target_pool
+{
+public:
+	struct entry
+	{
+		texture2d*		m_texture = nullptr;
+		render_target*	m_target = nullptr;
+		ivec2			m_size;
+		dx_format		m_format = DXGI_FORMAT_UNKNOWN;
+		bool			m_in_use = false;
+	};
+public:
+	explicit render_target_pool(renderer* r);
+	~render_target_pool();
+	render_target_pool(const render_target_pool&) = delete;
+	render_target_pool& operator=(const render_target_pool&) = delete;
+
+	// The texture is bindable as render target and shader resource
+	NODISCARD entry acquire(const ivec2& size, dx_format format);
+	void release(const texture2d* texture);
+	// Destroys every entry, none may be in use
+	void clear();
+	// Starts the per frame counters
+	void begin_frame();
+
+	NODISCARD size_t get_entry_count() const { return m_entries.size(); }
+	NODISCARD const render_target_pool_stats& get_stats() const { return m_stats; }
+
+private:
+	renderer*			m_renderer = nullptr;
+	std::vector<entry>	m_entries;
+	render_target_pool_stats m_stats;
+};
+}
@@ -1,14 +1,21 @@
 #include "glare/render/renderer.h"
 #include "glare/core/window.h"
 #include "glare/render/shader.h"
+#include "glare/render/shader_cache.h"
 #include "glare/render/surface.h"
 #include "glare/render/mesh.h"
+#include "glare/render/texture_loader.h"
 #include "glare/core/assert.h"
 #include "core/string_utils.h"
 #include "glare/render/sampler.h"
 
 namespace glare
 {
+constexpr size_t TRANSIENT_VERTEX_BYTES	= 4u << 20;
+constexpr size_t TRANSIENT_INDEX_BYTES	= 1u << 20;
+// Relative to the working directory, like the shader and texture paths
+constexpr const char* SHADER_CACHE_DIRECTORY = "cache/shaders";
+
 renderer::renderer(const window* client)
 {
 	m_resolution = client->get_client_resolution();
@@ -45,10 +52,18 @@ renderer::renderer(const window* client)
 	);
 
 	ASSERT(SUCCEEDED(hr), "Creating D3D Context failed.");
+	m_state_cache = new render_state_cache(new dx_render_state_device(m_context));
+	m_state_objects = new state_object_cache(this);
+	m_input_layouts = new input_layout_cache(new dx_input_layout_device(m_device));
+	m_shader_cache = new shader_cache(new dx_shader_compiler(), SHADER_CACHE_DIRECTORY);
+	m_render_target_pool = new render_target_pool(this);
+	m_transient_vertices = new transient_ring(this, RENDER_BUFFER_VERTEX, TRANSIENT_VERTEX_BYTES);
+	m_transient_indices = new transient_ring(this, RENDER_BUFFER_INDEX, TRANSIENT_INDEX_BYTES);
 	m_buffer_vbo = new vertex_buffer(this);
 	m_buffer_model = new constant_buffer(this);
 	m_buffer_post = new constant_buffer(this);
 	m_buffer_project = new constant_buffer(this);
+	m_texture_loader = new texture_loader(this);
 	
 #if GLARE_RENDERER_DEBUG_LEVEL >= GLARE_RENDERER_DEBUG_LEAK
 	hr = m_device->QueryInterface(IID_PPV_ARGS(&m_debug));
@@ -61,22 +76,34 @@ void renderer::start()
 	sampler::init(this);
 	sampler::get_point_sampler();
 	sampler::get_linear_sampler();
-	// #TODO: default texture
+	const surface white(1, 1, color::WHITE);
+	m_default_texture = new texture2d(this, &white, false);
 }
 
 void renderer::begin_frame()
 {
-	dx_texture2d* p_back_buffer;
-	m_swapchain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&p_back_buffer));
-	// add back buffer here
-	m_frame_back_buffer_texture = new texture2d(this);
-	m_frame_back_buffer_texture->wrap_dx_texture(p_back_buffer); // the original texture on swap chain
-	m_frame_texture = new texture2d(this, p_back_buffer);		 // a new blank texture for rendering, blit to back buffer at end of frame
-	m_frame_render_target = new render_target();
-	m_frame_render_target->make_from_dx_texture(m_device, m_frame_texture->get_texture_handle());
-	DX_RELEASE(p_back_buffer);
+	m_render_target_pool->begin_frame();
+	if (!m_frame_back_buffer_texture) {
+		// the swap chain discards, buffer 0 stays the back buffer until the next resize
+		dx_texture2d* p_back_buffer;
+		m_swapchain->GetBuffer(0, __uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&p_back_buffer));
+		m_frame_back_buffer_texture = new texture2d(this);
+		m_frame_back_buffer_texture->wrap_dx_texture(p_back_buffer); // the original texture on swap chain
+		D3D11_TEXTURE2D_DESC desc;
+		p_back_buffer->GetDesc(&desc);
+		m_frame_format = desc.Format;
+		DX_RELEASE(p_back_buffer);
+	}
+	// a blank texture for rendering, blit to back buffer at end of frame
+	const render_target_pool::entry frame = m_render_target_pool->acquire(m_frame_back_buffer_texture->get_size(), m_frame_format);
+	m_frame_texture = frame.m_texture;
+	m_frame_render_target = frame.m_target;
 
 	m_context->OMSetRenderTargets(1, &(m_frame_render_target->m_rtv), nullptr);
+	// binding a target unbinds its shader resource views behind the cache's back
+	m_state_cache->invalidate();
+	m_state_cache->begin_frame();
+	m_texture_loader->update();
 
 	reset_viewport();
 
@@ -89,19 +116,52 @@ void renderer::end_frame()
 	copy_texture(m_frame_back_buffer_texture, m_frame_texture);
 	// Check Present flags at https://msdn.microsoft.com/en-us/library/windows/desktop/bb509554(v=vs.85).aspx
 	m_swapchain->Present(0, 0);
-	delete m_frame_render_target;
+	m_transient_vertices->end_frame();
+	m_transient_indices->end_frame();
+	m_render_target_pool->release(m_frame_texture);
 	m_frame_render_target = nullptr;
-	delete m_frame_texture;
 	m_frame_texture = nullptr;
+}
+
+void renderer::resize(const ivec2& resolution)
+{
+	ASSERT(!m_frame_texture, "Resizing the swap chain inside a frame");
+	// every view on the back buffer has to be gone before ResizeBuffers
+	m_context->OMSetRenderTargets(0, nullptr, nullptr);
+	m_state_cache->invalidate();
+	m_render_target_pool->clear();
 	delete m_frame_back_buffer_texture;
 	m_frame_back_buffer_texture = nullptr;
+	HRESULT hr = m_swapchain->ResizeBuffers(0, resolution.x, resolution.y, DXGI_FORMAT_UNKNOWN, 0);
+	CHECK(SUCCEEDED(hr), "Resizing the swap chain failed");
+	m_resolution = resolution;
 }
 
 void renderer::stop()
 {
+	delete m_texture_loader;
+	m_texture_loader = nullptr;
 	delete m_buffer_vbo;
 	delete m_buffer_model;
 	delete m_buffer_post;
+	delete m_state_cache;
+	m_state_cache = nullptr;
+	delete m_state_objects;
+	m_state_objects = nullptr;
+	delete m_input_layouts;
+	m_input_layouts = nullptr;
+	delete m_shader_cache;
+	m_shader_cache = nullptr;
+	delete m_render_target_pool;
+	m_render_target_pool = nullptr;
+	delete m_transient_vertices;
+	m_transient_vertices = nullptr;
+	delete m_transient_indices;
+	m_transient_indices = nullptr;
+	delete m_frame_back_buffer_texture;
+	m_frame_back_buffer_texture = nullptr;
+	delete m_default_texture;
+	m_default_texture = nullptr;
 	DX_RELEASE(m_swapchain);
 	DX_RELEASE(m_context);
 	DX_RELEASE(m_device);
@@ -185,22 +245,21 @@ void renderer::copy_texture(texture* dst, texture* src) const
 void renderer::bind_shader(shader* shader)
 {
 	m_current_shader = shader;
-	m_context->VSSetShader(m_current_shader->get_dx_vs(), nullptr, 0);
-	m_context->PSSetShader(m_current_shader->get_dx_ps(), nullptr, 0);
+	m_state_cache->set_vertex_shader(m_current_shader->get_dx_vs());
+	m_state_cache->set_pixel_shader(m_current_shader->get_dx_ps());
 }
 
-void renderer::bind_vbo(vertex_buffer* vbo) const
+void renderer::bind_vbo(vertex_buffer* vbo, e_vertex_stream stream) const
 {
 	dx_buffer* buf = vbo?vbo->m_handle:nullptr;
 	unsigned stride = vbo?vbo->get_buffer_layout()->get_stride():0;
-	unsigned offset = 0;
-	m_context->IASetVertexBuffers(0, 1, &buf, &stride, &offset);
+	m_state_cache->set_vertex_buffer(stream, buf, stride);
 }
 
 void renderer::bind_ibo(index_buffer* ibo) const
 {
 	dx_buffer* buf = ibo ? ibo->m_handle : nullptr;
-	m_context->IASetIndexBuffer(buf, index_buffer::format, 0);
+	m_state_cache->set_index_buffer(buf, ibo ? ibo->get_format() : DXGI_FORMAT_UNKNOWN);
 }
 
 void renderer::bind_constant_buffer(e_constant_buffer_id buffer_id, constant_buffer* buffer) const
@@ -214,8 +273,8 @@ void renderer::bind_texture(const texture* tex, e_texture_slot slot, e_texture_f
 {
 	dx_srv* srv = tex->get_view_handle();
 	dx_sampler* sampler = sampler::get_sampler(filter);
-	m_context->PSSetShaderResources(slot, 1, &srv);
-	m_context->PSSetSamplers(slot, 1, &sampler);
+	m_state_cache->set_shader_resource(slot, srv);
+	m_state_cache->set_sampler(slot, sampler);
 }
 
 void renderer::clear_render_target(const rgba& clear_color) const
@@ -225,26 +284,39 @@ void renderer::clear_render_target(const rgba& clear_color) const
 
 void renderer::draw(size_t vertex_count, size_t offset) const
 {
-	m_current_shader->update_all_mode();
-	static float black[] = { 0.f,0.f,0.f,1.f };
-	m_context->OMSetBlendState(m_current_shader->m_dx_blend_state, black, 0xffffffff);
-	m_context->OMSetDepthStencilState(m_current_shader->m_dx_depth_stencil_state, 0);
-	m_context->RSSetState(m_current_shader->m_dx_rasterizer_state);
-	m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	m_context->IASetInputLayout(m_current_shader->m_vbo_layout);
+	bind_pipeline_state();
 	m_context->Draw(vertex_count, offset);
 }
 
-void renderer::draw_indexed(size_t indice_count, size_t offset) const
+void renderer::draw_indexed(size_t indice_count, size_t offset, size_t base_vertex) const
+{
+	bind_pipeline_state();
+	m_context->DrawIndexed(indice_count, offset, static_cast<INT>(base_vertex));
+}
+
+void renderer::draw_instanced(size_t vertex_count, size_t instance_count, size_t offset, size_t first_instance) const
+{
+	bind_pipeline_state();
+	m_context->DrawInstanced(static_cast<UINT>(vertex_count), static_cast<UINT>(instance_count)
+		, static_cast<UINT>(offset), static_cast<UINT>(first_instance));
+}
+
+void renderer::draw_indexed_instanced(size_t indice_count, size_t instance_count, size_t offset, size_t base_vertex, size_t first_instance) const
+{
+	bind_pipeline_state();
+	m_context->DrawIndexedInstanced(static_cast<UINT>(indice_count), static_cast<UINT>(instance_count)
+		, static_cast<UINT>(offset), static_cast<INT>(base_vertex), static_cast<UINT>(first_instance));
+}
+
+void renderer::bind_pipeline_state() const
 {
+	// Only rebuilds the dx states whose mode changed
 	m_current_shader->update_all_mode();
-	static float black[] = { 0.f,0.f,0.f,1.f };
-	m_context->OMSetBlendState(m_current_shader->m_dx_blend_state, black, 0xffffffff);
-	m_context->OMSetDepthStencilState(m_current_shader->m_dx_depth_stencil_state, 0);
-	m_context->RSSetState(m_current_shader->m_dx_rasterizer_state);
-	m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	m_context->IASetInputLayout(m_current_shader->m_vbo_layout);
-	m_context->DrawIndexed(indice_count, offset, 0);
+	m_state_cache->set_blend_state(m_current_shader->m_dx_blend_state);
+	m_state_cache->set_depth_stencil_state(m_current_shader->m_dx_depth_stencil_state);
+	m_state_cache->set_rasterizer_state(m_current_shader->m_dx_rasterizer_state);
+	m_state_cache->set_topology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	m_state_cache->set_input_layout(m_current_shader->m_vbo_layout);
 }
 
 void renderer::draw_mesh(const mesh* mesh) const
@@ -259,5 +331,48 @@ void renderer::draw_mesh(const mesh* mesh) const
 	}
 }
 
+void renderer::draw_mesh_instanced(const mesh* mesh, vertex_buffer* instances, size_t instance_count, size_t first_instance) const
+{
+	const buffer_layout* instance_layout = instances->get_buffer_layout();
+	ASSERT(instance_layout && instance_layout->get_input_rate() == INPUT_PER_INSTANCE, "Instance buffer without a per instance layout");
+	bind_vbo(mesh->m_gpu_vbo);
+	bind_vbo(instances, VERTEX_STREAM_INSTANCE);
+	m_current_shader->create_dx_vbo_layout(mesh->m_layout, instance_layout);
+	if (mesh->is_indexed()) {
+		bind_ibo(mesh->m_gpu_ibo);
+		draw_indexed_instanced(mesh->get_element_count(), instance_count, 0, 0, first_instance);
+	} else {
+		draw_instanced(mesh->get_element_count(), instance_count, 0, first_instance);
+	}
+}
+
+void renderer::draw_transient(const void* vertices, size_t vertex_count, const buffer_layout* layout) const
+{
+	const size_t stride = layout->get_stride();
+	const transient_allocation vertex_range = m_transient_vertices->push(vertices, vertex_count * stride, stride);
+	if (!vertex_range.is_valid()) {
+		return;
+	}
+	m_state_cache->set_vertex_buffer(VERTEX_STREAM_GEOMETRY, vertex_range.m_buffer->get_buffer_handle(), static_cast<uint32>(stride));
+	m_current_shader->create_dx_vbo_layout(layout);
+	draw(vertex_count, vertex_range.get_first_element(stride));
+}
+
+void renderer::draw_transient_indexed(const void* vertices, size_t vertex_count, const buffer_layout* layout
+	, const void* indices, size_t index_count, e_index_type index_type) const
+{
+	const size_t stride = layout->get_stride();
+	const size_t index_size = get_size_of_index_type(index_type);
+	const transient_allocation vertex_range = m_transient_vertices->push(vertices, vertex_count * stride, stride);
+	const transient_allocation index_range = m_transient_indices->push(indices, index_count * index_size, index_size);
+	if (!vertex_range.is_valid() || !index_range.is_valid()) {
+		return;
+	}
+	m_state_cache->set_vertex_buffer(VERTEX_STREAM_GEOMETRY, vertex_range.m_buffer->get_buffer_handle(), static_cast<uint32>(stride));
+	m_state_cache->set_index_buffer(index_range.m_buffer->get_buffer_handle(), get_dx_format_of_index_type(index_type));
+	m_current_shader->create_dx_vbo_layout(layout);
+	draw_indexed(index_count, index_range.get_first_element(index_size), vertex_range.get_first_element(stride));
+}
+
 STATIC std::unordered_map<string, texture2d*> renderer::s_cached_texture;
 };
\ No newline at end of file
@@ -4,6 +4,11 @@
 #include "glare/render/buffer.h"
 #include "glare/render/texture.h"
 #include "glare/render/render_target.h"
+#include "glare/render/render_state.h"
+#include "glare/render/state_object_cache.h"
+#include "glare/render/input_layout_cache.h"
+#include "glare/render/render_target_pool.h"
+#include "glare/render/transient_ring.h"
 #include "glare/math/vector.h"
 #include "glare/math/matrix.h"
 #include <unordered_map>
@@ -14,6 +19,8 @@ class mesh;
 struct rgba;
 class window;
 class shader;
+class texture_loader;
+class shader_cache;
 class renderer
 {
 public:
@@ -24,13 +31,27 @@ public:
 	void begin_frame();
 	void end_frame();
 	void stop();
+	// Resizes the swap chain, outside begin_frame()/end_frame()
+	void resize(const ivec2& resolution);
 	
 	NODISCARD dx_device* get_dx_device() const { return m_device; }
 	NODISCARD dx_context* get_dx_context() const { return m_context; }
+	// Filters the pipeline state calls, see render_state.h
+	NODISCARD render_state_cache* get_state_cache() const { return m_state_cache; }
+	// Blend, depth-stencil and rasterizer states shared by the shaders
+	NODISCARD state_object_cache* get_state_objects() const { return m_state_objects; }
+	NODISCARD input_layout_cache* get_input_layouts() const { return m_input_layouts; }
+	NODISCARD render_target_pool* get_render_target_pool() const { return m_render_target_pool; }
+	// Decodes on the job_system workers, begin_frame() uploads what is ready
+	NODISCARD texture_loader* get_texture_loader() const { return m_texture_loader; }
+	// Compiled shader bytecode kept on disk between runs
+	NODISCARD shader_cache* get_shader_cache() const { return m_shader_cache; }
 
 	// Resource
 	texture2d*	load_texture2d_from_file(const string& id, const char* path, bool flip_v=false);
 	NODISCARD texture2d*	get_texture2d_by_id(const string& id) const;
+	// 1x1 white, for drawing untextured with a textured shader. Created by start()
+	NODISCARD texture2d*	get_default_texture() const { return m_default_texture; }
 	
 	// Render states
 	void set_ortho(const vec2& ortho_min, const vec2& ortho_max, float32 near_z, float32 far_z);
@@ -38,15 +59,27 @@ public:
 	void reset_viewport() const;
 	void copy_texture(texture* dst, texture* src) const;
 	void bind_shader(shader* shader);
-	void bind_vbo(vertex_buffer* vbo) const;
+	void bind_vbo(vertex_buffer* vbo, e_vertex_stream stream=VERTEX_STREAM_GEOMETRY) const;
 	void bind_ibo(index_buffer* ibo) const;
 	void bind_constant_buffer(e_constant_buffer_id buffer_id, constant_buffer* buffer) const;
 	void bind_texture(const texture* tex, e_texture_slot slot=TEXTURE_SLOT_DIFFUSE, e_texture_filter filter=MIN_POINT_MAG_POINT) const;
 	// Render operations
 	void clear_render_target(const rgba& clear_color) const;
 	void draw(size_t vertex_count, size_t offset=0) const;
-	void draw_indexed(size_t indice_count, size_t offset=0) const;
+	void draw_indexed(size_t indice_count, size_t offset=0, size_t base_vertex=0) const;
+	// The instance stream is bound with bind_vbo(instances, VERTEX_STREAM_INSTANCE)
+	void draw_instanced(size_t vertex_count, size_t instance_count, size_t offset=0, size_t first_instance=0) const;
+	void draw_indexed_instanced(size_t indice_count, size_t instance_count, size_t offset=0, size_t base_vertex=0, size_t first_instance=0) const;
 	void draw_mesh(const mesh* mesh) const;
+	// <instances> holds per instance data, its layout is INPUT_PER_INSTANCE
+	void draw_mesh_instanced(const mesh* mesh, vertex_buffer* instances, size_t instance_count, size_t first_instance=0) const;
+	// Immediate geometry, copied into the frame rings and drawn with the current shader
+	void draw_transient(const void* vertices, size_t vertex_count, const buffer_layout* layout) const;
+	// <indices> are <index_count> values of <index_type>
+	void draw_transient_indexed(const void* vertices, size_t vertex_count, const buffer_layout* layout
+		, const void* indices, size_t index_count, e_index_type index_type) const;
+private:
+	void bind_pipeline_state() const;
 public: //members
 	ivec2			m_resolution;
 	mat4			m_projection = mat4::identity;
@@ -54,6 +87,14 @@ public: //members
 	dx_context*		m_context = nullptr;
 	dx_swapchain*	m_swapchain = nullptr;
 	dx_debug*		m_debug = nullptr;
+	render_state_cache*	m_state_cache = nullptr;
+	state_object_cache*	m_state_objects = nullptr;
+	input_layout_cache*	m_input_layouts = nullptr;
+	render_target_pool*	m_render_target_pool = nullptr;
+	transient_ring*		m_transient_vertices = nullptr;
+	transient_ring*		m_transient_indices = nullptr;
+	texture_loader*		m_texture_loader = nullptr;
+	shader_cache*		m_shader_cache = nullptr;
 
 	vertex_buffer*		m_buffer_vbo = nullptr;
 	constant_buffer*	m_buffer_project = nullptr;
@@ -61,9 +102,11 @@ public: //members
 	constant_buffer*	m_buffer_post = nullptr;
 	shader*				m_current_shader = nullptr;
 
-	texture2d*		m_frame_back_buffer_texture = nullptr;
-	texture2d*		m_frame_texture = nullptr;
+	texture2d*		m_frame_back_buffer_texture = nullptr;	// kept until resize()
+	dx_format		m_frame_format = DXGI_FORMAT_UNKNOWN;
+	texture2d*		m_frame_texture = nullptr;				// from m_render_target_pool, during a frame
 	render_target*	m_frame_render_target = nullptr;
+	texture2d*		m_default_texture = nullptr;
 
 public: // static member
 	static std::unordered_map<string, texture2d*> s_cached_texture;
@@ -1,5 +1,6 @@
 #include "glare/render/shader.h"
 #include "glare/render/renderer.h"
+#include "glare/render/shader_cache.h"
 #include "glare/core/assert.h"
 #include "glare/core/log.h"
 #include "glare/core/string_utils.h"
@@ -8,53 +9,52 @@
 #pragma comment(lib, "d3dcompiler.lib")
 
 ////////////////////////////////////////////////////////
-static glare::dx_bytecode* _compile_hlsl_shader(const void* code, size_t code_size, const char* entry_point, const char* shader_model, const char* filename)
+static glare::uint32 _get_compile_flags()
 {
-	DWORD compile_flags = 0U;
+	glare::uint32 compile_flags = 0U;
 #if GLARE_RENDERER_DEBUG_LEVEL >= GLARE_RENDERER_DEBUG_SHADER
 	compile_flags |= D3DCOMPILE_DEBUG;
 	compile_flags |= D3DCOMPILE_SKIP_OPTIMIZATION;
 #else
 	compile_flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
 #endif
-	glare::dx_bytecode* bytecode = nullptr;
-	ID3DBlob* error = nullptr;
+	return compile_flags;
+}
 
-	HRESULT hr = ::D3DCompile(code, code_size, filename, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, entry_point, shader_model, compile_flags, 0, &bytecode, &error);
+///////////////////////////////////////////////////////
+
+namespace glare
+{ 
+bool dx_shader_compiler::compile(const shader_compile_request& request, std::vector<byte>& out_bytecode)
+{
+	dx_bytecode* bytecode = nullptr;
+	ID3DBlob* error = nullptr;
+	HRESULT hr = ::D3DCompile(request.source, request.source_size, request.filename, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE
+		, request.entry_point, request.shader_model, request.flags, 0, &bytecode, &error);
 
 	if (FAILED(hr) || error) {
 		if (error) {
 			char* what = (char*) error->GetBufferPointer();
-			glare::debug_log("Compiling %s failed.\n(%s)",filename, what);
+			debug_log("Compiling %s failed.\n(%s)", request.filename, what);
 			DX_RELEASE(error);
 		} else {
-			glare::debug_log("Compiling %s failed.\nHRESULT=%u",filename, hr);
+			debug_log("Compiling %s failed.\nHRESULT=%u", request.filename, hr);
 		}
 	}
-	return bytecode;
+	if (!bytecode) {
+		return false;
+	}
+	const byte* code = static_cast<const byte*>(bytecode->GetBufferPointer());
+	out_bytecode.assign(code, code + bytecode->GetBufferSize());
+	DX_RELEASE(bytecode);
+	return true;
 }
 
-static DXGI_FORMAT _get_dxgi_format(glare::e_hlsl_type type)
+uint64 dx_shader_compiler::get_compiler_id() const
 {
-	switch(type) {
-	case glare::HLSL_NULL:
-		return DXGI_FORMAT_UNKNOWN;
-	case glare::HLSL_FLOAT:
-		return DXGI_FORMAT_R32_FLOAT;
-	case glare::HLSL_FLOAT2:
-		return DXGI_FORMAT_R32G32_FLOAT;
-	case glare::HLSL_FLOAT3:
-		return DXGI_FORMAT_R32G32B32_FLOAT;
-	case glare::HLSL_FLOAT4:
-		return DXGI_FORMAT_R32G32B32A32_FLOAT;
-	}
-	return DXGI_FORMAT_UNKNOWN;
+	return D3D_COMPILER_VERSION;
 }
 
-///////////////////////////////////////////////////////
-
-namespace glare
-{ 
 STATIC shader_stage::~shader_stage()
 {
 	DX_RELEASE(m_handle);
@@ -77,21 +77,33 @@ const char* shader_stage::get_shader_model(e_shader_stage stage)
 void shader_stage::compile(
 	const renderer* r, const string& src, e_shader_stage stage, const char* filename, const char* entry_point)
 {
-	dx_bytecode* bytecode = _compile_hlsl_shader(src.c_str(), src.length(), entry_point, get_shader_model(stage), filename);
-	if (!bytecode) {
+	shader_compile_request request;
+	request.filename		= filename;
+	request.source			= src.c_str();
+	request.source_size		= src.length();
+	request.entry_point		= entry_point;
+	request.shader_model	= get_shader_model(stage);
+	request.flags			= _get_compile_flags();
+	std::vector<byte> bytecode;
+	if (!r->get_shader_cache()->get_bytecode(request, bytecode)) {
 		FATAL(format("Compiling %s failed.", filename));
 	}
-	m_bytecode = bytecode;
+	DX_RELEASE(m_bytecode);
+	if (FAILED(::D3DCreateBlob(bytecode.size(), &m_bytecode))) {
+		FATAL("Creating the bytecode blob failed");
+	}
+	memcpy(m_bytecode->GetBufferPointer(), bytecode.data(), bytecode.size());
+	m_bytecode_hash = input_layout_cache::hash_bytecode(m_bytecode->GetBufferPointer(), m_bytecode->GetBufferSize());
 	m_stage = stage;
 	HRESULT hr = -1;
 	dx_device* device = r->get_dx_device();
 	switch(stage) {
 	case VERTEX_SHADER: {
-		hr = device->CreateVertexShader(m_bytecode->GetBufferPointer(), bytecode->GetBufferSize(), nullptr, &m_vertex_shader);
+		hr = device->CreateVertexShader(m_bytecode->GetBufferPointer(), m_bytecode->GetBufferSize(), nullptr, &m_vertex_shader);
 		break;
 	}
 	case PIXEL_SHADER: {
-		hr = device->CreatePixelShader(m_bytecode->GetBufferPointer(), bytecode->GetBufferSize(), nullptr, &m_pixel_shader);
+		hr = device->CreatePixelShader(m_bytecode->GetBufferPointer(), m_bytecode->GetBufferSize(), nullptr, &m_pixel_shader);
 		break;
 	}
 	default:
@@ -106,21 +118,25 @@ void shader_stage::compile(
 
 shader* shader::load_from_xml(const char* path, renderer* r)
 {
-	shader* created = new shader(r);
+	shader_pass_desc pass;
+	read_pass_from_xml(path, pass);
+	return create_from_pass(pass, r);
+}
+
+void shader::read_pass_from_xml(const char* path, shader_pass_desc& out_pass)
+{
 	xml::document* doc = xml::load_file(path);
 
 	xml::node pass = doc->child("shader").child("pass");
 	xml::node vert = pass.child("vert");
 	xml::node pixel = pass.child("pixel");
-	string src_file = xml::get_attr(pass, "src", "");
-	string vs_entry = xml::get_attr(vert, "vs", "Vert");
-	string ps_entry = xml::get_attr(pixel, "ps", "Pixel");
-	bool cr = created->load_hlsl(src_file.c_str(), vs_entry.c_str(), ps_entry.c_str());
-	ASSERT(cr, "Loading xml shader failed");
+	out_pass.src = xml::get_attr(pass, "src", "");
+	out_pass.vs_entry = xml::get_attr(vert, "vs", "Vert");
+	out_pass.ps_entry = xml::get_attr(pixel, "ps", "Pixel");
 	xml::node depth = pass.child("depth");
-	created->m_write_depth = xml::get_attr(depth, "write", true);
+	out_pass.write_depth = xml::get_attr(depth, "write", true);
 	string comp_op = xml::get_attr(depth, "comp", "g");
-	created->m_depth_comp_op = [&]() {
+	out_pass.depth_comp_op = [&]() {
 		if (comp_op == "l") {
 			return COMP_LESS;
 		} else if( comp_op == "leq") {
@@ -137,7 +153,7 @@ shader* shader::load_from_xml(const char* path, renderer* r)
 
 	xml::node blend = pass.child("blend");
 	string blend_mode = xml::get_attr(blend, "mode", "alpha");
-	created->m_blend_mode = [&]() {
+	out_pass.blend_mode = [&]() {
 		if (blend_mode == "alpha") {
 			return BLEND_ALPHA;
 		} else if (blend_mode == "opaque") {
@@ -151,14 +167,14 @@ shader* shader::load_from_xml(const char* path, renderer* r)
 	xml::node raster = pass.child("raster");
 	string cull = xml::get_attr(raster, "cull", "back");
 	string fill = xml::get_attr(raster, "fill", "solid");
-	created->m_front_ccw = xml::get_attr(raster, "front_ccw", true);
-	created->m_fill_mode = [&]() {
+	out_pass.front_ccw = xml::get_attr(raster, "front_ccw", true);
+	out_pass.fill_mode = [&]() {
 		if (fill == "wire") {
 			return FILL_WIRE;
 		}
 		return FILL_SOLID;
 	}();
-	created->m_cull_mode = [&] {
+	out_pass.cull_mode = [&] {
 		if (cull == "none") {
 			return CULL_NONE;
 		} else if (cull == "front") {
@@ -166,12 +182,25 @@ shader* shader::load_from_xml(const char* path, renderer* r)
 		}
 		return CULL_BACK;
 	}();
+	xml::unload_file(doc);
+}
+
+shader* shader::create_from_pass(const shader_pass_desc& pass, renderer* r)
+{
+	shader* created = new shader(r);
+	bool cr = created->load_hlsl(pass.src.c_str(), pass.vs_entry.c_str(), pass.ps_entry.c_str());
+	ASSERT(cr, "Compiling shader pass failed");
+	created->m_write_depth		= pass.write_depth;
+	created->m_depth_comp_op	= pass.depth_comp_op;
+	created->m_blend_mode		= pass.blend_mode;
+	created->m_front_ccw		= pass.front_ccw;
+	created->m_fill_mode		= pass.fill_mode;
+	created->m_cull_mode		= pass.cull_mode;
 
 	created->m_update_blend_mode = true;
 	created->m_update_rasterizer = true;
 	created->m_update_depth_stencil = true;
 	created->update_all_mode();
-	xml::unload_file(doc);
 	return created;
 }
 
@@ -183,7 +212,6 @@ shader::shader(renderer* r)
 
 shader::~shader()
 {
-	DX_RELEASE(m_vbo_layout);
 	DX_RELEASE(m_dx_blend_state);
 	DX_RELEASE(m_dx_rasterizer_state);
 	DX_RELEASE(m_dx_depth_stencil_state);
@@ -203,39 +231,25 @@ bool shader::is_valid() const
 	return m_vs.is_valid() && m_ps.is_valid();
 }
 
-void shader::create_dx_vbo_layout(const buffer_layout* layout)
+void shader::create_dx_vbo_layout(const buffer_layout* layout, const buffer_layout* instance_layout)
 {
 	ASSERT(layout, "Invalid buffer layout object");
-	if (layout == m_last_layout) {
+	if (layout == m_last_layout && instance_layout == m_last_instance_layout) {
 		return;
 	}
-	DX_RELEASE(m_vbo_layout);
-	const size_t attr_count = layout->get_attributes_count();
-	D3D11_INPUT_ELEMENT_DESC* desc = new D3D11_INPUT_ELEMENT_DESC[attr_count];
-	for (size_t i = 0; i < attr_count; ++i) {
-		auto& item = (*layout)[i];
-		desc[i].SemanticName = item.name.c_str();
-		desc[i].SemanticIndex = 0;
-		desc[i].Format = _get_dxgi_format(item.type);
-		desc[i].InputSlot = 0;
-		desc[i].AlignedByteOffset = item.offset;
-		desc[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-		desc[i].InstanceDataStepRate = 0;
-	}
 	dx_bytecode* vs_bytecode = m_vs.get_bytecode();
-	HRESULT hr =
-		m_renderer->get_dx_device()
-			->CreateInputLayout(desc, attr_count, vs_bytecode->GetBufferPointer(), vs_bytecode->GetBufferSize(), &m_vbo_layout);
-	delete[] desc;
-	if (FAILED(hr)) {
-		FATAL("Creating vbo input layout failed");
-	}
+	m_vbo_layout = m_renderer->get_input_layouts()->acquire(
+		vs_bytecode->GetBufferPointer(), vs_bytecode->GetBufferSize(), m_vs.get_bytecode_hash(), layout, instance_layout);
 	m_last_layout = layout;
+	m_last_instance_layout = instance_layout;
 }
 
 void shader::set_blend_mode(e_blend_mode blend_mode)
 {
-	m_blend_mode = blend_mode;
+	if (m_blend_mode != blend_mode) {
+		m_blend_mode = blend_mode;
+		m_update_blend_mode = true;
+	}
 }
 
 void shader::update_blend_mode()
@@ -244,43 +258,8 @@ void shader::update_blend_mode()
 		return;
 	}
 	DX_RELEASE(m_dx_blend_state);
-	D3D11_BLEND_DESC desc;
-	memset(&desc, 0, sizeof(desc));
-	desc.AlphaToCoverageEnable = false;
-	desc.IndependentBlendEnable = false;
-	desc.RenderTarget[0].BlendEnable = true;
-	if (m_blend_mode == BLEND_ALPHA) {
-		desc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
-		desc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
-		desc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-		desc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_SRC_ALPHA;
-		desc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
-		desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-	} else if (m_blend_mode == BLEND_OPAQUE) {
-		desc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
-		desc.RenderTarget[0].DestBlend = D3D11_BLEND_ZERO;
-		desc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-		desc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
-		desc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
-		desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-	} else if (m_blend_mode == BLEND_ADDITIVE) {
-		desc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
-		desc.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
-		desc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
-		desc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
-		desc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ONE;
-		desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
-	}
-	desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
-
-	HRESULT hr=
-		m_renderer->get_dx_device()
-			->CreateBlendState(&desc, &m_dx_blend_state);
-	if (SUCCEEDED(hr)) {
-		m_update_blend_mode = false;
-	} else {
-		FATAL("Creating blend state failed");
-	}
+	m_dx_blend_state = m_renderer->get_state_objects()->acquire_blend_state(m_blend_mode);
+	m_update_blend_mode = false;
 }
 
 void shader::set_depth_stencil_mode(e_compare_operator pass_op, bool write)
@@ -296,34 +275,8 @@ void shader::update_depth_stencil_mode()
 		return;
 	}
 	DX_RELEASE(m_dx_depth_stencil_state);
-	D3D11_DEPTH_STENCIL_DESC ds_desc;
-	memset(&ds_desc, 0, sizeof(ds_desc));
-	ds_desc.DepthEnable = TRUE;
-	ds_desc.DepthWriteMask	=
-		m_write_depth ?
-		D3D11_DEPTH_WRITE_MASK_ALL :
-		D3D11_DEPTH_WRITE_MASK_ZERO;
-	ds_desc.DepthFunc		= static_cast<D3D11_COMPARISON_FUNC>(m_depth_comp_op);
-	ds_desc.StencilEnable	= FALSE;
-	ds_desc.StencilReadMask	= 0xff;
-	ds_desc.StencilWriteMask	= 0xff;
-	D3D11_DEPTH_STENCILOP_DESC ds_op; {
-		memset(&ds_op, 0, sizeof(ds_op));
-		ds_op.StencilFailOp			= D3D11_STENCIL_OP_KEEP;
-		ds_op.StencilDepthFailOp	= D3D11_STENCIL_OP_KEEP;
-		ds_op.StencilPassOp			= D3D11_STENCIL_OP_KEEP;
-		ds_op.StencilFunc			= D3D11_COMPARISON_ALWAYS;
-	}
-	ds_desc.FrontFace	= ds_op;
-	ds_desc.BackFace	= ds_op;
-	HRESULT hr =
-		m_renderer->get_dx_device()
-			->CreateDepthStencilState(&ds_desc, &m_dx_depth_stencil_state);
-	if (SUCCEEDED(hr)) {
-		m_update_depth_stencil = false;
-	} else {
-		FATAL("Creating depth stencil state failed");
-	}
+	m_dx_depth_stencil_state = m_renderer->get_state_objects()->acquire_depth_stencil_state(m_depth_comp_op, m_write_depth);
+	m_update_depth_stencil = false;
 }
 
 void shader::set_rasterizer_mode(e_cull_mode cull_mode, e_fill_mode fill_mode, bool front_face_ccw, bool depth_clip)
@@ -341,22 +294,8 @@ void shader::update_rasterizer_mode()
 		return;
 	}
 	DX_RELEASE(m_dx_rasterizer_state);
-	D3D11_RASTERIZER_DESC rs_desc;
-	memset(&rs_desc, 0, sizeof(rs_desc));
-	rs_desc.CullMode		= static_cast<D3D11_CULL_MODE>(m_cull_mode);
-	rs_desc.FillMode		= static_cast<D3D11_FILL_MODE>(m_fill_mode);
-	rs_desc.DepthBias		= 0;
-	rs_desc.AntialiasedLineEnable = FALSE;
-	rs_desc.FrontCounterClockwise = static_cast<BOOL>(m_front_ccw);
-	rs_desc.DepthClipEnable	= static_cast<BOOL>(m_depth_clip);
-	HRESULT hr =
-		m_renderer->get_dx_device()
-			->CreateRasterizerState(&rs_desc, &m_dx_rasterizer_state);
-	if (SUCCEEDED(hr)) {
-		m_update_rasterizer = false;
-	} else {
-		FATAL("Creating rastrerizer state failed");
-	}
+	m_dx_rasterizer_state = m_renderer->get_state_objects()->acquire_rasterizer_state(m_cull_mode, m_fill_mode, m_front_ccw, m_depth_clip);
+	m_update_rasterizer = false;
 }
 
 void shader::update_all_mode()
@@ -388,8 +327,18 @@ void shader::reset_shader_mode()
 
 void shader::use_state(dx_state_blend* blend, dx_state_depth_stencil* depth_stencil, dx_state_rasterizer* rasterizer)
 {
+	// Shares the states, like the ones from state_object_cache
+	blend->AddRef();
+	depth_stencil->AddRef();
+	rasterizer->AddRef();
+	DX_RELEASE(m_dx_blend_state);
+	DX_RELEASE(m_dx_depth_stencil_state);
+	DX_RELEASE(m_dx_rasterizer_state);
 	m_dx_blend_state = blend;
 	m_dx_depth_stencil_state = depth_stencil;
 	m_dx_rasterizer_state = rasterizer;
+	m_update_blend_mode = false;
+	m_update_depth_stencil = false;
+	m_update_rasterizer = false;
 }
 };
\ No newline at end of file
@@ -22,6 +22,7 @@ public:
 	void compile(const renderer* r, const string& src, e_shader_stage stage, const char* filename, const char* entry_point);
 	NODISCARD bool is_valid() const { return m_handle != nullptr; }
 	NODISCARD dx_bytecode* get_bytecode() const {return m_bytecode; }
+	NODISCARD uint64 get_bytecode_hash() const { return m_bytecode_hash; }
 public:
 	union
 	{
@@ -30,13 +31,31 @@ public:
 		dx_ps*			m_pixel_shader;
 	};
 	dx_bytecode* m_bytecode = nullptr;
+	uint64 m_bytecode_hash = 0;
 	e_shader_stage m_stage = VERTEX_SHADER;
 };
 
+// The <pass> of a shader xml, defaults as when its attributes are left out
+struct shader_pass_desc
+{
+	string				src;
+	string				vs_entry		= "Vert";
+	string				ps_entry		= "Pixel";
+	e_blend_mode		blend_mode		= BLEND_ALPHA;
+	e_compare_operator	depth_comp_op	= COMP_GREATER;
+	bool				write_depth		= true;
+	e_cull_mode			cull_mode		= CULL_BACK;
+	e_fill_mode			fill_mode		= FILL_SOLID;
+	bool				front_ccw		= true;
+};
+
 class shader
 {
 public:
 	static shader* load_from_xml(const char* path, renderer* r);
+	static void read_pass_from_xml(const char* path, shader_pass_desc& out_pass);
+	// Compiles the hlsl of <pass> and creates its states
+	static shader* create_from_pass(const shader_pass_desc& pass, renderer* r);
 public:
 	shader(renderer* r);
 	~shader();
@@ -49,7 +68,8 @@ public:
 	NODISCARD dx_vs* get_dx_vs() const {return m_vs.m_vertex_shader;}
 	NODISCARD dx_ps* get_dx_ps() const {return m_ps.m_pixel_shader;}
 	
-	void create_dx_vbo_layout(const buffer_layout* layout);
+	// <instance_layout>: the layout of the instance stream for instanced draws
+	void create_dx_vbo_layout(const buffer_layout* layout, const buffer_layout* instance_layout = nullptr);
 	void set_blend_mode(e_blend_mode blend_mode);
 	void update_blend_mode();
 	void set_depth_stencil_mode(e_compare_operator pass_op, bool write);
@@ -62,7 +82,7 @@ public:
 	void use_state(dx_state_blend* blend, dx_state_depth_stencil* depth_stencil, dx_state_rasterizer* rasterizer);
 public:
 	renderer*			m_renderer		= nullptr;
-	dx_layout*			m_vbo_layout	= nullptr;
+	dx_layout*			m_vbo_layout	= nullptr;	// owned by the renderer input_layout_cache
 	dx_state_blend*			m_dx_blend_state			= nullptr;
 	dx_state_rasterizer*	m_dx_rasterizer_state		= nullptr;
 	dx_state_depth_stencil*	m_dx_depth_stencil_state	= nullptr;
@@ -80,6 +100,7 @@ public:
 
 	// update flag
 	const buffer_layout* m_last_layout = nullptr;
+	const buffer_layout* m_last_instance_layout = nullptr;
 	bool m_update_blend_mode = true;
 	bool m_update_rasterizer = true;
 	bool m_update_depth_stencil = true;
@@ -0,0 +1,225 @@
+#include "glare/render/shader_cache.h"
+#include "glare/core/assert.h"
+#include "glare/core/clock.h"
+#include "glare/core/hash.h"
+#include "glare/core/string_utils.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+
+namespace glare
+{
+constexpr uint32 CACHE_ENTRY_MAGIC = 0x43534c47;	// "GLSC"
+// Bump when the entry header changes
+constexpr uint32 CACHE_ENTRY_VERSION = 1;
+constexpr uint32 MAX_INCLUDE_DEPTH = 32;
+
+struct cache_entry_header
+{
+	uint32	magic;
+	uint32	version;
+	uint64	key;
+	uint64	bytecode_size;
+	uint64	bytecode_hash;		// catches entries cut short or damaged
+};
+
+// Return: false when <path> cannot be opened
+static bool _read_file(const string& path, std::vector<byte>& out_bytes)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file) {
+		return false;
+	}
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	out_bytes.resize(size > 0 ? static_cast<size_t>(size) : 0);
+	const bool read = out_bytes.empty() || fread(out_bytes.data(), 1, out_bytes.size(), file) == out_bytes.size();
+	fclose(file);
+	return read;
+}
+
+// Up to and with the last separator, empty for a bare file name
+static string _get_directory(const char* path)
+{
+	const char* end = path + strlen(path);
+	while (end != path && end[-1] != '/' && end[-1] != '\\') {
+		--end;
+	}
+	return string(path, end);
+}
+
+static void _hash_includes(const char* source, size_t source_size, const string& directory
+	, uint32 depth, std::vector<string>& visited, uint64& hash)
+{
+	const char* end = source + source_size;
+	for (const char* line = source; line < end;) {
+		const char* line_end = static_cast<const char*>(memchr(line, '\n', end - line));
+		line_end = line_end ? line_end : end;
+		const char* c = line;
+		const auto skip_blanks = [&c, line_end]() {
+			while (c < line_end && (*c == ' ' || *c == '\t')) {
+				++c;
+			}
+		};
+		skip_blanks();
+		if (c < line_end && *c == '#') {
+			++c;
+			skip_blanks();
+			if (line_end - c > 7 && strncmp(c, "include", 7) == 0) {
+				c += 7;
+				skip_blanks();
+				const char close = c < line_end && *c == '<' ? '>' : '"';
+				const char* name_end = c < line_end && (*c == '"' || *c == '<')
+					? static_cast<const char*>(memchr(c + 1, close, line_end - c - 1))
+					: nullptr;
+				if (name_end) {
+					const string path = directory + string(c + 1, name_end);
+					hash = hash_fnv1a(path.c_str(), path.size() + 1, hash);
+					if (std::find(visited.begin(), visited.end(), path) == visited.end()) {
+						visited.push_back(path);
+						std::vector<byte> included;
+						if (_read_file(path, included)) {
+							hash = hash_fnv1a(included.data(), included.size(), hash);
+							if (depth < MAX_INCLUDE_DEPTH) {
+								_hash_includes(reinterpret_cast<const char*>(included.data()), included.size()
+									, _get_directory(path.c_str()), depth + 1, visited, hash);
+							}
+						} else {
+							// fails to compile, still keyed apart from the file once it exists
+							hash = hash_fnv1a("missing", hash);
+						}
+					}
+				}
+			}
+		}
+		line = line_end + 1;
+	}
+}
+
+bool stub_shader_compiler::compile(const shader_compile_request& request, std::vector<byte>& out_bytecode)
+{
+	uint64 seed = hash_fnv1a(request.source, request.source_size);
+	seed = hash_fnv1a(request.entry_point, seed);
+	std::mt19937_64 rng(hash_fnv1a(&request.flags, sizeof(request.flags), seed));
+	out_bytecode.resize(BYTECODE_SIZE);
+	for (byte& each : out_bytecode) {
+		each = static_cast<byte>(rng());
+	}
+	return true;
+}
+
+shader_cache::shader_cache(i_shader_compiler* compiler, const string& directory)
+	: m_compiler(compiler)
+	, m_directory(directory)
+{
+	ASSERT(m_compiler, "shader_cache needs a compiler");
+	if (!m_directory.empty()) {
+		std::error_code error;
+		std::filesystem::create_directories(m_directory, error);
+		CHECK(!error, format("Creating the shader cache directory %s failed, every shader is compiled", m_directory.c_str()));
+	}
+}
+
+shader_cache::~shader_cache()
+{
+	delete m_compiler;
+}
+
+bool shader_cache::get_bytecode(const shader_compile_request& request, std::vector<byte>& out_bytecode)
+{
+	const float64 key_start = get_current_time_seconds();
+	const uint64 key = get_key(request);
+	const float64 load_start = get_current_time_seconds();
+	m_stats.key_ms += (load_start - key_start) * 1000.0;
+	if (!m_directory.empty() && load(key, out_bytecode)) {
+		m_stats.load_ms += (get_current_time_seconds() - load_start) * 1000.0;
+		++m_stats.hits;
+		return true;
+	}
+
+	++m_stats.misses;
+	const float64 compile_start = get_current_time_seconds();
+	const bool compiled = m_compiler->compile(request, out_bytecode);
+	m_stats.compile_ms += (get_current_time_seconds() - compile_start) * 1000.0;
+	if (!compiled) {
+		++m_stats.failed;
+		return false;
+	}
+	if (!m_directory.empty() && !store(key, out_bytecode)) {
+		++m_stats.write_failures;
+	}
+	return true;
+}
+
+uint64 shader_cache::get_key(const shader_compile_request& request) const
+{
+	uint64 key = hash_source(request.filename, request.source, request.source_size);
+	key = hash_fnv1a(request.entry_point, strlen(request.entry_point) + 1, key);
+	key = hash_fnv1a(request.shader_model, strlen(request.shader_model) + 1, key);
+	key = hash_fnv1a(&request.flags, sizeof(request.flags), key);
+	const uint64 compiler_id = m_compiler->get_compiler_id();
+	return hash_fnv1a(&compiler_id, sizeof(compiler_id), key);
+}
+
+string shader_cache::get_entry_path(uint64 key) const
+{
+	return format("%s/%016llx.cso", m_directory.c_str(), static_cast<unsigned long long>(key));
+}
+
+STATIC uint64 shader_cache::hash_source(const char* filename, const char* source, size_t source_size)
+{
+	uint64 hash = hash_fnv1a(filename, strlen(filename) + 1);
+	hash = hash_fnv1a(source, source_size, hash);
+	std::vector<string> visited;
+	_hash_includes(source, source_size, _get_directory(filename), 0, visited, hash);
+	return hash;
+}
+
+bool shader_cache::load(uint64 key, std::vector<byte>& out_bytecode) const
+{
+	std::vector<byte> bytes;
+	if (!_read_file(get_entry_path(key), bytes) || bytes.size() < sizeof(cache_entry_header)) {
+		return false;
+	}
+	cache_entry_header header;
+	memcpy(&header, bytes.data(), sizeof(header));
+	const byte* bytecode = bytes.data() + sizeof(header);
+	if (header.magic != CACHE_ENTRY_MAGIC || header.version != CACHE_ENTRY_VERSION || header.key != key
+		|| header.bytecode_size != bytes.size() - sizeof(header) || header.bytecode_hash != hash_fnv1a(bytecode, header.bytecode_size)) {
+		return false;
+	}
+	out_bytecode.assign(bytecode, bytecode + header.bytecode_size);
+	return true;
+}
+
+bool shader_cache::store(uint64 key, const std::vector<byte>& bytecode) const
+{
+	cache_entry_header header;
+	header.magic			= CACHE_ENTRY_MAGIC;
+	header.version			= CACHE_ENTRY_VERSION;
+	header.key				= key;
+	header.bytecode_size	= bytecode.size();
+	header.bytecode_hash	= hash_fnv1a(bytecode.data(), bytecode.size());
+
+	// a run stopped halfway leaves a temporary file, never a bad entry
+	const string path = get_entry_path(key);
+	const string temporary = path + ".tmp";
+	FILE* file = fopen(temporary.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1
+		&& fwrite(bytecode.data(), 1, bytecode.size(), file) == bytecode.size();
+	written = fclose(file) == 0 && written;
+	// rename() does not replace on windows, the old entry was unreadable anyway
+	std::remove(path.c_str());
+	if (!written || std::rename(temporary.c_str(), path.c_str()) != 0) {
+		std::remove(temporary.c_str());
+		return false;
+	}
+	return true;
+}
+}
@@ -0,0 +1,104 @@
+/// glare/render/shader_cache.h
+/// Compiled shader bytecode kept on disk between runs.
+///
+/// The key of a compilation hashes the file name, the source with every
+/// file it #includes (found relative to the including file, as
+/// D3D_COMPILE_STANDARD_FILE_INCLUDE does), the entry point, the shader
+/// model, the compile flags and the compiler build. A hit reads the stored
+/// bytecode back; a miss compiles and stores it. Editing a shader or any of
+/// its includes changes the key, so nothing has to be cleared by hand.
+/// Includes are found without preprocessing the source, so an include in an
+/// inactive #if block also counts; that only costs a needless compile.
+///
+/// Each entry is one file named by its key, written under a temporary name
+/// and renamed, with a header checked on load; an unreadable entry is a miss.
+/// Compilation goes through an i_shader_compiler: dx_shader_compiler, defined
+/// in shader.cpp with the rest of the D3D code, or stub_shader_compiler, so
+/// the cache builds and runs without D3D.
+
+#pragma once
+#include "glare/core/common.h"
+#include <vector>
+
+namespace glare
+{
+struct shader_compile_request
+{
+	const char*	filename		= "";		// #includes are relative to it
+	const char*	source			= nullptr;
+	size_t		source_size		= 0;
+	const char*	entry_point		= "";
+	const char*	shader_model	= "";		// vs_5_0, ps_5_0...
+	uint32		flags			= 0;		// D3DCOMPILE_*
+};
+
+class i_shader_compiler
+{
+public:
+	virtual ~i_shader_compiler() = default;
+	// Return: false when <request> does not compile, the errors are logged
+	virtual bool compile(const shader_compile_request& request, std::vector<byte>& out_bytecode) = 0;
+	// Part of every key, a different compiler build misses the entries of the old one
+	NODISCARD virtual uint64 get_compiler_id() const = 0;
+};
+
+class dx_shader_compiler final : public i_shader_compiler
+{
+public:
+	bool compile(const shader_compile_request& request, std::vector<byte>& out_bytecode) override;
+	NODISCARD uint64 get_compiler_id() const override;
+};
+
+// Bytecode made from the hash of the request, the same for the same request
+class stub_shader_compiler final : public i_shader_compiler
+{
+public:
+	static constexpr uint32 BYTECODE_SIZE = 2048;	// about a small real shader
+public:
+	bool compile(const shader_compile_request& request, std::vector<byte>& out_bytecode) override;
+	NODISCARD uint64 get_compiler_id() const override { return 1; }
+};
+
+struct shader_cache_stats
+{
+	uint32	hits			= 0;
+	uint32	misses			= 0;	// compiled, failed compilations included
+	uint32	failed			= 0;	// did not compile
+	uint32	write_failures	= 0;	// compiled but not stored
+	float64	key_ms			= 0.0;	// hashing the sources and includes
+	float64	load_ms			= 0.0;	// reading the hits
+	float64	compile_ms		= 0.0;
+};
+
+class shader_cache
+{
+public:
+	// Takes ownership of <compiler>. <directory> is created when missing;
+	// an empty one keeps nothing and compiles every request
+	shader_cache(i_shader_compiler* compiler, const string& directory);
+	~shader_cache();
+	shader_cache(const shader_cache&) = delete;
+	shader_cache& operator=(const shader_cache&) = delete;
+
+	// Return: false when the shader does not compile
+	bool get_bytecode(const shader_compile_request& request, std::vector<byte>& out_bytecode);
+
+	NODISCARD uint64 get_key(const shader_compile_request& request) const;
+	// Of the entry stored under <key>
+	NODISCARD string get_entry_path(uint64 key) const;
+	NODISCARD const string& get_directory() const { return m_directory; }
+	NODISCARD const shader_cache_stats& get_stats() const { return m_stats; }
+
+	// The file name, <source> and, depth first, every file it includes
+	NODISCARD static uint64 hash_source(const char* filename, const char* source, size_t source_size);
+
+private:
+	bool load(uint64 key, std::vector<byte>& out_bytecode) const;
+	bool store(uint64 key, const std::vector<byte>& bytecode) const;
+
+private:
+	i_shader_compiler*	m_compiler = nullptr;
+	string				m_directory;
+	shader_cache_stats	m_stats;
+};
+}
@@ -63,7 +63,12 @@ sprite_sheet::sprite_sheet(renderer* r, xml::document* xml_doc)
 	}
 	vec2 inv_texture_size(m_texture->get_size());
 	inv_texture_size = {1.f / inv_texture_size.u, 1.f / inv_texture_size.v};
-	auto sprites = root_node.children("sprite");
+	read_sprites_from_xml(root_node, inv_texture_size);
+}
+
+void sprite_sheet::read_sprites_from_xml(const xml::node& sprites_node, const vec2& inv_texture_size)
+{
+	auto sprites = sprites_node.children("sprite");
 	const size_t sprite_count = std::distance(std::begin(sprites), std::end(sprites));
 	m_sprites.resize(sprite_count);
 	for(auto& each : sprites) {
@@ -119,6 +119,8 @@ public:
 	}
 	//irregular layout constructor
 	sprite_sheet(renderer* r, xml::document* xml_doc);
+	// Fills m_sprites from the <sprite> children of <sprites_node>, uvs given in texels
+	void read_sprites_from_xml(const xml::node& sprites_node, const vec2& inv_texture_size);
 	//irregular layout getter
 	NODISCARD const sprite& get_sprite(size_t index) const
 	{
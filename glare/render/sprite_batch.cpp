@@ -0,0 +1,217 @@
+#include "glare/render/sprite_batch.h"
+#include "glare/render/renderer.h"
+#include "glare/render/shader.h"
+#include "glare/render/sprite.h"
+#include "glare/render/texture.h"
+#include "glare/core/assert.h"
+#include <algorithm>
+#include <functional>
+
+namespace glare
+{
+sprite_batch::sprite_batch(renderer* r)
+	: m_renderer(r)
+{
+}
+
+sprite_batch::~sprite_batch()
+{
+	delete m_gpu_vbo;
+	delete m_gpu_ibo;
+}
+
+void sprite_batch::begin(e_sprite_sort_mode sort_mode)
+{
+	ASSERT(!m_begun, "sprite_batch::begin() called twice without end()");
+	m_begun = true;
+	m_sort_mode = sort_mode;
+	m_submissions.clear();
+	m_groups.clear();
+	m_vertices.clear();
+	m_stats.sprites = 0;
+	m_stats.draw_calls = 0;
+}
+
+void sprite_batch::submit(const i_sprite_anim_base* sprite, const obb2& box, const rgba& tint)
+{
+	vec2 uvs[4];
+	sprite->get_current_frame_uvs(uvs);
+	submit(sprite->get_texture2d(), uvs, box, tint);
+}
+
+void sprite_batch::submit(const texture2d* texture, const vec2 uvs[4], const obb2& box, const rgba& tint)
+{
+	ASSERT(m_begun, "sprite_batch::submit() outside begin()/end()");
+	ASSERT(m_submissions.size() < MAX_SPRITES, "Too many sprites for 32 bit index offsets");
+	submission& added = m_submissions.emplace_back();
+	added.m_shader = m_shader;
+	added.m_texture = texture;
+	added.m_blend_mode = m_blend_mode;
+	added.m_tint = tint;
+	added.m_box = box;
+	added.m_uvs[0] = uvs[0];
+	added.m_uvs[1] = uvs[1];
+	added.m_uvs[2] = uvs[2];
+	added.m_uvs[3] = uvs[3];
+}
+
+void sprite_batch::end()
+{
+	ASSERT(m_begun, "sprite_batch::end() without begin()");
+	m_begun = false;
+
+	const size_t sprite_count = m_submissions.size();
+	m_order.resize(sprite_count);
+	for (size_t i = 0; i < sprite_count; ++i) {
+		m_order[i] = static_cast<uint32>(i);
+	}
+	if (m_sort_mode == SPRITE_SORT_STATE) {
+		const std::less<const void*> before;
+		std::stable_sort(m_order.begin(), m_order.end(), [&](uint32 lhs, uint32 rhs) {
+			const submission& a = m_submissions[lhs];
+			const submission& b = m_submissions[rhs];
+			if (a.m_shader != b.m_shader) {
+				return before(a.m_shader, b.m_shader);
+			}
+			if (a.m_blend_mode != b.m_blend_mode) {
+				return a.m_blend_mode < b.m_blend_mode;
+			}
+			return before(a.m_texture, b.m_texture);
+		});
+	}
+
+	m_vertices.resize(sprite_count * 4);
+	vertex_pcu* vertex = m_vertices.data();
+	vec2 corners[4];
+	for (size_t i = 0; i < sprite_count; ++i) {
+		const submission& each = m_submissions[m_order[i]];
+		group* last = m_groups.empty() ? nullptr : &m_groups.back();
+		if (last && last->m_shader == each.m_shader
+			&& last->m_blend_mode == each.m_blend_mode && last->m_texture == each.m_texture) {
+			last->m_index_count += 6;
+		} else {
+			group& added = m_groups.emplace_back();
+			added.m_shader = each.m_shader;
+			added.m_blend_mode = each.m_blend_mode;
+			added.m_texture = each.m_texture;
+			added.m_index_offset = static_cast<uint32>(i * 6);
+			added.m_index_count = 6;
+		}
+		each.m_box.get_corners(corners);
+		for (int32 k = 0; k < 4; ++k) {
+			vertex[k].position = corners[k]; // implicit convert
+			vertex[k].color = each.m_tint;
+			vertex[k].uv = each.m_uvs[k];
+		}
+		vertex += 4;
+	}
+	m_stats.sprites = static_cast<uint32>(sprite_count);
+	m_stats.draw_calls = static_cast<uint32>(m_groups.size());
+}
+
+void sprite_batch::flush()
+{
+	ASSERT(!m_begun, "sprite_batch::flush() before end()");
+	if (m_groups.empty()) {
+		return;
+	}
+	ASSERT(m_renderer, "sprite_batch created without renderer cannot flush");
+	upload();
+
+	const buffer_layout* layout = m_gpu_vbo->get_buffer_layout();
+	shader* const default_shader = m_renderer->m_current_shader;
+	shader* bound_shader = default_shader;
+	// the groups borrow the shaders, each gets its own blend mode back
+	shader* borrowed_shader = nullptr;
+	e_blend_mode shader_blend_mode = BLEND_ALPHA;
+	const texture2d* bound_texture = nullptr;
+	m_renderer->bind_vbo(m_gpu_vbo);
+	m_renderer->bind_ibo(m_gpu_ibo);
+	for (const group& each : m_groups) {
+		shader* group_shader = each.m_shader ? each.m_shader : default_shader;
+		ASSERT(group_shader, "sprite_batch group without a shader while no shader is bound");
+		if (group_shader != bound_shader) {
+			m_renderer->bind_shader(group_shader);
+			bound_shader = group_shader;
+		}
+		if (group_shader != borrowed_shader) {
+			if (borrowed_shader) {
+				borrowed_shader->set_blend_mode(shader_blend_mode);
+			}
+			borrowed_shader = group_shader;
+			shader_blend_mode = group_shader->m_blend_mode;
+		}
+		bound_shader->create_dx_vbo_layout(layout);
+		bound_shader->set_blend_mode(each.m_blend_mode);
+		// untextured sprites draw their tint
+		const texture2d* group_texture = each.m_texture ? each.m_texture : m_renderer->get_default_texture();
+		if (group_texture && group_texture != bound_texture) {
+			m_renderer->bind_texture(group_texture, TEXTURE_SLOT_DIFFUSE, m_filter);
+			bound_texture = group_texture;
+		}
+		m_renderer->draw_indexed(each.m_index_count, each.m_index_offset);
+	}
+	borrowed_shader->set_blend_mode(shader_blend_mode);
+}
+
+void sprite_batch::upload()
+{
+	const size_t sprite_count = m_submissions.size();
+	const size_t vertex_count = sprite_count * 4;
+	if (!m_gpu_vbo) {
+		m_gpu_vbo = new vertex_buffer(m_renderer);
+		m_gpu_vbo->set_buffer_layout(buffer_layout::acquire_layout_of<vertex_pcu>());
+		m_gpu_ibo = new index_buffer(m_renderer);
+	}
+
+	if (sprite_count > m_vertex_capacity) {
+		// create() copies the whole capacity, pad the array for it
+		m_vertex_capacity = std::min(std::max({sprite_count, m_vertex_capacity * 2, MIN_CAPACITY}), MAX_SPRITES);
+		m_vertices.resize(m_vertex_capacity * 4);
+		m_gpu_vbo->create(m_vertices.data(), m_vertices.size() * sizeof(vertex_pcu), sizeof(vertex_pcu)
+			, RENDER_BUFFER_VERTEX, GPU_MEMORY_DYNAMIC);
+		m_vertices.resize(vertex_count);
+		++m_stats.vertex_grows;
+	} else {
+		m_gpu_vbo->buffer(m_vertices.data(), vertex_count);
+	}
+
+	if (sprite_count > m_index_capacity) {
+		m_index_capacity = std::min(std::max({sprite_count, m_index_capacity * 2, MIN_CAPACITY}), MAX_SPRITES);
+		build_quad_indices(m_indices, m_index_capacity);
+		const e_index_type index_type = m_indices.get_index_type();
+		m_gpu_ibo->create(m_indices.data(), m_indices.get_size_in_bytes(), get_size_of_index_type(index_type)
+			, RENDER_BUFFER_INDEX, GPU_MEMORY_DYNAMIC);
+		m_gpu_ibo->set_index_type(index_type);
+		m_gpu_ibo->m_count = m_indices.size();
+		++m_stats.index_grows;
+	}
+}
+
+template<typename T>
+static void _build_quad_indices(T* out_indices, size_t sprite_count)
+{
+	for (size_t i = 0; i < sprite_count; ++i) {
+		const T base = static_cast<T>(i * 4);
+		T* quad = out_indices + i * 6;
+		quad[0] = base;
+		quad[1] = static_cast<T>(base + 2);
+		quad[2] = static_cast<T>(base + 1);
+		quad[3] = static_cast<T>(base + 1);
+		quad[4] = static_cast<T>(base + 2);
+		quad[5] = static_cast<T>(base + 3);
+	}
+}
+
+STATIC void sprite_batch::build_quad_indices(index_list& out_indices, size_t sprite_count)
+{
+	out_indices.clear();
+	out_indices.set_index_type(get_index_type_for_vertex_count(sprite_count * 4));
+	out_indices.resize(sprite_count * 6);
+	if (out_indices.get_index_type() == INDEX_UINT16) {
+		_build_quad_indices(out_indices.get_data16(), sprite_count);
+	} else {
+		_build_quad_indices(out_indices.get_data32(), sprite_count);
+	}
+}
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+/// glare/render/sprite_batch.h
+/// Draws many sprites with one draw_indexed per (shader, blend mode, texture) group.
+///
+/// begin() -> submit()... -> end() -> flush()
+/// end() sorts the submissions, writes the quads into a vertex array and
+/// builds the group list without touching the GPU, so the batching can be
+/// checked on a machine without a device.
+/// flush() uploads the vertices into one dynamic vertex_buffer, grown by
+/// doubling and never shrunk, and issues the draws. Quads share a constant
+/// index pattern, the index_buffer is only rebuilt when it grows.
+///
+/// SPRITE_SORT_STATE reorders sprites of different groups, so overlapping
+/// alpha blended sprites should use SPRITE_SORT_SUBMISSION, which only
+/// merges neighbouring submissions.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include "glare/math/obb2.h"
+#include "glare/render/common.h"
+#include "glare/render/buffer.h"
+#include "glare/render/vertex.h"
+#include "glare/render/index_list.h"
+#include <vector>
+
+namespace glare
+{
+class renderer;
+class shader;
+class texture2d;
+class i_sprite_anim_base;
+
+enum e_sprite_sort_mode : uint8
+{
+	SPRITE_SORT_STATE,		// group by shader, blend mode then texture, keeps order inside a group
+	SPRITE_SORT_SUBMISSION,	// keep submission order, merge consecutive sprites sharing a state
+};
+
+struct sprite_batch_stats
+{
+	uint32 sprites		= 0;
+	uint32 draw_calls	= 0;	// groups built by end(), one draw_indexed each
+	uint32 vertex_grows	= 0;	// vertex buffer re-creations, since construction
+	uint32 index_grows	= 0;	// index buffer re-creations, since construction
+};
+
+class sprite_batch
+{
+public:
+	static constexpr size_t MIN_CAPACITY = 256;	// sprites
+	// 6 indices a sprite, group::m_index_offset and D3D index counts are 32 bit.
+	// The vertices, 4 a sprite, stay under 32 bit indices then too
+	static constexpr size_t MAX_SPRITES = UINT32_MAX / 6;
+	static_assert(static_cast<uint64>(MAX_SPRITES) * 6 <= UINT32_MAX, "sprite_batch::MAX_SPRITES overflows 32 bit index offsets");
+
+	struct group
+	{
+		shader*				m_shader = nullptr;		// nullptr: the shader bound at flush()
+		e_blend_mode		m_blend_mode = BLEND_ALPHA;
+		const texture2d*	m_texture = nullptr;
+		uint32				m_index_offset = 0;
+		uint32				m_index_count = 0;
+	};
+public:
+	// <r> may be nullptr as long as flush() is never called
+	explicit sprite_batch(renderer* r);
+	~sprite_batch();
+	sprite_batch(const sprite_batch&) = delete;
+	sprite_batch& operator=(const sprite_batch&) = delete;
+
+	void begin(e_sprite_sort_mode sort_mode = SPRITE_SORT_STATE);
+	// State of the following submissions
+	void set_shader(shader* s)						{ m_shader = s; }
+	void set_blend_mode(e_blend_mode blend_mode)	{ m_blend_mode = blend_mode; }
+	void set_texture_filter(e_texture_filter filter) { m_filter = filter; }
+
+	// Samples the current frame of <sprite>
+	void submit(const i_sprite_anim_base* sprite, const obb2& box, const rgba& tint = color::WHITE);
+	// <uvs> in "Z" order like mesh_builder: tl, tr, bl, br
+	void submit(const texture2d* texture, const vec2 uvs[4], const obb2& box, const rgba& tint = color::WHITE);
+	// Builds vertices and groups, no GPU access
+	void end();
+	// Uploads and draws what end() built
+	void flush();
+
+	NODISCARD const std::vector<group>&			get_groups() const		{ return m_groups; }
+	NODISCARD const std::vector<vertex_pcu>&	get_vertices() const	{ return m_vertices; }
+	NODISCARD const sprite_batch_stats&			get_stats() const		{ return m_stats; }
+	// Index pattern for <sprite_count> quads: 4i + {0, 2, 1, 1, 2, 3}
+	// 16 bit up to 16384 sprites, 32 bit above
+	static void build_quad_indices(index_list& out_indices, size_t sprite_count);
+
+private:
+	struct submission
+	{
+		shader*				m_shader;
+		const texture2d*	m_texture;
+		e_blend_mode		m_blend_mode;
+		rgba				m_tint;
+		obb2				m_box;
+		vec2				m_uvs[4];
+	};
+
+	void upload();
+
+private:
+	renderer*				m_renderer = nullptr;
+	vertex_buffer*			m_gpu_vbo = nullptr;
+	index_buffer*			m_gpu_ibo = nullptr;
+	size_t					m_vertex_capacity = 0;	// sprites
+	size_t					m_index_capacity = 0;	// sprites
+
+	shader*					m_shader = nullptr;
+	e_blend_mode			m_blend_mode = BLEND_ALPHA;
+	e_texture_filter		m_filter = MIN_POINT_MAG_POINT;
+	e_sprite_sort_mode		m_sort_mode = SPRITE_SORT_STATE;
+	bool					m_begun = false;
+
+	std::vector<submission>	m_submissions;
+	std::vector<uint32>		m_order;
+	std::vector<vertex_pcu>	m_vertices;
+	index_list				m_indices;
+	std::vector<group>		m_groups;
+	sprite_batch_stats		m_stats;
+};
+}
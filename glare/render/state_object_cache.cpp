@@ -0,0 +1,186 @@
+#include "glare/render/state_object_cache.h"
+#include "glare/render/renderer.h"
+#include "glare/core/assert.h"
+
+namespace glare
+{
+template<typename T, typename CREATE_FN>
+static T* _acquire(std::unordered_map<uint32, T*>& states, uint32 key, state_object_cache_stats& stats, CREATE_FN create)
+{
+	const auto found = states.find(key);
+	if (found != states.end()) {
+		++stats.reused;
+		found->second->AddRef();
+		return found->second;
+	}
+	T* created = create();
+	++stats.created;
+	states.emplace(key, created);
+	created->AddRef(); // one for the cache, one for the caller
+	return created;
+}
+
+template<typename T>
+static void _trim(std::unordered_map<uint32, T*>& states)
+{
+	for (auto it = states.begin(); it != states.end();) {
+		T* state = it->second;
+		state->AddRef();
+		if (state->Release() == 1) {
+			DX_RELEASE(state);
+			it = states.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+template<typename T>
+static void _release_all(std::unordered_map<uint32, T*>& states)
+{
+	for (auto& each : states) {
+		DX_RELEASE(each.second);
+	}
+	states.clear();
+}
+
+state_object_cache::state_object_cache(renderer* r)
+	: m_renderer(r)
+{
+}
+
+state_object_cache::~state_object_cache()
+{
+	_release_all(m_blend_states);
+	_release_all(m_depth_stencil_states);
+	_release_all(m_rasterizer_states);
+}
+
+dx_state_blend* state_object_cache::acquire_blend_state(e_blend_mode blend_mode)
+{
+	return _acquire(m_blend_states, make_blend_key(blend_mode), m_stats, [&]() {
+		D3D11_BLEND_DESC desc;
+		memset(&desc, 0, sizeof(desc));
+		desc.AlphaToCoverageEnable = false;
+		desc.IndependentBlendEnable = false;
+		desc.RenderTarget[0].BlendEnable = true;
+		if (blend_mode == BLEND_ALPHA) {
+			desc.RenderTarget[0].SrcBlend = D3D11_BLEND_SRC_ALPHA;
+			desc.RenderTarget[0].DestBlend = D3D11_BLEND_INV_SRC_ALPHA;
+			desc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+			desc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_SRC_ALPHA;
+			desc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+			desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		} else if (blend_mode == BLEND_OPAQUE) {
+			desc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+			desc.RenderTarget[0].DestBlend = D3D11_BLEND_ZERO;
+			desc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+			desc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+			desc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+			desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		} else if (blend_mode == BLEND_ADDITIVE) {
+			desc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+			desc.RenderTarget[0].DestBlend = D3D11_BLEND_ONE;
+			desc.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+			desc.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+			desc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ONE;
+			desc.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+		}
+		desc.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+		dx_state_blend* state = nullptr;
+		HRESULT hr =
+			m_renderer->get_dx_device()
+				->CreateBlendState(&desc, &state);
+		if (FAILED(hr)) {
+			FATAL("Creating blend state failed");
+		}
+		return state;
+	});
+}
+
+dx_state_depth_stencil* state_object_cache::acquire_depth_stencil_state(e_compare_operator pass_op, bool write)
+{
+	return _acquire(m_depth_stencil_states, make_depth_stencil_key(pass_op, write), m_stats, [&]() {
+		D3D11_DEPTH_STENCIL_DESC ds_desc;
+		memset(&ds_desc, 0, sizeof(ds_desc));
+		ds_desc.DepthEnable = TRUE;
+		ds_desc.DepthWriteMask	=
+			write ?
+			D3D11_DEPTH_WRITE_MASK_ALL :
+			D3D11_DEPTH_WRITE_MASK_ZERO;
+		ds_desc.DepthFunc		= static_cast<D3D11_COMPARISON_FUNC>(pass_op);
+		ds_desc.StencilEnable	= FALSE;
+		ds_desc.StencilReadMask	= 0xff;
+		ds_desc.StencilWriteMask	= 0xff;
+		D3D11_DEPTH_STENCILOP_DESC ds_op; {
+			memset(&ds_op, 0, sizeof(ds_op));
+			ds_op.StencilFailOp			= D3D11_STENCIL_OP_KEEP;
+			ds_op.StencilDepthFailOp	= D3D11_STENCIL_OP_KEEP;
+			ds_op.StencilPassOp			= D3D11_STENCIL_OP_KEEP;
+			ds_op.StencilFunc			= D3D11_COMPARISON_ALWAYS;
+		}
+		ds_desc.FrontFace	= ds_op;
+		ds_desc.BackFace	= ds_op;
+
+		dx_state_depth_stencil* state = nullptr;
+		HRESULT hr =
+			m_renderer->get_dx_device()
+				->CreateDepthStencilState(&ds_desc, &state);
+		if (FAILED(hr)) {
+			FATAL("Creating depth stencil state failed");
+		}
+		return state;
+	});
+}
+
+dx_state_rasterizer* state_object_cache::acquire_rasterizer_state(e_cull_mode cull_mode, e_fill_mode fill_mode, bool front_face_ccw, bool depth_clip)
+{
+	return _acquire(m_rasterizer_states, make_rasterizer_key(cull_mode, fill_mode, front_face_ccw, depth_clip), m_stats, [&]() {
+		D3D11_RASTERIZER_DESC rs_desc;
+		memset(&rs_desc, 0, sizeof(rs_desc));
+		rs_desc.CullMode		= static_cast<D3D11_CULL_MODE>(cull_mode);
+		rs_desc.FillMode		= static_cast<D3D11_FILL_MODE>(fill_mode);
+		rs_desc.DepthBias		= 0;
+		rs_desc.AntialiasedLineEnable = FALSE;
+		rs_desc.FrontCounterClockwise = static_cast<BOOL>(front_face_ccw);
+		rs_desc.DepthClipEnable	= static_cast<BOOL>(depth_clip);
+
+		dx_state_rasterizer* state = nullptr;
+		HRESULT hr =
+			m_renderer->get_dx_device()
+				->CreateRasterizerState(&rs_desc, &state);
+		if (FAILED(hr)) {
+			FATAL("Creating rastrerizer state failed");
+		}
+		return state;
+	});
+}
+
+void state_object_cache::trim()
+{
+	_trim(m_blend_states);
+	_trim(m_depth_stencil_states);
+	_trim(m_rasterizer_states);
+}
+
+STATIC uint32 state_object_cache::make_blend_key(e_blend_mode blend_mode)
+{
+	return static_cast<uint32>(blend_mode);
+}
+
+STATIC uint32 state_object_cache::make_depth_stencil_key(e_compare_operator pass_op, bool write)
+{
+	// D3D11_COMPARISON_FUNC fits 4 bits
+	return static_cast<uint32>(pass_op) | (static_cast<uint32>(write) << 4);
+}
+
+STATIC uint32 state_object_cache::make_rasterizer_key(e_cull_mode cull_mode, e_fill_mode fill_mode, bool front_face_ccw, bool depth_clip)
+{
+	// D3D11_CULL_MODE and D3D11_FILL_MODE fit 2 bits each
+	return static_cast<uint32>(cull_mode)
+		| (static_cast<uint32>(fill_mode) << 2)
+		| (static_cast<uint32>(front_face_ccw) << 4)
+		| (static_cast<uint32>(depth_clip) << 5);
+}
+}
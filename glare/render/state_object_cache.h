@@ -0,0 +1,53 @@
+/// glare/render/state_object_cache.h
+/// Blend, depth-stencil and rasterizer state objects shared by all shaders.
+///
+/// Each state is found by a key packing the shader modes it is made from,
+/// and created on first request only. acquire_*() returns a new reference,
+/// which the caller releases with DX_RELEASE like any owned dx object, so
+/// switching a shader between modes at runtime is a lookup, not a creation.
+/// The cache keeps its own reference until trim() or destruction.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/common.h"
+#include <unordered_map>
+
+namespace glare
+{
+class renderer;
+
+struct state_object_cache_stats
+{
+	uint32 created	= 0;	// dx objects created
+	uint32 reused	= 0;	// requests served from the cache
+};
+
+class state_object_cache
+{
+public:
+	explicit state_object_cache(renderer* r);
+	~state_object_cache();
+	state_object_cache(const state_object_cache&) = delete;
+	state_object_cache& operator=(const state_object_cache&) = delete;
+
+	NODISCARD dx_state_blend*			acquire_blend_state(e_blend_mode blend_mode);
+	NODISCARD dx_state_depth_stencil*	acquire_depth_stencil_state(e_compare_operator pass_op, bool write);
+	NODISCARD dx_state_rasterizer*		acquire_rasterizer_state(e_cull_mode cull_mode, e_fill_mode fill_mode, bool front_face_ccw, bool depth_clip);
+	// Releases the states no one else references
+	void trim();
+
+	NODISCARD static uint32 make_blend_key(e_blend_mode blend_mode);
+	NODISCARD static uint32 make_depth_stencil_key(e_compare_operator pass_op, bool write);
+	NODISCARD static uint32 make_rasterizer_key(e_cull_mode cull_mode, e_fill_mode fill_mode, bool front_face_ccw, bool depth_clip);
+
+	NODISCARD size_t get_state_count() const { return m_blend_states.size() + m_depth_stencil_states.size() + m_rasterizer_states.size(); }
+	NODISCARD const state_object_cache_stats& get_stats() const { return m_stats; }
+
+private:
+	renderer*	m_renderer = nullptr;
+	std::unordered_map<uint32, dx_state_blend*>			m_blend_states;
+	std::unordered_map<uint32, dx_state_depth_stencil*>	m_depth_stencil_states;
+	std::unordered_map<uint32, dx_state_rasterizer*>	m_rasterizer_states;
+	state_object_cache_stats	m_stats;
+};
+}
@@ -1,4 +1,8 @@
 #include "glare/render/surface.h"
+#include "glare/render/surface_ops.h"
+#include "glare/render/vertex_format.h"
+#include <cstdlib>
+#include <cstring>
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb/stb_image.h"
 #define STB_IMAGE_WRITE_IMPLEMENTATION
@@ -17,21 +21,15 @@ surface* surface::load_image(const string& id, const char* path, bool flip_v)
 }
 
 surface::surface(const char* path, bool flip_v)
+	: m_storage(SURFACE_STORAGE_RGBA8)
 {
-	::stbi_set_flip_vertically_on_load(flip_v ? 1 : 0);
+	// per thread, texture_loader decodes on several at once
+	::stbi_set_flip_vertically_on_load_thread(flip_v ? 1 : 0);
 	int num_channels;
-	m_raw = stbi_load(path, &m_size.x, &m_size.y, &num_channels, 0);
-	m_raw_channels = static_cast<uint8>(num_channels);
-	const size_t num_texels = static_cast<size_t>(m_size.x) * static_cast<size_t>(m_size.y);
-	m_surface_data.reserve(num_texels);
-	for (size_t texel_idx = 0; texel_idx < num_texels; ++texel_idx) {
-		const size_t offset = texel_idx * m_raw_channels;
-		byte* const raw_color = m_raw + offset;
-		rgba8 texel8(raw_color[0], raw_color[1], raw_color[2]);
-		if (m_raw_channels == 4) {
-			texel8.a = m_raw[offset + 3];
-		}
-		m_surface_data.emplace_back(rgba(texel8));
+	// rgb images get an opaque alpha
+	m_raw = stbi_load(path, &m_size.x, &m_size.y, &num_channels, 4);
+	if (!m_raw) {
+		m_size = ivec2(0, 0);
 	}
 	m_path = path;
 }
@@ -49,66 +47,148 @@ surface::surface(size_t w, size_t h, const rgba* texel_data)
 	memcpy(m_surface_data.data(), texel_data, w * h * sizeof(rgba));
 }
 
-surface::~surface()
+surface::surface(size_t w, size_t h, const rgba8& default_color)
+	: m_size(static_cast<int32>(w), static_cast<int32>(h))
+	, m_storage(SURFACE_STORAGE_RGBA8)
 {
-	if (!m_path.empty() && m_raw) {
-		::stbi_image_free(m_raw);
-	} else {
-		delete[] m_raw;
+	m_raw = static_cast<byte*>(malloc(w * h * sizeof(rgba8)));
+	rgba8* texels = reinterpret_cast<rgba8*>(m_raw);
+	for (size_t i = 0; i < w * h; ++i) {
+		texels[i] = default_color;
 	}
 }
 
+surface::~surface()
+{
+	free(m_raw);
+}
+
 const rgba surface::get_texel(const ivec2& texel_coord) const
 {
 	const size_t texel_index = static_cast<size_t>(texel_coord.v) * m_size.u + texel_coord.u;
+	if (m_storage == SURFACE_STORAGE_RGBA8) {
+		return rgba(reinterpret_cast<const rgba8*>(m_raw)[texel_index]);
+	}
 	return m_surface_data[texel_index];
 }
 
 void surface::set_texel(const ivec2& texel_coord, const rgba& color)
 {
 	const size_t texel_index = static_cast<size_t>(texel_coord.v) * m_size.u + texel_coord.u;
-	m_surface_data[texel_index] = color;
-	if (m_raw) {
-		const rgba8 color8(color);
-		const size_t offset = texel_index * m_raw_channels * sizeof(byte);
-		byte* const raw_color = m_raw + offset;
-		raw_color[0] = color8.r;
-		raw_color[1] = color8.g;
-		raw_color[2] = color8.b;
-		if (m_raw_channels == 4) {
-			raw_color[3] = color8.a;
-		}
+	release_cache();
+	if (m_storage == SURFACE_STORAGE_RGBA8) {
+		reinterpret_cast<rgba8*>(m_raw)[texel_index] = vertex_packing::pack_unorm8x4(color);
+	} else {
+		m_surface_data[texel_index] = color;
 	}
 }
 
 rgba* surface::get_surface_buffer()
 {
+	set_storage(SURFACE_STORAGE_FLOAT);
+	release_cache();
 	return m_surface_data.data();
 }
 
 const rgba* surface::get_surface_buffer() const
 {
+	convert_to_float();
 	return m_surface_data.data();
 }
 
-void surface::write_png(const char* path) const
+rgba8* surface::get_rgba8_buffer()
 {
-	if (!m_raw) {
-		const size_t num_texel = static_cast<size_t>(m_size.u) * m_size.v;
-		m_raw = new byte[num_texel * m_raw_channels];
-		for (size_t texel_idx = 0; texel_idx < num_texel; ++texel_idx) {
-			const rgba8 color8(m_surface_data[texel_idx]);
-			const size_t offset = m_raw_channels * texel_idx * sizeof(byte);
-			byte* const raw_color = m_raw + offset;
-			raw_color[0] = color8.r;
-			raw_color[1] = color8.g;
-			raw_color[2] = color8.b;
-			if (m_raw_channels == 4) {
-				raw_color[3] = color8.a;
-			}
+	set_storage(SURFACE_STORAGE_RGBA8);
+	release_cache();
+	return reinterpret_cast<rgba8*>(m_raw);
+}
+
+const rgba8* surface::get_rgba8_buffer() const
+{
+	convert_to_rgba8();
+	return reinterpret_cast<const rgba8*>(m_raw);
+}
+
+void surface::set_storage(e_surface_storage storage)
+{
+	if (storage == m_storage) {
+		return;
+	}
+	if (storage == SURFACE_STORAGE_FLOAT) {
+		convert_to_float();
+	} else {
+		convert_to_rgba8();
+	}
+	m_storage = storage;
+	release_cache();
+}
+
+void surface::release_cache() const
+{
+	if (m_storage == SURFACE_STORAGE_RGBA8) {
+		if (!m_surface_data.empty()) {
+			std::vector<rgba>().swap(m_surface_data);
 		}
+	} else if (m_raw) {
+		free(m_raw);
+		m_raw = nullptr;
+	}
+}
+
+size_t surface::get_memory_usage() const
+{
+	size_t result = m_surface_data.capacity() * sizeof(rgba);
+	if (m_raw) {
+		result += get_texel_count() * sizeof(rgba8);
+	}
+	for (const mip_level& each : m_mips) {
+		result += each.texels.capacity() * sizeof(rgba);
+	}
+	return result;
+}
+
+void surface::convert_to_float() const
+{
+	const size_t num_texels = get_texel_count();
+	if (m_storage == SURFACE_STORAGE_FLOAT || m_surface_data.size() == num_texels) {
+		return;
+	}
+	m_surface_data.resize(num_texels);
+	surface_ops::convert_rgba8_to_float(m_surface_data.data(), reinterpret_cast<const rgba8*>(m_raw), num_texels);
+}
+
+void surface::convert_to_rgba8() const
+{
+	if (m_storage == SURFACE_STORAGE_RGBA8 || m_raw) {
+		return;
+	}
+	const size_t num_texels = get_texel_count();
+	m_raw = static_cast<byte*>(malloc(num_texels * sizeof(rgba8)));
+	surface_ops::convert_float_to_rgba8(reinterpret_cast<rgba8*>(m_raw), m_surface_data.data(), num_texels);
+}
+
+void surface::write_png(const char* path) const
+{
+	const rgba8* texels = get_rgba8_buffer();
+	::stbi_write_png(path, m_size.u, m_size.v, 4, texels, static_cast<int>(sizeof(rgba8) * m_size.x));
+}
+
+mip_chain_options surface::get_default_mip_options() const
+{
+	mip_chain_options options;
+	options.srgb = m_storage == SURFACE_STORAGE_RGBA8;
+	return options;
+}
+
+void surface::generate_mips(const mip_chain_options& options)
+{
+	// rgba8 storage is converted for the filter only
+	const bool had_float = m_storage == SURFACE_STORAGE_FLOAT || !m_surface_data.empty();
+	m_mips.clear();
+	generate_mip_chain(static_cast<const surface*>(this)->get_surface_buffer(), m_size, options, m_mips);
+	if (!had_float) {
+		release_cache();
 	}
-	::stbi_write_png(path, m_size.u, m_size.v, 4, m_raw, static_cast<int>(m_raw_channels * m_size.x));
 }
 
 STATIC std::unordered_map<string, surface*> surface::s_cached;
@@ -1,34 +1,84 @@
+/// glare/render/surface.h
+/// CPU image, level 0 texels plus an optional mip chain.
+///
+/// The texels live in one storage: rgba8 for decoded image files (4 bytes a
+/// texel) or float rgba for surfaces created from colors (16 bytes a texel).
+/// Reading the other format through a const accessor converts the whole image
+/// once with surface_ops and keeps it as a cache until the next write or
+/// release_cache(); the non const accessor of the other format moves the
+/// storage instead, as the caller may write through it.
+
 #pragma once
 #include "glare/core/common.h"
 #include "glare/core/color.h"
 #include "glare/math/vector.h"
+#include "glare/render/mip_chain.h"
 #include <vector>
 #include <unordered_map>
 
 namespace glare
 {
+enum e_surface_storage : uint8
+{
+	SURFACE_STORAGE_RGBA8,
+	SURFACE_STORAGE_FLOAT,
+};
+
 class surface
 {
 public:
 	static surface* load_image(const string& id, const char* path, bool flip_v=false);
 	surface() = default;
+	// rgba8 storage, m_size is 0 when the file does not decode
 	surface(const char* path, bool flip_v=false);
+	// float storage
 	surface(size_t w, size_t h, const rgba& default_color=color::WHITE);
 	surface(size_t w, size_t h, const rgba* texel_data);
+	// rgba8 storage
+	surface(size_t w, size_t h, const rgba8& default_color);
 	~surface();
+	surface(const surface&) = delete;
+	surface& operator=(const surface&) = delete;
+
 	NODISCARD const rgba get_texel(const ivec2& texel_coord) const;
 	void set_texel(const ivec2& texel_coord, const rgba& color);
 	NODISCARD rgba* get_surface_buffer();
 	NODISCARD const rgba* get_surface_buffer() const;
+	NODISCARD rgba8* get_rgba8_buffer();
+	NODISCARD const rgba8* get_rgba8_buffer() const;
+
+	NODISCARD e_surface_storage get_storage() const { return m_storage; }
+	// Converts the texels, the old storage is freed
+	void set_storage(e_surface_storage storage);
+	// Frees the converted copy made by a const accessor
+	void release_cache() const;
+	// Level 0 storage, its cache and the mips
+	NODISCARD size_t get_memory_usage() const;
+	NODISCARD size_t get_texel_count() const { return static_cast<size_t>(m_size.x) * static_cast<size_t>(m_size.y); }
 
 	void write_png(const char* path) const;
+
+	// Replaces m_mips with the chain below level 0
+	void generate_mips(const mip_chain_options& options);
+	void generate_mips() { generate_mips(get_default_mip_options()); }
+	// sRGB filtering for rgba8 storage, as 8 bit image files are encoded, linear for float storage
+	NODISCARD mip_chain_options get_default_mip_options() const;
+	// Level 0 included
+	NODISCARD size_t get_mip_count() const { return m_mips.size() + 1; }
 public:
 	string	m_path;
 	ivec2	m_size;
-	std::vector<rgba>	m_surface_data;
-	mutable byte*		m_raw = nullptr;
-	uint8	m_raw_channels = 4;
+	std::vector<mip_level>	m_mips;	// level 1 and below, from generate_mips()
 public:
 	static std::unordered_map<string, surface*> s_cached;
+
+private:
+	void convert_to_float() const;
+	void convert_to_rgba8() const;
+
+private:
+	e_surface_storage			m_storage = SURFACE_STORAGE_FLOAT;
+	mutable std::vector<rgba>	m_surface_data;		// float storage or the cache of rgba8 storage
+	mutable byte*				m_raw = nullptr;	// rgba8 storage or the cache of float storage, malloc'd like stb_image buffers
 };
 }
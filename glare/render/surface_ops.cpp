@@ -0,0 +1,710 @@
+#include "glare/render/surface_ops.h"
+#include "glare/render/surface.h"
+#include "glare/render/vertex_format.h"
+#include "glare/core/assert.h"
+#include "glare/core/job.h"
+#include "glare/math/simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+namespace glare
+{
+namespace surface_ops
+{
+// texels per job, the kernels are memory bound and smaller chunks only add overhead
+static constexpr size_t PARALLEL_TEXELS = 1u << 16;
+static constexpr float64 LANCZOS_RADIUS = 3.0;
+
+// Level 0 of a surface in its own storage, one of the two pointers is set
+struct texel_source
+{
+	const rgba*		floats = nullptr;
+	const rgba8*	bytes = nullptr;
+	size_t			width = 0;
+};
+
+struct texel_target
+{
+	rgba*	floats = nullptr;
+	rgba8*	bytes = nullptr;
+	size_t	width = 0;
+};
+
+// Source texels of every destination texel along one axis, contiguous and clamped to the image
+struct resize_taps
+{
+	size_t					taps_per_texel = 0;
+	std::vector<int32>		first;
+	std::vector<float32>	weights;	// zero padded to taps_per_texel
+};
+
+static void _rgba8_to_float(rgba* dst, const rgba8* src, size_t count)
+{
+	const byte* from = reinterpret_cast<const byte*>(src);
+	float32* to = reinterpret_cast<float32*>(dst);
+	size_t i = 0;
+	// division, not a multiply by 1/255, to match rgba(rgba8)
+#if defined(GLARE_SIMD_AVX2)
+	const __m256 scale8 = _mm256_set1_ps(255.f);
+	for (; i + 2 <= count; i += 2) {
+		const __m256i bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(from + i * 4)));
+		_mm256_storeu_ps(to + i * 4, _mm256_div_ps(_mm256_cvtepi32_ps(bytes), scale8));
+	}
+#elif defined(GLARE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps(255.f);
+	for (; i + 4 <= count; i += 4) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i * 4));
+		const __m128i words_01 = _mm_unpacklo_epi8(bytes, zero);
+		const __m128i words_23 = _mm_unpackhi_epi8(bytes, zero);
+		float32* out = to + i * 4;
+		_mm_storeu_ps(out, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words_01, zero)), scale));
+		_mm_storeu_ps(out + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words_01, zero)), scale));
+		_mm_storeu_ps(out + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words_23, zero)), scale));
+		_mm_storeu_ps(out + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(words_23, zero)), scale));
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = rgba(src[i]);
+	}
+}
+
+static void _float_to_rgba8(rgba8* dst, const rgba* src, size_t count)
+{
+	const float32* from = reinterpret_cast<const float32*>(src);
+	byte* to = reinterpret_cast<byte*>(dst);
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	const __m256 zero8 = _mm256_setzero_ps();
+	const __m256 one8 = _mm256_set1_ps(1.f);
+	const __m256 scale8 = _mm256_set1_ps(255.f);
+	// the packs work per 128 bit lane: texels 0 2 4 6 | 1 3 5 7
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	for (; i + 8 <= count; i += 8) {
+		__m256i pairs[4];
+		for (size_t k = 0; k < 4; ++k) {
+			const __m256 value = _mm256_loadu_ps(from + (i + k * 2) * 4);
+			pairs[k] = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(value, zero8), one8), scale8));
+		}
+		const __m256i packed = _mm256_packus_epi16(
+			_mm256_packs_epi32(pairs[0], pairs[1]), _mm256_packs_epi32(pairs[2], pairs[3]));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(to + i * 4), _mm256_permutevar8x32_epi32(packed, order));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 scale = _mm_set1_ps(255.f);
+	for (; i + 4 <= count; i += 4) {
+		__m128i channels[4];
+		for (size_t k = 0; k < 4; ++k) {
+			const __m128 value = _mm_loadu_ps(from + (i + k) * 4);
+			channels[k] = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), scale));
+		}
+		const __m128i packed = _mm_packus_epi16(
+			_mm_packs_epi32(channels[0], channels[1]), _mm_packs_epi32(channels[2], channels[3]));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(to + i * 4), packed);
+	}
+#endif
+	for (; i < count; ++i) {
+		dst[i] = vertex_packing::pack_unorm8x4(src[i]);
+	}
+}
+
+// dst = src * src.a + dst * (1 - src.a) on all four channels
+static void _blend_alpha(rgba* dst, const rgba* src, size_t count)
+{
+	const float32* from = reinterpret_cast<const float32*>(src);
+	float32* to = reinterpret_cast<float32*>(dst);
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	const __m256 one8 = _mm256_set1_ps(1.f);
+	for (; i + 2 <= count; i += 2) {
+		const __m256 color = _mm256_loadu_ps(from + i * 4);
+		const __m256 alpha = _mm256_permute_ps(color, _MM_SHUFFLE(3, 3, 3, 3));
+		const __m256 under = _mm256_loadu_ps(to + i * 4);
+		_mm256_storeu_ps(to + i * 4, _mm256_add_ps(_mm256_mul_ps(color, alpha), _mm256_mul_ps(under, _mm256_sub_ps(one8, alpha))));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 one = _mm_set1_ps(1.f);
+	for (; i < count; ++i) {
+		const __m128 color = _mm_loadu_ps(from + i * 4);
+		const __m128 alpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+		const __m128 under = _mm_loadu_ps(to + i * 4);
+		_mm_storeu_ps(to + i * 4, _mm_add_ps(_mm_mul_ps(color, alpha), _mm_mul_ps(under, _mm_sub_ps(one, alpha))));
+	}
+#endif
+	for (; i < count; ++i) {
+		const rgba& color = src[i];
+		rgba& under = dst[i];
+		const float32 inv_alpha = 1.f - color.a;
+		under.r = color.r * color.a + under.r * inv_alpha;
+		under.g = color.g * color.a + under.g * inv_alpha;
+		under.b = color.b * color.a + under.b * inv_alpha;
+		under.a = color.a * color.a + under.a * inv_alpha;
+	}
+}
+
+// round(c * a / 255) without a division, exact over [0, 255]
+static byte _mul_unorm8(uint32 c, uint32 a)
+{
+	const uint32 t = c * a + 128;
+	return static_cast<byte>((t + (t >> 8)) >> 8);
+}
+
+#if defined(GLARE_SIMD_SSE2)
+// Two texels widened to 16 bit words
+static __m128i _premultiply_words(__m128i words)
+{
+	const __m128i rgb_mask = _mm_set1_epi64x(0x0000FFFFFFFFFFFFll);
+	const __m128i alpha_max = _mm_set1_epi64x(0x00FF000000000000ll);
+	const __m128i alpha = _mm_shufflehi_epi16(_mm_shufflelo_epi16(words, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	const __m128i factor = _mm_or_si128(_mm_and_si128(alpha, rgb_mask), alpha_max);
+	const __m128i t = _mm_add_epi16(_mm_mullo_epi16(words, factor), _mm_set1_epi16(128));
+	return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+#endif
+#if defined(GLARE_SIMD_AVX2)
+static __m256i _premultiply_words8(__m256i words)
+{
+	const __m256i rgb_mask = _mm256_set1_epi64x(0x0000FFFFFFFFFFFFll);
+	const __m256i alpha_max = _mm256_set1_epi64x(0x00FF000000000000ll);
+	const __m256i alpha = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(words, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	const __m256i factor = _mm256_or_si256(_mm256_and_si256(alpha, rgb_mask), alpha_max);
+	const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(words, factor), _mm256_set1_epi16(128));
+	return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+#endif
+
+static void _premultiply_rgba8(rgba8* texels, size_t count)
+{
+	byte* data = reinterpret_cast<byte*>(texels);
+	size_t i = 0;
+	// the unpacks and the pack are per 128 bit lane and undo each other, so the texel order holds
+#if defined(GLARE_SIMD_AVX2)
+	const __m256i zero8 = _mm256_setzero_si256();
+	for (; i + 8 <= count; i += 8) {
+		__m256i* at = reinterpret_cast<__m256i*>(data + i * 4);
+		const __m256i bytes = _mm256_loadu_si256(at);
+		_mm256_storeu_si256(at, _mm256_packus_epi16(
+			_premultiply_words8(_mm256_unpacklo_epi8(bytes, zero8)), _premultiply_words8(_mm256_unpackhi_epi8(bytes, zero8))));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= count; i += 4) {
+		__m128i* at = reinterpret_cast<__m128i*>(data + i * 4);
+		const __m128i bytes = _mm_loadu_si128(at);
+		_mm_storeu_si128(at, _mm_packus_epi16(
+			_premultiply_words(_mm_unpacklo_epi8(bytes, zero)), _premultiply_words(_mm_unpackhi_epi8(bytes, zero))));
+	}
+#endif
+	for (; i < count; ++i) {
+		rgba8& texel = texels[i];
+		texel.r = _mul_unorm8(texel.r, texel.a);
+		texel.g = _mul_unorm8(texel.g, texel.a);
+		texel.b = _mul_unorm8(texel.b, texel.a);
+	}
+}
+
+static void _premultiply_float(rgba* texels, size_t count)
+{
+	float32* data = reinterpret_cast<float32*>(texels);
+	size_t i = 0;
+	// rgb takes alpha as the factor, alpha takes 1
+#if defined(GLARE_SIMD_AVX2)
+	const __m256 rgb_mask8 = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0));
+	const __m256 alpha_one8 = _mm256_setr_ps(0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f);
+	for (; i + 2 <= count; i += 2) {
+		const __m256 color = _mm256_loadu_ps(data + i * 4);
+		const __m256 alpha = _mm256_permute_ps(color, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm256_storeu_ps(data + i * 4, _mm256_mul_ps(color, _mm256_or_ps(_mm256_and_ps(alpha, rgb_mask8), alpha_one8)));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 rgb_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 alpha_one = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+	for (; i < count; ++i) {
+		const __m128 color = _mm_loadu_ps(data + i * 4);
+		const __m128 alpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+		_mm_storeu_ps(data + i * 4, _mm_mul_ps(color, _mm_or_ps(_mm_and_ps(alpha, rgb_mask), alpha_one)));
+	}
+#endif
+	for (; i < count; ++i) {
+		rgba& texel = texels[i];
+		texel.r *= texel.a;
+		texel.g *= texel.a;
+		texel.b *= texel.a;
+	}
+}
+
+static void _unpremultiply_rgba8(rgba8* texels, size_t count)
+{
+	byte* data = reinterpret_cast<byte*>(texels);
+	size_t i = 0;
+	// the same float steps as the scalar tail: 255 / a, multiply, clamp, round to nearest even
+#if defined(GLARE_SIMD_AVX2)
+	const __m256 zero8 = _mm256_setzero_ps();
+	const __m256 max8 = _mm256_set1_ps(255.f);
+	const __m256 rgb_mask8 = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0));
+	const __m256 alpha_one8 = _mm256_setr_ps(0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f);
+	const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	for (; i + 8 <= count; i += 8) {
+		__m256i pairs[4];
+		for (size_t k = 0; k < 4; ++k) {
+			const __m256 color = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data + (i + k * 2) * 4))));
+			const __m256 alpha = _mm256_permute_ps(color, _MM_SHUFFLE(3, 3, 3, 3));
+			const __m256 scale = _mm256_and_ps(_mm256_div_ps(max8, alpha), _mm256_cmp_ps(alpha, zero8, _CMP_GT_OQ));
+			const __m256 factor = _mm256_or_ps(_mm256_and_ps(scale, rgb_mask8), alpha_one8);
+			pairs[k] = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_mul_ps(color, factor), max8));
+		}
+		const __m256i packed = _mm256_packus_epi16(
+			_mm256_packs_epi32(pairs[0], pairs[1]), _mm256_packs_epi32(pairs[2], pairs[3]));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(data + i * 4), _mm256_permutevar8x32_epi32(packed, order));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const __m128i zero_bytes = _mm_setzero_si128();
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 max = _mm_set1_ps(255.f);
+	const __m128 rgb_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 alpha_one = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+	for (; i + 4 <= count; i += 4) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 4));
+		const __m128i words_01 = _mm_unpacklo_epi8(bytes, zero_bytes);
+		const __m128i words_23 = _mm_unpackhi_epi8(bytes, zero_bytes);
+		const __m128i dwords[4] = {
+			_mm_unpacklo_epi16(words_01, zero_bytes), _mm_unpackhi_epi16(words_01, zero_bytes),
+			_mm_unpacklo_epi16(words_23, zero_bytes), _mm_unpackhi_epi16(words_23, zero_bytes) };
+		__m128i channels[4];
+		for (size_t k = 0; k < 4; ++k) {
+			const __m128 color = _mm_cvtepi32_ps(dwords[k]);
+			const __m128 alpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+			const __m128 scale = _mm_and_ps(_mm_div_ps(max, alpha), _mm_cmpgt_ps(alpha, zero));
+			const __m128 factor = _mm_or_ps(_mm_and_ps(scale, rgb_mask), alpha_one);
+			channels[k] = _mm_cvtps_epi32(_mm_min_ps(_mm_mul_ps(color, factor), max));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(data + i * 4), _mm_packus_epi16(
+			_mm_packs_epi32(channels[0], channels[1]), _mm_packs_epi32(channels[2], channels[3])));
+	}
+#endif
+	for (; i < count; ++i) {
+		rgba8& texel = texels[i];
+		const float32 scale = texel.a > 0 ? 255.f / static_cast<float32>(texel.a) : 0.f;
+		texel.r = static_cast<byte>(std::lrint(std::min(static_cast<float32>(texel.r) * scale, 255.f)));
+		texel.g = static_cast<byte>(std::lrint(std::min(static_cast<float32>(texel.g) * scale, 255.f)));
+		texel.b = static_cast<byte>(std::lrint(std::min(static_cast<float32>(texel.b) * scale, 255.f)));
+	}
+}
+
+static void _unpremultiply_float(rgba* texels, size_t count)
+{
+	float32* data = reinterpret_cast<float32*>(texels);
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	const __m256 zero8 = _mm256_setzero_ps();
+	const __m256 one8 = _mm256_set1_ps(1.f);
+	const __m256 rgb_mask8 = _mm256_castsi256_ps(_mm256_setr_epi32(-1, -1, -1, 0, -1, -1, -1, 0));
+	const __m256 alpha_one8 = _mm256_setr_ps(0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f);
+	for (; i + 2 <= count; i += 2) {
+		const __m256 color = _mm256_loadu_ps(data + i * 4);
+		const __m256 alpha = _mm256_permute_ps(color, _MM_SHUFFLE(3, 3, 3, 3));
+		const __m256 inv_alpha = _mm256_and_ps(_mm256_div_ps(one8, alpha), _mm256_cmp_ps(alpha, zero8, _CMP_GT_OQ));
+		_mm256_storeu_ps(data + i * 4, _mm256_mul_ps(color, _mm256_or_ps(_mm256_and_ps(inv_alpha, rgb_mask8), alpha_one8)));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 rgb_mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+	const __m128 alpha_one = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+	for (; i < count; ++i) {
+		const __m128 color = _mm_loadu_ps(data + i * 4);
+		const __m128 alpha = _mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3));
+		const __m128 inv_alpha = _mm_and_ps(_mm_div_ps(one, alpha), _mm_cmpgt_ps(alpha, zero));
+		_mm_storeu_ps(data + i * 4, _mm_mul_ps(color, _mm_or_ps(_mm_and_ps(inv_alpha, rgb_mask), alpha_one)));
+	}
+#endif
+	for (; i < count; ++i) {
+		rgba& texel = texels[i];
+		const float32 inv_alpha = texel.a > 0.f ? 1.f / texel.a : 0.f;
+		texel.r *= inv_alpha;
+		texel.g *= inv_alpha;
+		texel.b *= inv_alpha;
+	}
+}
+
+static void _swizzle_rgba8(rgba8* texels, size_t count, const uint8 order[4])
+{
+	byte* data = reinterpret_cast<byte*>(texels);
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	alignas(32) byte shuffle[32];
+	for (size_t k = 0; k < 32; ++k) {
+		shuffle[k] = static_cast<byte>((k & ~size_t(3)) % 16 + order[k & 3]);
+	}
+	const __m256i control8 = _mm256_load_si256(reinterpret_cast<const __m256i*>(shuffle));
+	for (; i + 8 <= count; i += 8) {
+		__m256i* at = reinterpret_cast<__m256i*>(data + i * 4);
+		_mm256_storeu_si256(at, _mm256_shuffle_epi8(_mm256_loadu_si256(at), control8));
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	// no byte shuffle before SSSE3: each channel is shifted down, masked and shifted into place
+	const __m128i byte_mask = _mm_set1_epi32(0xFF);
+	__m128i shift_down[4];
+	__m128i shift_up[4];
+	for (int32 c = 0; c < 4; ++c) {
+		shift_down[c] = _mm_cvtsi32_si128(order[c] * 8);
+		shift_up[c] = _mm_cvtsi32_si128(c * 8);
+	}
+	for (; i + 4 <= count; i += 4) {
+		__m128i* at = reinterpret_cast<__m128i*>(data + i * 4);
+		const __m128i texel = _mm_loadu_si128(at);
+		__m128i result = _mm_setzero_si128();
+		for (int32 c = 0; c < 4; ++c) {
+			result = _mm_or_si128(result, _mm_sll_epi32(_mm_and_si128(_mm_srl_epi32(texel, shift_down[c]), byte_mask), shift_up[c]));
+		}
+		_mm_storeu_si128(at, result);
+	}
+#endif
+	for (; i < count; ++i) {
+		byte channels[4];
+		memcpy(channels, data + i * 4, 4);
+		for (int32 c = 0; c < 4; ++c) {
+			data[i * 4 + c] = channels[order[c]];
+		}
+	}
+}
+
+static void _swizzle_float(rgba* texels, size_t count, const uint8 order[4])
+{
+	float32* data = reinterpret_cast<float32*>(texels);
+	size_t i = 0;
+	// SSE2 has no variable shuffle, the scalar loop is as fast there
+#if defined(GLARE_SIMD_AVX2)
+	const __m256i control8 = _mm256_setr_epi32(order[0], order[1], order[2], order[3], order[0], order[1], order[2], order[3]);
+	for (; i + 2 <= count; i += 2) {
+		_mm256_storeu_ps(data + i * 4, _mm256_permutevar_ps(_mm256_loadu_ps(data + i * 4), control8));
+	}
+#endif
+	const uint8 r = order[0], g = order[1], b = order[2], a = order[3];
+	for (; i < count; ++i) {
+		float32* texel = data + i * 4;
+		const float32 channels[4] = { texel[0], texel[1], texel[2], texel[3] };
+		texel[0] = channels[r];
+		texel[1] = channels[g];
+		texel[2] = channels[b];
+		texel[3] = channels[a];
+	}
+}
+
+static float64 _resize_kernel(e_resize_filter filter, float64 x)
+{
+	x = std::abs(x);
+	if (filter == RESIZE_FILTER_BILINEAR) {
+		return std::max(0.0, 1.0 - x);
+	}
+	if (x >= LANCZOS_RADIUS) {
+		return 0.0;
+	}
+	if (x < 1e-8) {
+		return 1.0;
+	}
+	const float64 pi_x = 3.14159265358979323846 * x;
+	return LANCZOS_RADIUS * std::sin(pi_x) * std::sin(pi_x / LANCZOS_RADIUS) / (pi_x * pi_x);
+}
+
+static resize_taps _build_resize_taps(e_resize_filter filter, int32 src_size, int32 dst_size)
+{
+	const float64 scale = static_cast<float64>(src_size) / dst_size;
+	// minifying stretches the kernel over the source texels a destination texel covers
+	const float64 stretch = std::max(scale, 1.0);
+	const float64 support = (filter == RESIZE_FILTER_BILINEAR ? 1.0 : LANCZOS_RADIUS) * stretch;
+
+	resize_taps taps;
+	taps.taps_per_texel = std::min(static_cast<size_t>(std::ceil(support * 2.0)) + 1, static_cast<size_t>(src_size));
+	taps.first.resize(dst_size);
+	taps.weights.assign(taps.taps_per_texel * dst_size, 0.f);
+	std::vector<float64> weights(taps.taps_per_texel);
+	for (int32 i = 0; i < dst_size; ++i) {
+		const float64 center = (i + 0.5) * scale - 0.5;
+		const int32 low = static_cast<int32>(std::ceil(center - support));
+		const int32 high = static_cast<int32>(std::floor(center + support));
+		// taps past an edge fold onto the edge texel, so the window stays inside the image
+		const int32 first = std::min(std::max(low, 0), src_size - static_cast<int32>(taps.taps_per_texel));
+		std::fill(weights.begin(), weights.end(), 0.0);
+		float64 sum = 0.0;
+		for (int32 j = low; j <= high; ++j) {
+			const float64 weight = _resize_kernel(filter, (j - center) / stretch);
+			weights[std::min(std::max(j, 0), src_size - 1) - first] += weight;
+			sum += weight;
+		}
+		taps.first[i] = first;
+		for (size_t k = 0; k < taps.taps_per_texel; ++k) {
+			taps.weights[i * taps.taps_per_texel + k] = sum != 0.0 ? static_cast<float32>(weights[k] / sum) : 0.f;
+		}
+	}
+	return taps;
+}
+
+// <out> = <taps> applied along the row <src>
+static void _resize_row(rgba* out, const rgba* src, size_t dst_width, const resize_taps& taps)
+{
+	for (size_t x = 0; x < dst_width; ++x) {
+		const rgba* texels = src + taps.first[x];
+		const float32* weights = &taps.weights[x * taps.taps_per_texel];
+#if defined(GLARE_SIMD_SSE2)
+		__m128 sum = _mm_setzero_ps();
+		for (size_t k = 0; k < taps.taps_per_texel; ++k) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(&texels[k].r), _mm_set1_ps(weights[k])));
+		}
+		_mm_storeu_ps(&out[x].r, sum);
+#else
+		rgba sum(0.f, 0.f, 0.f, 0.f);
+		for (size_t k = 0; k < taps.taps_per_texel; ++k) {
+			sum.r += texels[k].r * weights[k];
+			sum.g += texels[k].g * weights[k];
+			sum.b += texels[k].b * weights[k];
+			sum.a += texels[k].a * weights[k];
+		}
+		out[x] = sum;
+#endif
+	}
+}
+
+// <out> = sum of <rows>[k] * <weights>[k], over <count> floats
+static void _resize_column(float32* out, const float32* const* rows, const float32* weights, size_t num_rows, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_AVX2)
+	for (; i + 8 <= count; i += 8) {
+		__m256 sum = _mm256_setzero_ps();
+		for (size_t k = 0; k < num_rows; ++k) {
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(rows[k] + i), _mm256_set1_ps(weights[k])));
+		}
+		_mm256_storeu_ps(out + i, sum);
+	}
+#endif
+#if defined(GLARE_SIMD_SSE2)
+	for (; i + 4 <= count; i += 4) {
+		__m128 sum = _mm_setzero_ps();
+		for (size_t k = 0; k < num_rows; ++k) {
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(weights[k])));
+		}
+		_mm_storeu_ps(out + i, sum);
+	}
+#endif
+	for (; i < count; ++i) {
+		float32 sum = 0.f;
+		for (size_t k = 0; k < num_rows; ++k) {
+			sum += rows[k][i] * weights[k];
+		}
+		out[i] = sum;
+	}
+}
+
+static texel_source _get_source(const surface* image)
+{
+	texel_source source;
+	source.width = static_cast<size_t>(image->m_size.x);
+	if (image->get_storage() == SURFACE_STORAGE_RGBA8) {
+		source.bytes = image->get_rgba8_buffer();
+	} else {
+		source.floats = image->get_surface_buffer();
+	}
+	return source;
+}
+
+static texel_target _get_target(surface* image)
+{
+	texel_target target;
+	target.width = static_cast<size_t>(image->m_size.x);
+	if (image->get_storage() == SURFACE_STORAGE_RGBA8) {
+		target.bytes = image->get_rgba8_buffer();
+	} else {
+		target.floats = image->get_surface_buffer();
+	}
+	return target;
+}
+
+// <count> texels from <first> as floats, converted into <temp> when the storage is rgba8
+static const rgba* _get_row(const texel_source& source, size_t first, size_t count, rgba* temp)
+{
+	if (source.floats) {
+		return source.floats + first;
+	}
+	_rgba8_to_float(temp, source.bytes + first, count);
+	return temp;
+}
+
+static void _set_row(const texel_target& target, size_t first, size_t count, const rgba* texels)
+{
+	if (target.bytes) {
+		_float_to_rgba8(target.bytes + first, texels, count);
+	} else if (target.floats + first != texels) {
+		memcpy(target.floats + first, texels, count * sizeof(rgba));
+	}
+}
+
+// Splits [0, num_rows) over job_system when the rows add up to more than one chunk of texels
+static void _for_rows(size_t num_rows, size_t row_texels, const job_range_func& func)
+{
+	job_system::parallel_for(num_rows, std::max<size_t>(1, PARALLEL_TEXELS / std::max<size_t>(1, row_texels)), func);
+}
+
+// Moves <from> and <to> past negative coordinates, then cuts <extent> at the end of both images
+static void _clip_span(int32& from, int32& to, int32& extent, int32 src_size, int32 dst_size)
+{
+	const int32 skip = std::max(0, std::max(-from, -to));
+	from += skip;
+	to += skip;
+	extent = std::min(extent - skip, std::min(src_size - from, dst_size - to));
+}
+
+void convert_rgba8_to_float(rgba* dst, const rgba8* src, size_t count)
+{
+	if (count <= PARALLEL_TEXELS) {
+		_rgba8_to_float(dst, src, count);
+		return;
+	}
+	job_system::parallel_for(count, PARALLEL_TEXELS, [dst, src](size_t begin, size_t end) {
+		_rgba8_to_float(dst + begin, src + begin, end - begin);
+	});
+}
+
+void convert_float_to_rgba8(rgba8* dst, const rgba* src, size_t count)
+{
+	if (count <= PARALLEL_TEXELS) {
+		_float_to_rgba8(dst, src, count);
+		return;
+	}
+	job_system::parallel_for(count, PARALLEL_TEXELS, [dst, src](size_t begin, size_t end) {
+		_float_to_rgba8(dst + begin, src + begin, end - begin);
+	});
+}
+
+void blit(surface* dst, const ivec2& dst_pos, const surface* src, const ivec2& src_pos, const ivec2& size, e_blit_mode mode)
+{
+	ASSERT(dst != src, "blit within one surface");
+	ivec2 from = src_pos;
+	ivec2 to = dst_pos;
+	ivec2 extent = size;
+	_clip_span(from.x, to.x, extent.x, src->m_size.x, dst->m_size.x);
+	_clip_span(from.y, to.y, extent.y, src->m_size.y, dst->m_size.y);
+	if (extent.x <= 0 || extent.y <= 0) {
+		return;
+	}
+
+	const texel_source source = _get_source(src);
+	const texel_target target = _get_target(dst);
+	const size_t width = static_cast<size_t>(extent.x);
+	_for_rows(static_cast<size_t>(extent.y), width, [&](size_t begin, size_t end) {
+		std::vector<rgba> src_row(mode == BLIT_ALPHA && source.bytes ? width : 0);
+		std::vector<rgba> dst_row(mode == BLIT_ALPHA && target.bytes ? width : 0);
+		for (size_t row = begin; row < end; ++row) {
+			const size_t src_first = (from.y + row) * source.width + from.x;
+			const size_t dst_first = (to.y + row) * target.width + to.x;
+			if (mode == BLIT_COPY) {
+				if (source.bytes && target.bytes) {
+					memcpy(static_cast<void*>(target.bytes + dst_first), source.bytes + src_first, width * sizeof(rgba8));
+				} else if (source.floats && target.floats) {
+					memcpy(target.floats + dst_first, source.floats + src_first, width * sizeof(rgba));
+				} else if (source.bytes) {
+					_rgba8_to_float(target.floats + dst_first, source.bytes + src_first, width);
+				} else {
+					_float_to_rgba8(target.bytes + dst_first, source.floats + src_first, width);
+				}
+				continue;
+			}
+			const rgba* over = _get_row(source, src_first, width, src_row.data());
+			if (target.floats) {
+				_blend_alpha(target.floats + dst_first, over, width);
+			} else {
+				_rgba8_to_float(dst_row.data(), target.bytes + dst_first, width);
+				_blend_alpha(dst_row.data(), over, width);
+				_float_to_rgba8(target.bytes + dst_first, dst_row.data(), width);
+			}
+		}
+	});
+}
+
+void resize(surface* dst, const surface* src, e_resize_filter filter)
+{
+	ASSERT(dst != src, "resize within one surface");
+	if (dst->get_texel_count() == 0 || src->get_texel_count() == 0) {
+		return;
+	}
+	const size_t src_width = static_cast<size_t>(src->m_size.x);
+	const size_t dst_width = static_cast<size_t>(dst->m_size.x);
+	const resize_taps horizontal = _build_resize_taps(filter, src->m_size.x, dst->m_size.x);
+	const resize_taps vertical = _build_resize_taps(filter, src->m_size.y, dst->m_size.y);
+
+	// each job filters the source rows it needs horizontally into a ring as deep as the vertical
+	// taps; first is non decreasing, so every source row enters the ring once a job
+	const texel_source source = _get_source(src);
+	const texel_target target = _get_target(dst);
+	const size_t ring_size = vertical.taps_per_texel;
+	_for_rows(static_cast<size_t>(dst->m_size.y), dst_width, [&](size_t begin, size_t end) {
+		std::vector<rgba> ring(ring_size * dst_width);
+		std::vector<rgba> src_row(source.bytes ? src_width : 0);
+		std::vector<rgba> dst_row(target.bytes ? dst_width : 0);
+		std::vector<const float32*> taps(ring_size);
+		size_t next_row = static_cast<size_t>(vertical.first[begin]);
+		for (size_t y = begin; y < end; ++y) {
+			const size_t first = static_cast<size_t>(vertical.first[y]);
+			for (next_row = std::max(next_row, first); next_row < first + ring_size; ++next_row) {
+				const rgba* row = _get_row(source, next_row * src_width, src_width, src_row.data());
+				_resize_row(&ring[(next_row % ring_size) * dst_width], row, dst_width, horizontal);
+			}
+			for (size_t k = 0; k < ring_size; ++k) {
+				taps[k] = &ring[((first + k) % ring_size) * dst_width].r;
+			}
+			rgba* out = target.floats ? target.floats + y * dst_width : dst_row.data();
+			_resize_column(&out->r, taps.data(), &vertical.weights[y * ring_size], ring_size, dst_width * 4);
+			_set_row(target, y * dst_width, dst_width, out);
+		}
+	});
+}
+
+void premultiply_alpha(surface* image)
+{
+	const texel_target target = _get_target(image);
+	job_system::parallel_for(image->get_texel_count(), PARALLEL_TEXELS, [&target](size_t begin, size_t end) {
+		if (target.bytes) {
+			_premultiply_rgba8(target.bytes + begin, end - begin);
+		} else {
+			_premultiply_float(target.floats + begin, end - begin);
+		}
+	});
+}
+
+void unpremultiply_alpha(surface* image)
+{
+	const texel_target target = _get_target(image);
+	job_system::parallel_for(image->get_texel_count(), PARALLEL_TEXELS, [&target](size_t begin, size_t end) {
+		if (target.bytes) {
+			_unpremultiply_rgba8(target.bytes + begin, end - begin);
+		} else {
+			_unpremultiply_float(target.floats + begin, end - begin);
+		}
+	});
+}
+
+void swizzle(surface* image, const uint8 order[4])
+{
+	ASSERT(order[0] < 4 && order[1] < 4 && order[2] < 4 && order[3] < 4, "swizzle channel out of range");
+	const texel_target target = _get_target(image);
+	job_system::parallel_for(image->get_texel_count(), PARALLEL_TEXELS, [&target, order](size_t begin, size_t end) {
+		if (target.bytes) {
+			_swizzle_rgba8(target.bytes + begin, end - begin, order);
+		} else {
+			_swizzle_float(target.floats + begin, end - begin, order);
+		}
+	});
+}
+}
+}
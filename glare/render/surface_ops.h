@@ -0,0 +1,52 @@
+/// glare/render/surface_ops.h
+/// Bulk texel kernels over surface storage.
+///
+/// rgba8 to float gives exactly rgba(rgba8), float to rgba8 exactly
+/// vertex_packing::pack_unorm8x4(), so converted and per-texel results agree
+/// bit for bit. SSE2 with an AVX2 path, scalar for the tail.
+///
+/// The surface operations work in the storage of the surfaces they are given
+/// (see surface.h) and do not change it; rgba8 rows go through float where
+/// the math needs it. Images of more than a few ten thousand texels are split
+/// by rows over job_system. Colors are taken as stored: nothing is linearized.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include "glare/math/vector.h"
+
+namespace glare
+{
+class surface;
+
+namespace surface_ops
+{
+enum e_blit_mode : uint8
+{
+	BLIT_COPY,
+	BLIT_ALPHA,	// the BLEND_ALPHA equation of state_object_cache, alpha included
+};
+
+enum e_resize_filter : uint8
+{
+	RESIZE_FILTER_BILINEAR,	// tent, widened when minifying
+	RESIZE_FILTER_LANCZOS3,	// sharper, may ring; rgba8 results are clamped
+};
+
+void convert_rgba8_to_float(rgba* dst, const rgba8* src, size_t count);
+// Clamped to [0, 1], rounded to nearest
+void convert_float_to_rgba8(rgba8* dst, const rgba* src, size_t count);
+
+// Copies the <size> rect at <src_pos> of <src> to <dst_pos> of <dst>, clipped to both.
+// <src> and <dst> are different surfaces
+void blit(surface* dst, const ivec2& dst_pos, const surface* src, const ivec2& src_pos, const ivec2& size, e_blit_mode mode = BLIT_COPY);
+// Resamples all of <src> to the size of <dst>
+void resize(surface* dst, const surface* src, e_resize_filter filter = RESIZE_FILTER_BILINEAR);
+// rgb *= a, rgba8 rounds to nearest
+void premultiply_alpha(surface* image);
+// rgb /= a, 0 where a is 0
+void unpremultiply_alpha(surface* image);
+// Channel i of each texel becomes channel order[i], each in [0, 3]; {2, 1, 0, 3} swaps bgra and rgba
+void swizzle(surface* image, const uint8 order[4]);
+}
+}
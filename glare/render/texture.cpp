@@ -1,10 +1,24 @@
 #include "glare/render/texture.h"
+#include "glare/render/block_compression.h"
 #include "glare/render/renderer.h"
 #include "glare/render/surface.h"
+#include "glare/render/vertex_format.h"
 #include "core/assert.h"
 
 namespace glare
 {
+dx_format get_block_dx_format(e_block_format format, bool srgb)
+{
+	switch (format) {
+	case BLOCK_FORMAT_BC1:	return srgb ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM;
+	case BLOCK_FORMAT_BC3:	return srgb ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM;
+	case BLOCK_FORMAT_BC4:	return DXGI_FORMAT_BC4_UNORM;
+	case BLOCK_FORMAT_BC5:	return DXGI_FORMAT_BC5_UNORM;
+	case BLOCK_FORMAT_BC7:	return srgb ? DXGI_FORMAT_BC7_UNORM_SRGB : DXGI_FORMAT_BC7_UNORM;
+	}
+	return DXGI_FORMAT_UNKNOWN;
+}
+
 texture2d::texture2d(renderer* r, dx_texture2d* ref_dx_texture)
 	: texture(r)
 {
@@ -30,45 +44,103 @@ texture2d::texture2d(renderer* r, dx_texture2d* ref_dx_texture)
 	}
 }
 
-texture2d::texture2d(renderer* r, const surface* from_surface)
+texture2d::texture2d(renderer* r, const surface* from_surface, bool with_mips)
 	: texture(r)
 {
-	dx_device* device = r->get_dx_device();
+	create_from_surface(from_surface, with_mips);
+}
+
+void texture2d::create_from_surface(const surface* from_surface, bool with_mips)
+{
+	const ivec2& size = from_surface->m_size;
+	const bool use_rgba8 = from_surface->get_storage() == SURFACE_STORAGE_RGBA8;
+
+	std::vector<mip_level> generated;
+	const std::vector<mip_level>* mips = &from_surface->m_mips;
+	if (mips->empty() && with_mips) {
+		generate_mip_chain(from_surface->get_surface_buffer(), size, from_surface->get_default_mip_options(), generated);
+		if (use_rgba8) {
+			// the float copy was made for the filter only
+			from_surface->release_cache();
+		}
+		mips = &generated;
+	}
+	const uint32 level_count = static_cast<uint32>(mips->size() + 1);
+
+	const size_t texel_size = use_rgba8 ? sizeof(rgba8) : sizeof(rgba);
+	std::vector<D3D11_SUBRESOURCE_DATA> data(level_count);
+	memset(data.data(), 0, data.size() * sizeof(D3D11_SUBRESOURCE_DATA));
+	data[0].pSysMem		= 
+		use_rgba8
+		?	static_cast<const void*>(from_surface->get_rgba8_buffer())
+		:	from_surface->get_surface_buffer();
+	data[0].SysMemPitch	= static_cast<UINT>(texel_size * size.u);
+
+	// the rgba8 levels are packed from the float ones, alive until the creation
+	std::vector<std::vector<rgba8>> packed(use_rgba8 ? mips->size() : 0);
+	for (size_t level = 1; level < level_count; ++level) {
+		const mip_level& mip = (*mips)[level - 1];
+		if (use_rgba8) {
+			std::vector<rgba8>& bytes = packed[level - 1];
+			bytes.resize(mip.texels.size());
+			vertex_packing::pack_unorm8x4(reinterpret_cast<byte*>(bytes.data()), sizeof(rgba8)
+				, reinterpret_cast<const byte*>(mip.texels.data()), sizeof(rgba), mip.texels.size());
+			data[level].pSysMem = bytes.data();
+		} else {
+			data[level].pSysMem = mip.texels.data();
+		}
+		data[level].SysMemPitch = static_cast<UINT>(texel_size * mip.size.u);
+	}
+	create_from_memory(size, use_rgba8 ? DXGI_FORMAT_R8G8B8A8_UNORM : DXGI_FORMAT_R32G32B32A32_FLOAT, data.data(), level_count);
+}
+
+texture2d::texture2d(renderer* r, const compressed_image& image)
+	: texture(r)
+{
+	create_from_compressed(image);
+}
+
+void texture2d::create_from_compressed(const compressed_image& image)
+{
+	ASSERT(!image.levels.empty(), "Compressed image has no levels");
+	const ivec2& size = image.levels[0].size;
+	ASSERT(size.x % 4 == 0 && size.y % 4 == 0, "Block compressed textures need a size that is a multiple of 4");
+
+	// the pitch is one row of blocks
+	std::vector<D3D11_SUBRESOURCE_DATA> data(image.levels.size());
+	memset(data.data(), 0, data.size() * sizeof(D3D11_SUBRESOURCE_DATA));
+	for (size_t level = 0; level < image.levels.size(); ++level) {
+		data[level].pSysMem		= image.levels[level].blocks.data();
+		data[level].SysMemPitch	= get_block_row_pitch(image.format, image.levels[level].size.u);
+	}
+	create_from_memory(size, get_block_dx_format(image.format, image.srgb), data.data(), static_cast<uint32>(data.size()));
+}
+
+void texture2d::create_from_memory(const ivec2& size, dx_format format, const D3D11_SUBRESOURCE_DATA* levels, uint32 level_count)
+{
+	DX_RELEASE(m_srv);
+	DX_RELEASE(m_handle);
+	dx_device* device = m_renderer->get_dx_device();
 	m_texture_usage = TEXTURE_SHADER_RESOURCE;
 	m_memory_usage	= GPU_MEMORY_IMMUTABLE;
-	m_size			= from_surface->m_size;
-	const bool use_rgba8 = (from_surface->m_raw && from_surface->m_raw_channels == 4);
+	m_size			= size;
+
 	D3D11_TEXTURE2D_DESC desc;
 	memset(&desc, 0, sizeof(desc));
 	desc.Width	= m_size.u;
 	desc.Height = m_size.v;
-	desc.MipLevels	= 1;
+	desc.MipLevels	= level_count;
 	desc.ArraySize	= 1;
 	desc.Usage		= static_cast<D3D11_USAGE>(m_memory_usage);
-	desc.Format		= 
-		use_rgba8
-		?	DXGI_FORMAT_R8G8B8A8_UNORM
-		:	DXGI_FORMAT_R32G32B32A32_FLOAT;
+	desc.Format		= format;
 	desc.BindFlags	= static_cast<D3D11_BIND_FLAG>(m_texture_usage);
 	desc.CPUAccessFlags	= 0;
 	desc.MiscFlags		= 0;
 	desc.SampleDesc.Count	= 1;
 	desc.SampleDesc.Quality	= 0;
-
-	const uint32 pitch = 
-		use_rgba8
-		?	sizeof(rgba8) * m_size.u
-		:	sizeof(rgba) * m_size.u;
-	D3D11_SUBRESOURCE_DATA data;
-	memset(&data, 0, sizeof(data));
-	data.pSysMem		= 
-		use_rgba8
-		?	static_cast<void*>(from_surface->m_raw)
-		:	from_surface->get_surface_buffer();
-	data.SysMemPitch	= pitch;
-	HRESULT hr = device->CreateTexture2D(&desc, &data, reinterpret_cast<dx_texture2d**>(&m_handle));
+	HRESULT hr = device->CreateTexture2D(&desc, levels, reinterpret_cast<dx_texture2d**>(&m_handle));
 	if (FAILED(hr)) {
-		FATAL("Creating texture from surface failed");
+		FATAL("Creating texture from memory failed");
 	}
 }
 
@@ -7,6 +7,12 @@ namespace glare
 {
 class renderer;
 class surface;
+struct compressed_image;
+enum e_block_format : uint8;
+
+// DXGI format of the BC blocks, see block_compression.h
+NODISCARD dx_format get_block_dx_format(e_block_format format, bool srgb);
+
 class texture
 {
 public:
@@ -47,12 +53,25 @@ public:
 	{
 	}
 	texture2d(renderer*r, dx_texture2d* ref_dx_texture);
-	texture2d(renderer*r, const surface* from_surface);
+	// Uploads from_surface->m_mips, or a chain built here when the surface has
+	// none and <with_mips> is set. Building it blocks for hundreds of ms on a
+	// large image, texture_loader builds it on its workers instead
+	texture2d(renderer*r, const surface* from_surface, bool with_mips=false);
+	// Uploads every level of <image> as BC blocks, see block_compression.h
+	texture2d(renderer*r, const compressed_image& image);
 	~texture2d() override
 	{
 		//texture::~texture();
 	}
 	void wrap_dx_texture(dx_texture2d* to_wrap);
+	// Replaces the content with <from_surface> like the surface constructor,
+	// the texture2d object stays valid for its users
+	void create_from_surface(const surface* from_surface, bool with_mips=false);
+	// Level 0 of <image> has to be a multiple of 4 texels in both directions
+	void create_from_compressed(const compressed_image& image);
+	// Immutable texture of <level_count> levels in <format>, level 0 of <size>.
+	// The device copies the texels, <levels> can go after the call
+	void create_from_memory(const ivec2& size, dx_format format, const D3D11_SUBRESOURCE_DATA* levels, uint32 level_count);
 	
 	NODISCARD virtual dx_texture2d* get_texture_handle() const override
 	{
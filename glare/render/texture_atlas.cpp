@@ -0,0 +1,269 @@
+#include "glare/render/texture_atlas.h"
+#include "glare/render/surface.h"
+#include "glare/render/texture.h"
+#include "glare/render/sprite.h"
+#include "glare/render/surface_ops.h"
+#include "glare/math/utilities.h"
+#include "glare/core/clock.h"
+#include "glare/core/assert.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// imgui_draw.cpp compiles its own static copy
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imgui/imstb_rectpack.h"
+
+namespace glare
+{
+struct texture_atlas::rect_packer
+{
+	stbrp_context			context;
+	std::vector<stbrp_node>	nodes;
+
+	rect_packer(int32 width, int32 height)
+		: nodes(width)
+	{
+		stbrp_init_target(&context, width, height, nodes.data(), width);
+		stbrp_setup_heuristic(&context, STBRP_HEURISTIC_Skyline_BF_sortHeight);
+	}
+	// The skyline is linked through the nodes and context.extra, the links are rebased on the copy
+	rect_packer(const rect_packer& from)
+		: context(from.context)
+		, nodes(from.nodes)
+	{
+		const auto rebase = [&from, this](stbrp_node* link) -> stbrp_node* {
+			if (!link) {
+				return nullptr;
+			}
+			const stbrp_node* first = from.nodes.data();
+			if (link >= first && link < first + from.nodes.size()) {
+				return nodes.data() + (link - first);
+			}
+			return context.extra + (link - from.context.extra);
+		};
+		context.active_head = rebase(context.active_head);
+		context.free_head = rebase(context.free_head);
+		for (stbrp_node& each : nodes) {
+			each.next = rebase(each.next);
+		}
+		for (stbrp_node& each : context.extra) {
+			each.next = rebase(each.next);
+		}
+	}
+};
+
+struct texture_atlas::page
+{
+	surface*		image = nullptr;	// rgba8 storage, what the texture uploads
+	texture2d*		texture = nullptr;
+	rect_packer*	packer = nullptr;
+	int32			bottom = 0;			// lowest packed texel row
+	bool			dirty = true;
+};
+
+texture_atlas::texture_atlas(renderer* r, const texture_atlas_options& options)
+	: m_renderer(r)
+	, m_options(options)
+{
+	ASSERT(options.bleed >= 0 && options.bleed <= options.padding, "Atlas bleed must fit in the padding");
+	ASSERT(options.page_size.x > 0 && options.page_size.y > 0 && options.page_size.x <= 0xffff && options.page_size.y <= 0xffff
+		, "Invalid atlas page size");
+}
+
+texture_atlas::~texture_atlas()
+{
+	for (page* each : m_pages) {
+		delete each->image;
+		delete each->texture;
+		delete each->packer;
+		delete each;
+	}
+}
+
+bool texture_atlas::add_surface(const surface* image, atlas_region& out_region)
+{
+	const float64 start = get_current_time_seconds();
+	std::vector<placement> placements(1);
+	placements[0].size = image->m_size;
+	const int32 page_index = pack(placements);
+	if (page_index < 0) {
+		return false;
+	}
+	copy_region(m_pages[page_index], image, placements[0]);
+	out_region = make_region(static_cast<uint32>(page_index), placements[0]);
+	m_stats.pack_ms += (get_current_time_seconds() - start) * 1000.0;
+	return true;
+}
+
+bool texture_atlas::add_sprite_sheet(sprite_sheet* sheet, const surface* sheet_image)
+{
+	const float64 start = get_current_time_seconds();
+	const ivec2 image_size = sheet_image->m_size;
+	std::vector<placement> placements(sheet->m_sprites.size());
+	for (size_t i = 0; i < placements.size(); ++i) {
+		const sprite& each = sheet->m_sprites[i];
+		const int32 left = clamp(static_cast<int32>(std::lround(std::min(each.m_bottom_left.u, each.m_top_right.u) * image_size.x)), 0, image_size.x);
+		const int32 right = clamp(static_cast<int32>(std::lround(std::max(each.m_bottom_left.u, each.m_top_right.u) * image_size.x)), left, image_size.x);
+		const int32 top = clamp(static_cast<int32>(std::lround(std::min(each.m_bottom_left.v, each.m_top_right.v) * image_size.y)), 0, image_size.y);
+		const int32 bottom = clamp(static_cast<int32>(std::lround(std::max(each.m_bottom_left.v, each.m_top_right.v) * image_size.y)), top, image_size.y);
+		placements[i].source = ivec2(left, top);
+		placements[i].size = ivec2(right - left, bottom - top);
+	}
+	const int32 page_index = pack(placements);
+	if (page_index < 0) {
+		return false;
+	}
+
+	page* target = m_pages[page_index];
+	for (size_t i = 0; i < placements.size(); ++i) {
+		copy_region(target, sheet_image, placements[i]);
+		const atlas_region region = make_region(static_cast<uint32>(page_index), placements[i]);
+		sprite& each = sheet->m_sprites[i];
+		each.m_bottom_left = region.uv_bottom_left;
+		each.m_top_right = region.uv_top_right;
+	}
+	sheet->m_texture = target->texture;
+	m_stats.pack_ms += (get_current_time_seconds() - start) * 1000.0;
+	return true;
+}
+
+void texture_atlas::update_textures()
+{
+	for (page* each : m_pages) {
+		if (each->dirty && each->texture) {
+			each->texture->create_from_surface(each->image, m_options.mips);
+		}
+		each->dirty = false;
+	}
+}
+
+const surface* texture_atlas::get_page_surface(size_t page) const
+{
+	return m_pages[page]->image;
+}
+
+texture2d* texture_atlas::get_page_texture(size_t page) const
+{
+	return m_pages[page]->texture;
+}
+
+texture_atlas_stats texture_atlas::get_stats() const
+{
+	texture_atlas_stats result = m_stats;
+	const uint64 page_area = static_cast<uint64>(m_options.page_size.x) * m_options.page_size.y;
+	result.page_texels = page_area * m_pages.size();
+	result.occupied_texels = 0;
+	for (const page* each : m_pages) {
+		result.occupied_texels += static_cast<uint64>(m_options.page_size.x) * each->bottom;
+	}
+	return result;
+}
+
+int32 texture_atlas::pack(std::vector<placement>& io_placements)
+{
+	const int32 padding = m_options.padding;
+	std::vector<stbrp_rect> rects(io_placements.size());
+	for (size_t i = 0; i < rects.size(); ++i) {
+		const ivec2 padded = io_placements[i].size + ivec2(padding * 2, padding * 2);
+		if (padded.x > m_options.page_size.x || padded.y > m_options.page_size.y) {
+			return -1;
+		}
+		rects[i].id = static_cast<int>(i);
+		rects[i].w = static_cast<stbrp_coord>(padded.x);
+		rects[i].h = static_cast<stbrp_coord>(padded.y);
+	}
+
+	// A rect that does not fit leaves the skyline as it was, so a single one
+	// packs in place. Several are tried on a copy, kept only when all fit.
+	const bool single = rects.size() == 1;
+	const auto try_page = [&](page* target) {
+		rect_packer* packer = single ? target->packer : new rect_packer(*target->packer);
+		const bool packed = stbrp_pack_rects(&packer->context, rects.data(), static_cast<int>(rects.size())) != 0;
+		if (!single) {
+			if (packed) {
+				std::swap(packer, target->packer);
+			}
+			delete packer;
+		}
+		return packed;
+	};
+
+	int32 page_index = -1;
+	for (size_t i = 0; i < m_pages.size() && page_index < 0; ++i) {
+		if (try_page(m_pages[i])) {
+			page_index = static_cast<int32>(i);
+		}
+	}
+	if (page_index < 0) {
+		if (m_pages.size() >= m_options.max_pages) {
+			return -1;
+		}
+		const ivec2 size = m_options.page_size;
+		page* created = new page;
+		created->image = new surface(size.x, size.y, rgba8(0, 0, 0, 0));
+		created->texture = m_renderer ? new texture2d(m_renderer) : nullptr;
+		created->packer = new rect_packer(size.x, size.y);
+		if (!try_page(created)) {
+			delete created->image;
+			delete created->texture;
+			delete created->packer;
+			delete created;
+			return -1;
+		}
+		m_pages.push_back(created);
+		page_index = static_cast<int32>(m_pages.size() - 1);
+	}
+
+	page* target = m_pages[page_index];
+	for (const stbrp_rect& each : rects) {
+		io_placements[each.id].position = ivec2(each.x + padding, each.y + padding);
+		target->bottom = std::max(target->bottom, static_cast<int32>(each.y + each.h));
+	}
+	target->dirty = true;
+	m_stats.regions += static_cast<uint32>(rects.size());
+	for (const placement& each : io_placements) {
+		m_stats.content_texels += static_cast<uint64>(each.size.x) * each.size.y;
+	}
+	return page_index;
+}
+
+void texture_atlas::copy_region(page* to, const surface* image, const placement& region) const
+{
+	if (region.size.x <= 0 || region.size.y <= 0) {
+		return;
+	}
+	rgba8* target = to->image->get_rgba8_buffer();
+	const int32 bleed = m_options.bleed;
+	const size_t page_width = static_cast<size_t>(to->image->m_size.x);
+	const bool source_bytes = image->get_storage() == SURFACE_STORAGE_RGBA8;
+	for (int32 dy = -bleed; dy < region.size.y + bleed; ++dy) {
+		const size_t source_y = static_cast<size_t>(region.source.y + clamp(dy, 0, region.size.y - 1));
+		const size_t source_row = source_y * image->m_size.x + region.source.x;
+		const size_t target_row = static_cast<size_t>(region.position.y + dy) * page_width + region.position.x;
+		if (source_bytes) {
+			memcpy(static_cast<void*>(target + target_row), image->get_rgba8_buffer() + source_row, region.size.x * sizeof(rgba8));
+		} else {
+			surface_ops::convert_float_to_rgba8(target + target_row, image->get_surface_buffer() + source_row, region.size.x);
+		}
+		const size_t last = target_row + region.size.x - 1;
+		for (int32 dx = 1; dx <= bleed; ++dx) {
+			target[target_row - dx] = target[target_row];
+			target[last + dx] = target[last];
+		}
+	}
+}
+
+atlas_region texture_atlas::make_region(uint32 page_index, const placement& region) const
+{
+	const vec2 inv_page_size(1.f / m_options.page_size.x, 1.f / m_options.page_size.y);
+	atlas_region result;
+	result.page = page_index;
+	result.position = region.position;
+	result.size = region.size;
+	result.uv_bottom_left = vec2(static_cast<float32>(region.position.x), static_cast<float32>(region.position.y + region.size.y)) * inv_page_size;
+	result.uv_top_right = vec2(static_cast<float32>(region.position.x + region.size.x), static_cast<float32>(region.position.y)) * inv_page_size;
+	return result;
+}
+}
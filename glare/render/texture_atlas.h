@@ -0,0 +1,104 @@
+/// glare/render/texture_atlas.h
+/// Packs surfaces and sprite sheets into shared texture pages.
+///
+/// Sprites of different sheets that land on the same page share a texture,
+/// so sprite_batch draws them in one group. Regions are placed with the
+/// skyline packer of imgui/imstb_rectpack.h, one packer per page that keeps
+/// its state, so adds can come at any time; each add only dirties its page
+/// and update_textures() re-creates the textures of the dirty pages.
+///
+/// Each region keeps <padding> empty texels on every side; the first <bleed>
+/// of them repeat the region edge so bilinear filtering (and the first mips)
+/// never reads a neighbour.
+///
+/// add_sprite_sheet() moves every sprite of a sheet to one page and rewrites
+/// the sheet texture and the sprite uvs in place. Sprites copied out of the
+/// sheet before, e.g. animation frames, keep the old uvs: atlas sheets before
+/// building animations from them.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/math/vector.h"
+#include <vector>
+
+namespace glare
+{
+class renderer;
+class surface;
+class texture2d;
+class sprite_sheet;
+
+struct texture_atlas_options
+{
+	ivec2	page_size = ivec2(2048, 2048);
+	int32	padding = 2;	// texels around each region
+	int32	bleed = 1;		// texels of the padding repeating the region edge, at most <padding>
+	uint32	max_pages = 16;
+	bool	mips = false;	// mip mapped pages want padding and bleed of 2^levels
+};
+
+struct atlas_region
+{
+	uint32	page = 0;
+	ivec2	position;	// texels, top left of the content
+	ivec2	size;
+	vec2	uv_bottom_left;
+	vec2	uv_top_right;
+};
+
+struct texture_atlas_stats
+{
+	uint32	regions = 0;
+	uint64	content_texels = 0;		// regions without their padding
+	uint64	page_texels = 0;		// every page, whole
+	uint64	occupied_texels = 0;	// every page down to its lowest region
+	float64	pack_ms = 0.0;			// packing and copying, since construction
+};
+
+class texture_atlas
+{
+public:
+	// <r> may be nullptr: the pages are then only built on the CPU
+	explicit texture_atlas(renderer* r, const texture_atlas_options& options = texture_atlas_options());
+	~texture_atlas();
+	texture_atlas(const texture_atlas&) = delete;
+	texture_atlas& operator=(const texture_atlas&) = delete;
+
+	// Return: false when <image> does not fit an empty page or max_pages is reached
+	bool add_surface(const surface* image, atlas_region& out_region);
+	// <sheet_image> is the image the sheet uvs refer to now.
+	// Return: false when the sprites do not fit one empty page, the sheet is left untouched
+	bool add_sprite_sheet(sprite_sheet* sheet, const surface* sheet_image);
+	// Re-creates the textures of the pages changed since the last call
+	void update_textures();
+
+	NODISCARD size_t get_page_count() const { return m_pages.size(); }
+	NODISCARD const surface* get_page_surface(size_t page) const;
+	// nullptr without a renderer
+	NODISCARD texture2d* get_page_texture(size_t page) const;
+	NODISCARD texture_atlas_stats get_stats() const;
+
+private:
+	struct rect_packer;
+	struct page;
+	struct placement
+	{
+		ivec2	source;		// top left in the source image
+		ivec2	size;
+		ivec2	position;	// top left of the content in the page
+	};
+
+private:
+	// Packs every <io_placements> into one page, filling their position.
+	// Return: the page index or -1
+	int32 pack(std::vector<placement>& io_placements);
+	void copy_region(page* to, const surface* image, const placement& region) const;
+	NODISCARD atlas_region make_region(uint32 page_index, const placement& region) const;
+
+private:
+	renderer*				m_renderer = nullptr;
+	texture_atlas_options	m_options;
+	std::vector<page*>		m_pages;
+	texture_atlas_stats		m_stats;
+};
+}
@@ -0,0 +1,242 @@
+#include "glare/render/texture_loader.h"
+#include "glare/render/renderer.h"
+#include "glare/render/surface.h"
+#include "glare/render/texture.h"
+#include "glare/render/sprite.h"
+#include "glare/core/job.h"
+#include "glare/core/clock.h"
+#include "glare/core/assert.h"
+#include "glare/core/string_utils.h"
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace glare
+{
+struct texture_loader::request
+{
+	string		id;
+	string		path;
+	bool		flip_v = false;
+	texture2d*	texture = nullptr;
+	surface*	image = nullptr;	// written by the worker before it queues the request
+	std::vector<texture_loaded_func>	callbacks;
+	// Sheets waiting for the texture size, with their parsed xml
+	std::vector<std::pair<sprite_sheet*, xml::document*>>	sheets;
+};
+
+static vec2 _get_inv_size(const ivec2& size)
+{
+	return size.x > 0 && size.y > 0 ? vec2(1.f / size.x, 1.f / size.y) : vec2::ZERO;
+}
+
+texture_loader::texture_loader(renderer* r, const texture_loader_options& options)
+	: m_renderer(r)
+	, m_options(options)
+{
+	if (m_renderer) {
+		const surface placeholder_image(1, 1, options.placeholder_color);
+		m_placeholder = new texture2d(m_renderer, &placeholder_image, false);
+	}
+}
+
+texture_loader::~texture_loader()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_decoded_mutex);
+		m_decoded_signal.wait(lock, [this] { return m_in_flight == 0; });
+	}
+	for (auto& each : m_requests) {
+		for (auto& waiting : each.second->sheets) {
+			xml::unload_file(waiting.second);
+		}
+		delete each.second->image;
+		delete each.second;
+	}
+	delete m_placeholder;
+}
+
+texture2d* texture_loader::load_texture2d(const string& id, const char* path, bool flip_v, texture_loaded_func on_loaded)
+{
+	const auto pending = m_requests.find(id);
+	if (pending != std::end(m_requests)) {
+		if (on_loaded) {
+			pending->second->callbacks.emplace_back(std::move(on_loaded));
+		}
+		return pending->second->texture;
+	}
+	const auto cached = renderer::s_cached_texture.find(id);
+	if (cached != std::end(renderer::s_cached_texture)) {
+		if (on_loaded) {
+			on_loaded(texture_load_result {id, cached->second, nullptr, true});
+		}
+		return cached->second;
+	}
+
+	request* created = new request;
+	created->id = id;
+	created->path = path;
+	created->flip_v = flip_v;
+	created->texture = new texture2d(m_renderer);
+	if (m_placeholder) {
+		created->texture->wrap_dx_texture(m_placeholder->get_texture_handle());
+	}
+	if (on_loaded) {
+		created->callbacks.emplace_back(std::move(on_loaded));
+	}
+	renderer::s_cached_texture[id] = created->texture;
+	m_requests[id] = created;
+	++m_stats.requested;
+	{
+		std::lock_guard<std::mutex> lock(m_decoded_mutex);
+		++m_in_flight;
+	}
+	// runs inline until job_system is started
+	job_system::submit([this, created] { decode(created); });
+	return created->texture;
+}
+
+sprite_sheet* texture_loader::load_sprite_sheet_from_xml(const string& id, const char* path)
+{
+	const auto found = sprite_sheet::s_sprite_sheet_cache.find(id);
+	if (found != std::end(sprite_sheet::s_sprite_sheet_cache)) {
+		// the replaced sheet may still wait for its texture
+		for (auto& each : m_requests) {
+			auto& sheets = each.second->sheets;
+			for (auto it = sheets.begin(); it != sheets.end();) {
+				if (it->first == found->second) {
+					xml::unload_file(it->second);
+					it = sheets.erase(it);
+				} else {
+					++it;
+				}
+			}
+		}
+		delete found->second;
+	}
+
+	xml::document* doc = xml::load_file(path);
+	const xml::node root_node = doc->root().child("sprites");
+	const string texture_id = root_node.attribute("texture").value();
+	texture2d* texture;
+	const auto cached = renderer::s_cached_texture.find(texture_id);
+	if (cached != std::end(renderer::s_cached_texture)) {
+		texture = cached->second;
+	} else {
+		const xml::attribute src = root_node.attribute("src");
+		if (src.empty()) {
+			FATAL("No available texture nor image file when loading sprite sheet");
+		}
+		texture = load_texture2d(texture_id, src.value());
+	}
+
+	sprite_sheet* created = new sprite_sheet();
+	created->m_texture = texture;
+	sprite_sheet::s_sprite_sheet_cache[id] = created;
+	const auto pending = m_requests.find(texture_id);
+	if (pending != std::end(m_requests)) {
+		pending->second->sheets.emplace_back(created, doc);
+	} else {
+		created->read_sprites_from_xml(root_node, _get_inv_size(texture->get_size()));
+		xml::unload_file(doc);
+	}
+	return created;
+}
+
+uint32 texture_loader::update()
+{
+	const float64 start = get_current_time_seconds();
+	uint32 finished = 0;
+	for (;;) {
+		request* next;
+		{
+			std::lock_guard<std::mutex> lock(m_decoded_mutex);
+			if (m_decoded.empty()) {
+				break;
+			}
+			next = m_decoded.front();
+			m_decoded.pop_front();
+		}
+		finish(next);
+		++finished;
+		if ((get_current_time_seconds() - start) * 1000.0 >= m_options.upload_budget_ms) {
+			break;
+		}
+	}
+	m_stats.max_update_ms = std::max(m_stats.max_update_ms, (get_current_time_seconds() - start) * 1000.0);
+	return finished;
+}
+
+void texture_loader::flush()
+{
+	// every pending request is either decoding or decoded, the callbacks may add more
+	while (!m_requests.empty()) {
+		request* next;
+		{
+			std::unique_lock<std::mutex> lock(m_decoded_mutex);
+			m_decoded_signal.wait(lock, [this] { return !m_decoded.empty(); });
+			next = m_decoded.front();
+			m_decoded.pop_front();
+		}
+		finish(next);
+	}
+}
+
+texture_loader_stats texture_loader::get_stats() const
+{
+	texture_loader_stats result = m_stats;
+	std::lock_guard<std::mutex> lock(m_decoded_mutex);
+	result.decode_ms = m_decode_ms;
+	return result;
+}
+
+void texture_loader::decode(request* job)
+{
+	const float64 start = get_current_time_seconds();
+	surface* image = new surface(job->path.c_str(), job->flip_v);
+	if (image->get_texel_count() > 0 && m_options.mips) {
+		image->generate_mips();
+	}
+	const float64 elapsed_ms = (get_current_time_seconds() - start) * 1000.0;
+	{
+		std::lock_guard<std::mutex> lock(m_decoded_mutex);
+		job->image = image;
+		m_decoded.push_back(job);
+		m_decode_ms += elapsed_ms;
+		--m_in_flight;
+	}
+	m_decoded_signal.notify_all();
+}
+
+void texture_loader::finish(request* done)
+{
+	const float64 start = get_current_time_seconds();
+	texture2d* texture = done->texture;
+	const bool succeeded = done->image->get_texel_count() > 0;
+	if (!succeeded) {
+		ALERT(format("texture(id=%s) failed to load from %s", done->id.c_str(), done->path.c_str()));
+		++m_stats.failed;
+	} else if (m_renderer) {
+		texture->create_from_surface(done->image, m_options.mips);
+		++m_stats.uploaded;
+	} else {
+		texture->m_size = done->image->m_size;
+		++m_stats.uploaded;
+	}
+	m_stats.upload_ms += (get_current_time_seconds() - start) * 1000.0;
+	m_requests.erase(done->id);
+
+	// a failed texture keeps its sprites, all at uv 0 on the placeholder
+	const vec2 inv_size = succeeded ? _get_inv_size(done->image->m_size) : vec2::ZERO;
+	for (auto& waiting : done->sheets) {
+		waiting.first->read_sprites_from_xml(waiting.second->root().child("sprites"), inv_size);
+		xml::unload_file(waiting.second);
+	}
+	const texture_load_result result {done->id, texture, done->image, succeeded};
+	for (const texture_loaded_func& each : done->callbacks) {
+		each(result);
+	}
+	delete done->image;
+	delete done;
+}
+}
@@ -0,0 +1,109 @@
+/// glare/render/texture_loader.h
+/// Loads textures and sprite sheets without stalling the render thread.
+///
+/// Image files are decoded (and their mip chains generated) by job_system
+/// workers; the render thread only creates the textures, in update(), and
+/// stops once the frame's upload budget is spent. A request hands out its
+/// texture2d at once, registered in renderer::s_cached_texture like
+/// load_texture2d_from_file(), showing a shared 1x1 placeholder until its
+/// upload, so the pointer can be stored and drawn right away.
+///
+/// Sprite sheet xml files are small and parsed on the calling thread; the
+/// sheet is cached at once and gets its sprites when its texture is uploaded,
+/// as the uvs depend on the texture size.
+///
+/// Without a renderer nothing is created on the device: update() only hands
+/// the decoded surfaces to the callbacks, which is what the headless checks
+/// in dev/texture_loader_bench use.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace glare
+{
+class renderer;
+class surface;
+class texture2d;
+class sprite_sheet;
+
+struct texture_loader_options
+{
+	float64	upload_budget_ms = 2.0;	// per update(), one upload always goes through
+	bool	mips = true;			// full mip chains, generated by the workers
+	rgba	placeholder_color = rgba(1.f, 0.f, 1.f, 1.f);
+};
+
+struct texture_load_result
+{
+	const string&	id;
+	texture2d*		texture;	// the one handed out by the request
+	const surface*	image;		// decoded texels, freed after the callbacks; nullptr when loaded before the request
+	bool			succeeded;	// false: the file did not decode, the placeholder stays
+};
+// Runs on the thread calling update()
+using texture_loaded_func = std::function<void(const texture_load_result& result)>;
+
+struct texture_loader_stats
+{
+	uint32	requested = 0;
+	uint32	uploaded = 0;
+	uint32	failed = 0;
+	float64	decode_ms = 0.0;			// summed over the workers
+	float64	upload_ms = 0.0;
+	float64	max_update_ms = 0.0;		// longest single update()
+};
+
+class texture_loader
+{
+public:
+	// <r> may be nullptr, see above
+	explicit texture_loader(renderer* r, const texture_loader_options& options = texture_loader_options());
+	// Waits for the decodes in flight, the textures handed out stay with the renderer cache
+	~texture_loader();
+	texture_loader(const texture_loader&) = delete;
+	texture_loader& operator=(const texture_loader&) = delete;
+
+	// Return: the cached texture when <id> is loaded or requested already
+	texture2d* load_texture2d(const string& id, const char* path, bool flip_v=false, texture_loaded_func on_loaded=nullptr);
+	// Caches the sheet under <id> like sprite_sheet::load_sprite_sheet_from_xml()
+	sprite_sheet* load_sprite_sheet_from_xml(const string& id, const char* path);
+
+	// Uploads decoded images until the budget is spent and runs their callbacks.
+	// Return: the number of requests finished
+	uint32 update();
+	// Blocks until every request is decoded and finishes all of them, budget or not
+	void flush();
+
+	NODISCARD size_t get_pending_count() const { return m_requests.size(); }
+	NODISCARD bool is_pending(const string& id) const { return m_requests.count(id) != 0; }
+	NODISCARD texture_loader_stats get_stats() const;
+
+private:
+	struct request;
+
+private:
+	void decode(request* job);
+	void finish(request* done);
+
+private:
+	renderer*				m_renderer = nullptr;
+	texture_loader_options	m_options;
+	texture2d*				m_placeholder = nullptr;
+	// Pending requests by texture id, only touched by the owning thread
+	std::unordered_map<string, request*>	m_requests;
+	texture_loader_stats	m_stats;
+
+	// Shared with the workers
+	mutable std::mutex		m_decoded_mutex;
+	std::condition_variable	m_decoded_signal;
+	std::deque<request*>	m_decoded;
+	size_t					m_in_flight = 0;
+	float64					m_decode_ms = 0.0;
+};
+}
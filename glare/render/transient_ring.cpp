@@ -0,0 +1,163 @@
+#include "glare/render/transient_ring.h"
+#include "glare/render/renderer.h"
+#include "glare/render/buffer.h"
+#include "glare/core/assert.h"
+
+namespace glare
+{
+ring_allocator::ring_allocator(size_t capacity)
+	: m_capacity(capacity)
+{
+}
+
+size_t ring_allocator::allocate(size_t size, size_t alignment)
+{
+	ASSERT(size > 0 && alignment > 0, "Invalid ring allocation");
+	if (m_used == 0) {
+		// nothing in flight, restart at the beginning, the pending fences hold no byte
+		m_head = 0;
+		m_tail = 0;
+		m_fences.clear();
+	}
+	if (m_used > 0 && m_head == m_tail) {
+		return INVALID_OFFSET; // full
+	}
+	const size_t aligned_head = (m_head + alignment - 1) / alignment * alignment;
+	size_t offset = INVALID_OFFSET;
+	size_t consumed = 0;
+	if (m_head >= m_tail) {
+		// free space is [head, capacity) then [0, tail)
+		if (aligned_head + size <= m_capacity) {
+			offset = aligned_head;
+			consumed = aligned_head - m_head + size;
+		} else if (size <= m_tail) {
+			// the end of the ring is wasted until the tail passes it
+			offset = 0;
+			consumed = m_capacity - m_head + size;
+		}
+	} else if (aligned_head + size <= m_tail) {
+		offset = aligned_head;
+		consumed = aligned_head - m_head + size;
+	}
+	if (offset == INVALID_OFFSET) {
+		return INVALID_OFFSET;
+	}
+	m_head = offset + size;
+	m_used += consumed;
+	m_frame_size += consumed;
+	return offset;
+}
+
+void ring_allocator::end_frame(uint64 frame)
+{
+	m_fences.push_back({frame, m_head, m_frame_size});
+	m_frame_size = 0;
+}
+
+void ring_allocator::retire(uint64 completed_frame)
+{
+	while (!m_fences.empty() && m_fences.front().frame <= completed_frame) {
+		m_tail = m_fences.front().head;
+		m_used -= m_fences.front().size;
+		m_fences.pop_front();
+	}
+}
+
+void ring_allocator::reset(size_t capacity)
+{
+	m_capacity = capacity;
+	m_head = 0;
+	m_tail = 0;
+	m_used = 0;
+	m_frame_size = 0;
+	m_fences.clear();
+}
+
+transient_ring::transient_ring(renderer* r, e_render_buffer_usage usage, size_t capacity
+	, e_ring_full_policy policy, size_t max_capacity)
+	: m_renderer(r)
+	, m_usage(usage)
+	, m_policy(policy)
+	, m_max_capacity(std::max(capacity, max_capacity))
+	, m_allocator(capacity)
+{
+	ASSERT(usage != RENDER_BUFFER_CONSTANT, "Constant buffers can not be bound by range before D3D 11.1");
+	create_buffer(capacity);
+}
+
+transient_ring::~transient_ring()
+{
+	for (const retired_buffer& retired : m_retired_buffers) {
+		delete retired.buffer;
+	}
+	delete m_buffer;
+}
+
+transient_allocation transient_ring::push(const void* data, size_t size, size_t alignment)
+{
+	size_t offset = m_allocator.allocate(size, alignment);
+	if (offset == ring_allocator::INVALID_OFFSET) {
+		const size_t capacity = m_allocator.get_capacity();
+		if (m_policy == RING_GROW && capacity < m_max_capacity) {
+			// the allocations of this frame keep pointing at the old buffer
+			create_buffer(std::min(std::max(capacity * 2, size + alignment), m_max_capacity));
+			++m_stats.grows;
+		} else {
+			m_discard_next = true;
+			++m_stats.discards;
+		}
+		m_allocator.reset(m_buffer->get_buffer_size());
+		offset = m_allocator.allocate(size, alignment);
+		if (offset == ring_allocator::INVALID_OFFSET) {
+			ALERT("Allocation larger than the transient ring.");
+			return transient_allocation();
+		}
+	}
+
+	dx_context* ctx = m_renderer->get_dx_context();
+	D3D11_MAPPED_SUBRESOURCE map;
+	HRESULT hr = ctx->Map(m_buffer->get_buffer_handle(), 0
+		, m_discard_next ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &map);
+	if (FAILED(hr)) {
+		ALERT("Mapping transient ring failed.");
+		return transient_allocation();
+	}
+	memcpy(static_cast<uint8*>(map.pData) + offset, data, size);
+	ctx->Unmap(m_buffer->get_buffer_handle(), 0);
+	m_discard_next = false;
+
+	++m_stats.allocations;
+	m_stats.bytes += static_cast<uint32>(size);
+	transient_allocation result;
+	result.m_buffer = m_buffer;
+	result.m_offset = offset;
+	result.m_size = size;
+	return result;
+}
+
+void transient_ring::end_frame()
+{
+	m_allocator.end_frame(m_frame);
+	if (m_frame >= FRAMES_IN_FLIGHT) {
+		m_allocator.retire(m_frame - FRAMES_IN_FLIGHT);
+		while (!m_retired_buffers.empty() && m_retired_buffers.front().frame <= m_frame - FRAMES_IN_FLIGHT) {
+			delete m_retired_buffers.front().buffer;
+			m_retired_buffers.pop_front();
+		}
+	}
+	++m_frame;
+	m_stats.allocations = 0;
+	m_stats.bytes = 0;
+	m_stats.discards = 0;
+}
+
+void transient_ring::create_buffer(size_t capacity)
+{
+	if (m_buffer) {
+		m_retired_buffers.push_back({m_frame, m_buffer});
+	}
+	m_buffer = new render_buffer(m_renderer);
+	m_buffer->create(nullptr, capacity, 1, m_usage, GPU_MEMORY_DYNAMIC);
+	m_discard_next = true;
+}
+}
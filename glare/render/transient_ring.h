@@ -0,0 +1,140 @@
+/// glare/render/transient_ring.h
+/// Per frame sub-allocation of dynamic vertex and index data.
+///
+/// ring_allocator is the bookkeeping only, no GPU involved: allocate()
+/// returns offsets in a ring of <capacity> bytes, end_frame() puts a fence
+/// after the bytes of the frame, and retire() frees the frames the GPU is
+/// done with. An allocation that does not fit before the end of the ring
+/// wraps to offset 0 when the retired space allows it.
+///
+/// transient_ring puts a ring_allocator over one large dynamic render_buffer
+/// and writes each allocation with a NO_OVERWRITE map, so appending never
+/// stalls on the GPU or re-creates the buffer. Frames are retired once
+/// FRAMES_IN_FLIGHT newer frames ended, the DXGI default frame latency.
+/// When the bytes in flight leave no room, e_ring_full_policy decides:
+/// grow the buffer, or restart it with a DISCARD map, which makes the
+/// driver hand out new memory while the GPU finishes with the old one.
+/// A buffer replaced by a grow is kept until its frame retires, since the
+/// allocations made before the grow still point at it.
+///
+/// Constant buffers are not handled: binding a range of one needs D3D 11.1.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/render/common.h"
+#include <deque>
+
+namespace glare
+{
+class renderer;
+class render_buffer;
+
+class ring_allocator
+{
+public:
+	static constexpr size_t INVALID_OFFSET = static_cast<size_t>(-1);
+public:
+	explicit ring_allocator(size_t capacity);
+
+	// Return: offset of <size> bytes aligned to <alignment> (any non zero value),
+	//		INVALID_OFFSET when the frames in flight leave no room
+	NODISCARD size_t allocate(size_t size, size_t alignment = 1);
+	// Fences the bytes allocated since the last end_frame() as <frame>
+	void end_frame(uint64 frame);
+	// Frees the bytes of every fenced frame up to <completed_frame>
+	void retire(uint64 completed_frame);
+	// Forgets every allocation and fence
+	void reset(size_t capacity);
+
+	NODISCARD size_t get_capacity() const	{ return m_capacity; }
+	NODISCARD size_t get_used() const		{ return m_used; }	// including padding and wrapped tails
+	NODISCARD bool is_empty() const			{ return m_used == 0; }
+
+private:
+	struct fence
+	{
+		uint64 frame;
+		size_t head;	// ring head when the frame ended
+		size_t size;	// bytes used by the frame
+	};
+
+	size_t				m_capacity = 0;
+	size_t				m_head = 0;		// next free byte
+	size_t				m_tail = 0;		// oldest byte in flight
+	size_t				m_used = 0;
+	size_t				m_frame_size = 0;	// bytes since the last fence
+	std::deque<fence>	m_fences;
+};
+
+enum e_ring_full_policy
+{
+	RING_GROW,		// double the buffer, up to the max capacity, then discard
+	RING_DISCARD,	// restart the buffer at offset 0 with a DISCARD map
+};
+
+struct transient_allocation
+{
+	render_buffer*	m_buffer = nullptr;
+	size_t			m_offset = 0;	// bytes
+	size_t			m_size = 0;		// bytes
+
+	// false when the ring could not hold the data, nothing to draw then
+	NODISCARD bool is_valid() const { return m_buffer != nullptr; }
+	// First vertex or index of the allocation, for draw()/draw_indexed()
+	NODISCARD size_t get_first_element(size_t element_size) const { return m_offset / element_size; }
+};
+
+struct transient_ring_stats
+{
+	uint32 allocations	= 0;	// since the last end_frame()
+	uint32 bytes		= 0;	// since the last end_frame()
+	uint32 discards		= 0;	// since the last end_frame()
+	uint32 grows		= 0;	// since creation
+};
+
+class transient_ring
+{
+public:
+	static constexpr uint64 FRAMES_IN_FLIGHT = 3;
+public:
+	transient_ring(renderer* r, e_render_buffer_usage usage, size_t capacity
+		, e_ring_full_policy policy = RING_GROW, size_t max_capacity = 64u << 20);
+	~transient_ring();
+	transient_ring(const transient_ring&) = delete;
+	transient_ring& operator=(const transient_ring&) = delete;
+
+	// Copies <size> bytes of <data> into the ring. Draw from the result before
+	// the next push(): a push that finds the ring full restarts it with a
+	// DISCARD map, and the earlier allocations of the frame that were not drawn
+	// yet lose their content (drawn ones are safe, the driver renames the buffer).
+	// Return: an invalid allocation when the data does not fit or the map fails
+	NODISCARD transient_allocation push(const void* data, size_t size, size_t alignment);
+	// Fences the frame and retires the ones the GPU is done with
+	void end_frame();
+
+	NODISCARD render_buffer*				get_buffer() const		{ return m_buffer; }
+	NODISCARD const ring_allocator&			get_allocator() const	{ return m_allocator; }
+	NODISCARD const transient_ring_stats&	get_stats() const		{ return m_stats; }
+
+private:
+	void create_buffer(size_t capacity);
+
+private:
+	struct retired_buffer
+	{
+		uint64			frame;	// the last frame that may use it
+		render_buffer*	buffer;
+	};
+
+	renderer*				m_renderer = nullptr;
+	render_buffer*			m_buffer = nullptr;
+	e_render_buffer_usage	m_usage;
+	e_ring_full_policy		m_policy;
+	size_t					m_max_capacity = 0;
+	ring_allocator			m_allocator;
+	std::deque<retired_buffer>	m_retired_buffers;	// replaced by a grow, oldest first
+	uint64					m_frame = 0;
+	bool					m_discard_next = true;	// the next map renames the buffer
+	transient_ring_stats	m_stats;
+};
+}
@@ -2,10 +2,13 @@
 
 namespace glare
 {
-STATIC buffer_layout::attribute vertex_pcu::_s_attr[] = {
-	{"POSITION",	HLSL_FLOAT3, offsetof(vertex_pcu, position)},
-	{"COLOR",		HLSL_FLOAT4, offsetof(vertex_pcu, color)},
-	{"TEXCOORD",	HLSL_FLOAT2, offsetof(vertex_pcu, uv)},
-	buffer_layout::attribute::END()
+vertex_pcu_compact::vertex_pcu_compact(const vec3& position, const rgba& color, const vec2& uv)
+	: position(position), color(vertex_packing::pack_unorm8x4(color)), uv(vertex_packing::pack_half2(uv))
+{
+}
+
+vertex_pcu_2d::vertex_pcu_2d(const vec2& position, const rgba& color, const vec2& uv)
+	: position(position), color(vertex_packing::pack_unorm8x4(color)), uv(vertex_packing::pack_unorm16x2(uv))
+{
+}
 };
-};
\ No newline at end of file
@@ -2,16 +2,10 @@
 #include "glare/math/vector.h"
 #include "glare/core/color.h"
 #include "glare/render/buffer.h"
+#include "glare/render/vertex_format.h"
 
 namespace glare
 {
-struct super_vertex
-{
-	vec3 position;
-	rgba color;
-	vec2 uv;
-};
-
 struct vertex_pcu
 {
 	vec3 position;
@@ -31,18 +25,42 @@ struct vertex_pcu
 		uv = copy.uv;
 		return *this;
 	}
-	
-	static buffer_layout::attribute _s_attr[];
-	static void _copy_from_super_vertex(void* dst, const super_vertex* src, size_t count);
 };
 
-inline void vertex_pcu::_copy_from_super_vertex(void* dst, const super_vertex* src, size_t count)
+template<> struct vertex_format<vertex_pcu> : vertex_format_of<vertex_pcu
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu, position, VERTEX_POSITION)
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu, color, VERTEX_COLOR)
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu, uv, VERTEX_UV)> {};
+
+// 20 bytes instead of 36: 8 bit color, half uv (any range, tiling still works)
+struct vertex_pcu_compact
 {
-	vertex_pcu* buffer = static_cast<vertex_pcu*>(dst);
-	for (size_t i = 0; i < count; ++i) {
-		buffer[i].position = src[i].position;
-		buffer[i].color = src[i].color;
-		buffer[i].uv = src[i].uv;
-	}
-}
+	vec3 position;
+	rgba8 color;
+	half2 uv;
+
+	vertex_pcu_compact() = default;
+	vertex_pcu_compact(const vec3& position, const rgba& color, const vec2& uv);
+};
+
+template<> struct vertex_format<vertex_pcu_compact> : vertex_format_of<vertex_pcu_compact
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu_compact, position, VERTEX_POSITION)
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu_compact, color, VERTEX_COLOR)
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu_compact, uv, VERTEX_UV)> {};
+
+// 16 bytes, for sprites: 2D position (z reads as 0), 8 bit color, uv clamped to [0, 1]
+struct vertex_pcu_2d
+{
+	vec2 position;
+	rgba8 color;
+	unorm16x2 uv;
+
+	vertex_pcu_2d() = default;
+	vertex_pcu_2d(const vec2& position, const rgba& color, const vec2& uv);
+};
+
+template<> struct vertex_format<vertex_pcu_2d> : vertex_format_of<vertex_pcu_2d
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu_2d, position, VERTEX_POSITION)
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu_2d, color, VERTEX_COLOR)
+	, GLARE_VERTEX_ATTRIBUTE(vertex_pcu_2d, uv, VERTEX_UV)> {};
 };
\ No newline at end of file
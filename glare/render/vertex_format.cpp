@@ -0,0 +1,139 @@
+#include "glare/render/vertex_format.h"
+#include "glare/math/utilities.h"
+#include "glare/math/simd.h"
+#include <cmath>
+#include <cstring>
+
+namespace glare
+{
+namespace vertex_packing
+{
+// Scalar packing rounds to nearest even like _mm_cvtps_epi32, so both paths give the same bits
+static byte _pack_unorm8(float32 value)
+{
+	return static_cast<byte>(std::lrint(clamp(value, 0.f, 1.f) * 255.f));
+}
+
+static uint16 _pack_unorm16(float32 value)
+{
+	return static_cast<uint16>(std::lrint(clamp(value, 0.f, 1.f) * 65535.f));
+}
+
+rgba8 pack_unorm8x4(const rgba& value)
+{
+	return rgba8(_pack_unorm8(value.r), _pack_unorm8(value.g), _pack_unorm8(value.b), _pack_unorm8(value.a));
+}
+
+half2 pack_half2(const vec2& value)
+{
+	half2 result;
+	result.x = float_to_half(value.x);
+	result.y = float_to_half(value.y);
+	return result;
+}
+
+unorm16x2 pack_unorm16x2(const vec2& value)
+{
+	unorm16x2 result;
+	result.x = _pack_unorm16(value.x);
+	result.y = _pack_unorm16(value.y);
+	return result;
+}
+
+#if defined(GLARE_SIMD_SSE2)
+// Two float2 of 4 values as x0 y0 x1 y1 and x2 y2 x3 y3
+static void _load_float2_4(const byte* src, size_t src_stride, __m128& out_01, __m128& out_23)
+{
+	const auto load_pair = [](const byte* a, const byte* b) {
+		const __m128 low = _mm_loadl_pi(_mm_setzero_ps(), reinterpret_cast<const __m64*>(a));
+		return _mm_loadh_pi(low, reinterpret_cast<const __m64*>(b));
+	};
+	out_01 = load_pair(src, src + src_stride);
+	out_23 = load_pair(src + 2 * src_stride, src + 3 * src_stride);
+}
+
+// Writes the 4 uint32 of <packed>, one every <dst_stride> bytes
+static void _store_uint32_4(byte* dst, size_t dst_stride, const __m128i& packed)
+{
+	uint32 values[4];
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(values), packed);
+	for (size_t k = 0; k < 4; ++k) {
+		memcpy(dst + k * dst_stride, &values[k], sizeof(uint32));
+	}
+}
+#endif
+
+void pack_unorm8x4(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 scale = _mm_set1_ps(255.f);
+	for (; i + 4 <= count; i += 4) {
+		const byte* from = src + i * src_stride;
+		__m128i channels[4];
+		for (size_t k = 0; k < 4; ++k) {
+			const __m128 value = _mm_loadu_ps(reinterpret_cast<const float32*>(from + k * src_stride));
+			channels[k] = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value, zero), one), scale));
+		}
+		const __m128i packed = _mm_packus_epi16(
+			_mm_packs_epi32(channels[0], channels[1]), _mm_packs_epi32(channels[2], channels[3]));
+		_store_uint32_4(dst + i * dst_stride, dst_stride, packed);
+	}
+#endif
+	for (; i < count; ++i) {
+		const float32* from = reinterpret_cast<const float32*>(src + i * src_stride);
+		byte* to = dst + i * dst_stride;
+		for (size_t c = 0; c < 4; ++c) {
+			to[c] = _pack_unorm8(from[c]);
+		}
+	}
+}
+
+void pack_half2(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	for (; i + 4 <= count; i += 4) {
+		__m128 value_01, value_23;
+		_load_float2_4(src + i * src_stride, src_stride, value_01, value_23);
+		// sign extend the halves first, packs_epi32 saturates
+		const __m128i half_01 = _mm_srai_epi32(_mm_slli_epi32(simd::float_to_half(value_01), 16), 16);
+		const __m128i half_23 = _mm_srai_epi32(_mm_slli_epi32(simd::float_to_half(value_23), 16), 16);
+		_store_uint32_4(dst + i * dst_stride, dst_stride, _mm_packs_epi32(half_01, half_23));
+	}
+#endif
+	for (; i < count; ++i) {
+		const float32* from = reinterpret_cast<const float32*>(src + i * src_stride);
+		const half2 packed = pack_half2(vec2(from[0], from[1]));
+		memcpy(dst + i * dst_stride, &packed, sizeof(packed));
+	}
+}
+
+void pack_unorm16x2(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count)
+{
+	size_t i = 0;
+#if defined(GLARE_SIMD_SSE2)
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+	const __m128 scale = _mm_set1_ps(65535.f);
+	// shifted into the signed range so packs_epi32 does not saturate it
+	const __m128i bias = _mm_set1_epi32(32768);
+	const __m128i unbias = _mm_set1_epi16(static_cast<int16>(0x8000));
+	for (; i + 4 <= count; i += 4) {
+		__m128 value_01, value_23;
+		_load_float2_4(src + i * src_stride, src_stride, value_01, value_23);
+		const __m128i unorm_01 = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value_01, zero), one), scale)), bias);
+		const __m128i unorm_23 = _mm_sub_epi32(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(value_23, zero), one), scale)), bias);
+		_store_uint32_4(dst + i * dst_stride, dst_stride, _mm_xor_si128(_mm_packs_epi32(unorm_01, unorm_23), unbias));
+	}
+#endif
+	for (; i < count; ++i) {
+		const float32* from = reinterpret_cast<const float32*>(src + i * src_stride);
+		const unorm16x2 packed = pack_unorm16x2(vec2(from[0], from[1]));
+		memcpy(dst + i * dst_stride, &packed, sizeof(packed));
+	}
+}
+}
+}
@@ -0,0 +1,164 @@
+/// glare/render/vertex_format.h
+/// Vertex types described once, at compile time.
+///
+/// A vertex type lists its attributes in a vertex_format specialization,
+/// each naming the member and the super_vertex field it is filled from:
+///
+///	template<> struct vertex_format<my_vertex> : vertex_format_of<my_vertex
+///		, GLARE_VERTEX_ATTRIBUTE(my_vertex, position, VERTEX_POSITION)
+///		, GLARE_VERTEX_ATTRIBUTE(my_vertex, color, VERTEX_COLOR)> {};
+///
+/// The HLSL type follows from the member type, the semantic from the source
+/// field. The attribute table, the stride and the buffer_layout are constexpr,
+/// so buffer_layout::acquire_layout_of<T>() is an address, not a lookup.
+/// copy_from_super_vertex() is generated from the same list: it converts
+/// blocks of vertices one attribute at a time with the vertex_packing
+/// kernels, which use SSE2 for the packed types.
+
+#pragma once
+#include "glare/core/common.h"
+#include "glare/core/color.h"
+#include "glare/math/vector.h"
+#include "glare/math/half.h"
+#include "glare/render/buffer.h"
+#include <algorithm>
+#include <cstddef>
+
+namespace glare
+{
+struct super_vertex
+{
+	vec3 position;
+	rgba color;
+	vec2 uv;
+};
+
+struct half2
+{
+	half x = 0;
+	half y = 0;
+};
+
+// [0, 1] in 1/65535 steps, read back as float by R16G16_UNORM
+struct unorm16x2
+{
+	uint16 x = 0;
+	uint16 y = 0;
+};
+
+enum e_vertex_source
+{
+	VERTEX_POSITION,	// super_vertex::position, "POSITION"
+	VERTEX_COLOR,		// super_vertex::color, "COLOR"
+	VERTEX_UV,			// super_vertex::uv, "TEXCOORD"
+};
+
+constexpr const char* get_semantic_of_vertex_source(e_vertex_source source)
+{
+	return source == VERTEX_POSITION ? "POSITION" : source == VERTEX_COLOR ? "COLOR" : "TEXCOORD";
+}
+
+constexpr size_t get_offset_of_vertex_source(e_vertex_source source)
+{
+	return source == VERTEX_POSITION ? offsetof(super_vertex, position)
+		: source == VERTEX_COLOR ? offsetof(super_vertex, color) : offsetof(super_vertex, uv);
+}
+
+constexpr size_t get_component_count_of_vertex_source(e_vertex_source source)
+{
+	return source == VERTEX_POSITION ? 3u : source == VERTEX_COLOR ? 4u : 2u;
+}
+
+// HLSL type of a vertex member type, undefined for the unsupported ones
+template<typename T> struct hlsl_type_of;
+template<> struct hlsl_type_of<float32>		{ static constexpr e_hlsl_type VALUE = HLSL_FLOAT; };
+template<> struct hlsl_type_of<vec2>		{ static constexpr e_hlsl_type VALUE = HLSL_FLOAT2; };
+template<> struct hlsl_type_of<vec3>		{ static constexpr e_hlsl_type VALUE = HLSL_FLOAT3; };
+template<> struct hlsl_type_of<vec4>		{ static constexpr e_hlsl_type VALUE = HLSL_FLOAT4; };
+template<> struct hlsl_type_of<rgba>		{ static constexpr e_hlsl_type VALUE = HLSL_FLOAT4; };
+template<> struct hlsl_type_of<rgba8>		{ static constexpr e_hlsl_type VALUE = HLSL_UNORM8X4; };
+template<> struct hlsl_type_of<half2>		{ static constexpr e_hlsl_type VALUE = HLSL_HALF2; };
+template<> struct hlsl_type_of<unorm16x2>	{ static constexpr e_hlsl_type VALUE = HLSL_UNORM16X2; };
+
+// Strided conversion kernels: read <count> values of floats at <src> every
+// <src_stride> bytes, write one value at <dst> every <dst_stride> bytes.
+// Packing clamps to the unorm range and rounds to nearest even.
+namespace vertex_packing
+{
+template<size_t COMPONENTS>
+inline void copy_floats(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		const float32* from = reinterpret_cast<const float32*>(src + i * src_stride);
+		float32* to = reinterpret_cast<float32*>(dst + i * dst_stride);
+		for (size_t c = 0; c < COMPONENTS; ++c) {
+			to[c] = from[c];
+		}
+	}
+}
+void pack_unorm8x4(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count);
+void pack_half2(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count);
+void pack_unorm16x2(byte* dst, size_t dst_stride, const byte* src, size_t src_stride, size_t count);
+
+rgba8 pack_unorm8x4(const rgba& value);
+half2 pack_half2(const vec2& value);
+unorm16x2 pack_unorm16x2(const vec2& value);
+}
+
+template<e_vertex_source SOURCE, typename T, size_t OFFSET>
+struct vertex_attribute
+{
+	static constexpr e_hlsl_type TYPE = hlsl_type_of<T>::VALUE;
+	static_assert(sizeof(T) == get_size_of_hlsl_type(TYPE), "Vertex member size does not match its HLSL type");
+	static_assert(get_component_count_of_hlsl_type(TYPE) <= get_component_count_of_vertex_source(SOURCE)
+		, "The super_vertex field has fewer components than the attribute");
+
+	static constexpr buffer_layout::attribute get_attribute()
+	{
+		return buffer_layout::attribute(get_semantic_of_vertex_source(SOURCE), TYPE, OFFSET);
+	}
+
+	// <dst> points to the first vertex
+	static void copy(byte* dst, size_t stride, const super_vertex* src, size_t count)
+	{
+		const byte* from = reinterpret_cast<const byte*>(src) + get_offset_of_vertex_source(SOURCE);
+		if constexpr (TYPE == HLSL_UNORM8X4) {
+			vertex_packing::pack_unorm8x4(dst + OFFSET, stride, from, sizeof(super_vertex), count);
+		} else if constexpr (TYPE == HLSL_HALF2) {
+			vertex_packing::pack_half2(dst + OFFSET, stride, from, sizeof(super_vertex), count);
+		} else if constexpr (TYPE == HLSL_UNORM16X2) {
+			vertex_packing::pack_unorm16x2(dst + OFFSET, stride, from, sizeof(super_vertex), count);
+		} else {
+			vertex_packing::copy_floats<get_component_count_of_hlsl_type(TYPE)>(dst + OFFSET, stride, from, sizeof(super_vertex), count);
+		}
+	}
+};
+
+#define GLARE_VERTEX_ATTRIBUTE(vertex, member, source) \
+	::glare::vertex_attribute<source, decltype(vertex::member), offsetof(vertex, member)>
+
+template<typename V, typename... ATTRIBUTES>
+struct vertex_format_of
+{
+	static constexpr size_t STRIDE = sizeof(V);
+	static constexpr size_t ATTRIBUTES_COUNT = sizeof...(ATTRIBUTES);
+	// the super_vertex block stays in L1 while each attribute makes its pass over it
+	static constexpr size_t BLOCK_SIZE = 64;
+	static_assert(ATTRIBUTES_COUNT > 0, "A vertex format needs at least one attribute");
+	static_assert(((ATTRIBUTES::get_attribute().offset + get_size_of_hlsl_type(ATTRIBUTES::TYPE) <= STRIDE) && ...)
+		, "Vertex attribute outside of the vertex");
+
+	static void copy_from_super_vertex(void* dst, const super_vertex* src, size_t count)
+	{
+		byte* out = static_cast<byte*>(dst);
+		for (size_t first = 0; first < count; first += BLOCK_SIZE) {
+			const size_t block = std::min(BLOCK_SIZE, count - first);
+			(ATTRIBUTES::copy(out + first * STRIDE, STRIDE, src + first, block), ...);
+		}
+	}
+
+	// ends with attribute::END() like the hand written tables
+	static constexpr buffer_layout::attribute ATTRIBUTES_TABLE[] = {ATTRIBUTES::get_attribute()..., buffer_layout::attribute()};
+	static constexpr buffer_layout LAYOUT = buffer_layout(ATTRIBUTES_TABLE, ATTRIBUTES_COUNT, STRIDE, &copy_from_super_vertex);
+};
+}